@@ -29,6 +29,7 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <cstdint>
 
 namespace rmf_fleet_adapter {
 namespace agv {
@@ -142,6 +143,37 @@ public:
       Watchdog watchdog,
       rmf_traffic::Duration wait_duration = std::chrono::seconds(10));
 
+    /// Counts of the position and battery updates that have been given to this
+    /// robot. The updates are applied by the robot's worker. While an update is
+    /// waiting for the worker, a newer update of the same kind replaces it.
+    struct UpdateStats
+    {
+      /// The number of updates that were given
+      uint64_t received = 0;
+
+      /// The number of updates that were applied to the robot
+      uint64_t applied = 0;
+
+      /// The number of updates that were replaced by a newer one before the
+      /// worker could apply them
+      uint64_t dropped = 0;
+
+      /// The number of updates that arrived while the worker was already
+      /// scheduled to apply an earlier update, so they did not need to be
+      /// scheduled separately
+      uint64_t coalesced = 0;
+    };
+
+    /// Get the current update stats of this robot
+    UpdateStats update_stats() const;
+
+    /// Set how much delay needs to build up before it gets published to the
+    /// traffic schedule. A smaller delay is held back, unless it would cause
+    /// the robot to conflict with another participant of the schedule. The
+    /// default threshold is 2 seconds. A zero threshold will publish every
+    /// delay right away.
+    void set_delay_threshold(rmf_traffic::Duration threshold);
+
   private:
     friend Implementation;
     Implementation* _pimpl;
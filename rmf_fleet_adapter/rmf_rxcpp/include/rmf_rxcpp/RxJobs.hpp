@@ -31,6 +31,16 @@ inline auto make_job(const std::shared_ptr<Action>& action)
   return detail::make_observable<T>(action);
 }
 
+/// Same as make_job(action), but the job will be run by workers of the given
+/// scheduler instead of the default event loop.
+template<typename T, typename Action>
+inline auto make_job(
+  const std::shared_ptr<Action>& action,
+  const rxcpp::schedulers::scheduler& scheduler)
+{
+  return detail::make_observable<T>(action, scheduler);
+}
+
 template<typename T, typename F>
 inline auto make_leaky_job(const F& f)
 {
@@ -50,6 +60,16 @@ inline auto make_job_from_action_list(const ActionsIterable& actions)
   return detail::make_merged_observable<typename Action::Result>(actions);
 }
 
+template<typename ActionsIterable>
+inline auto make_job_from_action_list(
+  const ActionsIterable& actions,
+  const rxcpp::schedulers::scheduler& scheduler)
+{
+  using Action = typename std::iterator_traits<decltype(actions.begin())>::value_type::element_type;
+  return detail::make_merged_observable<typename Action::Result>(
+    actions, scheduler);
+}
+
 struct subscription_guard
 {
   subscription_guard(rxcpp::subscription s = rxcpp::subscription())
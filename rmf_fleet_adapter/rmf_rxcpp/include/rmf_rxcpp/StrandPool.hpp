@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef RMF_RXCPP__STRANDPOOL_HPP
+#define RMF_RXCPP__STRANDPOOL_HPP
+
+#include <rmf_rxcpp/detail/StrandPoolDetail.hpp>
+
+#include <unordered_map>
+
+namespace rmf_rxcpp {
+
+//==============================================================================
+/// A fixed-size pool of threads that services any number of strands. Each
+/// strand is exposed as an rxcpp worker, so it can be used anywhere that a
+/// worker from rxcpp::schedulers::make_event_loop() could be used. Actions that
+/// are scheduled on the same strand are serialized, but different strands may
+/// run in parallel on different threads of the pool, so one slow strand will
+/// not hold up the others.
+///
+/// Strands may be given a priority. When more strands are ready than there are
+/// threads, the strands with the highest priority value get served first.
+///
+/// Like the rest of rmf_rxcpp, everything here is defined inline so that
+/// rmf_rxcpp does not need to be exported as its own library.
+class StrandPool : public std::enable_shared_from_this<StrandPool>
+{
+public:
+
+  /// Make a strand pool.
+  ///
+  /// \param[in] num_threads
+  ///   The number of threads to run in the pool. If 0 is given, the number of
+  ///   hardware threads will be used (with a minimum of 2).
+  static std::shared_ptr<StrandPool> make(std::size_t num_threads = 0)
+  {
+    if (num_threads == 0)
+    {
+      num_threads = std::max(
+        static_cast<std::size_t>(std::thread::hardware_concurrency()),
+        static_cast<std::size_t>(2));
+    }
+
+    return std::shared_ptr<StrandPool>(new StrandPool(num_threads));
+  }
+
+  /// Create a new strand that is not shared with anything else.
+  rxcpp::schedulers::worker make_strand(int priority = 0) const
+  {
+    return scheduler(priority).create_worker();
+  }
+
+  /// Get the strand that belongs to the given key, e.g. a robot's participant
+  /// ID. The same key will always give back the same strand, so everything
+  /// that is dispatched with the same key will be serialized.
+  rxcpp::schedulers::worker strand(std::size_t key)
+  {
+    std::lock_guard<std::mutex> lock(_strands_mutex);
+    const auto insertion = _strands.insert({key, rxcpp::schedulers::worker()});
+    if (insertion.second)
+      insertion.first->second = make_strand();
+
+    return insertion.first->second;
+  }
+
+  /// Forget the strand that belongs to the given key. Work that was already
+  /// scheduled on that strand will still be performed.
+  void release_strand(std::size_t key)
+  {
+    std::lock_guard<std::mutex> lock(_strands_mutex);
+    _strands.erase(key);
+  }
+
+  /// Get an rxcpp scheduler that creates a new strand with the given priority
+  /// for each worker.
+  rxcpp::schedulers::scheduler scheduler(int priority = 0) const
+  {
+    return rxcpp::schedulers::make_scheduler<detail::StrandScheduler>(
+      _state, priority);
+  }
+
+  /// Get the number of threads in this pool.
+  std::size_t num_threads() const
+  {
+    return _threads.size();
+  }
+
+  ~StrandPool()
+  {
+    _state->stop();
+    for (auto& thread : _threads)
+    {
+      if (!thread.joinable())
+        continue;
+
+      // If the last reference to the pool was dropped by an action that is
+      // running inside the pool, we cannot join our own thread.
+      if (thread.get_id() == std::this_thread::get_id())
+        thread.detach();
+      else
+        thread.join();
+    }
+  }
+
+private:
+
+  StrandPool(std::size_t num_threads)
+  : _state(std::make_shared<detail::StrandPoolState>())
+  {
+    _threads.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+      _threads.emplace_back([state = _state]()
+        {
+          state->spin();
+        });
+    }
+  }
+
+  std::shared_ptr<detail::StrandPoolState> _state;
+  std::vector<std::thread> _threads;
+
+  std::mutex _strands_mutex;
+  std::unordered_map<std::size_t, rxcpp::schedulers::worker> _strands;
+};
+
+using StrandPoolPtr = std::shared_ptr<StrandPool>;
+
+} // namespace rmf_rxcpp
+
+#endif // RMF_RXCPP__STRANDPOOL_HPP
@@ -20,6 +20,7 @@
 
 #include <rmf_rxcpp/detail/TransportDetail.hpp>
 #include <rmf_rxcpp/RxJobs.hpp>
+#include <rmf_rxcpp/StrandPool.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <rxcpp/rx.hpp>
 #include <utility>
@@ -137,6 +138,7 @@ public:
       const std::string& node_name,
       const rclcpp::NodeOptions& options = rclcpp::NodeOptions())
     : rclcpp::Node{node_name, options},
+      _worker{worker},
       _executor{std::make_shared<RxCppExecutor>(
                   worker, _make_exec_args(options))}
   {
@@ -205,6 +207,53 @@ public:
     return !_stopping && rclcpp::ok(get_node_options().context());
   }
 
+  /// Get the worker that this node is spun on
+  const rxcpp::schedulers::worker& worker() const
+  {
+    return _worker;
+  }
+
+  /// Switch this transport into multi-threaded mode. The node itself will
+  /// continue to be spun on its own worker, but strand(key) will hand out
+  /// separate strands of the given pool so that the work dispatched for one
+  /// key cannot hold up the work of any other key.
+  ///
+  /// Passing in a nullptr switches back to single-threaded mode for any
+  /// strands that get requested afterwards.
+  Transport& strands(std::shared_ptr<StrandPool> pool)
+  {
+    _strands = std::move(pool);
+    return *this;
+  }
+
+  /// Get the strand pool of this transport. This will be a nullptr unless the
+  /// transport is in multi-threaded mode.
+  const std::shared_ptr<StrandPool>& strands() const
+  {
+    return _strands;
+  }
+
+  /// Get the worker that should be used for anything that is dispatched with
+  /// the given key, e.g. a robot's participant ID. In multi-threaded mode each
+  /// key gets its own serialized strand. Otherwise this is the same worker that
+  /// the node is spun on.
+  rxcpp::schedulers::worker strand(std::size_t key) const
+  {
+    if (_strands)
+      return _strands->strand(key);
+
+    return _worker;
+  }
+
+  /// Forget the strand of the given key once nothing will be dispatched with
+  /// that key anymore, e.g. when a robot is removed. This does nothing in
+  /// single-threaded mode.
+  void release_strand(std::size_t key) const
+  {
+    if (_strands)
+      _strands->release_strand(key);
+  }
+
   /**
    * Creates a sharable observable that is bridged to a rclcpp subscription and is observed on an
    * event loop. When there are multiple subscribers, it multiplexes the message onto each
@@ -234,6 +283,8 @@ private:
   std::atomic_bool _stopping = false;
   std::mutex _stopping_mutex;
 
+  rxcpp::schedulers::worker _worker;
+  std::shared_ptr<StrandPool> _strands;
   std::shared_ptr<RxCppExecutor> _executor;
   bool _node_added = false;
   std::thread _spin_thread;
@@ -84,6 +84,21 @@ auto make_observable(const std::shared_ptr<Action>& action)
   });
 }
 
+/// Same as make_observable, except the job will run on a worker of the given
+/// scheduler instead of the event loop.
+template<typename T, typename Action>
+auto make_observable(
+  const std::shared_ptr<Action>& action,
+  const rxcpp::schedulers::scheduler& scheduler)
+{
+  return rxcpp::observable<>::create<T>(
+        [a = std::weak_ptr<Action>(action), scheduler](const auto& s)
+  {
+    auto worker = scheduler.create_worker();
+    detail::schedule_job(a, s, worker);
+  });
+}
+
 /// Alternative to make_observable that is unconcerned about memory leaks
 template<typename T, typename Action>
 auto make_leaky_observable(const std::shared_ptr<Action>& action)
@@ -110,6 +125,23 @@ auto make_merged_observable(const ActionsIterable& actions)
   }).merge(rxcpp::serialize_event_loop());
 }
 
+template<typename T, typename ActionsIterable>
+auto make_merged_observable(
+  const ActionsIterable& actions,
+  const rxcpp::schedulers::scheduler& scheduler)
+{
+  using Observable =
+    decltype(detail::make_observable<T>(*actions.begin(), scheduler));
+
+  return rxcpp::observable<>::create<Observable>(
+        [&actions, scheduler](const auto& s)
+  {
+    for (const auto& a : actions)
+      s.on_next(detail::make_observable<T>(a, scheduler));
+    s.on_completed();
+  }).merge(rxcpp::serialize_event_loop());
+}
+
 } // namespace detail
 } // namespace rmf_rxcpp
 
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef RMF_RXCPP__DETAIL__STRANDPOOLDETAIL_HPP
+#define RMF_RXCPP__DETAIL__STRANDPOOLDETAIL_HPP
+
+#include <rxcpp/rx.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace rmf_rxcpp {
+namespace detail {
+
+class StrandPoolState;
+
+//==============================================================================
+/// The queue of one strand. Actions that are pushed into the same strand will
+/// never run concurrently with each other, and they will run in the order that
+/// they became due. When several strands are waiting for a thread, the ones
+/// with a higher priority value are served first.
+class StrandState : public std::enable_shared_from_this<StrandState>
+{
+public:
+
+  using schedulable = rxcpp::schedulers::schedulable;
+
+  StrandState(std::weak_ptr<StrandPoolState> pool, int priority)
+  : _pool(std::move(pool)),
+    _priority(priority)
+  {
+    // Do nothing
+  }
+
+  /// Push an action that is ready to run. Returns true if the strand needs to
+  /// be handed to the pool because it was idle.
+  bool push(const schedulable& scbl)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.push_back(scbl);
+    _recursion.reset(false);
+    if (_active)
+      return false;
+
+    _active = true;
+    return true;
+  }
+
+  /// Run up to max_actions of the queued actions. Returns true if the strand
+  /// still has work remaining and should be handed back to the pool.
+  bool run(std::size_t max_actions)
+  {
+    for (std::size_t i = 0; i < max_actions; ++i)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_queue.empty())
+      {
+        _active = false;
+        return false;
+      }
+
+      auto what = std::move(_queue.front());
+      _queue.pop_front();
+      if (!what.is_subscribed())
+        continue;
+
+      _recursion.reset(_queue.empty());
+      lock.unlock();
+
+      what(_recursion.get_recurse());
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_queue.empty())
+    {
+      _active = false;
+      return false;
+    }
+
+    return true;
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.clear();
+  }
+
+  const std::weak_ptr<StrandPoolState>& pool() const
+  {
+    return _pool;
+  }
+
+  int priority() const
+  {
+    return _priority;
+  }
+
+private:
+  std::weak_ptr<StrandPoolState> _pool;
+  const int _priority;
+  std::mutex _mutex;
+  std::deque<schedulable> _queue;
+  rxcpp::schedulers::recursion _recursion;
+
+  // True while the strand is either waiting in the pool's ready queue or being
+  // run by one of the pool threads.
+  bool _active = false;
+};
+
+//==============================================================================
+class StrandPoolState : public std::enable_shared_from_this<StrandPoolState>
+{
+public:
+
+  using clock_type = rxcpp::schedulers::scheduler_base::clock_type;
+  using schedulable = rxcpp::schedulers::schedulable;
+
+  /// The maximum number of actions that a strand may run before it yields its
+  /// thread to the next strand in line.
+  static constexpr std::size_t MaxActionsPerTurn = 16;
+
+  void schedule(
+    const std::shared_ptr<StrandState>& strand,
+    const schedulable& scbl)
+  {
+    if (!scbl.is_subscribed())
+      return;
+
+    if (!strand->push(scbl))
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_stopping)
+      {
+        strand->clear();
+        return;
+      }
+
+      _ready[strand->priority()].push_back(strand);
+    }
+
+    _cv.notify_one();
+  }
+
+  void schedule(
+    clock_type::time_point when,
+    const std::shared_ptr<StrandState>& strand,
+    const schedulable& scbl)
+  {
+    if (when <= clock_type::now())
+      return schedule(strand, scbl);
+
+    if (!scbl.is_subscribed())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_stopping)
+        return;
+
+      _timers.push(Timer{when, _timer_count++, strand, scbl});
+    }
+
+    // Wake up a thread so that it can adjust its wait time
+    _cv.notify_one();
+  }
+
+  void spin()
+  {
+    std::vector<Timer> due;
+    for (;;)
+    {
+      std::shared_ptr<StrandState> next;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;)
+        {
+          if (_stopping)
+            return;
+
+          const auto now = clock_type::now();
+          while (!_timers.empty() && _timers.top().when <= now)
+          {
+            due.push_back(_timers.top());
+            _timers.pop();
+          }
+
+          if (!due.empty() || !_ready.empty())
+            break;
+
+          if (_timers.empty())
+            _cv.wait(lock);
+          else
+            _cv.wait_until(lock, _timers.top().when);
+        }
+
+        if (due.empty())
+        {
+          // The map is sorted so that the highest priority comes first
+          const auto bucket = _ready.begin();
+          next = std::move(bucket->second.front());
+          bucket->second.pop_front();
+          if (bucket->second.empty())
+            _ready.erase(bucket);
+        }
+      }
+
+      if (!due.empty())
+      {
+        for (const auto& timer : due)
+          schedule(timer.strand, timer.what);
+
+        due.clear();
+        continue;
+      }
+
+      if (next->run(MaxActionsPerTurn))
+      {
+        // Send the strand to the back of the line so other strands get a turn
+        std::lock_guard<std::mutex> lock(_mutex);
+        const int priority = next->priority();
+        _ready[priority].push_back(std::move(next));
+      }
+    }
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+      _ready.clear();
+      _timers = TimerQueue();
+    }
+
+    _cv.notify_all();
+  }
+
+private:
+
+  struct Timer
+  {
+    clock_type::time_point when;
+    std::size_t order;
+    std::shared_ptr<StrandState> strand;
+    schedulable what;
+  };
+
+  struct TimerCompare
+  {
+    bool operator()(const Timer& a, const Timer& b) const
+    {
+      if (a.when == b.when)
+        return a.order > b.order;
+
+      return a.when > b.when;
+    }
+  };
+
+  using TimerQueue =
+    std::priority_queue<Timer, std::vector<Timer>, TimerCompare>;
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  using ReadyQueue = std::deque<std::shared_ptr<StrandState>>;
+  std::map<int, ReadyQueue, std::greater<int>> _ready;
+  TimerQueue _timers;
+  std::size_t _timer_count = 0;
+  bool _stopping = false;
+};
+
+//==============================================================================
+class StrandWorker : public rxcpp::schedulers::worker_interface
+{
+public:
+
+  using clock_type = rxcpp::schedulers::scheduler_base::clock_type;
+  using schedulable = rxcpp::schedulers::schedulable;
+
+  StrandWorker(std::shared_ptr<StrandState> strand)
+  : _strand(std::move(strand))
+  {
+    // Do nothing
+  }
+
+  clock_type::time_point now() const final
+  {
+    return clock_type::now();
+  }
+
+  void schedule(const schedulable& scbl) const final
+  {
+    if (const auto pool = _strand->pool().lock())
+      pool->schedule(_strand, scbl);
+  }
+
+  void schedule(
+    clock_type::time_point when,
+    const schedulable& scbl) const final
+  {
+    if (const auto pool = _strand->pool().lock())
+      pool->schedule(when, _strand, scbl);
+  }
+
+private:
+  std::shared_ptr<StrandState> _strand;
+};
+
+//==============================================================================
+class StrandScheduler : public rxcpp::schedulers::scheduler_interface
+{
+public:
+
+  using clock_type = rxcpp::schedulers::scheduler_base::clock_type;
+
+  StrandScheduler(std::weak_ptr<StrandPoolState> pool, int priority)
+  : _pool(std::move(pool)),
+    _priority(priority)
+  {
+    // Do nothing
+  }
+
+  clock_type::time_point now() const final
+  {
+    return clock_type::now();
+  }
+
+  rxcpp::schedulers::worker create_worker(
+    rxcpp::composite_subscription cs) const final
+  {
+    return rxcpp::schedulers::worker(
+      cs, std::make_shared<StrandWorker>(
+        std::make_shared<StrandState>(_pool, _priority)));
+  }
+
+private:
+  std::weak_ptr<StrandPoolState> _pool;
+  int _priority;
+};
+
+} // namespace detail
+} // namespace rmf_rxcpp
+
+#endif // RMF_RXCPP__DETAIL__STRANDPOOLDETAIL_HPP
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_utils/catch.hpp>
+
+#include <rmf_rxcpp/StrandPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("strands are serialized and ordered", "[StrandPool]")
+{
+  const auto pool = rmf_rxcpp::StrandPool::make(4);
+  const std::size_t NumStrands = 8;
+  const std::size_t NumActions = 200;
+
+  struct Record
+  {
+    std::atomic_int running{0};
+    std::atomic_bool overlapped{false};
+    std::vector<std::size_t> order;
+  };
+
+  std::vector<Record> records(NumStrands);
+  std::vector<std::promise<void>> finished(NumStrands);
+
+  for (std::size_t s = 0; s < NumStrands; ++s)
+  {
+    const auto strand = pool->strand(s);
+    for (std::size_t i = 0; i < NumActions; ++i)
+    {
+      strand.schedule(
+        [&record = records[s], &done = finished[s], i, NumActions](const auto&)
+        {
+          if (record.running.fetch_add(1) != 0)
+            record.overlapped = true;
+
+          record.order.push_back(i);
+          std::this_thread::sleep_for(10us);
+
+          record.running.fetch_sub(1);
+          if (i+1 == NumActions)
+            done.set_value();
+        });
+    }
+  }
+
+  for (auto& f : finished)
+    CHECK(f.get_future().wait_for(10s) == std::future_status::ready);
+
+  for (const auto& record : records)
+  {
+    CHECK_FALSE(record.overlapped);
+    REQUIRE(record.order.size() == NumActions);
+    for (std::size_t i = 0; i < NumActions; ++i)
+      CHECK(record.order[i] == i);
+  }
+}
+
+TEST_CASE("the same key gives the same strand", "[StrandPool]")
+{
+  const auto pool = rmf_rxcpp::StrandPool::make(2);
+  std::atomic_int running{0};
+  std::atomic_bool overlapped{false};
+  std::promise<void> done;
+  const std::size_t N = 50;
+  std::atomic_size_t count{0};
+
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    // Request the strand fresh each time to make sure the key is honored
+    pool->strand(42).schedule(
+      [&](const auto&)
+      {
+        if (running.fetch_add(1) != 0)
+          overlapped = true;
+
+        std::this_thread::sleep_for(100us);
+        running.fetch_sub(1);
+
+        if (++count == N)
+          done.set_value();
+      });
+  }
+
+  REQUIRE(done.get_future().wait_for(10s) == std::future_status::ready);
+  CHECK_FALSE(overlapped);
+}
+
+TEST_CASE("delayed actions run after their due time", "[StrandPool]")
+{
+  const auto pool = rmf_rxcpp::StrandPool::make(2);
+  const auto strand = pool->make_strand();
+
+  std::promise<std::chrono::steady_clock::time_point> ran;
+  const auto start = std::chrono::steady_clock::now();
+  strand.schedule(
+    strand.now() + 50ms,
+    [&ran](const auto&)
+    {
+      ran.set_value(std::chrono::steady_clock::now());
+    });
+
+  auto future = ran.get_future();
+  REQUIRE(future.wait_for(5s) == std::future_status::ready);
+  CHECK(future.get() - start >= 50ms);
+}
+
+TEST_CASE("higher priority strands are served first", "[StrandPool]")
+{
+  const auto pool = rmf_rxcpp::StrandPool::make(1);
+
+  // Occupy the only thread until every strand has been given its work
+  std::promise<void> release_promise;
+  auto release = release_promise.get_future().share();
+  std::promise<void> blocking_promise;
+  pool->make_strand(0).schedule(
+    [release, &blocking_promise](const auto&)
+    {
+      blocking_promise.set_value();
+      release.wait();
+    });
+  blocking_promise.get_future().wait();
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  const std::vector<int> priorities = {0, 3, 1, 2, 3, 0};
+  std::atomic_size_t remaining{priorities.size()};
+  std::vector<rxcpp::schedulers::worker> strands;
+  for (const int p : priorities)
+  {
+    strands.push_back(pool->make_strand(p));
+    strands.back().schedule(
+      [&, p](const auto&)
+      {
+        {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(p);
+        }
+
+        if (--remaining == 0)
+          done.set_value();
+      });
+  }
+
+  release_promise.set_value();
+  REQUIRE(done.get_future().wait_for(5s) == std::future_status::ready);
+  CHECK(order == std::vector<int>({3, 3, 2, 1, 0, 0}));
+}
+
+TEST_CASE("latency under load with 100 robots", "[StrandPool]")
+{
+  // Simulate one fleet adapter with 100 robots. A few of the robots are stuck
+  // in slow callbacks (such as handling a plan result), while every robot is
+  // receiving state updates. The updates of the robots that are not stuck must
+  // not be delayed by the slow ones.
+  const std::size_t NumRobots = 100;
+  const std::size_t NumSlowRobots = 3;
+  const std::size_t UpdatesPerRobot = 20;
+  const auto slow_duration = 500ms;
+
+  const auto pool = rmf_rxcpp::StrandPool::make(NumSlowRobots + 2);
+
+  std::vector<rxcpp::schedulers::worker> robots;
+  for (std::size_t r = 0; r < NumRobots; ++r)
+    robots.push_back(pool->strand(r));
+
+  for (std::size_t r = 0; r < NumSlowRobots; ++r)
+  {
+    robots[r].schedule(
+      [slow_duration](const auto&)
+      {
+        std::this_thread::sleep_for(slow_duration);
+      });
+  }
+
+  // Give the slow callbacks a moment to occupy their threads
+  std::this_thread::sleep_for(10ms);
+
+  using Clock = std::chrono::steady_clock;
+  std::mutex latency_mutex;
+  Clock::duration worst_latency = Clock::duration::zero();
+  std::atomic_size_t remaining{(NumRobots - NumSlowRobots) * UpdatesPerRobot};
+  std::promise<void> done;
+
+  const auto test_start = Clock::now();
+  for (std::size_t u = 0; u < UpdatesPerRobot; ++u)
+  {
+    for (std::size_t r = NumSlowRobots; r < NumRobots; ++r)
+    {
+      const auto sent = Clock::now();
+      robots[r].schedule(
+        [&, sent](const auto&)
+        {
+          // Pretend to do a small amount of work for this update
+          std::this_thread::sleep_for(20us);
+
+          const auto latency = Clock::now() - sent;
+          {
+            std::lock_guard<std::mutex> lock(latency_mutex);
+            worst_latency = std::max(worst_latency, latency);
+          }
+
+          if (--remaining == 0)
+            done.set_value();
+        });
+    }
+  }
+
+  REQUIRE(done.get_future().wait_for(10s) == std::future_status::ready);
+  const auto total_time = Clock::now() - test_start;
+
+  CAPTURE(std::chrono::duration_cast<std::chrono::milliseconds>(
+      worst_latency).count());
+  CAPTURE(std::chrono::duration_cast<std::chrono::milliseconds>(
+      total_time).count());
+
+  // If the fast robots had to wait behind the slow ones, every update would
+  // take at least as long as the slow callback.
+  CHECK(worst_latency < slow_duration/2);
+  CHECK(total_time < slow_duration);
+}
@@ -48,6 +48,12 @@ std::shared_ptr<FleetAdapterNode> FleetAdapterNode::make()
   node->_delay_threshold =
     get_parameter_or_default_time(*node, "delay_threshold", 5.0);
 
+  // This node responds to negotiations synchronously, so the tables of all
+  // the robots that it manages can be responded to in parallel. Setting this
+  // to 0 responds to them one at a time.
+  const auto negotiation_threads =
+    get_parameter_or_default(*node, "negotiation_threads", 4);
+
   auto mirror_future = rmf_traffic_ros2::schedule::make_mirror(
     *node, rmf_traffic::schedule::query_all());
 
@@ -70,6 +76,12 @@ std::shared_ptr<FleetAdapterNode> FleetAdapterNode::make()
       node->_negotiation = rmf_traffic_ros2::schedule::Negotiation(
         *node, node->_mirror->snapshot_handle());
 
+      if (negotiation_threads > 0)
+      {
+        node->_negotiation->parallel_responses(
+          static_cast<std::size_t>(negotiation_threads));
+      }
+
       return node;
     }
   }
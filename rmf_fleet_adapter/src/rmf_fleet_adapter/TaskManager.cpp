@@ -52,13 +52,20 @@ TaskManagerPtr TaskManager::make(agv::RobotContextPtr context)
       }
     });
 
+  // The timers fire on the executor thread, so they hand their work over to
+  // the worker of the robot, which might be a separate strand.
   mgr->_task_timer = mgr->context()->node()->create_wall_timer(
     std::chrono::seconds(1),
     [w = mgr->weak_from_this()]()
     {
       if (auto mgr = w.lock())
       {
-        mgr->_begin_next_task();
+        mgr->_context->worker().schedule(
+          [w](const auto&)
+          {
+            if (auto mgr = w.lock())
+              mgr->_begin_next_task();
+          });
       }
     });
 
@@ -68,7 +75,12 @@ TaskManagerPtr TaskManager::make(agv::RobotContextPtr context)
     {
       if (auto mgr = w.lock())
       {
-        mgr->retreat_to_charger();
+        mgr->_context->worker().schedule(
+          [w](const auto&)
+          {
+            if (auto mgr = w.lock())
+              mgr->retreat_to_charger();
+          });
       }
     });
   return mgr;
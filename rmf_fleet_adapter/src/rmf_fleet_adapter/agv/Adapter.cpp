@@ -29,6 +29,7 @@
 #include "internal_TrafficLight.hpp"
 #include "internal_EasyTrafficLight.hpp"
 
+#include "../jobs/PlanningScheduler.hpp"
 #include "../load_param.hpp"
 
 namespace rmf_fleet_adapter {
@@ -88,6 +89,9 @@ public:
   // This mutex protects the initialization of traffic lights
   std::mutex _traffic_light_init_mutex;
 
+  rclcpp::TimerBase::SharedPtr planning_metrics_timer;
+  jobs::PlanningScheduler::Metrics last_planning_metrics = {};
+
   Implementation(
       rxcpp::schedulers::worker worker_,
       std::shared_ptr<Node> node_,
@@ -101,7 +105,50 @@ public:
       blockade_writer{rmf_traffic_ros2::blockade::Writer::make(*node)},
       mirror_manager{std::move(mirror_manager_)}
   {
-    // Do nothing
+    // The planning metrics are logged periodically. A period of zero turns
+    // this off.
+    const auto metrics_period =
+        get_parameter_or_default_time(*node, "planning_metrics_period", 60.0);
+    if (metrics_period > rmf_traffic::Duration(0))
+    {
+      planning_metrics_timer = node->create_wall_timer(
+            metrics_period, [this]() { log_planning_metrics(); });
+    }
+  }
+
+  void log_planning_metrics()
+  {
+    // These are in the order of jobs::PlanningScheduler::Priority
+    static const std::array<const char*, jobs::PlanningScheduler::NumPriorities>
+        names = {"bid", "routine", "negotiation", "emergency"};
+
+    const auto to_ms = [](const rmf_traffic::Duration d)
+    {
+      return std::chrono::duration_cast<
+          std::chrono::duration<double, std::milli>>(d).count();
+    };
+
+    const auto metrics = jobs::PlanningScheduler::get()->metrics();
+    for (std::size_t i = 0; i < metrics.size(); ++i)
+    {
+      const auto& m = metrics[i];
+      const auto& last = last_planning_metrics[i];
+      const std::size_t slices = m.slices - last.slices;
+      if (slices == 0)
+        continue;
+
+      RCLCPP_INFO(
+        node->get_logger(),
+        "Planning metrics [%s]: %zu slices (%zu yielded), %zu jobs completed, "
+        "busy %.1f ms, mean wait %.1f ms, max wait so far %.1f ms",
+        names[i],
+        slices, m.yields - last.yields, m.completed - last.completed,
+        to_ms(m.busy_time - last.busy_time),
+        to_ms(m.wait_time - last.wait_time) / static_cast<double>(slices),
+        to_ms(m.max_wait_time));
+    }
+
+    last_planning_metrics = metrics;
   }
 
   static rmf_utils::unique_impl_ptr<Implementation> make(
@@ -121,6 +168,17 @@ public:
     const auto worker = rxcpp::schedulers::make_event_loop().create_worker();
     auto node = Node::make(worker, node_name, node_options);
 
+    // When worker_threads is greater than zero, each robot will get its own
+    // strand on a shared pool of that many threads instead of sharing the
+    // node's worker, so that one busy robot cannot delay all the others.
+    const auto worker_threads =
+        get_parameter_or_default(*node, "worker_threads", 0);
+    if (worker_threads > 0)
+    {
+      node->strands(rmf_rxcpp::StrandPool::make(
+          static_cast<std::size_t>(worker_threads)));
+    }
+
     if (!discovery_timeout)
     {
       discovery_timeout =
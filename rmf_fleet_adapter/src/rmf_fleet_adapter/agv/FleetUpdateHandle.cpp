@@ -36,6 +36,7 @@
 #include <rmf_task_msgs/msg/delivery.hpp> 
 #include <rmf_task_msgs/msg/loop.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -97,18 +98,10 @@ void FleetUpdateHandle::Implementation::dock_summary_cb(
 }
 
 //==============================================================================
-void FleetUpdateHandle::Implementation::bid_notice_cb(
-  const BidNotice::SharedPtr msg)
+bool FleetUpdateHandle::Implementation::ready_for_bidding() const
 {
   if (task_managers.empty())
-    return;
-
-  if (msg->task_profile.task_id.empty())
-    return;
-
-  if (bid_notice_assignments.find(msg->task_profile.task_id)
-      != bid_notice_assignments.end())
-    return;
+    return false;
 
   if (!accept_task)
   {
@@ -118,18 +111,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
       "FleetUpdateHadndle::accept_task_requests(~) to define a callback "
       "for accepting requests", name.c_str());
 
-    return;
-  }
-
-  if (!accept_task(msg->task_profile))
-  {
-    RCLCPP_INFO(
-      node->get_logger(),
-      "Fleet [%s] is configured to not accept task [%s]",
-      name.c_str(),
-      msg->task_profile.task_id.c_str());
-
-      return;
+    return false;
   }
 
   if (!task_planner
@@ -141,17 +123,41 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
       "Use FleetUpdateHandle::set_task_planner_params(~) to set the "
       "parameters required.", name.c_str());
 
-    return;
+    return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+rmf_task::ConstRequestPtr FleetUpdateHandle::Implementation::generate_request(
+  const TaskProfile& task_profile)
+{
+  if (task_profile.task_id.empty())
+    return nullptr;
+
+  if (bid_notice_assignments.find(task_profile.task_id)
+      != bid_notice_assignments.end())
+    return nullptr;
+
+  if (!accept_task(task_profile))
+  {
+    RCLCPP_INFO(
+      node->get_logger(),
+      "Fleet [%s] is configured to not accept task [%s]",
+      name.c_str(),
+      task_profile.task_id.c_str());
+
+      return nullptr;
   }
 
   // Determine task type and convert to request pointer
   rmf_task::ConstRequestPtr new_request = nullptr;
-  const auto& task_profile = msg->task_profile;
   const auto& task_type = task_profile.description.task_type;
   const rmf_traffic::Time start_time = 
     rmf_traffic_ros2::convert(task_profile.description.start_time);
   // TODO (YV) get rid of ID field in RequestPtr
-  std::string id = msg->task_profile.task_id;
+  std::string id = task_profile.task_id;
   const auto& graph = planner->get_configuration().graph();
 
   // Generate the priority of the request. The current implementation supports
@@ -171,7 +177,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [clean.start_waypoint] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     // Check for valid start waypoint
@@ -186,7 +192,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), start_wp_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     // Get dock parameters
@@ -198,7 +204,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Dock param for dock_name:[%s] unavailable. Rejecting BidNotice with "
         "task_id:[%s]", start_wp_name.c_str(), id.c_str());
 
-      return;
+      return nullptr;
     }
     const auto& clean_param = clean_param_it->second;
 
@@ -213,7 +219,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), finish_wp_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     // Interpolate docking waypoint into trajectory
@@ -233,7 +239,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Unable to generate cleaning trajectory from positions specified "
         " in DockSummary msg for [%s]", start_wp_name.c_str());
       
-      return;
+      return nullptr;
     }
 
     new_request = rmf_task::requests::Clean::make(
@@ -264,7 +270,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [delivery.pickup_place_name] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (delivery.pickup_dispenser.empty())
@@ -274,7 +280,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [delivery.pickup_dispenser] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (delivery.dropoff_place_name.empty())
@@ -284,7 +290,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [delivery.dropoff_place_name] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (delivery.dropoff_place_name.empty())
@@ -294,7 +300,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [delivery.dropoff_place_name] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (delivery.dropoff_ingestor.empty())
@@ -304,7 +310,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [delivery.dropoff_ingestor] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     const auto pickup_wp = graph.find_waypoint(delivery.pickup_place_name);
@@ -316,7 +322,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), delivery.pickup_place_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     const auto dropoff_wp = graph.find_waypoint(delivery.dropoff_place_name);
@@ -328,7 +334,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), delivery.dropoff_place_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     new_request = rmf_task::requests::Delivery::make(
@@ -360,7 +366,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [loop.start_name] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (loop.finish_name.empty())
@@ -370,7 +376,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [loop.finish_name] missing in TaskProfile."
         "Rejecting BidNotice with task_id:[%s]" , id.c_str());
 
-      return;
+      return nullptr;
     }
 
     if (loop.num_loops < 1)
@@ -380,7 +386,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "Required param [loop.num_loops: %d] in TaskProfile is invalid."
         "Rejecting BidNotice with task_id:[%s]" , loop.num_loops, id.c_str());
 
-      return;
+      return nullptr;
     }
 
     const auto start_wp = graph.find_waypoint(loop.start_name);
@@ -392,7 +398,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), loop.start_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     const auto finish_wp = graph.find_waypoint(loop.finish_name);
@@ -404,7 +410,7 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
         "nav graph. Rejecting BidNotice with task_id:[%s]",
         name.c_str(), loop.finish_name.c_str(), id.c_str());
 
-        return;
+        return nullptr;
     }
 
     new_request = rmf_task::requests::Loop::make(
@@ -431,20 +437,61 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
       "task_id:[%s]",
       task_type.type, id.c_str());
 
-    return;
+    return nullptr;
   }
-  
+
+  if (new_request)
+    generated_requests.insert({id, new_request});
+
+  return new_request;
+}
+
+//==============================================================================
+void FleetUpdateHandle::Implementation::bid_notice_cb(
+  const BidNotice::SharedPtr msg)
+{
+  // We always respond, even when we have nothing to offer, so that the
+  // dispatcher does not need to wait for the time window to run out.
+  if (!ready_for_bidding())
+    return submit_no_bid(msg->task_profile);
+
+  const auto new_request = generate_request(msg->task_profile);
   if (!new_request)
-    return;
-  generated_requests.insert({id, new_request});
+    return submit_no_bid(msg->task_profile);
+
+  plan_for_bid(
+    snapshot_allocation({new_request}),
+    [this, msg](std::optional<Assignments> allocation_result)
+    {
+      // The task may have been awarded to another fleet while we were still
+      // planning for it.
+      if (!generated_requests.count(msg->task_profile.task_id))
+        return;
 
-  const auto allocation_result = allocate_tasks(new_request);
+      if (!allocation_result.has_value())
+        return submit_no_bid(msg->task_profile);
 
-  if (!allocation_result.has_value())
-    return;
-  
-  const auto& assignments = allocation_result.value();
+      submit_bid_proposal(msg->task_profile, *allocation_result);
+    });
+}
 
+//==============================================================================
+void FleetUpdateHandle::Implementation::submit_no_bid(
+  const TaskProfile& task_profile)
+{
+  rmf_task_msgs::msg::BidProposal no_bid;
+  no_bid.fleet_name = name;
+  no_bid.task_profile = task_profile;
+  no_bid.no_bid = true;
+  bid_proposal_pub->publish(no_bid);
+}
+
+//==============================================================================
+void FleetUpdateHandle::Implementation::submit_bid_proposal(
+  const TaskProfile& task_profile,
+  const Assignments& assignments)
+{
+  const auto& id = task_profile.task_id;
   const double cost = task_planner->compute_cost(assignments);
 
   // Display computed assignments for debugging
@@ -514,12 +561,160 @@ void FleetUpdateHandle::Implementation::bid_notice_cb(
 
 }
 
+//==============================================================================
+void FleetUpdateHandle::Implementation::batch_bid_notice_cb(
+  const BatchBidNotice::SharedPtr msg)
+{
+  // We always respond to a batch, even when we have nothing to offer, so that
+  // the dispatcher does not need to wait for the time window to run out.
+  BatchBidProposal batch_proposal;
+  batch_proposal.fleet_name = name;
+  batch_proposal.batch_id = msg->batch_id;
+
+  std::vector<rmf_task::ConstRequestPtr> new_requests;
+  std::unordered_map<std::string, const TaskProfile*> task_profiles;
+  if (ready_for_bidding())
+  {
+    for (const auto& task_profile : msg->task_profiles)
+    {
+      if (task_profiles.count(task_profile.task_id))
+        continue;
+
+      auto new_request = generate_request(task_profile);
+      if (!new_request)
+        continue;
+
+      task_profiles.insert({task_profile.task_id, &task_profile});
+      new_requests.push_back(std::move(new_request));
+    }
+  }
+
+  if (new_requests.empty())
+  {
+    batch_bid_proposal_pub->publish(batch_proposal);
+    return;
+  }
+
+  // Plan for every task of the batch that we can accommodate at once
+  auto snapshot = snapshot_allocation(new_requests);
+  plan_for_bid(
+    std::move(snapshot),
+    [this, msg, batch_proposal, new_requests = std::move(new_requests),
+     task_profiles = std::move(task_profiles)](
+      std::optional<Assignments> allocation_result)
+    {
+      if (!allocation_result.has_value())
+        return batch_bid_proposal_pub->publish(batch_proposal);
+
+      submit_batch_bid_proposal(
+        *msg, new_requests, task_profiles, *allocation_result);
+    });
+}
+
+//==============================================================================
+void FleetUpdateHandle::Implementation::submit_batch_bid_proposal(
+  const BatchBidNotice& batch,
+  const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+  const std::unordered_map<std::string, const TaskProfile*>& task_profiles,
+  const Assignments& assignments)
+{
+  BatchBidProposal batch_proposal;
+  batch_proposal.fleet_name = name;
+  batch_proposal.batch_id = batch.batch_id;
+
+  const double cost = task_planner->compute_cost(assignments);
+
+  // Each task is charged for its own cost within the combined assignments,
+  // along with an equal share of the delays that the batch causes for the
+  // tasks which were already queued.
+  using Assignment = rmf_task::agv::TaskPlanner::Assignment;
+  const auto cost_of = [&](const Assignment& assignment)
+    {
+      return task_planner->compute_cost(Assignments{{assignment}});
+    };
+
+  std::unordered_map<std::string, std::pair<std::size_t, const Assignment*>>
+    batch_assignments;
+  double own_cost = 0.0;
+  for (std::size_t index = 0; index < assignments.size(); ++index)
+  {
+    for (const auto& assignment : assignments[index])
+    {
+      const auto& task_id = assignment.request()->id();
+      if (!task_profiles.count(task_id))
+        continue;
+
+      batch_assignments.insert({task_id, {index, &assignment}});
+      own_cost += cost_of(assignment);
+    }
+  }
+
+  const double knock_on_cost = batch_assignments.empty() ? 0.0 :
+    (cost - current_assignment_cost - own_cost) / batch_assignments.size();
+
+  std::vector<std::string> robot_names;
+  for (const auto& t : task_managers)
+    robot_names.push_back(t.first->name());
+
+  auto batch_tasks = std::make_shared<std::unordered_set<std::string>>();
+  for (const auto& new_request : new_requests)
+  {
+    const auto& id = new_request->id();
+    const auto batch_it = batch_assignments.find(id);
+    if (batch_it == batch_assignments.end())
+      continue;
+
+    // The task may have been awarded to another fleet while we were still
+    // planning for it.
+    if (!generated_requests.count(id))
+      continue;
+
+    const std::size_t robot = batch_it->second.first;
+    const auto& assignment = *batch_it->second.second;
+
+    rmf_task_msgs::msg::BidProposal bid_proposal;
+    bid_proposal.fleet_name = name;
+    bid_proposal.task_profile = *task_profiles.at(id);
+    bid_proposal.prev_cost = current_assignment_cost;
+    bid_proposal.new_cost =
+      current_assignment_cost + cost_of(assignment) + knock_on_cost;
+    bid_proposal.finish_time =
+      rmf_traffic_ros2::convert(assignment.state().finish_time());
+    if (robot < robot_names.size())
+      bid_proposal.robot_name = robot_names[robot];
+
+    batch_proposal.proposals.push_back(std::move(bid_proposal));
+    batch_tasks->insert(id);
+  }
+
+  for (const auto& id : *batch_tasks)
+  {
+    bid_notice_assignments.insert({id, assignments});
+    bid_batches.insert({id, batch_tasks});
+  }
+
+  batch_bid_proposal_pub->publish(batch_proposal);
+  RCLCPP_INFO(
+    node->get_logger(),
+    "Submitted BidProposals for [%zu] of the [%zu] tasks in batch [%s] with new "
+    "cost [%f]",
+    batch_proposal.proposals.size(), batch.task_profiles.size(),
+    batch.batch_id.c_str(), cost);
+}
+
 //==============================================================================
 void FleetUpdateHandle::Implementation::dispatch_request_cb(
   const DispatchRequest::SharedPtr msg)
 {
   if (msg->fleet_name != name)
+  {
+    // The task was awarded to another fleet, so we have no more use for what
+    // we prepared when we bid for it.
+    if (msg->method == DispatchRequest::ADD)
+      forget_bid(msg->task_profile.task_id);
+
     return;
+  }
 
   const std::string id = msg->task_profile.task_id;
   DispatchAck dispatch_ack;
@@ -545,6 +740,25 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
       id.c_str(), name.c_str());
 
     auto& assignments = task_it->second;
+
+    // The assignments of a batch were planned as if this fleet would win every
+    // task that it bid for in the batch. If any other task of the batch has not
+    // been awarded to this fleet, then the deployment times and predicted
+    // states of these assignments are wrong, so we need to plan again for the
+    // tasks that we actually hold.
+    bool batch_assignments_hold = true;
+    const auto batch_it = bid_batches.find(id);
+    if (batch_it != bid_batches.end())
+    {
+      for (const auto& other_id : *batch_it->second)
+      {
+        if (other_id != id && !assigned_requests.count(other_id))
+        {
+          batch_assignments_hold = false;
+          break;
+        }
+      }
+    }
     
     if (assignments.size() != task_managers.size())
     {
@@ -571,7 +785,8 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
       return;
     }
 
-    bool valid_assignments = is_valid_assignments(assignments);
+    bool valid_assignments =
+      batch_assignments_hold && is_valid_assignments(assignments);
     if (!valid_assignments)
     {
       // TODO: This replanning is blocking the main thread. Instead, the
@@ -589,20 +804,31 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
         return;
       }
       assignments = replan_results.value();
-      // We do not need to re-check if assignments are valid as this function
-      // is being called by the ROS2 executor and is running on the main
-      // rxcpp worker. Hence, no new tasks would have started during this replanning.
-    }
 
-    std::size_t index = 0;
-    for (auto& t : task_managers)
-    {
-      t.second->set_queue(assignments[index]);
-      ++index;
+      // In multi-threaded mode the robots keep running on their own strands
+      // while we replan, so a task might have begun in the meantime.
+      if (node->strands() && !is_valid_assignments(assignments))
+      {
+        RCLCPP_WARN(
+          node->get_logger(),
+          "A task began while replanning assignments to accommodate "
+          "task_id:[%s]. This request will be ignored.",
+          id.c_str());
+        dispatch_ack_pub->publish(dispatch_ack);
+        return;
+      }
     }
 
+    for_each_robot(
+      [&assignments](std::size_t index, TaskManager& mgr)
+      {
+        mgr.set_queue(assignments[index]);
+      });
+
     current_assignment_cost = task_planner->compute_cost(assignments);
+    current_assignments = assignments;
     assigned_requests.insert({id, request_it->second});
+    forget_bid(id);
     dispatch_ack.success = true;
     dispatch_ack_pub->publish(dispatch_ack);
   
@@ -646,11 +872,8 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
     }
 
     std::unordered_set<std::string> executed_tasks;
-    for (const auto& [context, mgr] : task_managers)
-    {
-      const auto& tasks = mgr->get_executed_tasks();
+    for (const auto& tasks : collect_executed_tasks())
       executed_tasks.insert(tasks.begin(), tasks.end());
-    }
 
     // Check if received request is to cancel an active task
     if (executed_tasks.find(id) != executed_tasks.end())
@@ -681,14 +904,14 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
     }
 
     const auto& assignments = replan_results.value();
-    std::size_t index = 0;
-    for (auto& t : task_managers)
-    {
-      t.second->set_queue(assignments[index]);
-      ++index;
-    }
+    for_each_robot(
+      [&assignments](std::size_t index, TaskManager& mgr)
+      {
+        mgr.set_queue(assignments[index]);
+      });
 
     current_assignment_cost = task_planner->compute_cost(assignments);
+    current_assignments = assignments;
 
     dispatch_ack.success = true;
     dispatch_ack_pub->publish(dispatch_ack);
@@ -713,16 +936,56 @@ void FleetUpdateHandle::Implementation::dispatch_request_cb(
 
 }
 
+//==============================================================================
+void FleetUpdateHandle::Implementation::forget_bid(const std::string& task_id)
+{
+  bid_notice_assignments.erase(task_id);
+  bid_batches.erase(task_id);
+  generated_requests.erase(task_id);
+}
+
+//==============================================================================
+void FleetUpdateHandle::Implementation::plan_for_bid(
+  AllocationSnapshot snapshot,
+  std::function<void(std::optional<Assignments>)> on_done) const
+{
+  using Priority = jobs::PlanningScheduler::Priority;
+  const auto& scheduler = jobs::PlanningScheduler::get();
+  const auto scheduled_time = std::chrono::steady_clock::now();
+
+  scheduler->make_worker(Priority::Bid).schedule(
+    [this, w = weak_self, scheduler, scheduled_time,
+     snapshot = std::move(snapshot), on_done = std::move(on_done)](
+      const auto&)
+    {
+      const auto self = w.lock();
+      if (!self)
+        return;
+
+      const auto start_time = std::chrono::steady_clock::now();
+      auto result = solve_allocation(snapshot);
+      scheduler->record(
+        Priority::Bid, start_time - scheduled_time,
+        std::chrono::steady_clock::now() - start_time, false, true);
+
+      // Everything else that the fleet does happens on its worker, so the
+      // result gets delivered there.
+      worker.schedule(
+        [w, on_done, result = std::move(result)](const auto&)
+        {
+          if (const auto self = w.lock())
+            on_done(std::move(result));
+        });
+    });
+}
+
 //==============================================================================
 auto FleetUpdateHandle::Implementation::is_valid_assignments(
   Assignments& assignments) const -> bool
 {
   std::unordered_set<std::string> executed_tasks;
-  for (const auto& [context, mgr] : task_managers)
-  {
-    const auto& tasks = mgr->get_executed_tasks();
+  for (const auto& tasks : collect_executed_tasks())
     executed_tasks.insert(tasks.begin(), tasks.end());
-  }
 
   for (const auto& agent : assignments)
   {
@@ -845,9 +1108,8 @@ rmf_fleet_msgs::msg::RobotState convert_state(const TaskManager& mgr)
 //==============================================================================
 void FleetUpdateHandle::Implementation::publish_fleet_state() const
 {
-  std::vector<rmf_fleet_msgs::msg::RobotState> robot_states;
-  for (const auto& [context, mgr] : task_managers)
-    robot_states.emplace_back(convert_state(*mgr));
+  auto robot_states = collect_from_robots(
+    [](const TaskManager& mgr) { return convert_state(mgr); });
 
   auto fleet_state = rmf_fleet_msgs::build<rmf_fleet_msgs::msg::FleetState>()
       .name(name)
@@ -861,28 +1123,96 @@ auto FleetUpdateHandle::Implementation::allocate_tasks(
   rmf_task::ConstRequestPtr new_request,
   rmf_task::ConstRequestPtr ignore_request) const -> std::optional<Assignments>
 {
-  // Collate robot states, constraints and combine new requestptr with 
-  // requestptr of non-charging tasks in task manager queues
-  std::vector<rmf_task::agv::State> states;
-  std::vector<rmf_task::agv::Constraints> constraints_set;
-  std::vector<rmf_task::ConstRequestPtr> pending_requests;
-  std::string id = "";
-
+  std::vector<rmf_task::ConstRequestPtr> new_requests;
   if (new_request)
+    new_requests.push_back(std::move(new_request));
+
+  return allocate_tasks(new_requests, std::move(ignore_request));
+}
+
+//==============================================================================
+auto FleetUpdateHandle::Implementation::allocate_tasks(
+  const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+  rmf_task::ConstRequestPtr ignore_request) const -> std::optional<Assignments>
+{
+  return solve_allocation(
+    snapshot_allocation(new_requests, std::move(ignore_request)));
+}
+
+//==============================================================================
+auto FleetUpdateHandle::Implementation::snapshot_allocation(
+  const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+  rmf_task::ConstRequestPtr ignore_request) const -> AllocationSnapshot
+{
+  // Collate robot states, constraints and combine new requestptrs with
+  // requestptr of non-charging tasks in task manager queues
+  AllocationSnapshot snapshot;
+  snapshot.time = rmf_traffic_ros2::convert(node->now());
+  snapshot.task_planner = task_planner;
+  snapshot.new_requests = new_requests;
+  auto& pending_requests = snapshot.pending_requests;
+  auto& id = snapshot.id;
+
+  // The assignments that were last handed to the task managers are used as a
+  // warm start, as long as every request that is still queued can be found in
+  // them.
+  Assignments warm_start;
+  bool use_warm_start = !new_requests.empty() && !ignore_request
+    && current_assignments.size() == task_managers.size();
+
+  for (const auto& new_request : new_requests)
   {
     pending_requests.push_back(new_request);
-    id = new_request->id();
+    if (!id.empty())
+      id += ", ";
+    id += new_request->id();
   }
 
-  for (const auto& t : task_managers)
+  struct RobotSnapshot
+  {
+    rmf_task::agv::State state;
+    rmf_task::agv::Constraints constraints;
+    std::vector<rmf_task::ConstRequestPtr> requests;
+  };
+
+  const auto robots = collect_from_robots(
+    [](const TaskManager& mgr)
+    {
+      return RobotSnapshot{
+        mgr.expected_finish_state(),
+        mgr.context()->task_planning_constraints(),
+        mgr.requests()
+      };
+    });
+
+  for (const auto& robot : robots)
   {
-    states.push_back(t.second->expected_finish_state());
-    constraints_set.push_back(t.first->task_planning_constraints());
-    const auto requests = t.second->requests();
+    snapshot.states.push_back(robot.state);
+    snapshot.constraints_set.push_back(robot.constraints);
+    const auto& requests = robot.requests;
     pending_requests.insert(
       pending_requests.end(), requests.begin(), requests.end());
+
+    if (use_warm_start)
+    {
+      std::unordered_set<std::string> queued_ids;
+      for (const auto& r : requests)
+        queued_ids.insert(r->id());
+
+      auto& agent = warm_start.emplace_back();
+      for (const auto& a : current_assignments[warm_start.size()-1])
+      {
+        if (queued_ids.count(a.request()->id()))
+          agent.push_back(a);
+      }
+
+      use_warm_start = agent.size() == requests.size();
+    }
   }
 
+  if (use_warm_start)
+    snapshot.warm_start = std::move(warm_start);
+
   // Remove the request to be ignored if present
   if (ignore_request)
   {
@@ -910,18 +1240,34 @@ auto FleetUpdateHandle::Implementation::allocate_tasks(
     }
   }
 
+  return snapshot;
+}
+
+//==============================================================================
+auto FleetUpdateHandle::Implementation::solve_allocation(
+  const AllocationSnapshot& snapshot) const -> std::optional<Assignments>
+{
+  const auto& id = snapshot.id;
+
   RCLCPP_INFO(
     node->get_logger(), 
-    "Planning for [%d] robot(s) and [%d] request(s)", 
-    states.size(), pending_requests.size());
+    "Planning for [%zu] robot(s) and [%zu] request(s)", 
+    snapshot.states.size(), snapshot.pending_requests.size());
 
   // Generate new task assignments
-  const auto result = task_planner->optimal_plan(
-    rmf_traffic_ros2::convert(node->now()),
-    states,
-    constraints_set,
-    pending_requests,
-    nullptr);
+  const auto result = snapshot.warm_start.has_value() ?
+    snapshot.task_planner->incremental_plan(
+      snapshot.time,
+      snapshot.states,
+      snapshot.constraints_set,
+      *snapshot.warm_start,
+      snapshot.new_requests) :
+    snapshot.task_planner->optimal_plan(
+      snapshot.time,
+      snapshot.states,
+      snapshot.constraints_set,
+      snapshot.pending_requests,
+      nullptr);
 
   auto assignments_ptr = std::get_if<
     rmf_task::agv::TaskPlanner::Assignments>(&result);
@@ -1006,6 +1352,9 @@ void FleetUpdateHandle::add_robot(
       start[0], charger_wp, 1.0};
     rmf_task::agv::Constraints task_planning_constraints =
       rmf_task::agv::Constraints{fleet->_pimpl->recharge_threshold};
+    // In multi-threaded mode this gives the robot its own strand. Otherwise it
+    // is the same worker that the fleet uses.
+    const auto robot_worker = fleet->_pimpl->node->strand(participant.id());
     auto context = std::make_shared<RobotContext>(
           RobotContext{
             std::move(command),
@@ -1014,13 +1363,22 @@ void FleetUpdateHandle::add_robot(
             fleet->_pimpl->snappable,
             fleet->_pimpl->planner,
             fleet->_pimpl->node,
-            fleet->_pimpl->worker,
+            robot_worker,
             fleet->_pimpl->default_maximum_delay,
             state,
             task_planning_constraints,
             fleet->_pimpl->task_planner
           });
 
+    context->_strand_license = std::shared_ptr<void>(
+          nullptr,
+          [w_node = std::weak_ptr<Node>(fleet->_pimpl->node),
+           id = context->itinerary().id()](void*)
+    {
+      if (const auto node = w_node.lock())
+        node->release_strand(id);
+    });
+
     // We schedule the following operations on the worker to make sure we do not
     // have a multiple read/write race condition on the FleetUpdateHandle.
     worker.schedule(
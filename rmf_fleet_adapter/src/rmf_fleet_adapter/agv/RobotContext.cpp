@@ -20,6 +20,7 @@
 #include <rmf_traffic_ros2/Time.hpp>
 
 #include <rmf_traffic/schedule/StubbornNegotiator.hpp>
+#include <rmf_traffic/DetectConflict.hpp>
 
 namespace rmf_fleet_adapter {
 namespace agv {
@@ -282,6 +283,178 @@ rmf_traffic::Duration RobotContext::get_lift_rewait_duration() const
   return _lift_rewait_duration;
 }
 
+//==============================================================================
+void RobotContext::post_position(RobotStateMailbox::Position position)
+{
+  if (!_state_mailbox.post(std::move(position)))
+    return;
+
+  _worker.schedule(
+    [self = shared_from_this()](const auto&)
+  {
+    self->_apply_posted_state();
+  });
+}
+
+//==============================================================================
+void RobotContext::post_battery_soc(const double battery_soc)
+{
+  if (!_state_mailbox.post_battery_soc(battery_soc))
+    return;
+
+  _worker.schedule(
+    [self = shared_from_this()](const auto&)
+  {
+    self->_apply_posted_state();
+  });
+}
+
+//==============================================================================
+RobotStateMailbox::Stats RobotContext::update_stats() const
+{
+  return _state_mailbox.stats();
+}
+
+//==============================================================================
+void RobotContext::report_delay(const rmf_traffic::Duration delay)
+{
+  if (_itinerary.version() != _unpublished_delay_version)
+  {
+    // The itinerary has changed since the last report, so the delay that was
+    // held back does not apply to it anymore.
+    _unpublished_delay = std::chrono::seconds(0);
+    _conflict_checked_delay = std::chrono::seconds(0);
+    _unpublished_delay_version = _itinerary.version();
+  }
+
+  _unpublished_delay += delay;
+  if (_unpublished_delay.count() == 0)
+    return;
+
+  bool publish =
+    std::abs(_unpublished_delay.count()) >= _delay_threshold.count();
+
+  // Looking for conflicts means taking a snapshot of the schedule, so we only
+  // look again once the delay has moved by a tenth of the threshold.
+  const auto since_check = _unpublished_delay - _conflict_checked_delay;
+  if (!publish
+    && std::abs(since_check.count()) * 10 >= _delay_threshold.count())
+  {
+    _conflict_checked_delay = _unpublished_delay;
+    publish = _unpublished_delay_conflicts();
+  }
+
+  if (!publish)
+    return;
+
+  _itinerary.delay(_unpublished_delay);
+  _unpublished_delay = std::chrono::seconds(0);
+  _conflict_checked_delay = std::chrono::seconds(0);
+  _unpublished_delay_version = _itinerary.version();
+}
+
+//==============================================================================
+rmf_traffic::Duration RobotContext::cumulative_delay() const
+{
+  if (_itinerary.version() != _unpublished_delay_version)
+    return _itinerary.delay();
+
+  return _itinerary.delay() + _unpublished_delay;
+}
+
+//==============================================================================
+rmf_traffic::Duration RobotContext::delay_threshold() const
+{
+  return _delay_threshold;
+}
+
+//==============================================================================
+RobotContext& RobotContext::delay_threshold(
+  const rmf_traffic::Duration threshold)
+{
+  _delay_threshold = threshold;
+  return *this;
+}
+
+//==============================================================================
+bool RobotContext::_unpublished_delay_conflicts() const
+{
+  const auto snapshot = _schedule->snapshot();
+  const auto& profile = _itinerary.description().profile();
+  for (const auto& item : _itinerary.itinerary())
+  {
+    if (item.route->trajectory().size() < 2)
+      continue;
+
+    auto trajectory = item.route->trajectory();
+    trajectory.front().adjust_times(_unpublished_delay);
+    const auto start_time = *trajectory.start_time();
+    const auto finish_time = *trajectory.finish_time();
+
+    const auto view = snapshot->query(
+      rmf_traffic::schedule::make_query(
+        {item.route->map()}, &start_time, &finish_time));
+
+    for (const auto& other : view)
+    {
+      if (other.participant == _itinerary.id())
+        continue;
+
+      if (other.route.trajectory().size() < 2)
+        continue;
+
+      if (rmf_traffic::DetectConflict::between(
+            profile, trajectory,
+            other.description.profile(), other.route.trajectory()))
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+//==============================================================================
+void RobotContext::_apply_posted_state()
+{
+  auto contents = _state_mailbox.take();
+  if (contents.position)
+  {
+    auto& position = *contents.position;
+    if (position.merge)
+    {
+      const auto& merge = *position.merge;
+      auto starts = rmf_traffic::agv::compute_plan_starts(
+            navigation_graph(), merge.map_name, merge.position, position.time,
+            merge.max_merge_waypoint_distance, merge.max_merge_lane_distance,
+            merge.min_lane_length);
+
+      if (starts.empty())
+      {
+        RCLCPP_ERROR(
+              _node->get_logger(),
+              "[RobotUpdateHandle::update_position] The robot [%s] has "
+              "diverged from its navigation graph, currently located at "
+              "<%f, %f, %f> on map [%s]", requester_id().c_str(),
+              merge.position[0], merge.position[1], merge.position[2],
+              merge.map_name.c_str());
+      }
+      else
+      {
+        _location = std::move(starts);
+      }
+    }
+    else
+    {
+      _location = std::move(position.starts);
+    }
+  }
+
+  if (contents.battery_soc)
+    current_battery_soc(*contents.battery_soc);
+}
+
 //==============================================================================
 void RobotContext::respond(
     const TableViewerPtr& table_viewer,
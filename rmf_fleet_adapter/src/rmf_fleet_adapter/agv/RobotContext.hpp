@@ -21,6 +21,7 @@
 #include <rxcpp/rx-observable.hpp>
 
 #include "Node.hpp"
+#include "RobotStateMailbox.hpp"
 
 namespace rmf_fleet_adapter {
 namespace agv {
@@ -147,6 +148,34 @@ public:
 
   rmf_traffic::Duration get_lift_rewait_duration() const;
 
+  /// Post a new position for this robot. It will be applied by the worker,
+  /// unless a newer position gets posted before the worker is free.
+  void post_position(RobotStateMailbox::Position position);
+
+  /// Post a new battery state of charge for this robot. It will be applied by
+  /// the worker, unless a newer one gets posted before the worker is free.
+  void post_battery_soc(double battery_soc);
+
+  /// Get the stats of the positions and battery states that have been posted
+  RobotStateMailbox::Stats update_stats() const;
+
+  /// Report that the robot has fallen behind its itinerary by this much more
+  /// than cumulative_delay(). Small delays are held back until they add up to
+  /// the delay threshold, or until holding them back would hide a conflict
+  /// from the other participants of the schedule. This must only be called by
+  /// the worker.
+  void report_delay(rmf_traffic::Duration delay);
+
+  /// The delay of the itinerary, including any delay that has been reported
+  /// but not published to the schedule yet.
+  rmf_traffic::Duration cumulative_delay() const;
+
+  /// Get the delay that needs to build up before it gets published
+  rmf_traffic::Duration delay_threshold() const;
+
+  /// Set the delay that needs to build up before it gets published
+  RobotContext& delay_threshold(rmf_traffic::Duration threshold);
+
 private:
   friend class FleetUpdateHandle;
   friend class RobotUpdateHandle;
@@ -173,6 +202,9 @@ private:
 
   std::shared_ptr<void> _negotiation_license;
 
+  /// Releases the strand of this robot when the robot is destroyed
+  std::shared_ptr<void> _strand_license;
+
   rxcpp::subjects::subject<Empty> _interrupt_publisher;
   rxcpp::observable<Empty> _interrupt_obs;
 
@@ -193,6 +225,26 @@ private:
 
   RobotUpdateHandle::Unstable::Watchdog _lift_watchdog;
   rmf_traffic::Duration _lift_rewait_duration = std::chrono::seconds(0);
+
+  /// Apply the newest contents of _state_mailbox. This must only be called by
+  /// the worker.
+  void _apply_posted_state();
+
+  RobotStateMailbox _state_mailbox;
+
+  /// Check whether the robot would conflict with another participant if its
+  /// itinerary were delayed by _unpublished_delay.
+  bool _unpublished_delay_conflicts() const;
+
+  rmf_traffic::Duration _delay_threshold = std::chrono::seconds(2);
+
+  /// The delay that has been reported but not published yet. It only applies
+  /// to the itinerary version that it was reported for.
+  rmf_traffic::Duration _unpublished_delay = std::chrono::seconds(0);
+  rmf_traffic::schedule::ItineraryVersion _unpublished_delay_version = 0;
+
+  /// The value of _unpublished_delay when we last checked it for conflicts
+  rmf_traffic::Duration _conflict_checked_delay = std::chrono::seconds(0);
 };
 
 using RobotContextPtr = std::shared_ptr<RobotContext>;
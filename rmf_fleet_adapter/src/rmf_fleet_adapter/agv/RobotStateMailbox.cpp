@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "RobotStateMailbox.hpp"
+
+namespace rmf_fleet_adapter {
+namespace agv {
+
+//==============================================================================
+bool RobotStateMailbox::post(Position position)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  const bool replaced = _position.has_value();
+  _position = std::move(position);
+  return _received(replaced);
+}
+
+//==============================================================================
+bool RobotStateMailbox::post_battery_soc(const double battery_soc)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  const bool replaced = _battery_soc.has_value();
+  _battery_soc = battery_soc;
+  return _received(replaced);
+}
+
+//==============================================================================
+auto RobotStateMailbox::take() -> Contents
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  Contents contents{std::move(_position), std::move(_battery_soc)};
+  _position = rmf_utils::nullopt;
+  _battery_soc = rmf_utils::nullopt;
+  _job_scheduled = false;
+
+  if (contents.position)
+    ++_stats.applied;
+
+  if (contents.battery_soc)
+    ++_stats.applied;
+
+  return contents;
+}
+
+//==============================================================================
+auto RobotStateMailbox::stats() const -> Stats
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _stats;
+}
+
+//==============================================================================
+bool RobotStateMailbox::_received(const bool replaced)
+{
+  ++_stats.received;
+  if (replaced)
+    ++_stats.dropped;
+
+  if (_job_scheduled)
+  {
+    ++_stats.coalesced;
+    return false;
+  }
+
+  _job_scheduled = true;
+  return true;
+}
+
+} // namespace agv
+} // namespace rmf_fleet_adapter
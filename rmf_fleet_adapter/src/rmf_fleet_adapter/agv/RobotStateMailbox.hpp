@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_FLEET_ADAPTER__AGV__ROBOTSTATEMAILBOX_HPP
+#define SRC__RMF_FLEET_ADAPTER__AGV__ROBOTSTATEMAILBOX_HPP
+
+#include <rmf_fleet_adapter/agv/RobotUpdateHandle.hpp>
+
+#include <rmf_traffic/agv/Planner.hpp>
+
+#include <mutex>
+
+namespace rmf_fleet_adapter {
+namespace agv {
+
+//==============================================================================
+/// Collects the position and battery updates of a robot until its worker is
+/// free to apply them. Only the newest update of each kind is kept, so a robot
+/// that reports its state faster than its worker can keep up will not build
+/// up a backlog of stale updates.
+///
+/// This class is thread-safe.
+class RobotStateMailbox
+{
+public:
+
+  using Stats = RobotUpdateHandle::Unstable::UpdateStats;
+  using StartSet = rmf_traffic::agv::Plan::StartSet;
+
+  /// A position given as a location on a map, which still needs to be merged
+  /// onto the navigation graph with rmf_traffic::agv::compute_plan_starts().
+  struct Merge
+  {
+    std::string map_name;
+    Eigen::Vector3d position;
+    double max_merge_waypoint_distance;
+    double max_merge_lane_distance;
+    double min_lane_length;
+  };
+
+  struct Position
+  {
+    /// The time that the robot was at this position
+    rmf_traffic::Time time;
+
+    /// The plan starts for this position. These are only used when there is no
+    /// merge.
+    StartSet starts;
+
+    /// If this has a value, then the plan starts need to be computed from it.
+    /// We leave that for the worker so that it is only done for the positions
+    /// that actually get applied.
+    rmf_utils::optional<Merge> merge;
+  };
+
+  /// Post a new position. This replaces any position that is still waiting.
+  ///
+  /// \return true if the caller needs to schedule a job on the worker that will
+  /// take() the contents of the mailbox, or false if one is already scheduled.
+  bool post(Position position);
+
+  /// Post a new battery state of charge. This replaces any battery state of
+  /// charge that is still waiting.
+  ///
+  /// \return true if the caller needs to schedule a job on the worker that will
+  /// take() the contents of the mailbox, or false if one is already scheduled.
+  bool post_battery_soc(double battery_soc);
+
+  struct Contents
+  {
+    rmf_utils::optional<Position> position;
+    rmf_utils::optional<double> battery_soc;
+  };
+
+  /// Take the newest updates out of the mailbox. This should only be called by
+  /// the job that was scheduled when a post function returned true. Posts that
+  /// arrive after this call will ask for a new job to be scheduled.
+  Contents take();
+
+  /// Get the current stats of this mailbox
+  Stats stats() const;
+
+private:
+
+  /// Count a post, and decide whether a job needs to be scheduled for it.
+  /// This must be called while _mutex is locked.
+  bool _received(bool replaced);
+
+  mutable std::mutex _mutex;
+  rmf_utils::optional<Position> _position;
+  rmf_utils::optional<double> _battery_soc;
+  bool _job_scheduled = false;
+  Stats _stats;
+};
+
+} // namespace agv
+} // namespace rmf_fleet_adapter
+
+#endif // SRC__RMF_FLEET_ADAPTER__AGV__ROBOTSTATEMAILBOX_HPP
@@ -62,15 +62,13 @@ void RobotUpdateHandle::update_position(
 {
   if (const auto context = _pimpl->get_context())
   {
-    context->worker().schedule(
-          [context, waypoint, orientation](const auto&)
-    {
-      context->_location = {
-        rmf_traffic::agv::Plan::Start(
-          rmf_traffic_ros2::convert(context->node()->now()),
-          waypoint, orientation)
-      };
-    });
+    const auto now = rmf_traffic_ros2::convert(context->node()->now());
+    context->post_position(
+      {
+        now,
+        {rmf_traffic::agv::Plan::Start(now, waypoint, orientation)},
+        rmf_utils::nullopt
+      });
   }
 }
 
@@ -100,11 +98,7 @@ void RobotUpdateHandle::update_position(
         });
     }
 
-    context->worker().schedule(
-          [context, starts = std::move(starts)](const auto&)
-    {
-      context->_location = std::move(starts);
-    });
+    context->post_position({now, std::move(starts), rmf_utils::nullopt});
   }
 }
 
@@ -115,15 +109,17 @@ void RobotUpdateHandle::update_position(
 {
   if (const auto& context = _pimpl->get_context())
   {
-    context->worker().schedule(
-          [context, position, waypoint](const auto&)
-    {
-      context->_location = {
-        rmf_traffic::agv::Plan::Start(
-          rmf_traffic_ros2::convert(context->node()->now()),
-          waypoint, position[2], Eigen::Vector2d(position.block<2,1>(0,0)))
-      };
-    });
+    const auto now = rmf_traffic_ros2::convert(context->node()->now());
+    context->post_position(
+      {
+        now,
+        {
+          rmf_traffic::agv::Plan::Start(
+            now, waypoint, position[2],
+            Eigen::Vector2d(position.block<2,1>(0,0)))
+        },
+        rmf_utils::nullopt
+      });
   }
 }
 
@@ -137,28 +133,20 @@ void RobotUpdateHandle::update_position(
 {
   if (const auto context = _pimpl->get_context())
   {
-    const auto now = rmf_traffic_ros2::convert(context->node()->now());
-    auto starts = rmf_traffic::agv::compute_plan_starts(
-          context->navigation_graph(), map_name, position, now,
-          max_merge_waypoint_distance, max_merge_lane_distance,
-          min_lane_length);
-
-    if (starts.empty())
-    {
-      RCLCPP_ERROR(
-            context->node()->get_logger(),
-            "[RobotUpdateHandle::update_position] The robot [%s] has diverged "
-            "from its navigation graph, currently located at <%f, %f, %f> on "
-            "map [%s]", context->requester_id().c_str(),
-            position[0], position[1], position[2], map_name.c_str());
-      return;
-    }
-
-    context->worker().schedule(
-          [context, starts = std::move(starts)](const auto&)
-    {
-      context->_location = std::move(starts);
-    });
+    // The plan starts are computed by the worker, so that we only merge the
+    // positions that actually get applied.
+    context->post_position(
+      {
+        rmf_traffic_ros2::convert(context->node()->now()),
+        {},
+        RobotStateMailbox::Merge{
+          map_name,
+          position,
+          max_merge_waypoint_distance,
+          max_merge_lane_distance,
+          min_lane_length
+        }
+      });
   }
 }
 
@@ -187,13 +175,7 @@ void RobotUpdateHandle::update_battery_soc(const double battery_soc)
     return;
 
   if (const auto context = _pimpl->get_context())
-  {
-    context->worker().schedule(
-          [context, battery_soc](const auto&)
-    {
-      context->current_battery_soc(battery_soc);
-    });
-  }
+    context->post_battery_soc(battery_soc);
 }
 
 //==============================================================================
@@ -267,5 +249,28 @@ void RobotUpdateHandle::Unstable::set_lift_entry_watchdog(
   }
 }
 
+//==============================================================================
+auto RobotUpdateHandle::Unstable::update_stats() const -> UpdateStats
+{
+  if (const auto context = _pimpl->get_context())
+    return context->update_stats();
+
+  return UpdateStats();
+}
+
+//==============================================================================
+void RobotUpdateHandle::Unstable::set_delay_threshold(
+  const rmf_traffic::Duration threshold)
+{
+  if (const auto context = _pimpl->get_context())
+  {
+    context->worker().schedule(
+      [context, threshold](const auto&)
+    {
+      context->delay_threshold(threshold);
+    });
+  }
+}
+
 } // namespace agv
 } // namespace rmf_fleet_adapter
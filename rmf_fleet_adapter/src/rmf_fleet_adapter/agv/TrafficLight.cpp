@@ -376,7 +376,7 @@ void TrafficLight::UpdateHandle::Implementation::Data::plan_timing(
     std::move(goal), schedule->snapshot(), itinerary.id(), profile);
 
   find_path_subscription = rmf_rxcpp::make_job<services::FindPath::Result>(
-        find_path_service)
+        find_path_service, find_path_service->scheduler())
       .observe_on(rxcpp::identity_same_worker(worker))
       .subscribe(
         [w = weak_from_this(),
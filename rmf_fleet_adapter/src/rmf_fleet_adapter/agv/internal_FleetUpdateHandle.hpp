@@ -22,6 +22,8 @@
 
 #include <rmf_task_msgs/msg/bid_proposal.hpp>
 #include <rmf_task_msgs/msg/bid_notice.hpp>
+#include <rmf_task_msgs/msg/batch_bid_notice.hpp>
+#include <rmf_task_msgs/msg/batch_bid_proposal.hpp>
 #include <rmf_task_msgs/msg/dispatch_request.hpp>
 #include <rmf_task_msgs/msg/dispatch_ack.hpp>
 
@@ -38,6 +40,7 @@
 #include "Node.hpp"
 #include "RobotContext.hpp"
 #include "../TaskManager.hpp"
+#include "../jobs/PlanningScheduler.hpp"
 
 #include <rmf_traffic/schedule/Snapshot.hpp>
 #include <rmf_traffic/agv/Interpolate.hpp>
@@ -47,6 +50,7 @@
 #include <rmf_traffic_ros2/schedule/Negotiation.hpp>
 #include <rmf_traffic_ros2/Time.hpp>
 
+#include <future>
 #include <iostream>
 #include <unordered_set>
 #include <optional>
@@ -129,6 +133,7 @@ class FleetUpdateHandle::Implementation
 {
 public:
 
+  std::weak_ptr<FleetUpdateHandle> weak_self;
   std::string name;
   std::shared_ptr<rmf_traffic::agv::Planner> planner;
   std::shared_ptr<Node> node;
@@ -175,8 +180,13 @@ public:
   std::unordered_set<std::size_t> available_charging_waypoints;
 
   double current_assignment_cost = 0.0;
+  // The assignments that were last handed to the task managers
+  Assignments current_assignments = {};
   // Map to store task id with assignments for BidNotice
   std::unordered_map<std::string, Assignments> bid_notice_assignments = {};
+  // Map task id to the ids of all the tasks that were bid for in its batch
+  std::unordered_map<std::string,
+    std::shared_ptr<const std::unordered_set<std::string>>> bid_batches = {};
 
   std::unordered_map<
     std::string, rmf_task::ConstRequestPtr> generated_requests = {};
@@ -194,6 +204,16 @@ public:
   using BidProposalPub = rclcpp::Publisher<BidProposal>::SharedPtr;
   BidProposalPub bid_proposal_pub = nullptr;
 
+  using TaskProfile = rmf_task_msgs::msg::TaskProfile;
+
+  using BatchBidNotice = rmf_task_msgs::msg::BatchBidNotice;
+  using BatchBidNoticeSub = rclcpp::Subscription<BatchBidNotice>::SharedPtr;
+  BatchBidNoticeSub batch_bid_notice_sub = nullptr;
+
+  using BatchBidProposal = rmf_task_msgs::msg::BatchBidProposal;
+  using BatchBidProposalPub = rclcpp::Publisher<BatchBidProposal>::SharedPtr;
+  BatchBidProposalPub batch_bid_proposal_pub = nullptr;
+
   using DispatchRequest = rmf_task_msgs::msg::DispatchRequest;
   using DispatchRequestSub = rclcpp::Subscription<DispatchRequest>::SharedPtr;
   DispatchRequestSub dispatch_request_sub = nullptr;
@@ -229,6 +249,11 @@ public:
       handle._pimpl->node->create_publisher<BidProposal>(
         BidProposalTopicName, default_qos);
 
+    // Publish BatchBidProposal
+    handle._pimpl->batch_bid_proposal_pub =
+      handle._pimpl->node->create_publisher<BatchBidProposal>(
+        BatchBidProposalTopicName, default_qos);
+
     // Publish DispatchAck
     handle._pimpl->dispatch_ack_pub =
       handle._pimpl->node->create_publisher<DispatchAck>(
@@ -244,6 +269,16 @@ public:
           p->bid_notice_cb(msg);
         });
 
+    // Subscribe BatchBidNotice
+    handle._pimpl->batch_bid_notice_sub =
+      handle._pimpl->node->create_subscription<BatchBidNotice>(
+        BatchBidNoticeTopicName,
+        default_qos,
+        [p = handle._pimpl.get()](const BatchBidNotice::SharedPtr msg)
+        {
+          p->batch_bid_notice_cb(msg);
+        });
+
     // Subscribe DispatchRequest
     handle._pimpl->dispatch_request_sub =
       handle._pimpl->node->create_subscription<DispatchRequest>(
@@ -272,30 +307,165 @@ public:
     handle._pimpl->available_charging_waypoints =
       handle._pimpl->charging_waypoints;
 
-    return std::make_shared<FleetUpdateHandle>(std::move(handle));
+    auto fleet = std::make_shared<FleetUpdateHandle>(std::move(handle));
+    fleet->_pimpl->weak_self = fleet;
+    return fleet;
   }
 
   void dock_summary_cb(const DockSummary::SharedPtr& msg);
 
+  /// Check whether this fleet is configured to bid for tasks
+  bool ready_for_bidding() const;
+
+  /// Generate the request for a task that is being bid for. This returns a
+  /// nullptr if this fleet cannot or will not accommodate the task.
+  rmf_task::ConstRequestPtr generate_request(const TaskProfile& task_profile);
+
   void bid_notice_cb(const BidNotice::SharedPtr msg);
 
+  /// Tell the dispatcher that this fleet will not bid for a task
+  void submit_no_bid(const TaskProfile& task_profile);
+
+  /// Publish the proposal for a bid once its assignments have been planned
+  void submit_bid_proposal(
+    const TaskProfile& task_profile,
+    const Assignments& assignments);
+
+  void batch_bid_notice_cb(const BatchBidNotice::SharedPtr msg);
+
+  /// Publish the proposals for a batch of bids once their assignments have
+  /// been planned
+  void submit_batch_bid_proposal(
+    const BatchBidNotice& batch,
+    const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+    const std::unordered_map<std::string, const TaskProfile*>& task_profiles,
+    const Assignments& assignments);
+
   void dispatch_request_cb(const DispatchRequest::SharedPtr msg);
 
+  /// Erase everything that was stored for a bid once its task has been
+  /// awarded, whether to this fleet or to another one.
+  void forget_bid(const std::string& task_id);
+
   std::size_t get_nearest_charger(
     const rmf_traffic::agv::Planner::Start& start,
     const std::unordered_set<std::size_t>& charging_waypoints);
 
+  /// Everything that task allocation needs to know about the fleet. This gets
+  /// collected on the fleet worker so that the planning itself can be done on
+  /// any thread.
+  struct AllocationSnapshot
+  {
+    rmf_traffic::Time time;
+    std::shared_ptr<rmf_task::agv::TaskPlanner> task_planner;
+    std::vector<rmf_task::agv::State> states;
+    std::vector<rmf_task::agv::Constraints> constraints_set;
+    std::vector<rmf_task::ConstRequestPtr> new_requests;
+    std::vector<rmf_task::ConstRequestPtr> pending_requests;
+    std::optional<Assignments> warm_start;
+    std::string id;
+  };
+
+  /// Collect the snapshot that allocate_tasks() plans with
+  AllocationSnapshot snapshot_allocation(
+    const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+    rmf_task::ConstRequestPtr ignore_request = nullptr) const;
+
+  /// Plan the task assignments for a snapshot of the fleet
+  std::optional<Assignments> solve_allocation(
+    const AllocationSnapshot& snapshot) const;
+
   /// Generate task assignments for a collection of task requests comprising of
   /// task requests currently in TaskManager queues while optionally including a  
-  /// new request and while optionally ignoring a specific request.
+  /// new request and while optionally ignoring a specific request. New requests
+  /// are inserted into the current assignments when possible, instead of
+  /// planning for every request from scratch.
   std::optional<Assignments> allocate_tasks(
     rmf_task::ConstRequestPtr new_request = nullptr,
     rmf_task::ConstRequestPtr ignore_request = nullptr) const;
 
+  /// Generate task assignments which accommodate several new requests at once.
+  std::optional<Assignments> allocate_tasks(
+    const std::vector<rmf_task::ConstRequestPtr>& new_requests,
+    rmf_task::ConstRequestPtr ignore_request = nullptr) const;
+
   /// Helper function to check if assignments are valid. An assignment set is
   /// invalid if one of the assignments has already begun execution.
   bool is_valid_assignments(Assignments& assignments) const;
 
+  /// Run f(index, task_manager) for every robot, where index is the position
+  /// of the robot in task_managers, and wait for all of them to finish.
+  ///
+  /// The TaskManager and RobotContext of a robot may only be used from the
+  /// worker of that robot. In multi-threaded mode every robot has its own
+  /// strand, so f gets dispatched to each of those strands. Otherwise all the
+  /// robots share the fleet worker, which is where this gets called from, so
+  /// f is run right away.
+  template<typename F>
+  void for_each_robot(const F& f) const
+  {
+    if (!node->strands())
+    {
+      std::size_t index = 0;
+      for (const auto& t : task_managers)
+        f(index++, *t.second);
+
+      return;
+    }
+
+    std::vector<std::future<void>> finished;
+    finished.reserve(task_managers.size());
+    std::size_t index = 0;
+    for (const auto& t : task_managers)
+    {
+      auto job = std::make_shared<std::packaged_task<void()>>(
+            [&f, index, mgr = t.second]() { f(index, *mgr); });
+      finished.push_back(job->get_future());
+      t.first->worker().schedule([job](const auto&) { (*job)(); });
+      ++index;
+    }
+
+    for (auto& done : finished)
+      done.get();
+  }
+
+  /// Get the executed tasks of every robot
+  std::vector<std::vector<std::string>> collect_executed_tasks() const
+  {
+    return collect_from_robots(
+      [](const TaskManager& mgr) { return mgr.get_executed_tasks(); });
+  }
+
+  /// Get f(task_manager) for every robot, in the order of task_managers. This
+  /// follows the same rules as for_each_robot().
+  template<typename F>
+  auto collect_from_robots(const F& f) const
+  -> std::vector<decltype(f(std::declval<TaskManager&>()))>
+  {
+    using Result = decltype(f(std::declval<TaskManager&>()));
+    std::vector<rmf_utils::optional<Result>> results(task_managers.size());
+    for_each_robot(
+      [&f, &results](std::size_t index, TaskManager& mgr)
+      {
+        results[index] = f(mgr);
+      });
+
+    std::vector<Result> output;
+    output.reserve(results.size());
+    for (auto& r : results)
+      output.emplace_back(std::move(*r));
+
+    return output;
+  }
+
+  /// Plan the assignments for a bid on the planning scheduler at Bid priority
+  /// and then pass them to on_done on the fleet worker. The fleet worker never
+  /// waits for the planning, so a bid that keeps stepping aside for routine,
+  /// negotiation, or emergency planning cannot stall the rest of the fleet.
+  void plan_for_bid(
+    AllocationSnapshot snapshot,
+    std::function<void(std::optional<Assignments>)> on_done) const;
+
   static Implementation& get(FleetUpdateHandle& fleet)
   {
     return *fleet._pimpl;
@@ -69,5 +69,58 @@ const rmf_traffic::agv::Planner::Result& Planning::progress() const
   return *_current_result;
 }
 
+//==============================================================================
+Planning& Planning::priority(Priority value)
+{
+  _priority = value;
+  return *this;
+}
+
+//==============================================================================
+auto Planning::priority() const -> Priority
+{
+  return _priority;
+}
+
+//==============================================================================
+rxcpp::schedulers::scheduler Planning::scheduler() const
+{
+  return _scheduler->scheduler(_priority);
+}
+
+//==============================================================================
+bool Planning::_resume_for(const rmf_traffic::Duration time_slice)
+{
+  auto& options = _current_result->options();
+  const auto original_flag = options.interrupt_flag();
+  const auto original_interrupter = options.interrupter();
+
+  bool slice_expired = false;
+  const auto deadline = std::chrono::steady_clock::now() + time_slice;
+  options.interrupter(
+        [&original_interrupter, &slice_expired, deadline]() -> bool
+  {
+    if (original_interrupter && original_interrupter())
+      return true;
+
+    if (std::chrono::steady_clock::now() < deadline)
+      return false;
+
+    slice_expired = true;
+    return true;
+  });
+
+  _current_result->resume();
+
+  // Put back the original interruption settings. Using interrupt_flag(~) when
+  // it was originally set makes sure the flag field is preserved as well.
+  if (original_flag)
+    options.interrupt_flag(original_flag);
+  else
+    options.interrupter(original_interrupter);
+
+  return slice_expired && !_current_result->success();
+}
+
 } // namespace jobs
 } // namespace rmf_fleet_adapter
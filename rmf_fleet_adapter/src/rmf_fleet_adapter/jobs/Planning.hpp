@@ -18,6 +18,8 @@
 #ifndef SRC__RMF_FLEET_ADAPTER__JOBS__PLANNINGJOB_HPP
 #define SRC__RMF_FLEET_ADAPTER__JOBS__PLANNINGJOB_HPP
 
+#include "PlanningScheduler.hpp"
+
 #include <rmf_rxcpp/RxJobs.hpp>
 #include <rmf_traffic/agv/Planner.hpp>
 #include <rmf_traffic/agv/RouteValidator.hpp>
@@ -27,7 +29,10 @@ namespace rmf_fleet_adapter {
 namespace jobs {
 
 //==============================================================================
-/// A job to advance a planning effort forward
+/// A job to advance a planning effort forward. Each time the job is run, it
+/// will plan for at most one time slice of the PlanningScheduler before it
+/// yields its thread to other jobs. Subscribers are only notified when the
+/// planner stops for a reason other than the time slice running out.
 class Planning : public std::enable_shared_from_this<Planning>
 {
 public:
@@ -36,6 +41,8 @@ public:
     Planning& job;
   };
 
+  using Priority = PlanningScheduler::Priority;
+
   Planning(
     std::shared_ptr<const rmf_traffic::agv::Planner> planner,
     const rmf_traffic::agv::Plan::StartSet& starts,
@@ -57,9 +64,27 @@ public:
 
   const rmf_traffic::agv::Planner::Result& progress() const;
 
+  /// Set the priority of this job. This must be set before the job is started.
+  Planning& priority(Priority value);
+
+  /// Get the priority of this job.
+  Priority priority() const;
+
+  /// Get the scheduler that this job should be run on.
+  rxcpp::schedulers::scheduler scheduler() const;
+
 private:
+
+  /// Resume the planner until it stops or the time slice runs out. Returns
+  /// true if the planner stopped because the time slice ran out.
+  bool _resume_for(rmf_traffic::Duration time_slice);
+
   std::function<void()> _resume;
   rmf_utils::optional<rmf_traffic::agv::Planner::Result> _current_result;
+
+  Priority _priority = Priority::Routine;
+  std::shared_ptr<PlanningScheduler> _scheduler = PlanningScheduler::get();
+  rmf_utils::optional<std::chrono::steady_clock::time_point> _scheduled_time;
 };
 
 } // namespace jobs
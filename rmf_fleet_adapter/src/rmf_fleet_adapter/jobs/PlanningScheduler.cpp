@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "PlanningScheduler.hpp"
+
+namespace rmf_fleet_adapter {
+namespace jobs {
+
+//==============================================================================
+std::shared_ptr<PlanningScheduler> PlanningScheduler::make(
+    std::size_t max_concurrency,
+    rmf_traffic::Duration time_slice)
+{
+  return std::shared_ptr<PlanningScheduler>(
+        new PlanningScheduler(max_concurrency, time_slice));
+}
+
+//==============================================================================
+const std::shared_ptr<PlanningScheduler>& PlanningScheduler::get()
+{
+  static const auto instance = make();
+  return instance;
+}
+
+//==============================================================================
+rxcpp::schedulers::scheduler PlanningScheduler::scheduler(
+    const Priority priority) const
+{
+  return _pool->scheduler(static_cast<int>(priority));
+}
+
+//==============================================================================
+rxcpp::schedulers::worker PlanningScheduler::make_worker(
+    const Priority priority) const
+{
+  return _pool->make_strand(static_cast<int>(priority));
+}
+
+//==============================================================================
+rmf_traffic::Duration PlanningScheduler::time_slice() const
+{
+  return _time_slice;
+}
+
+//==============================================================================
+std::size_t PlanningScheduler::max_concurrency() const
+{
+  return _pool->num_threads();
+}
+
+//==============================================================================
+void PlanningScheduler::record(
+    const Priority priority,
+    const rmf_traffic::Duration waited,
+    const rmf_traffic::Duration ran,
+    const bool yielded,
+    const bool completed)
+{
+  std::lock_guard<std::mutex> lock(_metrics_mutex);
+  auto& m = _metrics.at(static_cast<std::size_t>(priority));
+  ++m.slices;
+  if (yielded)
+    ++m.yields;
+
+  if (completed)
+    ++m.completed;
+
+  m.busy_time += ran;
+  m.wait_time += waited;
+  m.max_wait_time = std::max(m.max_wait_time, waited);
+}
+
+//==============================================================================
+auto PlanningScheduler::metrics() const -> Metrics
+{
+  std::lock_guard<std::mutex> lock(_metrics_mutex);
+  return _metrics;
+}
+
+//==============================================================================
+PlanningScheduler::PlanningScheduler(
+    const std::size_t max_concurrency,
+    const rmf_traffic::Duration time_slice)
+  : _pool(rmf_rxcpp::StrandPool::make(max_concurrency)),
+    _time_slice(time_slice)
+{
+  // Do nothing
+}
+
+} // namespace jobs
+} // namespace rmf_fleet_adapter
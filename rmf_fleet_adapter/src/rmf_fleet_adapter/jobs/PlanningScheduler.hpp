@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_FLEET_ADAPTER__JOBS__PLANNINGSCHEDULER_HPP
+#define SRC__RMF_FLEET_ADAPTER__JOBS__PLANNINGSCHEDULER_HPP
+
+#include <rmf_rxcpp/StrandPool.hpp>
+
+#include <rmf_traffic/Time.hpp>
+
+#include <array>
+#include <mutex>
+
+namespace rmf_fleet_adapter {
+namespace jobs {
+
+//==============================================================================
+/// The scheduler that all planning jobs (Planning, Rollout, SearchForPath) run
+/// on. It has a bounded number of threads, and when more jobs are ready than
+/// there are threads, the jobs with the highest priority are run first. Each
+/// planning job is expected to yield its thread after time_slice() so that
+/// urgent jobs do not need to wait for long-running routine jobs to finish.
+class PlanningScheduler
+{
+public:
+
+  enum class Priority : int
+  {
+    /// Planning that is needed to bid on a task
+    Bid = 0,
+
+    /// Routine planning, e.g. for GoToPlace
+    Routine = 1,
+
+    /// Responding to an active traffic negotiation
+    Negotiation = 2,
+
+    /// Finding an emergency pullover
+    Emergency = 3
+  };
+
+  static constexpr std::size_t NumPriorities = 4;
+
+  /// Metrics that are tracked for each priority level
+  struct PriorityMetrics
+  {
+    /// How many time slices have been run
+    std::size_t slices = 0;
+
+    /// How many slices ended early so that the thread could be yielded
+    std::size_t yields = 0;
+
+    /// How many jobs have run to completion
+    std::size_t completed = 0;
+
+    /// The total time spent running jobs of this priority
+    rmf_traffic::Duration busy_time = rmf_traffic::Duration(0);
+
+    /// The total time that slices waited in the queue before running
+    rmf_traffic::Duration wait_time = rmf_traffic::Duration(0);
+
+    /// The longest time that any slice waited in the queue before running
+    rmf_traffic::Duration max_wait_time = rmf_traffic::Duration(0);
+  };
+
+  using Metrics = std::array<PriorityMetrics, NumPriorities>;
+
+  /// Make a planning scheduler.
+  ///
+  /// \param[in] max_concurrency
+  ///   The maximum number of planning jobs that can run at the same time. If 0
+  ///   is given, the number of hardware threads will be used.
+  ///
+  /// \param[in] time_slice
+  ///   How long a planning job may run before it yields to other jobs.
+  static std::shared_ptr<PlanningScheduler> make(
+    std::size_t max_concurrency = 0,
+    rmf_traffic::Duration time_slice = std::chrono::milliseconds(50));
+
+  /// Get the scheduler that is shared by all the fleets in this process.
+  static const std::shared_ptr<PlanningScheduler>& get();
+
+  /// Get an rxcpp scheduler whose workers have the given priority. Each worker
+  /// is serialized, so a job that runs on one worker will never run in
+  /// parallel with itself.
+  rxcpp::schedulers::scheduler scheduler(Priority priority) const;
+
+  /// Make a new worker with the given priority.
+  rxcpp::schedulers::worker make_worker(Priority priority) const;
+
+  /// How long a planning job may run before it should yield its thread.
+  rmf_traffic::Duration time_slice() const;
+
+  /// The maximum number of jobs that can run at the same time.
+  std::size_t max_concurrency() const;
+
+  /// Record a time slice that was run by a planning job.
+  ///
+  /// \param[in] priority
+  ///   The priority of the job.
+  ///
+  /// \param[in] waited
+  ///   How long the job waited between being scheduled and starting.
+  ///
+  /// \param[in] ran
+  ///   How long the job ran for.
+  ///
+  /// \param[in] yielded
+  ///   True if the job stopped because its time slice ran out.
+  ///
+  /// \param[in] completed
+  ///   True if the job will not be resumed again.
+  void record(
+    Priority priority,
+    rmf_traffic::Duration waited,
+    rmf_traffic::Duration ran,
+    bool yielded,
+    bool completed);
+
+  /// Get a copy of the current metrics.
+  Metrics metrics() const;
+
+private:
+  PlanningScheduler(
+    std::size_t max_concurrency,
+    rmf_traffic::Duration time_slice);
+
+  std::shared_ptr<rmf_rxcpp::StrandPool> _pool;
+  rmf_traffic::Duration _time_slice;
+
+  mutable std::mutex _metrics_mutex;
+  Metrics _metrics;
+};
+
+} // namespace jobs
+} // namespace rmf_fleet_adapter
+
+#endif // SRC__RMF_FLEET_ADAPTER__JOBS__PLANNINGSCHEDULER_HPP
@@ -25,14 +25,37 @@ Rollout::Rollout(
     rmf_traffic::agv::Planner::Result result,
     rmf_traffic::schedule::ParticipantId blocker,
     rmf_traffic::Duration span,
-    rmf_utils::optional<std::size_t> max_rollouts)
+    rmf_utils::optional<std::size_t> max_rollouts,
+    const Priority priority)
   : _rollout(std::move(result)),
     _blocker(blocker),
     _span(span),
-    _max_rollouts(max_rollouts)
+    _max_rollouts(max_rollouts),
+    _priority(priority)
 {
   // Do nothing
 }
 
+//==============================================================================
+auto Rollout::priority() const -> Priority
+{
+  return _priority;
+}
+
+//==============================================================================
+rxcpp::schedulers::scheduler Rollout::scheduler() const
+{
+  return _scheduler->scheduler(_priority);
+}
+
+//==============================================================================
+bool Rollout::_expand_for(const rmf_traffic::Duration time_slice)
+{
+  if (!_expansion)
+    _expansion = _rollout.begin(_blocker, _span, _max_rollouts);
+
+  return !_expansion->resume(time_slice);
+}
+
 } // namespace jobs
 } // namespace rmf_fleet_adapter
@@ -18,16 +18,24 @@
 #ifndef SRC__RMF_FLEET_ADAPTER__JOBS__ROLLOUT_HPP
 #define SRC__RMF_FLEET_ADAPTER__JOBS__ROLLOUT_HPP
 
+#include "PlanningScheduler.hpp"
+
 #include <rmf_traffic/agv/Rollout.hpp>
 
 namespace rmf_fleet_adapter {
 namespace jobs {
 
 //==============================================================================
-class Rollout
+/// A job to expand a planning result through a blocker. Like the Planning job,
+/// each run of this job expands for at most one time slice of the
+/// PlanningScheduler before it yields its thread to other jobs. Subscribers
+/// are only notified once the expansion is finished.
+class Rollout : public std::enable_shared_from_this<Rollout>
 {
 public:
 
+  using Priority = PlanningScheduler::Priority;
+
   struct Result
   {
     std::vector<rmf_traffic::schedule::Itinerary> alternatives;
@@ -37,16 +45,33 @@ public:
       rmf_traffic::agv::Planner::Result result,
       rmf_traffic::schedule::ParticipantId blocker,
       rmf_traffic::Duration span,
-      rmf_utils::optional<std::size_t> max_rollouts = rmf_utils::nullopt);
+      rmf_utils::optional<std::size_t> max_rollouts = rmf_utils::nullopt,
+      Priority priority = Priority::Routine);
 
   template<typename Subscriber, typename Worker>
   void operator()(const Subscriber& s, const Worker& w);
 
+  /// Get the priority of this job.
+  Priority priority() const;
+
+  /// Get the scheduler that this job should be run on.
+  rxcpp::schedulers::scheduler scheduler() const;
+
 private:
+
+  /// Expand until the rollout is finished or the time slice runs out. Returns
+  /// true if the expansion stopped because the time slice ran out.
+  bool _expand_for(rmf_traffic::Duration time_slice);
+
   rmf_traffic::agv::Rollout _rollout;
   rmf_traffic::schedule::ParticipantId _blocker;
   rmf_traffic::Duration _span;
   rmf_utils::optional<std::size_t> _max_rollouts;
+  rmf_utils::optional<rmf_traffic::agv::Rollout::Expansion> _expansion;
+
+  Priority _priority;
+  std::shared_ptr<PlanningScheduler> _scheduler = PlanningScheduler::get();
+  rmf_utils::optional<std::chrono::steady_clock::time_point> _scheduled_time;
 };
 
 } // namespace jobs
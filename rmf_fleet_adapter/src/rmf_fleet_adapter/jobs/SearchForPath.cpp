@@ -27,13 +27,14 @@ SearchForPath::SearchForPath(
     rmf_traffic::agv::Plan::Goal goal,
     std::shared_ptr<const rmf_traffic::schedule::Snapshot> schedule,
     rmf_traffic::schedule::ParticipantId participant_id,
-    const std::shared_ptr<const rmf_traffic::Profile>& profile)
+    const std::shared_ptr<const rmf_traffic::Profile>& profile,
+    const Planning::Priority priority)
   : _planner(std::move(planner)),
     _starts(std::move(starts)),
     _goal(std::move(goal)),
     _schedule(std::move(schedule)),
     _participant_id(participant_id),
-    _worker(rxcpp::schedulers::make_event_loop().create_worker())
+    _worker(PlanningScheduler::get()->make_worker(priority))
 {
   auto greedy_options = _planner->get_default_options();
   greedy_options.validator(nullptr);
@@ -77,7 +78,9 @@ SearchForPath::SearchForPath(
   auto compliant_setup = _planner->setup(_starts, _goal, compliant_options);
 
   _greedy_job = std::make_shared<Planning>(std::move(greedy_setup));
+  _greedy_job->priority(priority);
   _compliant_job = std::make_shared<Planning>(std::move(compliant_setup));
+  _compliant_job->priority(priority);
 }
 
 //==============================================================================
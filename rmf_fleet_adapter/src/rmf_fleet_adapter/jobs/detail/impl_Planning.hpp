@@ -29,6 +29,9 @@ void Planning::operator()(const Subscriber& s, const Worker& w)
 {
   _resume = [a = weak_from_this(), s, w]()
   {
+    if (const auto action = a.lock())
+      action->_scheduled_time = std::chrono::steady_clock::now();
+
     w.schedule([a, s, w](const auto&)
     {
       if (const auto action = a.lock())
@@ -36,14 +39,30 @@ void Planning::operator()(const Subscriber& s, const Worker& w)
     });
   };
 
-  if (!_current_result)
+  if (!_current_result || !s.is_subscribed())
     return;
 
-  _current_result->resume();
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto waited = _scheduled_time?
+        start_time - *_scheduled_time : rmf_traffic::Duration(0);
+
+  const bool yielded = _resume_for(_scheduler->time_slice());
+  const auto ran = std::chrono::steady_clock::now() - start_time;
+
+  if (yielded)
+  {
+    // The time slice ran out, so we go to the back of the line and let other
+    // jobs have a turn. The subscriber does not need to hear about this.
+    _scheduler->record(_priority, waited, ran, true, false);
+    _resume();
+    return;
+  }
 
   const bool completed =
       _current_result->success() || !_current_result->cost_estimate();
 
+  _scheduler->record(_priority, waited, ran, false, completed);
+
   s.on_next(Result{*this});
   if (completed)
   {
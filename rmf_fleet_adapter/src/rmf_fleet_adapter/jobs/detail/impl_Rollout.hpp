@@ -25,9 +25,33 @@ namespace jobs {
 
 //==============================================================================
 template<typename Subscriber, typename Worker>
-void Rollout::operator()(const Subscriber& s, const Worker&)
+void Rollout::operator()(const Subscriber& s, const Worker& w)
 {
-  s.on_next(Result{_rollout.expand(_blocker, _span, _max_rollouts)});
+  if (!s.is_subscribed())
+    return;
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto waited = _scheduled_time?
+        start_time - *_scheduled_time : rmf_traffic::Duration(0);
+
+  const bool yielded = _expand_for(_scheduler->time_slice());
+  const auto ran = std::chrono::steady_clock::now() - start_time;
+  _scheduler->record(_priority, waited, ran, yielded, !yielded);
+
+  if (yielded)
+  {
+    // The time slice ran out, so we go to the back of the line and let other
+    // jobs have a turn.
+    _scheduled_time = std::chrono::steady_clock::now();
+    w.schedule([a = weak_from_this(), s, w](const auto&)
+    {
+      if (const auto action = a.lock())
+        (*action)(s, w);
+    });
+    return;
+  }
+
+  s.on_next(Result{_expansion->alternatives()});
   s.on_completed();
 }
 
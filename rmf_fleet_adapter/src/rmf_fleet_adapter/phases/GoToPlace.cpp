@@ -222,7 +222,7 @@ void GoToPlace::Active::find_plan()
         _context->profile());
 
   _plan_subscription = rmf_rxcpp::make_job<services::FindPath::Result>(
-        _find_path_service)
+        _find_path_service, _find_path_service->scheduler())
       .observe_on(rxcpp::identity_same_worker(_context->worker()))
       .subscribe(
         [w = weak_from_this()](
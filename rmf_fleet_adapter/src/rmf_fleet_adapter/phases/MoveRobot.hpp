@@ -141,34 +141,52 @@ void MoveRobot::Action::operator()(const Subscriber& s)
       return;
     }
 
-    const auto current_delay = action->_context->itinerary().delay();
-
-    const rmf_traffic::Time t = action->_context->now();
-    const auto previously_expected_arrival =
-        action->_waypoints[path_index].time() + current_delay;
-    const auto newly_expected_arrival = t + estimate;
-    const auto new_delay = newly_expected_arrival - previously_expected_arrival;
+    // The published delay is all we can look at from here, but it is enough
+    // to avoid scheduling a job on the worker while the robot is on time.
+    // A delay that has already been published still needs to be taken back
+    // when the robot catches up.
+    const auto t = action->_context->now();
+    const auto published_delay = action->_context->itinerary().delay();
+    const auto published_expected_arrival =
+        action->_waypoints[path_index].time() + published_delay;
+
+    if (t + estimate - published_expected_arrival <= std::chrono::seconds(0)
+        && published_delay <= std::chrono::seconds(0))
+    {
+      return;
+    }
 
-    if (!action->_interrupted)
+    // The delay is worked out on the worker, because that is where the delays
+    // that have been reported but not published yet are kept.
+    action->_context->worker().schedule(
+          [w_action, path_index, estimate, t](const auto&)
     {
-      if (const auto max_delay = action->_context->maximum_delay())
+      const auto action = w_action.lock();
+      if (!action)
+        return;
+
+      const auto& context = action->_context;
+      const auto current_delay = context->cumulative_delay();
+      const auto previously_expected_arrival =
+          action->_waypoints[path_index].time() + current_delay;
+      const auto newly_expected_arrival = t + estimate;
+      const auto new_delay =
+          newly_expected_arrival - previously_expected_arrival;
+
+      if (!action->_interrupted)
       {
-        if (*max_delay < current_delay + new_delay)
+        if (const auto max_delay = context->maximum_delay())
         {
-          action->_interrupted = true;
-          action->_context->trigger_interrupt();
+          if (*max_delay < current_delay + new_delay)
+          {
+            action->_interrupted = true;
+            context->trigger_interrupt();
+          }
         }
       }
-    }
 
-    if (std::chrono::milliseconds(500).count() < std::abs(new_delay.count()))
-    {
-      action->_context->worker().schedule(
-            [context = action->_context, new_delay](const auto&)
-      {
-        context->itinerary().delay(new_delay);
-      });
-    }
+      context->report_delay(new_delay);
+    });
   },
         [s]()
   {
@@ -117,16 +117,25 @@ void RequestLift::ActivePhase::_init_obs()
           // supervisor sees our request.
           me->_do_publish();
 
-          const auto current_expected_finish =
+          // The published delay is all we can look at from here, but it is
+          // enough to avoid scheduling a job on the worker while the robot
+          // is still on time.
+          const auto published_expected_finish =
               me->_expected_finish + me->_context->itinerary().delay();
 
-          const auto delay = me->_context->now() - current_expected_finish;
-          if (delay > std::chrono::seconds(0))
+          if (me->_context->now() - published_expected_finish
+              > std::chrono::seconds(0))
           {
             me->_context->worker().schedule(
-                  [context = me->_context, delay](const auto&)
+                  [context = me->_context,
+                   expected_finish = me->_expected_finish](const auto&)
             {
-              context->itinerary().delay(delay);
+              const auto current_expected_finish =
+                  expected_finish + context->cumulative_delay();
+
+              const auto delay = context->now() - current_expected_finish;
+              if (delay > std::chrono::seconds(0))
+                context->report_delay(delay);
             });
           }
         });
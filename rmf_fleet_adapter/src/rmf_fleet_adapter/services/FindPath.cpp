@@ -27,7 +27,9 @@ FindPath::FindPath(
     rmf_traffic::agv::Plan::Goal goal,
     std::shared_ptr<const rmf_traffic::schedule::Snapshot> schedule,
     rmf_traffic::schedule::ParticipantId participant_id,
-    const std::shared_ptr<const rmf_traffic::Profile>& profile)
+    const std::shared_ptr<const rmf_traffic::Profile>& profile,
+    const jobs::Planning::Priority priority)
+  : _priority(priority)
 {
   _search_job = std::make_shared<jobs::SearchForPath>(
         std::move(planner),
@@ -35,7 +37,8 @@ FindPath::FindPath(
         std::move(goal),
         std::move(schedule),
         participant_id,
-        profile);
+        profile,
+        priority);
 }
 
 //==============================================================================
@@ -44,5 +47,11 @@ void FindPath::interrupt()
   _search_job->interrupt();
 }
 
+//==============================================================================
+rxcpp::schedulers::scheduler FindPath::scheduler() const
+{
+  return jobs::PlanningScheduler::get()->scheduler(_priority);
+}
+
 } // namespace services
 } // namespace rmf_fleet_adapter
@@ -36,7 +36,8 @@ public:
     rmf_traffic::agv::Plan::Goal goal,
     std::shared_ptr<const rmf_traffic::schedule::Snapshot> schedule,
     rmf_traffic::schedule::ParticipantId participant_id,
-    const std::shared_ptr<const rmf_traffic::Profile>& profile);
+    const std::shared_ptr<const rmf_traffic::Profile>& profile,
+    jobs::Planning::Priority priority = jobs::Planning::Priority::Routine);
 
   using Result = rmf_traffic::agv::Plan::Result;
 
@@ -45,8 +46,12 @@ public:
 
   void interrupt();
 
+  /// Get the scheduler that this service should be run on.
+  rxcpp::schedulers::scheduler scheduler() const;
+
 private:
   std::shared_ptr<jobs::SearchForPath> _search_job;
+  jobs::Planning::Priority _priority;
   rmf_rxcpp::subscription_guard _search_sub;
 };
 
@@ -85,7 +85,7 @@ std::shared_ptr<Negotiate> Negotiate::emergency_pullover(
       goals.push_back(wp.index());
   }
 
-  return std::make_shared<Negotiate>(
+  auto negotiate = std::make_shared<Negotiate>(
         std::move(planner),
         std::move(starts),
         std::move(goals),
@@ -93,6 +93,12 @@ std::shared_ptr<Negotiate> Negotiate::emergency_pullover(
         std::move(responder),
         std::move(approval),
         evaluator);
+
+  negotiate->_priority = jobs::Planning::Priority::Emergency;
+  negotiate->_worker =
+      jobs::PlanningScheduler::get()->make_worker(negotiate->_priority);
+
+  return negotiate;
 }
 
 //==============================================================================
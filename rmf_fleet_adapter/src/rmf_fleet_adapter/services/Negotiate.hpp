@@ -129,6 +129,14 @@ private:
 
   static constexpr std::size_t max_concurrent_jobs = 5;
 
+  // Emergency pullovers are given a higher priority than other negotiations
+  jobs::Planning::Priority _priority = jobs::Planning::Priority::Negotiation;
+
+  // All results are observed on this worker so that the search results and the
+  // rollout results never get handled at the same time.
+  rxcpp::schedulers::worker _worker =
+      jobs::PlanningScheduler::get()->make_worker(_priority);
+
   ProgressEvaluator _evaluator;
 };
 
@@ -36,7 +36,8 @@ void FindEmergencyPullover::operator()(const Subscriber& s)
     if (wp.is_parking_spot())
     {
       auto search = std::make_shared<jobs::SearchForPath>(
-          _planner, _starts, wp.index(), _schedule, _participant_id, _profile);
+          _planner, _starts, wp.index(), _schedule, _participant_id, _profile,
+          jobs::Planning::Priority::Emergency);
 
       // Be sure to initialize these individually and not in a single statement,
       // otherwise the logic might short-circuit one of the initialize() calls
@@ -59,7 +60,10 @@ void FindEmergencyPullover::operator()(const Subscriber& s)
   for (const auto& job : _search_jobs)
     job->set_cost_limit(initial_max_cost);
 
-  _search_sub = rmf_rxcpp::make_job_from_action_list(_search_jobs)
+  _search_sub = rmf_rxcpp::make_job_from_action_list(
+        _search_jobs,
+        jobs::PlanningScheduler::get()->scheduler(
+          jobs::Planning::Priority::Emergency))
       .subscribe(
         [weak = weak_from_this(), s, N_jobs](
           const jobs::SearchForPath::Result& progress)
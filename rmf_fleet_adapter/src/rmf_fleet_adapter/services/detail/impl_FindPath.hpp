@@ -27,8 +27,11 @@ namespace services {
 template<typename Subscriber>
 void FindPath::operator()(const Subscriber& s)
 {
-  _search_sub = rmf_rxcpp::make_job<jobs::SearchForPath::Result>(_search_job)
-      .observe_on(rxcpp::observe_on_event_loop())
+  // The search itself only coordinates its planning jobs, so it runs on the
+  // planning scheduler at the same priority as those jobs instead of taking a
+  // thread of the global event loop.
+  _search_sub = rmf_rxcpp::make_job<jobs::SearchForPath::Result>(
+        _search_job, scheduler())
       .subscribe(
     [s](const jobs::SearchForPath::Result& result)
     {
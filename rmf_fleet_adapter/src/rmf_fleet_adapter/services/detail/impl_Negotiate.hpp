@@ -53,6 +53,7 @@ void Negotiate::operator()(const Subscriber& s)
             _planner, _starts, goal,
             rmf_traffic::agv::Plan::Options(validator)
             .interrupter(interrupter));
+      job->priority(_priority);
 
       _evaluator.initialize(job->progress());
 
@@ -165,8 +166,9 @@ void Negotiate::operator()(const Subscriber& s)
     return false;
   };
 
-  _search_sub = rmf_rxcpp::make_job_from_action_list(_queued_jobs)
-      .observe_on(rxcpp::observe_on_event_loop())
+  _search_sub = rmf_rxcpp::make_job_from_action_list(
+        _queued_jobs, jobs::PlanningScheduler::get()->scheduler(_priority))
+      .observe_on(rxcpp::identity_same_worker(_worker))
       .subscribe(
         [n_weak = weak_from_this(), s,
          check_if_finished = std::move(check_if_finished)](
@@ -206,11 +208,12 @@ void Negotiate::operator()(const Subscriber& s)
 
           n->_rollout_job = std::make_shared<jobs::Rollout>(
                 std::move(rollout_source), parent_id,
-                std::chrono::seconds(15), 200);
+                std::chrono::seconds(15), 200, n->_priority);
 
           n->_rollout_sub =
-              rmf_rxcpp::make_job<jobs::Rollout::Result>(n->_rollout_job)
-              .observe_on(rxcpp::observe_on_event_loop())
+              rmf_rxcpp::make_job<jobs::Rollout::Result>(
+                n->_rollout_job, n->_rollout_job->scheduler())
+              .observe_on(rxcpp::identity_same_worker(n->_worker))
               .subscribe(
                 [n, check_if_finished](const jobs::Rollout::Result& result)
           {
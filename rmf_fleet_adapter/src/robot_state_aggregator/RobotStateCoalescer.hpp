@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__ROBOT_STATE_AGGREGATOR__ROBOTSTATECOALESCER_HPP
+#define SRC__ROBOT_STATE_AGGREGATOR__ROBOTSTATECOALESCER_HPP
+
+#include <rclcpp/time.hpp>
+
+#include <rmf_fleet_msgs/msg/robot_state.hpp>
+#include <rmf_fleet_msgs/msg/fleet_state.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace robot_state_aggregator {
+
+//==============================================================================
+/// Keeps the latest state of each robot in a fleet and remembers which robots
+/// have changed since the last delta was taken, so that the aggregator can
+/// publish many robot updates together instead of a whole fleet per update.
+class RobotStateCoalescer
+{
+public:
+
+  using RobotState = rmf_fleet_msgs::msg::RobotState;
+  using FleetState = rmf_fleet_msgs::msg::FleetState;
+
+  RobotStateCoalescer(std::string prefix, std::string fleet_name)
+  : _prefix(std::move(prefix)),
+    _fleet_name(std::move(fleet_name))
+  {
+    // Do nothing
+  }
+
+  /// Give a new robot state to the coalescer. This returns true if the state
+  /// belongs to this fleet and is newer than the last state of its robot.
+  bool update(RobotState::UniquePtr msg)
+  {
+    const std::string& name = msg->name;
+    if (name.size() < _prefix.size())
+      return false;
+
+    if (name.compare(0, _prefix.size(), _prefix) != 0)
+      return false;
+
+    const auto insertion = _latest_states.insert(std::make_pair(name, nullptr));
+    const auto it = insertion.first;
+    if (!insertion.second)
+    {
+      if (rclcpp::Time(msg->location.t) <= rclcpp::Time(it->second->location.t))
+        return false;
+    }
+
+    it->second = std::move(msg);
+    _updated.insert(it->first);
+    return true;
+  }
+
+  /// Get the latest state of every robot in the fleet.
+  FleetState full_snapshot() const
+  {
+    FleetState fleet;
+    fleet.name = _fleet_name;
+    fleet.robots.reserve(_latest_states.size());
+    for (const auto& robot_state : _latest_states)
+      fleet.robots.emplace_back(*robot_state.second);
+
+    return fleet;
+  }
+
+  /// Get the latest state of each robot that has been updated since the last
+  /// time this was called. This returns a nullopt if no robot was updated.
+  std::optional<FleetState> take_delta()
+  {
+    if (_updated.empty())
+      return std::nullopt;
+
+    FleetState fleet;
+    fleet.name = _fleet_name;
+    fleet.robots.reserve(_updated.size());
+    for (const auto& name : _updated)
+      fleet.robots.emplace_back(*_latest_states.at(name));
+
+    _updated.clear();
+    return fleet;
+  }
+
+  /// Forget which robots have been updated without making a delta.
+  void clear_delta()
+  {
+    _updated.clear();
+  }
+
+  /// The number of robots whose states are known.
+  std::size_t size() const
+  {
+    return _latest_states.size();
+  }
+
+private:
+  std::string _prefix;
+  std::string _fleet_name;
+  std::unordered_map<std::string, std::unique_ptr<RobotState>> _latest_states;
+  std::unordered_set<std::string> _updated;
+};
+
+} // namespace robot_state_aggregator
+
+#endif // SRC__ROBOT_STATE_AGGREGATOR__ROBOTSTATECOALESCER_HPP
@@ -22,8 +22,11 @@
 
 #include <rmf_fleet_adapter/StandardNames.hpp>
 
+#include "RobotStateCoalescer.hpp"
+
 using RobotState = rmf_fleet_msgs::msg::RobotState;
 using FleetState = rmf_fleet_msgs::msg::FleetState;
+using RobotStateCoalescer = robot_state_aggregator::RobotStateCoalescer;
 
 class RobotStateAggregator : public rclcpp::Node
 {
@@ -44,8 +47,81 @@ public:
       return nullptr;
     }
 
-    node->_prefix = std::move(prefix);
-    node->_fleet_name = std::move(fleet_name);
+    // When publish_rate is zero, the whole fleet state gets published each time
+    // any robot state is updated. Otherwise the robots that have been updated
+    // get published together at this rate (in Hz).
+    const double publish_rate = node->declare_parameter("publish_rate", 0.0);
+
+    // If a delta_topic is given, the coalesced updates will be published there
+    // and the fleet state topic will only receive full snapshots. Otherwise the
+    // coalesced updates are published on the fleet state topic.
+    const auto delta_topic = node->declare_parameter("delta_topic", "");
+
+    // The period (in seconds) for publishing a full snapshot of the fleet when
+    // publish_rate is not zero. A value of zero disables the snapshots.
+    const double full_snapshot_period =
+      node->declare_parameter("full_snapshot_period", 1.0);
+
+    node->_coalescer = std::make_unique<RobotStateCoalescer>(
+      std::move(prefix), std::move(fleet_name));
+
+    if (publish_rate < 0.0 || full_snapshot_period < 0.0)
+    {
+      RCLCPP_FATAL(
+        node->get_logger(),
+        "The parameters [publish_rate] and [full_snapshot_period] must not be "
+        "negative");
+      return nullptr;
+    }
+
+    if (publish_rate == 0.0)
+      return node;
+
+    if (!delta_topic.empty())
+    {
+      node->_delta_pub = node->create_publisher<FleetState>(
+        delta_topic, rclcpp::SystemDefaultsQoS());
+
+      if (full_snapshot_period == 0.0)
+      {
+        RCLCPP_WARN(
+          node->get_logger(),
+          "A [delta_topic] was given while [full_snapshot_period] is zero, so "
+          "nothing will be published to [%s]",
+          rmf_fleet_adapter::FleetStateTopicName.c_str());
+      }
+    }
+
+    node->_delta_timer = node->create_wall_timer(
+      std::chrono::duration<double>(1.0/publish_rate),
+      [w = node->weak_from_this()]()
+      {
+        if (const auto n = std::static_pointer_cast<RobotStateAggregator>(
+            w.lock()))
+          n->_publish_delta();
+      });
+
+    if (full_snapshot_period > 0.0)
+    {
+      node->_snapshot_timer = node->create_wall_timer(
+        std::chrono::duration<double>(full_snapshot_period),
+        [w = node->weak_from_this()]()
+        {
+          if (const auto n = std::static_pointer_cast<RobotStateAggregator>(
+              w.lock()))
+            n->_publish_snapshot();
+        });
+    }
+
+    node->_coalescing = true;
+
+    RCLCPP_INFO(
+      node->get_logger(),
+      "Publishing robot updates at %fHz on [%s] with a full snapshot every %fs",
+      publish_rate,
+      delta_topic.empty() ?
+      rmf_fleet_adapter::FleetStateTopicName.c_str() : delta_topic.c_str(),
+      full_snapshot_period);
 
     return node;
   }
@@ -69,49 +145,46 @@ private:
       });
   }
 
-  std::string _prefix;
-  std::string _fleet_name;
-
-  std::unordered_map<std::string, std::unique_ptr<RobotState>> _latest_states;
+  std::unique_ptr<RobotStateCoalescer> _coalescer;
+  bool _coalescing = false;
 
   rclcpp::Publisher<FleetState>::SharedPtr _fleet_state_pub;
+  rclcpp::Publisher<FleetState>::SharedPtr _delta_pub;
+  rclcpp::TimerBase::SharedPtr _delta_timer;
+  rclcpp::TimerBase::SharedPtr _snapshot_timer;
 
   rclcpp::Subscription<RobotState>::SharedPtr _robot_state_sub;
   void _robot_state_update(RobotState::UniquePtr msg)
   {
-    const std::string& name = msg->name;
-    if (name.size() < _prefix.size())
+    if (!_coalescer->update(std::move(msg)))
       return;
 
-    if (name.substr(0, _prefix.size()) != _prefix)
-      return;
-
-    const auto insertion = _latest_states.insert(std::make_pair(name, nullptr));
-    const auto it = insertion.first;
-    bool updated = false;
-    if (insertion.second)
+    if (!_coalescing)
     {
-      it->second = std::move(msg);
-      updated = true;
+      // Every update gets a full snapshot, so there is no use for the deltas
+      _coalescer->clear_delta();
+      _publish_snapshot();
     }
+  }
+
+  void _publish_delta()
+  {
+    auto delta = _coalescer->take_delta();
+    if (!delta)
+      return;
+
+    if (_delta_pub)
+      _delta_pub->publish(*delta);
     else
-    {
-      if (rclcpp::Time(it->second->location.t) < rclcpp::Time(msg->location.t) )
-      {
-        it->second = std::move(msg);
-        updated = true;
-      }
-    }
+      _fleet_state_pub->publish(*delta);
+  }
 
-    if (updated)
-    {
-      FleetState fleet;
-      fleet.name = _fleet_name;
-      for (const auto& robot_state : _latest_states)
-        fleet.robots.emplace_back(*robot_state.second);
+  void _publish_snapshot()
+  {
+    if (_coalescer->size() == 0)
+      return;
 
-      _fleet_state_pub->publish(fleet);
-    }
+    _fleet_state_pub->publish(_coalescer->full_snapshot());
   }
 
 };
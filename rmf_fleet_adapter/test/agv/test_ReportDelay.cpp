@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "../phases/MockAdapterFixture.hpp"
+
+#include <rmf_utils/catch.hpp>
+
+#include <future>
+
+namespace {
+//==============================================================================
+/// Run a job on the worker of the context and wait for it to finish
+template<typename F>
+void run_on_worker(
+  const std::shared_ptr<rmf_fleet_adapter::agv::RobotContext>& context,
+  F f)
+{
+  std::promise<void> finished;
+  context->worker().schedule(
+    [&](const auto&)
+    {
+      f();
+      finished.set_value();
+    });
+  finished.get_future().wait();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO_METHOD(
+  rmf_fleet_adapter::phases::test::MockAdapterFixture,
+  "Small delays are held back until they reach the threshold",
+  "[agv]")
+{
+  using namespace std::chrono_literals;
+
+  const auto info = add_robot();
+  const auto& context = info.context;
+
+  const auto now = context->now();
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(now, {0.0, -10.0, 0.0}, {0.0, 0.0, 0.0});
+  trajectory.insert(now + 10s, {0.0, -5.0, 0.0}, {0.0, 0.0, 0.0});
+
+  run_on_worker(context, [&]()
+    {
+      context->delay_threshold(2s);
+      context->itinerary().set({{"test_map", trajectory}});
+    });
+
+  rmf_traffic::schedule::ItineraryVersion initial_version = 0;
+  run_on_worker(context, [&]()
+    {
+      initial_version = context->itinerary().version();
+      for (std::size_t i = 0; i < 3; ++i)
+        context->report_delay(500ms);
+    });
+
+  run_on_worker(context, [&]()
+    {
+      CHECK(context->itinerary().version() == initial_version);
+      CHECK(context->itinerary().delay() == 0s);
+      CHECK(context->cumulative_delay() == 1500ms);
+    });
+
+  WHEN("The delays cancel out")
+  {
+    run_on_worker(context, [&]()
+      {
+        context->report_delay(-1500ms);
+        CHECK(context->itinerary().version() == initial_version);
+        CHECK(context->cumulative_delay() == 0s);
+      });
+  }
+
+  WHEN("The delays reach the threshold")
+  {
+    run_on_worker(context, [&]()
+      {
+        context->report_delay(500ms);
+        CHECK(context->itinerary().version() == initial_version + 1);
+        CHECK(context->itinerary().delay() == 2s);
+        CHECK(context->cumulative_delay() == 2s);
+      });
+  }
+
+  WHEN("The itinerary is replaced")
+  {
+    run_on_worker(context, [&]()
+      {
+        context->itinerary().set({{"test_map", trajectory}});
+        CHECK(context->cumulative_delay() == 0s);
+
+        context->report_delay(500ms);
+        CHECK(context->itinerary().delay() == 0s);
+        CHECK(context->cumulative_delay() == 500ms);
+      });
+  }
+}
+
+//==============================================================================
+SCENARIO_METHOD(
+  rmf_fleet_adapter::phases::test::MockAdapterFixture,
+  "Small delays are published right away if they cause a conflict",
+  "[agv]")
+{
+  using namespace std::chrono_literals;
+
+  const auto info = add_robot();
+  const auto& context = info.context;
+
+  const auto now = context->now();
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(now, {0.0, -10.0, 0.0}, {0.0, 0.0, 0.0});
+  trajectory.insert(now + 10s, {0.0, -5.0, 0.0}, {0.0, 0.0, 0.0});
+
+  // The other robot arrives at the end of our trajectory shortly after we
+  // are scheduled to leave it, so a delay of one second would run into it.
+  const auto other = add_robot("other_robot");
+  rmf_traffic::Trajectory blocking;
+  blocking.insert(now + 10500ms, {0.0, -5.0, 0.0}, {0.0, 0.0, 0.0});
+  blocking.insert(now + 30s, {0.0, -5.0, 0.0}, {0.0, 0.0, 0.0});
+
+  run_on_worker(other.context, [&]()
+    {
+      other.context->itinerary().set({{"test_map", blocking}});
+    });
+
+  run_on_worker(context, [&]()
+    {
+      context->delay_threshold(2s);
+      context->itinerary().set({{"test_map", trajectory}});
+    });
+
+  run_on_worker(context, [&]()
+    {
+      const auto initial_version = context->itinerary().version();
+      context->report_delay(1s);
+
+      CHECK(context->itinerary().version() == initial_version + 1);
+      CHECK(context->itinerary().delay() == 1s);
+      CHECK(context->cumulative_delay() == 1s);
+    });
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "../../src/robot_state_aggregator/RobotStateCoalescer.hpp"
+
+#include <rmf_utils/catch.hpp>
+
+using RobotStateCoalescer = robot_state_aggregator::RobotStateCoalescer;
+using RobotState = RobotStateCoalescer::RobotState;
+
+namespace {
+//==============================================================================
+RobotState::UniquePtr make_robot_state(
+  const std::size_t robot,
+  const int32_t time_ns)
+{
+  auto state = std::make_unique<RobotState>();
+  state->name = "robot_" + std::to_string(robot);
+  state->model = "test_model";
+  state->location.t.nanosec = static_cast<uint32_t>(time_ns);
+  state->location.level_name = "L1";
+  return state;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Robot state coalescing", "[robot_state_aggregator]")
+{
+  RobotStateCoalescer coalescer("robot_", "fleet");
+  CHECK_FALSE(coalescer.take_delta().has_value());
+
+  CHECK(coalescer.update(make_robot_state(0, 10)));
+  CHECK(coalescer.update(make_robot_state(1, 10)));
+  CHECK(coalescer.update(make_robot_state(0, 20)));
+
+  auto not_in_fleet = make_robot_state(2, 30);
+  not_in_fleet->name = "other_2";
+  CHECK_FALSE(coalescer.update(std::move(not_in_fleet)));
+
+  auto delta = coalescer.take_delta();
+  REQUIRE(delta.has_value());
+  CHECK(delta->name == "fleet");
+  CHECK(delta->robots.size() == 2);
+  CHECK_FALSE(coalescer.take_delta().has_value());
+
+  WHEN("An older state arrives")
+  {
+    CHECK_FALSE(coalescer.update(make_robot_state(0, 15)));
+    CHECK_FALSE(coalescer.take_delta().has_value());
+  }
+
+  WHEN("Only one robot is updated")
+  {
+    CHECK(coalescer.update(make_robot_state(1, 30)));
+    delta = coalescer.take_delta();
+    REQUIRE(delta.has_value());
+    REQUIRE(delta->robots.size() == 1);
+    CHECK(delta->robots.front().name == "robot_1");
+
+    const auto snapshot = coalescer.full_snapshot();
+    CHECK(snapshot.robots.size() == 2);
+  }
+}
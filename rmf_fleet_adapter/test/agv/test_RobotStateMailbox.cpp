@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "../phases/MockAdapterFixture.hpp"
+
+#include <agv/RobotStateMailbox.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using RobotStateMailbox = rmf_fleet_adapter::agv::RobotStateMailbox;
+
+namespace {
+//==============================================================================
+RobotStateMailbox::Position make_position(const std::size_t waypoint)
+{
+  const auto now = std::chrono::steady_clock::now();
+  return {now, {{now, waypoint, 0.0}}, rmf_utils::nullopt};
+}
+
+//==============================================================================
+/// Wait until every job that was scheduled on the worker so far has finished
+void wait_for_worker(const rxcpp::schedulers::worker& worker)
+{
+  std::promise<void> finished;
+  worker.schedule([&finished](const auto&) { finished.set_value(); });
+  finished.get_future().wait();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Robot state mailbox keeps only the newest updates")
+{
+  RobotStateMailbox mailbox;
+
+  // The first post of either kind asks for a job
+  CHECK(mailbox.post(make_position(0)));
+  CHECK_FALSE(mailbox.post(make_position(1)));
+  CHECK_FALSE(mailbox.post_battery_soc(0.5));
+  CHECK_FALSE(mailbox.post_battery_soc(0.4));
+
+  auto contents = mailbox.take();
+  REQUIRE(contents.position);
+  REQUIRE(contents.position->starts.size() == 1);
+  CHECK(contents.position->starts.front().waypoint() == 1);
+  REQUIRE(contents.battery_soc);
+  CHECK(*contents.battery_soc == Approx(0.4));
+
+  auto stats = mailbox.stats();
+  CHECK(stats.received == 4);
+  CHECK(stats.applied == 2);
+  CHECK(stats.dropped == 2);
+  CHECK(stats.coalesced == 3);
+
+  // Once the contents are taken, the next post needs a new job
+  contents = mailbox.take();
+  CHECK_FALSE(contents.position);
+  CHECK_FALSE(contents.battery_soc);
+  CHECK(mailbox.post_battery_soc(0.3));
+  contents = mailbox.take();
+  CHECK_FALSE(contents.position);
+  REQUIRE(contents.battery_soc);
+  CHECK(*contents.battery_soc == Approx(0.3));
+
+  stats = mailbox.stats();
+  CHECK(stats.received == 5);
+  CHECK(stats.applied == 3);
+}
+
+//==============================================================================
+SCENARIO("Robot state mailbox under concurrent posts")
+{
+  RobotStateMailbox mailbox;
+  const std::size_t num_threads = 4;
+  const std::size_t posts_per_thread = 5000;
+
+  std::atomic_bool posting(true);
+  std::atomic_size_t jobs_requested(0);
+  std::atomic_size_t jobs_run(0);
+
+  // A slow consumer, which takes from the mailbox whenever a job has been
+  // requested.
+  std::thread consumer(
+    [&]()
+    {
+      while (posting || jobs_run < jobs_requested)
+      {
+        if (jobs_run < jobs_requested)
+        {
+          mailbox.take();
+          ++jobs_run;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+
+  std::vector<std::thread> producers;
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    producers.emplace_back(
+      [&, i]()
+      {
+        for (std::size_t j = 0; j < posts_per_thread; ++j)
+        {
+          const bool scheduled = (j % 2 == 0) ?
+            mailbox.post(make_position(i)) :
+            mailbox.post_battery_soc(static_cast<double>(j)/posts_per_thread);
+
+          if (scheduled)
+            ++jobs_requested;
+        }
+      });
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  posting = false;
+  consumer.join();
+
+  const auto stats = mailbox.stats();
+  const std::size_t total = num_threads * posts_per_thread;
+  CHECK(stats.received == total);
+  CHECK(stats.received == stats.applied + stats.dropped);
+  CHECK(stats.received == stats.coalesced + jobs_requested);
+
+  // The consumer is much slower than the producers, so most of the updates
+  // should have been dropped instead of applied.
+  CHECK(stats.applied < total/2);
+}
+
+//==============================================================================
+SCENARIO_METHOD(
+  rmf_fleet_adapter::phases::test::MockAdapterFixture,
+  "Robot updates are coalesced while the worker is busy",
+  "[agv]")
+{
+  const auto info = add_robot();
+  const auto& context = info.context;
+  const auto updater = info.command->updater;
+  REQUIRE(updater);
+
+  const auto initial_stats = updater->unstable().update_stats();
+
+  // Keep the worker busy while the updates arrive
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  context->worker().schedule([released](const auto&) { released.wait(); });
+
+  const std::size_t num_threads = 4;
+  const std::size_t posts_per_thread = 1000;
+  std::vector<std::thread> producers;
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    producers.emplace_back(
+      [&, i]()
+      {
+        for (std::size_t j = 0; j < posts_per_thread; ++j)
+        {
+          updater->update_position(i % 3, 0.0);
+          updater->update_battery_soc(0.5);
+        }
+      });
+  }
+
+  for (auto& producer : producers)
+    producer.join();
+
+  // These are the newest updates, so they are the ones that should be applied
+  updater->update_position(9, 1.0);
+  updater->update_battery_soc(0.25);
+
+  release.set_value();
+  wait_for_worker(context->worker());
+
+  REQUIRE(context->location().size() == 1);
+  CHECK(context->location().front().waypoint() == 9);
+  CHECK(context->location().front().orientation() == Approx(1.0));
+  CHECK(context->current_battery_soc() == Approx(0.25));
+
+  const auto stats = updater->unstable().update_stats();
+  const std::size_t total = 2*(num_threads * posts_per_thread + 1);
+  CHECK(stats.received - initial_stats.received == total);
+  CHECK(stats.applied - initial_stats.applied == 2);
+  CHECK(stats.dropped - initial_stats.dropped == total - 2);
+  CHECK(stats.coalesced - initial_stats.coalesced == total - 1);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "../../src/robot_state_aggregator/RobotStateCoalescer.hpp"
+
+#include <rclcpp/serialization.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+using RobotStateCoalescer = robot_state_aggregator::RobotStateCoalescer;
+using RobotState = RobotStateCoalescer::RobotState;
+using FleetState = RobotStateCoalescer::FleetState;
+
+namespace {
+//==============================================================================
+RobotState::UniquePtr make_robot_state(
+  const std::size_t robot,
+  const int64_t time_ns,
+  const std::size_t path_length)
+{
+  auto state = std::make_unique<RobotState>();
+  state->name = "robot_" + std::to_string(robot);
+  state->model = "benchmark_model";
+  state->task_id = "task_" + std::to_string(robot);
+  state->battery_percent = 100.0;
+  state->location.t.sec = static_cast<int32_t>(time_ns / 1000000000);
+  state->location.t.nanosec = static_cast<uint32_t>(time_ns % 1000000000);
+  state->location.x = static_cast<float>(robot);
+  state->location.level_name = "L1";
+  state->path.resize(path_length, state->location);
+  return state;
+}
+
+//==============================================================================
+std::size_t serialized_size(const FleetState& msg)
+{
+  static const rclcpp::Serialization<FleetState> serializer;
+  rclcpp::SerializedMessage serialized;
+  serializer.serialize_message(&msg, &serialized);
+  return serialized.size();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Benchmark robot state aggregator bandwidth", "[.benchmark]")
+{
+  // Replay 100 robots that each report their state at 5Hz with a path of 10
+  // waypoints, and measure how many bytes the aggregator would publish for
+  // each mode. The robots report at evenly staggered times, which is the worst
+  // case for publishing the whole fleet on every update.
+  const std::size_t num_robots = 100;
+  const std::size_t path_length = 10;
+  const double robot_rate = 5.0;
+  const double duration = 10.0;
+  const double snapshot_period = 1.0;
+
+  const int64_t robot_period_ns = static_cast<int64_t>(1e9/robot_rate);
+  const int64_t duration_ns = static_cast<int64_t>(duration*1e9);
+  const int64_t stagger_ns = robot_period_ns / num_robots;
+  const int64_t snapshot_period_ns = static_cast<int64_t>(snapshot_period*1e9);
+
+  std::cout << std::setw(16) << "publish [Hz]"
+            << std::setw(12) << "msgs/s"
+            << std::setw(16) << "robots/s"
+            << std::setw(16) << "KB/s" << std::endl;
+
+  double legacy_bytes_per_second = 0.0;
+  for (const double publish_rate : {0.0, 1.0, 2.0, 5.0, 10.0})
+  {
+    RobotStateCoalescer coalescer("robot_", "fleet");
+    const int64_t publish_period_ns = publish_rate > 0.0 ?
+      static_cast<int64_t>(1e9/publish_rate) : 0;
+
+    std::size_t messages = 0;
+    std::size_t robots = 0;
+    std::size_t bytes = 0;
+    const auto publish = [&](const FleetState& msg)
+      {
+        ++messages;
+        robots += msg.robots.size();
+        bytes += serialized_size(msg);
+      };
+
+    int64_t next_publish = publish_period_ns;
+    int64_t next_snapshot = snapshot_period_ns;
+    for (int64_t t = 0; t < duration_ns; t += stagger_ns)
+    {
+      const std::size_t robot = (t / stagger_ns) % num_robots;
+      coalescer.update(make_robot_state(robot, t, path_length));
+
+      if (publish_rate == 0.0)
+      {
+        coalescer.clear_delta();
+        publish(coalescer.full_snapshot());
+        continue;
+      }
+
+      if (t >= next_publish)
+      {
+        if (const auto delta = coalescer.take_delta())
+          publish(*delta);
+
+        next_publish += publish_period_ns;
+      }
+
+      if (t >= next_snapshot)
+      {
+        publish(coalescer.full_snapshot());
+        next_snapshot += snapshot_period_ns;
+      }
+    }
+
+    const double bytes_per_second = bytes/duration;
+    if (publish_rate == 0.0)
+      legacy_bytes_per_second = bytes_per_second;
+    else
+      CHECK(bytes_per_second < legacy_bytes_per_second);
+
+    std::cout << std::setw(16)
+              << (publish_rate == 0.0 ? std::string("every update") :
+                    std::to_string(publish_rate))
+              << std::setw(12) << messages/duration
+              << std::setw(16) << robots/duration
+              << std::setw(16) << bytes_per_second/1000.0 << std::endl;
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <jobs/PlanningScheduler.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace std::chrono_literals;
+using PlanningScheduler = rmf_fleet_adapter::jobs::PlanningScheduler;
+using Priority = PlanningScheduler::Priority;
+
+//==============================================================================
+TEST_CASE("Planning jobs are run in order of priority", "[PlanningScheduler]")
+{
+  const auto scheduler = PlanningScheduler::make(1);
+  REQUIRE(scheduler->max_concurrency() == 1);
+
+  // Occupy the only thread until every job has been queued up
+  std::promise<void> release_promise;
+  auto release = release_promise.get_future().share();
+  std::promise<void> blocking_promise;
+  scheduler->make_worker(Priority::Bid).schedule(
+    [release, &blocking_promise](const auto&)
+    {
+      blocking_promise.set_value();
+      release.wait();
+    });
+  blocking_promise.get_future().wait();
+
+  const std::vector<Priority> priorities = {
+    Priority::Bid,
+    Priority::Routine,
+    Priority::Emergency,
+    Priority::Negotiation,
+    Priority::Routine,
+    Priority::Bid
+  };
+
+  std::mutex order_mutex;
+  std::vector<Priority> order;
+  std::promise<void> done;
+  std::atomic_size_t remaining{priorities.size()};
+  std::vector<rxcpp::schedulers::worker> workers;
+  for (const auto p : priorities)
+  {
+    workers.push_back(scheduler->make_worker(p));
+    workers.back().schedule(
+      [p, &order_mutex, &order, &remaining, &done](const auto&)
+      {
+        {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(p);
+        }
+
+        if (--remaining == 0)
+          done.set_value();
+      });
+  }
+
+  release_promise.set_value();
+  REQUIRE(done.get_future().wait_for(5s) == std::future_status::ready);
+
+  const std::vector<Priority> expected = {
+    Priority::Emergency,
+    Priority::Negotiation,
+    Priority::Routine,
+    Priority::Routine,
+    Priority::Bid,
+    Priority::Bid
+  };
+
+  CHECK(order == expected);
+}
+
+//==============================================================================
+TEST_CASE("Planning jobs respect the concurrency limit", "[PlanningScheduler]")
+{
+  const std::size_t max_concurrency = 2;
+  const auto scheduler = PlanningScheduler::make(max_concurrency);
+  REQUIRE(scheduler->max_concurrency() == max_concurrency);
+
+  const std::size_t N = 12;
+  std::atomic_size_t running{0};
+  std::atomic_size_t most_running{0};
+  std::atomic_size_t remaining{N};
+  std::promise<void> done;
+
+  std::vector<rxcpp::schedulers::worker> workers;
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    // Each job gets its own worker so that nothing but the scheduler itself
+    // is keeping the jobs from running in parallel.
+    workers.push_back(scheduler->make_worker(
+        static_cast<Priority>(i % PlanningScheduler::NumPriorities)));
+
+    workers.back().schedule(
+      [&](const auto&)
+      {
+        const std::size_t now_running = ++running;
+        std::size_t previous = most_running;
+        while (previous < now_running
+               && !most_running.compare_exchange_weak(previous, now_running))
+        {
+          // Keep trying until the maximum is updated
+        }
+
+        std::this_thread::sleep_for(5ms);
+        --running;
+
+        if (--remaining == 0)
+          done.set_value();
+      });
+  }
+
+  REQUIRE(done.get_future().wait_for(5s) == std::future_status::ready);
+  CHECK(most_running <= max_concurrency);
+  CHECK(most_running > 0);
+}
+
+//==============================================================================
+TEST_CASE("Planning metrics are tracked per priority", "[PlanningScheduler]")
+{
+  const auto scheduler = PlanningScheduler::make(1, 10ms);
+  CHECK(scheduler->time_slice() == 10ms);
+
+  scheduler->record(Priority::Negotiation, 2ms, 10ms, true, false);
+  scheduler->record(Priority::Negotiation, 5ms, 3ms, false, true);
+  scheduler->record(Priority::Bid, 1ms, 4ms, false, true);
+
+  const auto metrics = scheduler->metrics();
+
+  const auto& negotiation =
+    metrics[static_cast<std::size_t>(Priority::Negotiation)];
+  CHECK(negotiation.slices == 2);
+  CHECK(negotiation.yields == 1);
+  CHECK(negotiation.completed == 1);
+  CHECK(negotiation.busy_time == 13ms);
+  CHECK(negotiation.wait_time == 7ms);
+  CHECK(negotiation.max_wait_time == 5ms);
+
+  const auto& bid = metrics[static_cast<std::size_t>(Priority::Bid)];
+  CHECK(bid.slices == 1);
+  CHECK(bid.yields == 0);
+  CHECK(bid.completed == 1);
+
+  const auto& routine = metrics[static_cast<std::size_t>(Priority::Routine)];
+  CHECK(routine.slices == 0);
+}
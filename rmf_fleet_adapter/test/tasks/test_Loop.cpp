@@ -21,6 +21,7 @@
 #include <rmf_traffic/schedule/Database.hpp>
 
 #include <rmf_fleet_adapter/agv/test/MockAdapter.hpp>
+#include <agv/internal_FleetUpdateHandle.hpp>
 #include <rmf_fleet_adapter/StandardNames.hpp>
 
 #include <rmf_traffic_ros2/Time.hpp>
@@ -216,6 +217,16 @@ SCENARIO("Test loop requests")
   const std::string fleet_type = "test_fleet";
   const auto fleet = adapter.add_fleet(fleet_type, traits, graph);
 
+  // Run the scenario a second time with a strand pool, so that each robot's
+  // task manager gets driven from its own strand while the fleet keeps
+  // bidding and dispatching from the executor.
+  const bool use_strand_pool = GENERATE(false, true);
+  if (use_strand_pool)
+  {
+    rmf_fleet_adapter::agv::FleetUpdateHandle::Implementation::get(*fleet)
+      .node->strands(rmf_rxcpp::StrandPool::make(4));
+  }
+
   // Configure default battery param
   using BatterySystem = rmf_battery::agv::BatterySystem;
   using PowerSystem = rmf_battery::agv::PowerSystem;
@@ -32,6 +32,7 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <optional>
 #include <variant>
 
 namespace rmf_task {
@@ -194,6 +195,47 @@ public:
     std::vector<ConstRequestPtr> requests,
     std::function<bool()> interrupter);
 
+  /// Get assignments that accommodate new requests by inserting them into the
+  /// assignments that are already queued up for the agents. Those assignments
+  /// are usually close to optimal already, so this is much faster than
+  /// planning for every request from scratch, which makes it well suited for
+  /// bidding.
+  ///
+  /// Each new request is inserted wherever it raises the cost the least. Then
+  /// a new request is swapped with a request of another agent for as long as
+  /// that lowers the cost, up to max_swaps times. The requests that are
+  /// already queued never move, so if their order has become poor, the
+  /// inserted assignments can cost more than planning from scratch. The result
+  /// of greedy_plan() for every request is therefore computed as well, and the
+  /// cheaper of the two is returned, unless the inserted assignments cost no
+  /// more than cost_bound. If a new request cannot be inserted anywhere, the
+  /// result of greedy_plan() is returned.
+  ///
+  /// \param[in] current_assignments
+  ///   The assignments that are currently queued up for each agent. Only the
+  ///   order of their requests is used, and their charging tasks are ignored.
+  ///   This should have one entry for each of the initial_states, otherwise
+  ///   the result of greedy_plan() will be returned.
+  ///
+  /// \param[in] new_requests
+  ///   The requests to insert into the assignments
+  ///
+  /// \param[in] max_swaps
+  ///   The maximum number of swaps to perform after the insertions
+  ///
+  /// \param[in] cost_bound
+  ///   If the inserted assignments cost no more than this, they are accepted
+  ///   without computing the result of greedy_plan(). Leave this as a nullopt
+  ///   to always compare against the result of greedy_plan().
+  Result incremental_plan(
+    rmf_traffic::Time time_now,
+    std::vector<State> initial_states,
+    std::vector<Constraints> constraints_set,
+    const Assignments& current_assignments,
+    std::vector<ConstRequestPtr> new_requests,
+    std::size_t max_swaps = 10,
+    std::optional<double> cost_bound = std::nullopt);
+
   /// Compute the cost of a set of assignments
   double compute_cost(const Assignments& assignments) const;
 
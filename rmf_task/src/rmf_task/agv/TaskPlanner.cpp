@@ -953,7 +953,294 @@ public:
 
     return nullptr;
   }
-  
+
+  static bool is_charging(const ConstRequestPtr& request)
+  {
+    return static_cast<bool>(std::dynamic_pointer_cast<
+      const rmf_task::requests::ChargeBatteryDescription>(
+        request->description()));
+  }
+
+  // A high priority request may not follow a low priority one in the queue of
+  // an agent
+  static bool valid_priority_order(const std::vector<ConstRequestPtr>& queue)
+  {
+    bool low_priority_seen = false;
+    for (const auto& request : queue)
+    {
+      if (!request->priority())
+        low_priority_seen = true;
+      else if (low_priority_seen)
+        return false;
+    }
+
+    return true;
+  }
+
+  // Estimate the assignments of an agent that executes a queue of requests in
+  // order. A charging task is inserted wherever the battery would not last
+  // through the next request. Returns a nullopt if the queue is not feasible.
+  std::optional<std::vector<Assignment>> estimate_queue(
+    const State& initial_state,
+    const Constraints& constraints,
+    const std::vector<ConstRequestPtr>& queue)
+  {
+    std::vector<Assignment> assignments;
+    assignments.reserve(queue.size());
+    State state = initial_state;
+    for (const auto& request : queue)
+    {
+      auto estimate = request->description()->estimate_finish(
+        state, constraints, estimate_cache);
+
+      if (!estimate.has_value())
+      {
+        if (!assignments.empty() && is_charging(assignments.back().request()))
+          return std::nullopt;
+
+        auto charge_battery = make_charging_request(state.finish_time());
+        const auto battery_estimate =
+          charge_battery->description()->estimate_finish(
+            state, constraints, estimate_cache);
+        if (!battery_estimate.has_value())
+          return std::nullopt;
+
+        assignments.push_back(
+          Assignment
+          {
+            charge_battery,
+            battery_estimate.value().finish_state(),
+            battery_estimate.value().wait_until()
+          });
+        state = battery_estimate.value().finish_state();
+
+        estimate = request->description()->estimate_finish(
+          state, constraints, estimate_cache);
+        if (!estimate.has_value())
+          return std::nullopt;
+      }
+
+      assignments.push_back(
+        Assignment
+        {
+          request,
+          estimate.value().finish_state(),
+          estimate.value().wait_until()
+        });
+      state = estimate.value().finish_state();
+    }
+
+    return assignments;
+  }
+
+  double queue_cost(const std::vector<Assignment>& assignments)
+  {
+    return cost_calculator->compute_cost(Assignments{assignments});
+  }
+
+  Result incremental_solve(
+    rmf_traffic::Time time_now,
+    const std::vector<State>& initial_states,
+    const std::vector<Constraints>& constraints_set,
+    const Assignments& current_assignments,
+    const std::vector<ConstRequestPtr>& new_requests,
+    const std::size_t max_swaps,
+    const std::optional<double> cost_bound)
+  {
+    assert(initial_states.size() == constraints_set.size());
+    const std::size_t num_agents = initial_states.size();
+    const bool warm_start = current_assignments.size() == num_agents;
+
+    std::vector<std::vector<ConstRequestPtr>> queues(num_agents);
+    std::vector<ConstRequestPtr> all_requests;
+    for (std::size_t i = 0; i < current_assignments.size(); ++i)
+    {
+      for (const auto& a : current_assignments[i])
+      {
+        if (is_charging(a.request()))
+          continue;
+
+        all_requests.push_back(a.request());
+        if (warm_start)
+          queues[i].push_back(a.request());
+      }
+    }
+    all_requests.insert(
+      all_requests.end(), new_requests.begin(), new_requests.end());
+
+    // We only plan for every request from scratch when the warm start is not
+    // possible, fails, or is too costly.
+    const auto greedy_solve_all = [&]() -> Result
+      {
+        auto greedy_states = initial_states;
+        return complete_solve(
+          time_now, greedy_states, constraints_set, all_requests, nullptr,
+          true);
+      };
+
+    if (!warm_start)
+      return greedy_solve_all();
+
+    cost_calculator = config->cost_calculator() ? config->cost_calculator() :
+      rmf_task::BinaryPriorityScheme::make_cost_calculator();
+
+    std::vector<std::vector<Assignment>> estimates(num_agents);
+    std::vector<double> costs(num_agents);
+    for (std::size_t i = 0; i < num_agents; ++i)
+    {
+      auto estimate = estimate_queue(
+        initial_states[i], constraints_set[i], queues[i]);
+      if (!estimate.has_value())
+        return greedy_solve_all();
+
+      costs[i] = queue_cost(*estimate);
+      estimates[i] = std::move(*estimate);
+    }
+
+    struct Change
+    {
+      double delta;
+      std::size_t agent;
+      std::vector<ConstRequestPtr> queue;
+      std::vector<Assignment> estimate;
+      double cost;
+    };
+
+    // Insert each new request wherever it raises the cost the least
+    for (const auto& request : new_requests)
+    {
+      std::optional<Change> best;
+      for (std::size_t i = 0; i < num_agents; ++i)
+      {
+        for (std::size_t p = 0; p <= queues[i].size(); ++p)
+        {
+          auto queue = queues[i];
+          queue.insert(queue.begin() + p, request);
+          if (!valid_priority_order(queue))
+            continue;
+
+          auto estimate = estimate_queue(
+            initial_states[i], constraints_set[i], queue);
+          if (!estimate.has_value())
+            continue;
+
+          const double cost = queue_cost(*estimate);
+          const double delta = cost - costs[i];
+          if (!best || delta < best->delta)
+          {
+            best = Change{
+              delta, i, std::move(queue), std::move(*estimate), cost};
+          }
+        }
+      }
+
+      if (!best)
+        return greedy_solve_all();
+
+      queues[best->agent] = std::move(best->queue);
+      estimates[best->agent] = std::move(best->estimate);
+      costs[best->agent] = best->cost;
+    }
+
+    // Swap a new request with a request of another agent for as long as that
+    // keeps lowering the cost, up to max_swaps times
+    const auto locate = [&](const ConstRequestPtr& request)
+      -> std::pair<std::size_t, std::size_t>
+      {
+        for (std::size_t i = 0; i < num_agents; ++i)
+        {
+          for (std::size_t p = 0; p < queues[i].size(); ++p)
+          {
+            if (queues[i][p] == request)
+              return {i, p};
+          }
+        }
+
+        return {num_agents, 0};
+      };
+
+    for (std::size_t swap = 0; swap < max_swaps; ++swap)
+    {
+      std::optional<std::pair<Change, Change>> best;
+      for (const auto& request : new_requests)
+      {
+        const auto [a, p] = locate(request);
+        if (a >= num_agents)
+          continue;
+
+        for (std::size_t b = 0; b < num_agents; ++b)
+        {
+          if (b == a)
+            continue;
+
+          for (std::size_t q = 0; q < queues[b].size(); ++q)
+          {
+            const auto& other = queues[b][q];
+            if (static_cast<bool>(other->priority())
+              != static_cast<bool>(request->priority()))
+              continue;
+
+            auto queue_a = queues[a];
+            auto queue_b = queues[b];
+            queue_a[p] = other;
+            queue_b[q] = request;
+
+            auto estimate_a = estimate_queue(
+              initial_states[a], constraints_set[a], queue_a);
+            if (!estimate_a.has_value())
+              continue;
+
+            auto estimate_b = estimate_queue(
+              initial_states[b], constraints_set[b], queue_b);
+            if (!estimate_b.has_value())
+              continue;
+
+            const double cost_a = queue_cost(*estimate_a);
+            const double cost_b = queue_cost(*estimate_b);
+            const double delta = cost_a + cost_b - costs[a] - costs[b];
+            if (delta < -1e-6 && (!best || delta < best->first.delta))
+            {
+              best = std::make_pair(
+                Change{delta, a, std::move(queue_a),
+                  std::move(*estimate_a), cost_a},
+                Change{delta, b, std::move(queue_b),
+                  std::move(*estimate_b), cost_b});
+            }
+          }
+        }
+      }
+
+      if (!best)
+        break;
+
+      for (auto* change : {&best->first, &best->second})
+      {
+        queues[change->agent] = std::move(change->queue);
+        estimates[change->agent] = std::move(change->estimate);
+        costs[change->agent] = change->cost;
+      }
+    }
+
+    // The queued requests were never moved, so if their order has become
+    // poor, planning from scratch may do better.
+    Assignments assignments = std::move(estimates);
+    const double cost = compute_cost(assignments);
+    if (cost_bound.has_value() && cost <= *cost_bound)
+      return assignments;
+
+    auto greedy_result = greedy_solve_all();
+    const auto* greedy = std::get_if<Assignments>(&greedy_result);
+    if (greedy && !greedy->empty() && compute_cost(*greedy) < cost)
+      return greedy_result;
+
+    return assignments;
+  }
+
+  double compute_cost(const Assignments& assignments) const
+  {
+    return cost_calculator->compute_cost(assignments);
+  }
+
 };
 
 // ============================================================================
@@ -1001,6 +1288,26 @@ auto TaskPlanner::optimal_plan(
     false);
 }
 
+// ============================================================================
+auto TaskPlanner::incremental_plan(
+  rmf_traffic::Time time_now,
+  std::vector<State> initial_states,
+  std::vector<Constraints> constraints_set,
+  const Assignments& current_assignments,
+  std::vector<ConstRequestPtr> new_requests,
+  const std::size_t max_swaps,
+  const std::optional<double> cost_bound) -> Result
+{
+  return _pimpl->incremental_solve(
+    time_now,
+    initial_states,
+    constraints_set,
+    current_assignments,
+    new_requests,
+    max_swaps,
+    cost_bound);
+}
+
 // ============================================================================
 auto TaskPlanner::compute_cost(const Assignments& assignments) const -> double
 {
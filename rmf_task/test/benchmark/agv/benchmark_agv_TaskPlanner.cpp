@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_task/agv/TaskPlanner.hpp>
+#include <rmf_task/agv/State.hpp>
+#include <rmf_task/agv/Constraints.hpp>
+#include <rmf_task/requests/Delivery.hpp>
+
+#include <rmf_task/BinaryPriorityScheme.hpp>
+
+#include <rmf_traffic/agv/Graph.hpp>
+#include <rmf_traffic/agv/Planner.hpp>
+#include <rmf_traffic/geometry/Circle.hpp>
+
+#include <rmf_battery/agv/SimpleDevicePowerSink.hpp>
+#include <rmf_battery/agv/SimpleMotionPowerSink.hpp>
+#include <rmf_battery/agv/BatterySystem.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+using TaskPlanner = rmf_task::agv::TaskPlanner;
+
+namespace {
+
+//==============================================================================
+/// Four robots in the corners of a 4x4 grid, and a burst of delivery requests
+/// between random waypoints of the grid
+struct BenchmarkSetup
+{
+  std::shared_ptr<rmf_battery::agv::SimpleMotionPowerSink> motion_sink;
+  std::shared_ptr<rmf_battery::agv::SimpleDevicePowerSink> device_sink;
+  std::shared_ptr<rmf_traffic::agv::Planner> planner;
+  std::shared_ptr<TaskPlanner::Configuration> task_config;
+  rmf_traffic::Time now;
+  std::vector<rmf_task::agv::State> initial_states;
+  std::vector<rmf_task::agv::Constraints> constraints;
+  std::vector<rmf_task::ConstRequestPtr> burst;
+};
+
+//==============================================================================
+BenchmarkSetup make_setup(const std::size_t num_tasks)
+{
+  const int grid_size = 4;
+  const double edge_length = 1000;
+  const bool drain_battery = false;
+
+  using BatterySystem = rmf_battery::agv::BatterySystem;
+  using MechanicalSystem = rmf_battery::agv::MechanicalSystem;
+  using PowerSystem = rmf_battery::agv::PowerSystem;
+  using SimpleMotionPowerSink = rmf_battery::agv::SimpleMotionPowerSink;
+  using SimpleDevicePowerSink = rmf_battery::agv::SimpleDevicePowerSink;
+
+  rmf_traffic::agv::Graph graph;
+  const std::string map_name = "test_map";
+  for (int i = 0; i < grid_size; ++i)
+  {
+    for (int j = 0; j < grid_size; ++j)
+      graph.add_waypoint(map_name, {j*edge_length, -i*edge_length});
+  }
+
+  for (int i = 0; i < grid_size*grid_size; ++i)
+  {
+    if ((i+1) % grid_size != 0)
+    {
+      graph.add_lane(i, i+1);
+      graph.add_lane(i+1, i);
+    }
+
+    if (i + grid_size < grid_size*grid_size)
+    {
+      graph.add_lane(i, i+grid_size);
+      graph.add_lane(i+grid_size, i);
+    }
+  }
+
+  const auto shape = rmf_traffic::geometry::make_final_convex<
+    rmf_traffic::geometry::Circle>(1.0);
+  const rmf_traffic::Profile profile{shape, shape};
+  const rmf_traffic::agv::VehicleTraits traits(
+    {1.0, 0.7}, {0.6, 0.5}, profile);
+
+  BenchmarkSetup setup;
+  setup.planner = std::make_shared<rmf_traffic::agv::Planner>(
+    rmf_traffic::agv::Planner::Configuration{graph, traits},
+    rmf_traffic::agv::Planner::Options{nullptr});
+
+  auto battery_system = *BatterySystem::make(24.0, 40.0, 8.8);
+  auto mechanical_system = *MechanicalSystem::make(70.0, 40.0, 0.22);
+  auto power_system = *PowerSystem::make(20.0);
+
+  setup.motion_sink =
+    std::make_shared<SimpleMotionPowerSink>(battery_system, mechanical_system);
+  setup.device_sink =
+    std::make_shared<SimpleDevicePowerSink>(battery_system, power_system);
+
+  setup.task_config = std::make_shared<TaskPlanner::Configuration>(
+    battery_system,
+    setup.motion_sink,
+    setup.device_sink,
+    setup.planner,
+    rmf_task::BinaryPriorityScheme::make_cost_calculator());
+
+  setup.now = std::chrono::steady_clock::now();
+  for (const std::size_t wp : {0, 3, 12, 15})
+  {
+    setup.initial_states.push_back(
+      rmf_task::agv::State{
+        rmf_traffic::agv::Plan::Start{setup.now, wp, 0.0}, wp, 1.0});
+    setup.constraints.push_back(rmf_task::agv::Constraints{0.2});
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<std::size_t> waypoint(
+    0, grid_size*grid_size - 1);
+  for (std::size_t i = 0; i < num_tasks; ++i)
+  {
+    const std::size_t pickup = waypoint(rng);
+    std::size_t dropoff = waypoint(rng);
+    while (dropoff == pickup)
+      dropoff = waypoint(rng);
+
+    setup.burst.push_back(
+      rmf_task::requests::Delivery::make(
+        std::to_string(i),
+        pickup,
+        "dispenser",
+        dropoff,
+        "ingestor",
+        {},
+        setup.motion_sink,
+        setup.device_sink,
+        setup.planner,
+        setup.now,
+        drain_battery));
+  }
+
+  return setup;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Benchmark bidding for a burst of 200 tasks", "[.benchmark]")
+{
+  // A fleet adapter that bids for each task of a burst separately will plan
+  // once per task, and each of those plans includes every task of the burst
+  // that it has already been awarded. When the burst is offered in batches,
+  // the fleet adapter only needs to plan once per batch.
+  //
+  // The fleet adapter normally bids with the optimal planner, but that is not
+  // practical for queues this long, so both replays use the greedy planner.
+  const std::size_t num_tasks = 200;
+  using Clock = std::chrono::steady_clock;
+
+  const auto setup = make_setup(num_tasks);
+  const auto& task_config = setup.task_config;
+  const auto& now = setup.now;
+  const auto& initial_states = setup.initial_states;
+  const auto& constraints = setup.constraints;
+  const auto& burst = setup.burst;
+
+  std::cout << std::setw(12) << "batch size"
+            << std::setw(10) << "plans"
+            << std::setw(14) << "total [ms]"
+            << std::setw(14) << "per task [ms]"
+            << std::setw(14) << "final cost" << std::endl;
+
+  for (const std::size_t batch_size : {1, 10, 50, 200})
+  {
+    // Use a fresh task planner so that each replay starts with a cold cache
+    TaskPlanner task_planner(task_config);
+
+    std::size_t plans = 0;
+    double final_cost = 0.0;
+    const auto start = Clock::now();
+    for (std::size_t end = 0; end < num_tasks; )
+    {
+      end = std::min(end + batch_size, num_tasks);
+      const std::vector<rmf_task::ConstRequestPtr> requests(
+        burst.begin(), burst.begin() + end);
+
+      const auto result = task_planner.greedy_plan(
+        now, initial_states, constraints, requests);
+      ++plans;
+
+      const auto* assignments = std::get_if<TaskPlanner::Assignments>(&result);
+      REQUIRE(assignments);
+      final_cost = task_planner.compute_cost(*assignments);
+    }
+    const double total = std::chrono::duration_cast<
+      std::chrono::duration<double, std::milli>>(Clock::now() - start).count();
+
+    std::cout << std::setw(12) << batch_size
+              << std::setw(10) << plans
+              << std::setw(14) << total
+              << std::setw(14) << total/num_tasks
+              << std::setw(14) << final_cost << std::endl;
+
+    CHECK(plans == (num_tasks + batch_size - 1)/batch_size);
+  }
+}
+
+//==============================================================================
+SCENARIO("Benchmark incremental planning against greedy planning",
+  "[.benchmark]")
+{
+  // A fleet that already has N-1 tasks queued up bids for one more task. The
+  // greedy planner plans for all N tasks from scratch, while the incremental
+  // planner inserts the new task into the queues that the fleet already has.
+  using Clock = std::chrono::steady_clock;
+  const auto to_ms = [](const Clock::duration d)
+    {
+      return std::chrono::duration_cast<
+        std::chrono::duration<double, std::milli>>(d).count();
+    };
+
+  const std::vector<std::size_t> queue_sizes = {10, 25, 50, 100, 200};
+  const auto setup = make_setup(queue_sizes.back());
+
+  std::cout << std::setw(8) << "N"
+            << std::setw(14) << "greedy [ms]"
+            << std::setw(18) << "incremental [ms]"
+            << std::setw(14) << "greedy cost"
+            << std::setw(18) << "incremental cost" << std::endl;
+
+  for (const std::size_t n : queue_sizes)
+  {
+    const std::vector<rmf_task::ConstRequestPtr> old_requests(
+      setup.burst.begin(), setup.burst.begin() + n - 1);
+    const std::vector<rmf_task::ConstRequestPtr> all_requests(
+      setup.burst.begin(), setup.burst.begin() + n);
+    const std::vector<rmf_task::ConstRequestPtr> new_requests = {
+      setup.burst[n-1]
+    };
+
+    TaskPlanner task_planner(setup.task_config);
+    const auto current_result = task_planner.greedy_plan(
+      setup.now, setup.initial_states, setup.constraints, old_requests);
+    const auto* current = std::get_if<TaskPlanner::Assignments>(
+      &current_result);
+    REQUIRE(current);
+
+    // Both planners now share a warm estimate cache
+    const auto greedy_start = Clock::now();
+    const auto greedy_result = task_planner.greedy_plan(
+      setup.now, setup.initial_states, setup.constraints, all_requests);
+    const double greedy_time = to_ms(Clock::now() - greedy_start);
+
+    // Without a cost bound, the incremental planner would also compute the
+    // greedy result to compare against, so we only time the insertion here.
+    const auto incremental_start = Clock::now();
+    const auto incremental_result = task_planner.incremental_plan(
+      setup.now, setup.initial_states, setup.constraints, *current,
+      new_requests, 10, std::numeric_limits<double>::infinity());
+    const double incremental_time = to_ms(Clock::now() - incremental_start);
+
+    const auto* greedy = std::get_if<TaskPlanner::Assignments>(&greedy_result);
+    const auto* incremental =
+      std::get_if<TaskPlanner::Assignments>(&incremental_result);
+    REQUIRE(greedy);
+    REQUIRE(incremental);
+
+    std::cout << std::setw(8) << n
+              << std::setw(14) << greedy_time
+              << std::setw(18) << incremental_time
+              << std::setw(14) << task_planner.compute_cost(*greedy)
+              << std::setw(18) << task_planner.compute_cost(*incremental)
+              << std::endl;
+  }
+}
@@ -40,7 +40,9 @@
 
 #include <rmf_utils/catch.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 
 using TaskPlanner = rmf_task::agv::TaskPlanner;
 
@@ -1744,4 +1746,166 @@ SCENARIO("Grid World")
     }
   }
 
+  WHEN("Inserting new requests into existing assignments")
+  {
+    const auto now = std::chrono::steady_clock::now();
+    const double default_orientation = 0.0;
+
+    rmf_traffic::agv::Plan::Start first_location{now, 13, default_orientation};
+    rmf_traffic::agv::Plan::Start second_location{now, 2, default_orientation};
+
+    std::vector<rmf_task::agv::State> initial_states =
+    {
+      rmf_task::agv::State{first_location, 13, 1.0},
+      rmf_task::agv::State{second_location, 2, 1.0}
+    };
+
+    std::vector<rmf_task::agv::Constraints> task_planning_constraints =
+    {
+      rmf_task::agv::Constraints{0.2},
+      rmf_task::agv::Constraints{0.2}
+    };
+
+    const std::vector<std::pair<std::size_t, std::size_t>> deliveries =
+    {
+      {0, 3}, {15, 2}, {7, 9}, {8, 11}, {1, 14}, {12, 5}
+    };
+
+    std::vector<rmf_task::ConstRequestPtr> requests;
+    for (std::size_t i = 0; i < deliveries.size(); ++i)
+    {
+      requests.push_back(
+        rmf_task::requests::Delivery::make(
+          std::to_string(i+1),
+          deliveries[i].first,
+          "dispenser",
+          deliveries[i].second,
+          "ingestor",
+          {},
+          motion_sink,
+          device_sink,
+          planner,
+          now + rmf_traffic::time::from_seconds(0),
+          drain_battery));
+    }
+
+    const std::vector<rmf_task::ConstRequestPtr> old_requests(
+      requests.begin(), requests.begin() + 4);
+    const std::vector<rmf_task::ConstRequestPtr> new_requests(
+      requests.begin() + 4, requests.end());
+
+    TaskPlanner task_planner(task_config);
+    const auto current_result = task_planner.optimal_plan(
+      now, initial_states, task_planning_constraints, old_requests, nullptr);
+    const auto current_assignments = std::get_if<
+      TaskPlanner::Assignments>(&current_result);
+    REQUIRE(current_assignments);
+
+    // An infinite cost bound keeps the inserted assignments no matter what
+    const double no_comparison = std::numeric_limits<double>::infinity();
+    const auto inserted_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, *current_assignments,
+      new_requests, 10, no_comparison);
+    const auto inserted_assignments = std::get_if<
+      TaskPlanner::Assignments>(&inserted_result);
+    REQUIRE(inserted_assignments);
+    const double inserted_cost =
+      task_planner.compute_cost(*inserted_assignments);
+
+    if (display_solutions)
+      display_solution("Inserted", *inserted_assignments, inserted_cost);
+
+    // Every request is assigned exactly once
+    std::vector<std::string> assigned_ids;
+    for (const auto& agent : *inserted_assignments)
+    {
+      for (const auto& a : agent)
+      {
+        if (!std::dynamic_pointer_cast<
+          const rmf_task::requests::ChargeBatteryDescription>(
+            a.request()->description()))
+          assigned_ids.push_back(a.request()->id());
+      }
+    }
+    std::sort(assigned_ids.begin(), assigned_ids.end());
+    CHECK(assigned_ids ==
+      std::vector<std::string>({"1", "2", "3", "4", "5", "6"}));
+
+    const auto greedy_result = task_planner.greedy_plan(
+      now, initial_states, task_planning_constraints, requests);
+    const auto greedy_assignments = std::get_if<
+      TaskPlanner::Assignments>(&greedy_result);
+    REQUIRE(greedy_assignments);
+    const double greedy_cost = task_planner.compute_cost(*greedy_assignments);
+
+    // Without a cost bound, the result is always compared against the greedy
+    // result
+    const auto incremental_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, *current_assignments,
+      new_requests);
+    const auto incremental_assignments = std::get_if<
+      TaskPlanner::Assignments>(&incremental_result);
+    REQUIRE(incremental_assignments);
+    const double incremental_cost =
+      task_planner.compute_cost(*incremental_assignments);
+    CHECK(incremental_cost <= inserted_cost);
+    CHECK(incremental_cost <= greedy_cost);
+
+    // The same happens with a cost bound below the inserted cost
+    const auto bounded_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, *current_assignments,
+      new_requests, 10, inserted_cost - 1.0);
+    const auto bounded_assignments = std::get_if<
+      TaskPlanner::Assignments>(&bounded_result);
+    REQUIRE(bounded_assignments);
+    const double bounded_cost =
+      task_planner.compute_cost(*bounded_assignments);
+    CHECK(bounded_cost == Approx(incremental_cost));
+
+    // With a cost bound above it, the inserted assignments are kept
+    const auto accepted_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, *current_assignments,
+      new_requests, 10, inserted_cost + 1.0);
+    const auto accepted_assignments = std::get_if<
+      TaskPlanner::Assignments>(&accepted_result);
+    REQUIRE(accepted_assignments);
+    CHECK(task_planner.compute_cost(*accepted_assignments) ==
+      Approx(inserted_cost));
+
+    // Stack every existing request onto the first agent, leaving the second
+    // agent idle, so that inserting the new requests does worse than planning
+    // from scratch
+    TaskPlanner::Assignments stacked_assignments(2);
+    for (const auto& agent : *current_assignments)
+    {
+      stacked_assignments[0].insert(
+        stacked_assignments[0].end(), agent.begin(), agent.end());
+    }
+
+    const auto stacked_inserted_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, stacked_assignments,
+      new_requests, 10, no_comparison);
+    const auto stacked_inserted = std::get_if<
+      TaskPlanner::Assignments>(&stacked_inserted_result);
+    REQUIRE(stacked_inserted);
+    const double stacked_inserted_cost =
+      task_planner.compute_cost(*stacked_inserted);
+    REQUIRE(stacked_inserted_cost > greedy_cost);
+
+    const auto stacked_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, stacked_assignments,
+      new_requests);
+    const auto stacked = std::get_if<TaskPlanner::Assignments>(&stacked_result);
+    REQUIRE(stacked);
+    CHECK(task_planner.compute_cost(*stacked) < stacked_inserted_cost);
+
+    // Without a warm start we get the greedy result
+    const auto cold_result = task_planner.incremental_plan(
+      now, initial_states, task_planning_constraints, {}, requests);
+    const auto cold_assignments = std::get_if<
+      TaskPlanner::Assignments>(&cold_result);
+    REQUIRE(cold_assignments);
+    CHECK(task_planner.compute_cost(*cold_assignments) ==
+      Approx(greedy_cost));
+  }
 }
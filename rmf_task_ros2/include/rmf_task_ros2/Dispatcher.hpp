@@ -105,7 +105,10 @@ public:
   /// Get a mutable ref of active tasks map list handled by dispatcher
   const DispatchTasks& active_tasks() const;
 
-  /// Get a mutable ref of terminated tasks map list
+  /// Get a mutable ref of the most recently terminated tasks. The number of
+  /// tasks that are kept is set by the `terminated_tasks_max_size` parameter.
+  /// Older tasks can still be queried through the GetTaskList service when
+  /// the `task_history_log` parameter names a log file.
   const DispatchTasks& terminated_tasks() const;
 
   using StatusCallback = std::function<void(const TaskStatusPtr status)>;
@@ -25,6 +25,8 @@ namespace rmf_task_ros2 {
 const std::string Prefix = "rmf_task/";
 const std::string BidNoticeTopicName = Prefix + "bid_notice";
 const std::string BidProposalTopicName = Prefix + "bid_proposal";
+const std::string BatchBidNoticeTopicName = Prefix + "batch_bid_notice";
+const std::string BatchBidProposalTopicName = Prefix + "batch_bid_proposal";
 
 const std::string SubmitTaskSrvName = "submit_task";
 const std::string CancelTaskSrvName = "cancel_task";
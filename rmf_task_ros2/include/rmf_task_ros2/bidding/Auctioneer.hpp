@@ -59,13 +59,48 @@ public:
     const std::shared_ptr<rclcpp::Node>& node,
     BiddingResultCallback result_callback);
 
-  /// Start a bidding process by provide a bidding task. Note the each
-  /// bidding process is conducted sequentially
+  /// Start a bidding process by provide a bidding task. The auction will be
+  /// opened right away unless the maximum number of concurrent auctions are
+  /// already open, in which case it will wait in a queue. An auction is closed
+  /// when its time window runs out on the ROS clock of the node, or as soon as
+  /// every subscriber of the bid notices has responded, either with a proposal
+  /// or with a no-bid. Subscribers that stayed silent for the whole time window
+  /// of an earlier auction are not waited for until they respond again.
   ///
   /// \param[in] bid_notice
   ///   bidding task, task which will call for bid
   void start_bidding(const BidNotice& bid_notice);
 
+  /// Start a bidding process for several tasks at once. Each bidder will be
+  /// offered the whole batch and can plan for all of the tasks together, which
+  /// is much cheaper than planning for them one at a time. Once every bidder
+  /// that is expected to respond has responded, following the same rules as
+  /// start_bidding(), or the time window runs out, a winner is chosen for
+  /// each task of the batch and the result callback is triggered once per
+  /// task, in the order that the tasks appear in the batch.
+  ///
+  /// The proposals of a bidder assume that it wins every task it bid for, but
+  /// the winners are chosen task by task, so a bidder may be awarded only some
+  /// of them. Bidders are expected to plan again for the tasks that they are
+  /// actually awarded in that case.
+  ///
+  /// Batch auctions are opened right away. They do not count towards the
+  /// maximum number of concurrent auctions.
+  ///
+  /// \param[in] batch_notice
+  ///   the tasks which will be called for bid
+  void start_batch_bidding(const BatchBidNotice& batch_notice);
+
+  /// Set the maximum number of auctions that can be open at the same time.
+  /// The default is 1, which means tasks are auctioned one at a time.
+  ///
+  /// \param[in] max
+  ///   maximum number of concurrent auctions. This will be at least 1.
+  void set_max_concurrent_auctions(std::size_t max);
+
+  /// Get the maximum number of auctions that can be open at the same time.
+  std::size_t get_max_concurrent_auctions() const;
+
   /// A pure abstract interface class for the auctioneer to choose the best
   /// choosing the best submissions.
   class Evaluator
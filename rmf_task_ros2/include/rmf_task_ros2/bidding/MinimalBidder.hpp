@@ -55,7 +55,9 @@ public:
     std::function<Submission(const BidNotice& notice)>;
 
 
-  /// Create a bidder to bid for incoming task requests from Task Dispatcher
+  /// Create a bidder to bid for incoming task requests from Task Dispatcher.
+  /// The bidder also responds to batch bid notices, by calling submission_cb
+  /// once for each task of the batch that it supports.
   ///
   /// \param[in] node
   ///   ROS 2 node instance
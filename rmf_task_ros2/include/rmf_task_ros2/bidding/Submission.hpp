@@ -20,6 +20,7 @@
 
 #include <rmf_traffic/Time.hpp>
 #include <rmf_task_msgs/msg/bid_notice.hpp>
+#include <rmf_task_msgs/msg/batch_bid_notice.hpp>
 
 namespace rmf_task_ros2 {
 namespace bidding {
@@ -37,6 +38,7 @@ struct Submission
 //==============================================================================
 using Submissions = std::vector<Submission>;
 using BidNotice = rmf_task_msgs::msg::BidNotice;
+using BatchBidNotice = rmf_task_msgs::msg::BatchBidNotice;
 
 } // namespace bidding
 } // namespace rmf_task_ros2
@@ -20,6 +20,7 @@
 #include <rclcpp/node.hpp>
 
 #include "action/Client.hpp"
+#include "TaskHistory.hpp"
 
 #include <rmf_task_msgs/srv/submit_task.hpp>
 #include <rmf_task_msgs/srv/cancel_task.hpp>
@@ -27,6 +28,11 @@
 
 #include <rmf_traffic_ros2/Time.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <unordered_map>
+
 namespace rmf_task_ros2 {
 
 //==============================================================================
@@ -44,15 +50,31 @@ public:
   rclcpp::Service<SubmitTaskSrv>::SharedPtr submit_task_srv;
   rclcpp::Service<CancelTaskSrv>::SharedPtr cancel_task_srv;
   rclcpp::Service<GetTaskListSrv>::SharedPtr get_task_list_srv;
+  rclcpp::callback_group::CallbackGroup::SharedPtr get_task_list_cb_group;
 
   StatusCallback on_change_fn;
 
   std::queue<bidding::BidNotice> queue_bidding_tasks;
+  // Tasks that have been handed to the auctioneer and have not been accepted
+  // by a fleet adapter yet, mapped to the auction that they were offered in.
+  // An auction is named after its task, or after its batch.
+  std::unordered_map<TaskID, std::string> bidding_tasks_in_flight;
+  // The number of tasks of each auction that are still in flight
+  std::unordered_map<std::string, std::size_t> auctions_in_flight;
   DispatchTasks active_dispatch_tasks;
-  DispatchTasks terminal_dispatch_tasks;
+  std::unique_ptr<TaskHistory> task_history;
+  // A copy of the active tasks for the GetTaskList service, which runs in its
+  // own callback group so that history queries do not hold up the dispatcher
+  std::vector<StatusMsg> active_tasks_snapshot;
+  mutable std::mutex active_tasks_snapshot_mutex;
   std::size_t task_counter = 0; // index for generating task_id
   double bidding_time_window;
   int terminated_tasks_max_size;
+  std::size_t max_concurrent_auctions;
+  std::size_t batch_bidding_size;
+  double batch_bidding_delay;
+  std::size_t batch_counter = 0; // index for generating batch_id
+  rclcpp::TimerBase::SharedPtr batch_bidding_timer;
 
   std::unordered_map<std::size_t, std::string> task_type_name =
   {
@@ -77,6 +99,29 @@ public:
     RCLCPP_INFO(node->get_logger(),
       " Declared Terminated Tasks Max Size Param as: %d",
       terminated_tasks_max_size);
+    const auto task_history_log =
+      node->declare_parameter<std::string>("task_history_log", "");
+    if (!task_history_log.empty())
+    {
+      RCLCPP_INFO(node->get_logger(),
+        " Declared Task History Log Param as: %s", task_history_log.c_str());
+    }
+    task_history = std::make_unique<TaskHistory>(
+      static_cast<std::size_t>(std::max(1, terminated_tasks_max_size)),
+      task_history_log);
+    max_concurrent_auctions = static_cast<std::size_t>(std::max(1,
+      node->declare_parameter<int>("max_concurrent_auctions", 1)));
+    RCLCPP_INFO(node->get_logger(),
+      " Declared Max Concurrent Auctions Param as: %zu",
+      max_concurrent_auctions);
+    batch_bidding_size = static_cast<std::size_t>(std::max(1,
+      node->declare_parameter<int>("batch_bidding_size", 1)));
+    RCLCPP_INFO(node->get_logger(),
+      " Declared Batch Bidding Size Param as: %zu", batch_bidding_size);
+    batch_bidding_delay =
+      node->declare_parameter<double>("batch_bidding_delay", 0.1);
+    RCLCPP_INFO(node->get_logger(),
+      " Declared Batch Bidding Delay Param as: %f secs", batch_bidding_delay);
 
     // Setup up stream srv interfaces
     submit_task_srv = node->create_service<SubmitTaskSrv>(
@@ -129,27 +174,111 @@ public:
       }
     );
 
+    get_task_list_cb_group = node->create_callback_group(
+      rclcpp::callback_group::CallbackGroupType::MutuallyExclusive);
     get_task_list_srv = node->create_service<GetTaskListSrv>(
       rmf_task_ros2::GetTaskListSrvName,
       [this](
         const std::shared_ptr<GetTaskListSrv::Request> request,
         std::shared_ptr<GetTaskListSrv::Response> response)
       {
-        for (auto task : (this->active_dispatch_tasks))
+        this->get_task_list(*request, *response);
+      },
+      rmw_qos_profile_services_default,
+      get_task_list_cb_group
+    );
+  }
+
+  void get_task_list(
+    const GetTaskListSrv::Request& request,
+    GetTaskListSrv::Response& response) const
+  {
+    // This may run in parallel with the rest of the dispatcher, so it only
+    // touches the active tasks snapshot and the task history.
+    response.terminated_total =
+      static_cast<uint32_t>(task_history->size());
+
+    // Reading tasks back from the history log may fail, in which case the
+    // request fails rather than the dispatcher.
+    try
+    {
+      fill_task_list(request, response);
+    }
+    catch (const std::exception& e)
+    {
+      RCLCPP_ERROR(node->get_logger(),
+        "Failed to read the task history: %s", e.what());
+      response.active_tasks.clear();
+      response.terminated_tasks.clear();
+      response.success = false;
+    }
+  }
+
+  void fill_task_list(
+    const GetTaskListSrv::Request& request,
+    GetTaskListSrv::Response& response) const
+  {
+    if (!request.task_id.empty())
+    {
+      for (const auto& id : request.task_id)
+      {
         {
-          response->active_tasks.push_back(
-            rmf_task_ros2::convert_status(*(task.second)));
+          std::lock_guard<std::mutex> lock(active_tasks_snapshot_mutex);
+          const auto it = std::find_if(
+            active_tasks_snapshot.begin(), active_tasks_snapshot.end(),
+            [&id](const StatusMsg& status) { return status.task_id == id; });
+
+          if (it != active_tasks_snapshot.end())
+          {
+            response.active_tasks.push_back(*it);
+            continue;
+          }
         }
 
-        // Terminated Tasks
-        for (auto task : (this->terminal_dispatch_tasks))
+        const auto terminated = task_history->find(id);
+        if (terminated)
         {
-          response->terminated_tasks.push_back(
-            rmf_task_ros2::convert_status(*(task.second)));
+          response.terminated_tasks.push_back(
+            rmf_task_ros2::convert_status(*terminated));
         }
-        response->success = true;
       }
-    );
+
+      response.success = true;
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(active_tasks_snapshot_mutex);
+      response.active_tasks = active_tasks_snapshot;
+    }
+
+    // Terminated Tasks. A page is never larger than the number of tasks that
+    // the history can hold in memory, so that a single request cannot make us
+    // read the whole log.
+    const std::size_t max_limit =
+      static_cast<std::size_t>(std::max(1, terminated_tasks_max_size));
+    const std::size_t limit = request.terminated_limit > 0 ?
+      std::min<std::size_t>(request.terminated_limit, max_limit) :
+      task_history->memory_size();
+    for (const auto& task :
+      task_history->page(request.terminated_offset, limit))
+    {
+      response.terminated_tasks.push_back(
+        rmf_task_ros2::convert_status(task));
+    }
+
+    response.success = true;
+  }
+
+  void update_active_tasks_snapshot()
+  {
+    std::vector<StatusMsg> snapshot;
+    snapshot.reserve(active_dispatch_tasks.size());
+    for (const auto& task : active_dispatch_tasks)
+      snapshot.push_back(rmf_task_ros2::convert_status(*task.second));
+
+    std::lock_guard<std::mutex> lock(active_tasks_snapshot_mutex);
+    active_tasks_snapshot = std::move(snapshot);
   }
 
   void start()
@@ -157,6 +286,7 @@ public:
     using namespace std::placeholders;
     auctioneer = bidding::Auctioneer::make(node,
         std::bind(&Implementation::receive_bidding_winner_cb, this, _1, _2));
+    auctioneer->set_max_concurrent_auctions(max_concurrent_auctions);
     action_client->on_terminate(
       std::bind(&Implementation::terminate_task, this, _1));
     action_client->on_change(
@@ -189,6 +319,7 @@ public:
     status.task_profile = submitted_task;
     auto new_task_status = std::make_shared<TaskStatus>(status);
     active_dispatch_tasks[submitted_task.task_id] = new_task_status;
+    update_active_tasks_snapshot();
 
     if (on_change_fn)
       on_change_fn(new_task_status);
@@ -199,12 +330,84 @@ public:
       rmf_traffic::time::from_seconds(bidding_time_window));
     queue_bidding_tasks.push(bid_notice);
 
-    if (queue_bidding_tasks.size() == 1)
-      auctioneer->start_bidding(queue_bidding_tasks.front());
+    if (batch_bidding_size > 1
+      && queue_bidding_tasks.size() < batch_bidding_size)
+    {
+      // Give the rest of a burst of submissions a moment to arrive, so that
+      // the fleets can plan for all of them at once.
+      if (!batch_bidding_timer)
+      {
+        batch_bidding_timer = node->create_wall_timer(
+          rmf_traffic::time::from_seconds(batch_bidding_delay),
+          [this]()
+          {
+            this->batch_bidding_timer->cancel();
+            this->batch_bidding_timer.reset();
+            this->start_next_biddings();
+          });
+      }
+    }
+    else
+    {
+      start_next_biddings();
+    }
 
     return submitted_task.task_id;
   }
 
+  void start_next_biddings()
+  {
+    while (!queue_bidding_tasks.empty()
+      && auctions_in_flight.size() < max_concurrent_auctions)
+    {
+      if (batch_bidding_size <= 1)
+      {
+        const auto& bid_notice = queue_bidding_tasks.front();
+        const auto& id = bid_notice.task_profile.task_id;
+        bidding_tasks_in_flight[id] = id;
+        auctions_in_flight[id] = 1;
+        auctioneer->start_bidding(bid_notice);
+        queue_bidding_tasks.pop();
+        continue;
+      }
+
+      bidding::BatchBidNotice batch_notice;
+      batch_notice.batch_id = "Batch" + std::to_string(batch_counter++);
+      batch_notice.time_window = rmf_traffic_ros2::convert(
+        rmf_traffic::time::from_seconds(bidding_time_window));
+
+      while (!queue_bidding_tasks.empty()
+        && batch_notice.task_profiles.size() < batch_bidding_size)
+      {
+        const auto& task_profile = queue_bidding_tasks.front().task_profile;
+        bidding_tasks_in_flight[task_profile.task_id] = batch_notice.batch_id;
+        batch_notice.task_profiles.push_back(task_profile);
+        queue_bidding_tasks.pop();
+      }
+
+      auctions_in_flight[batch_notice.batch_id] =
+        batch_notice.task_profiles.size();
+      auctioneer->start_batch_bidding(batch_notice);
+    }
+  }
+
+  void finish_bidding(const TaskID& task_id)
+  {
+    const auto it = bidding_tasks_in_flight.find(task_id);
+    if (it == bidding_tasks_in_flight.end())
+      return;
+
+    const auto auction_it = auctions_in_flight.find(it->second);
+    bidding_tasks_in_flight.erase(it);
+
+    // An auction stays in flight until every one of its tasks is finished
+    if (auction_it == auctions_in_flight.end() || --auction_it->second > 0)
+      return;
+
+    auctions_in_flight.erase(auction_it);
+    start_next_biddings();
+  }
+
   bool cancel_task(const TaskID& task_id)
   {
     // check if key exists
@@ -266,6 +469,7 @@ public:
       else
         ++it;
     }
+    update_active_tasks_snapshot();
 
     // Cancel action task, this will only send a cancel to FA. up to
     // the FA whether to cancel the task. On change is implemented
@@ -282,9 +486,9 @@ public:
       return it->second->state;
 
     // check if taskid exists in terminated tasks
-    it = terminal_dispatch_tasks.find(task_id);
-    if (it != terminal_dispatch_tasks.end())
-      return it->second->state;
+    const auto terminated = task_history->find(task_id);
+    if (terminated)
+      return terminated->state;
 
     return std::nullopt;
   }
@@ -295,7 +499,10 @@ public:
   {
     const auto it = active_dispatch_tasks.find(task_id);
     if (it == active_dispatch_tasks.end())
+    {
+      finish_bidding(task_id);
       return;
+    }
     const auto& pending_task_status = it->second;
 
     if (!winner)
@@ -308,9 +515,7 @@ public:
       if (on_change_fn)
         on_change_fn(pending_task_status);
 
-      queue_bidding_tasks.pop();
-      if (!queue_bidding_tasks.empty())
-        auctioneer->start_bidding(queue_bidding_tasks.front());
+      finish_bidding(task_id);
       return;
     }
 
@@ -338,6 +543,7 @@ public:
       else
         ++it;
     }
+    update_active_tasks_snapshot();
 
     // add task to action server
     action_client->add_task(
@@ -350,29 +556,12 @@ public:
   {
     assert(terminate_status->is_terminated());
 
-    // prevent terminal_dispatch_tasks from piling up meaning
-    if (terminal_dispatch_tasks.size() >= terminated_tasks_max_size)
-    {
-      RCLCPP_WARN(node->get_logger(),
-        "Terminated tasks reached max size, remove earliest submited task");
-
-      auto rm_task = terminal_dispatch_tasks.begin();
-      for (auto it = rm_task++; it != terminal_dispatch_tasks.end(); it++)
-      {
-        const auto t1 = it->second->task_profile.submission_time;
-        const auto t2 = rm_task->second->task_profile.submission_time;
-        if (rmf_traffic_ros2::convert(t1) < rmf_traffic_ros2::convert(t2))
-          rm_task = it;
-      }
-      terminal_dispatch_tasks.erase(terminal_dispatch_tasks.begin() );
-    }
-
+    // The history evicts the earliest terminated task once it is full
     const auto id = terminate_status->task_profile.task_id;
-
-    // destroy prev status ptr and recreate one
-    auto status = std::make_shared<TaskStatus>(*terminate_status);
-    (terminal_dispatch_tasks)[id] = status;
+    task_history->push(
+      *terminate_status, rmf_traffic_ros2::convert(node->now()));
     active_dispatch_tasks.erase(id);
+    update_active_tasks_snapshot();
   }
 
   void task_status_cb(const TaskStatusPtr status)
@@ -391,13 +580,8 @@ public:
 
     // check if there's a change in state for the previous completed bidding task
     // TODO, better way to impl this
-    if (!queue_bidding_tasks.empty()
-      && id == queue_bidding_tasks.front().task_profile.task_id)
-    {
-      queue_bidding_tasks.pop();
-      if (!queue_bidding_tasks.empty())
-        auctioneer->start_bidding(queue_bidding_tasks.front());
-    }
+    finish_bidding(id);
+    update_active_tasks_snapshot();
 
     if (on_change_fn)
       on_change_fn(status);
@@ -461,7 +645,7 @@ const Dispatcher::DispatchTasks& Dispatcher::active_tasks() const
 //==============================================================================
 const Dispatcher::DispatchTasks& Dispatcher::terminated_tasks() const
 {
-  return _pimpl->terminal_dispatch_tasks;
+  return _pimpl->task_history->terminated_tasks();
 }
 
 //==============================================================================
@@ -486,7 +670,12 @@ std::shared_ptr<rclcpp::Node> Dispatcher::node()
 //==============================================================================
 void Dispatcher::spin()
 {
-  rclcpp::spin(_pimpl->node);
+  // The GetTaskList service has its own callback group, so give it a thread of
+  // its own to keep history queries off the dispatcher's thread.
+  rclcpp::executors::MultiThreadedExecutor executor(
+    rclcpp::ExecutorOptions(), 2);
+  executor.add_node(_pimpl->node);
+  executor.spin();
 }
 
 //==============================================================================
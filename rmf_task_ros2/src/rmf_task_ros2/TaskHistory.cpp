@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TaskHistory.hpp"
+
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rmf_task_ros2 {
+
+namespace {
+
+//==============================================================================
+struct RecordHeader
+{
+  int64_t time;
+  uint64_t size;
+};
+
+//==============================================================================
+const rclcpp::Serialization<StatusMsg>& serializer()
+{
+  static const rclcpp::Serialization<StatusMsg> instance;
+  return instance;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+TaskHistory::TaskHistory(std::size_t capacity, const std::string& log_path)
+: _ring(std::max<std::size_t>(capacity, 1))
+{
+  if (!log_path.empty())
+    _open_log(log_path);
+}
+
+//==============================================================================
+TaskHistory::~TaskHistory()
+{
+  if (_log_fd >= 0)
+    ::close(_log_fd);
+}
+
+//==============================================================================
+void TaskHistory::push(
+  const TaskStatus& status,
+  rmf_traffic::Time terminated_time)
+{
+  auto task = std::make_shared<TaskStatus>(status);
+
+  // Only push() changes the log descriptor, so the record can be serialized
+  // before taking the lock.
+  std::vector<uint8_t> buffer;
+  if (_log_fd >= 0)
+    buffer = _serialize(status);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  const auto time = std::max(terminated_time, _last_time);
+  _last_time = time;
+
+  if (_log_fd >= 0 && _records.size() == _total)
+    _append_log(std::move(buffer), task->task_profile.task_id, time);
+
+  _push_memory(task, time);
+}
+
+//==============================================================================
+const TaskHistory::DispatchTasks& TaskHistory::terminated_tasks() const
+{
+  return _terminated;
+}
+
+//==============================================================================
+std::optional<TaskStatus> TaskHistory::find(const TaskID& task_id) const
+{
+  std::vector<Lookup> lookups;
+  ConstMappingPtr mapping;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _terminated.find(task_id);
+    if (it != _terminated.end())
+      return *it->second;
+
+    const auto log_it = _log_ids.find(task_id);
+    if (log_it == _log_ids.end())
+      return std::nullopt;
+
+    auto lookup = _lookup(log_it->second);
+    if (!lookup)
+      return std::nullopt;
+
+    lookups.emplace_back(std::move(*lookup));
+    mapping = _mapping_for(lookups);
+  }
+
+  return _resolve(lookups, mapping).front();
+}
+
+//==============================================================================
+std::vector<TaskStatus> TaskHistory::page(
+  std::size_t offset,
+  std::size_t limit) const
+{
+  std::vector<Lookup> lookups;
+  ConstMappingPtr mapping;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (std::size_t i = offset; i < _total && lookups.size() < limit; ++i)
+    {
+      auto lookup = _lookup(_total - 1 - i);
+      if (!lookup)
+        break;
+
+      lookups.emplace_back(std::move(*lookup));
+    }
+
+    mapping = _mapping_for(lookups);
+  }
+
+  return _resolve(lookups, mapping);
+}
+
+//==============================================================================
+std::vector<TaskStatus> TaskHistory::since(
+  rmf_traffic::Time time,
+  std::size_t limit) const
+{
+  const int64_t t = time.time_since_epoch().count();
+
+  std::vector<Lookup> lookups;
+  ConstMappingPtr mapping;
+  std::unique_lock<std::mutex> lock(_mutex);
+  const std::size_t memory_begin = _total - std::min(_total, _ring.size());
+
+  // Binary search for the first task that terminated at or after the time.
+  // Look in the log first, unless every task in it is older.
+  std::size_t lower = memory_begin;
+  if (!_records.empty() && _records.back().time >= t)
+  {
+    lower = static_cast<std::size_t>(std::lower_bound(
+        _records.begin(), _records.end(), t,
+        [](const Record& record, int64_t value)
+        {
+          return record.time < value;
+        }) - _records.begin());
+  }
+  else
+  {
+    std::size_t upper = _total;
+    while (lower < upper)
+    {
+      const std::size_t mid = lower + (upper - lower)/2;
+      if (_ring[mid % _ring.size()].time.time_since_epoch().count() < t)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+  }
+
+  for (std::size_t i = lower; i < _total && lookups.size() < limit; ++i)
+  {
+    auto lookup = _lookup(i);
+    if (lookup)
+      lookups.emplace_back(std::move(*lookup));
+  }
+
+  mapping = _mapping_for(lookups);
+  lock.unlock();
+
+  return _resolve(lookups, mapping);
+}
+
+//==============================================================================
+std::size_t TaskHistory::size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  const std::size_t in_memory = std::min(_total, _ring.size());
+  return in_memory + std::min(_records.size(), _total - in_memory);
+}
+
+//==============================================================================
+std::size_t TaskHistory::memory_size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return std::min(_total, _ring.size());
+}
+
+//==============================================================================
+bool TaskHistory::has_log() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _log_fd >= 0;
+}
+
+//==============================================================================
+void TaskHistory::_push_memory(
+  const TaskStatusPtr& status,
+  rmf_traffic::Time time)
+{
+  auto& slot = _ring[_total % _ring.size()];
+  if (slot.status)
+  {
+    // Evict the oldest task, unless a newer task with the same ID has replaced
+    // it in the index.
+    const auto it = _terminated.find(slot.status->task_profile.task_id);
+    if (it != _terminated.end() && it->second == slot.status)
+      _terminated.erase(it);
+  }
+
+  slot.time = time;
+  slot.status = status;
+  _terminated[status->task_profile.task_id] = status;
+  ++_total;
+}
+
+//==============================================================================
+void TaskHistory::_open_log(const std::string& log_path)
+{
+  _log_fd = ::open(log_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (_log_fd < 0)
+  {
+    throw std::runtime_error(
+            "[TaskHistory] Unable to open task history log ["
+            + log_path + "]: " + std::strerror(errno));
+  }
+
+  struct stat info;
+  if (::fstat(_log_fd, &info) != 0)
+  {
+    throw std::runtime_error(
+            "[TaskHistory] Unable to read task history log ["
+            + log_path + "]: " + std::strerror(errno));
+  }
+
+  _log_size = static_cast<std::size_t>(info.st_size);
+  _load_log();
+}
+
+//==============================================================================
+void TaskHistory::_load_log()
+{
+  if (_log_size == 0)
+    return;
+
+  std::size_t offset = 0;
+  {
+    const auto mapping = _map_log();
+    if (!mapping)
+    {
+      throw std::runtime_error(
+              std::string("[TaskHistory] Unable to map task history log: ")
+              + std::strerror(errno));
+    }
+
+    while (offset + sizeof(RecordHeader) <= _log_size)
+    {
+      RecordHeader header;
+      std::memcpy(&header, mapping->data + offset, sizeof(RecordHeader));
+      const std::size_t begin = offset + sizeof(RecordHeader);
+      if (header.size > _log_size - begin)
+        break;
+
+      _records.push_back({header.time, begin, header.size});
+      offset = begin + header.size;
+    }
+  }
+
+  if (offset < _log_size)
+  {
+    // The dispatcher was stopped in the middle of writing a record, so drop
+    // the partial record.
+    _map.reset();
+    if (::ftruncate(_log_fd, static_cast<off_t>(offset)) != 0)
+    {
+      throw std::runtime_error(
+              std::string("[TaskHistory] Unable to repair task history log: ")
+              + std::strerror(errno));
+    }
+    _log_size = offset;
+  }
+
+  const auto mapping = _map_log();
+  for (std::size_t i = 0; i < _records.size(); ++i)
+  {
+    const auto status = _read_record(*mapping, _records[i]);
+    _log_ids[status.task_profile.task_id] = i;
+
+    if (i + _ring.size() >= _records.size())
+    {
+      _push_memory(
+        std::make_shared<TaskStatus>(status),
+        rmf_traffic::Time(rmf_traffic::Duration(_records[i].time)));
+    }
+    else
+    {
+      ++_total;
+    }
+  }
+
+  if (!_records.empty())
+  {
+    _last_time =
+      rmf_traffic::Time(rmf_traffic::Duration(_records.back().time));
+  }
+}
+
+//==============================================================================
+bool TaskHistory::_append_log(
+  std::vector<uint8_t> buffer,
+  const TaskID& task_id,
+  rmf_traffic::Time time)
+{
+  RecordHeader header;
+  header.time = time.time_since_epoch().count();
+  header.size = buffer.size() - sizeof(RecordHeader);
+  std::memcpy(buffer.data(), &header, sizeof(RecordHeader));
+
+  std::size_t written = 0;
+  while (written < buffer.size())
+  {
+    const auto n = ::write(
+      _log_fd, buffer.data() + written, buffer.size() - written);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      // Stop logging rather than leave a gap in the record indices. The
+      // tasks that were logged so far can still be read through the last
+      // mapping of the log.
+      _map_log();
+      ::close(_log_fd);
+      _log_fd = -1;
+      return false;
+    }
+
+    written += static_cast<std::size_t>(n);
+  }
+
+  _records.push_back(
+    {header.time, _log_size + sizeof(RecordHeader), header.size});
+  _log_ids[task_id] = _records.size() - 1;
+  _log_size += buffer.size();
+  return true;
+}
+
+//==============================================================================
+TaskHistory::Mapping::Mapping(const uint8_t* data_, std::size_t size_)
+: data(data_),
+  size(size_)
+{
+  // Do nothing
+}
+
+//==============================================================================
+TaskHistory::Mapping::~Mapping()
+{
+  ::munmap(const_cast<uint8_t*>(data), size);
+}
+
+//==============================================================================
+auto TaskHistory::_map_log() const -> ConstMappingPtr
+{
+  if (_map && _map->size >= _log_size)
+    return _map;
+
+  if (_log_fd < 0 || _log_size == 0)
+    return _map;
+
+  // Queries that are still reading the old mapping keep it alive until they
+  // finish.
+  void* map = ::mmap(nullptr, _log_size, PROT_READ, MAP_SHARED, _log_fd, 0);
+  if (map == MAP_FAILED)
+    return nullptr;
+
+  _map = std::make_shared<const Mapping>(
+    static_cast<const uint8_t*>(map), _log_size);
+  return _map;
+}
+
+//==============================================================================
+auto TaskHistory::_lookup(std::size_t index) const -> std::optional<Lookup>
+{
+  if (index >= _total)
+    return std::nullopt;
+
+  if (index + _ring.size() >= _total)
+    return Lookup{_ring[index % _ring.size()].status, Record{}};
+
+  if (index < _records.size())
+    return Lookup{nullptr, _records[index]};
+
+  return std::nullopt;
+}
+
+//==============================================================================
+auto TaskHistory::_mapping_for(const std::vector<Lookup>& lookups) const
+-> ConstMappingPtr
+{
+  const bool needs_log = std::any_of(
+    lookups.begin(), lookups.end(),
+    [](const Lookup& lookup) { return !lookup.status; });
+
+  if (!needs_log)
+    return nullptr;
+
+  auto mapping = _map_log();
+  if (!mapping)
+  {
+    throw std::runtime_error(
+            "[TaskHistory] Unable to map the task history log");
+  }
+
+  return mapping;
+}
+
+//==============================================================================
+std::vector<uint8_t> TaskHistory::_serialize(const TaskStatus& status)
+{
+  const auto msg = convert_status(status);
+  rclcpp::SerializedMessage serialized;
+  serializer().serialize_message(&msg, &serialized);
+  const auto& rcl_msg = serialized.get_rcl_serialized_message();
+
+  // Leave room for the header, which is filled in once the termination time
+  // is known
+  std::vector<uint8_t> buffer(sizeof(RecordHeader) + rcl_msg.buffer_length);
+  std::memcpy(
+    buffer.data() + sizeof(RecordHeader),
+    rcl_msg.buffer, rcl_msg.buffer_length);
+
+  return buffer;
+}
+
+//==============================================================================
+TaskStatus TaskHistory::_read_record(
+  const Mapping& mapping,
+  const Record& record)
+{
+  if (record.offset + record.size > mapping.size)
+  {
+    throw std::runtime_error(
+            "[TaskHistory] A record is outside of the task history log");
+  }
+
+  rclcpp::SerializedMessage serialized(record.size);
+  auto& rcl_msg = serialized.get_rcl_serialized_message();
+  std::memcpy(rcl_msg.buffer, mapping.data + record.offset, record.size);
+  rcl_msg.buffer_length = record.size;
+
+  StatusMsg msg;
+  serializer().deserialize_message(&serialized, &msg);
+  return convert_status(msg);
+}
+
+//==============================================================================
+std::vector<TaskStatus> TaskHistory::_resolve(
+  const std::vector<Lookup>& lookups,
+  const ConstMappingPtr& mapping)
+{
+  std::vector<TaskStatus> tasks;
+  tasks.reserve(lookups.size());
+  for (const auto& lookup : lookups)
+  {
+    if (lookup.status)
+      tasks.push_back(*lookup.status);
+    else
+      tasks.push_back(_read_record(*mapping, lookup.record));
+  }
+
+  return tasks;
+}
+
+} // namespace rmf_task_ros2
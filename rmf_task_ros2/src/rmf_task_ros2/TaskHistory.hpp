@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TASK_ROS2__TASK_HISTORY_HPP
+#define SRC__RMF_TASK_ROS2__TASK_HISTORY_HPP
+
+#include <rmf_task_ros2/TaskStatus.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rmf_task_ros2 {
+
+//==============================================================================
+/// Stores the statuses of terminated tasks in the order that they terminated.
+///
+/// The most recent tasks are kept in memory in a ring buffer of a fixed
+/// capacity, indexed by task ID and by termination time. When a log path is
+/// given, every task is also appended to a log file on disk, so older tasks
+/// can still be looked up after they have been evicted from memory, and after
+/// a restart. The log is read through a memory map.
+///
+/// push() and terminated_tasks() must only be used by the thread that owns
+/// the dispatcher. All of the query functions are safe to call from any
+/// thread. Records are deserialized from the log without holding the lock, so
+/// slow queries do not hold up push(). The query functions throw a
+/// std::runtime_error if the log cannot be read.
+class TaskHistory
+{
+public:
+  using DispatchTasks = std::unordered_map<TaskID, TaskStatusPtr>;
+
+  /// Constructor
+  ///
+  /// \param[in] capacity
+  ///   The number of tasks to keep in memory. This must be at least 1.
+  ///
+  /// \param[in] log_path
+  ///   The file to append the history to. If empty, no log will be kept. If
+  ///   the file already exists, its tasks will be loaded.
+  TaskHistory(std::size_t capacity, const std::string& log_path = "");
+
+  ~TaskHistory();
+
+  /// Add a terminated task to the history. If the time is earlier than the
+  /// last time that was pushed, the last time will be used instead, so that
+  /// the history stays ordered.
+  void push(const TaskStatus& status, rmf_traffic::Time terminated_time);
+
+  /// The tasks that are currently held in memory, mapped by task ID.
+  const DispatchTasks& terminated_tasks() const;
+
+  /// Find the most recent terminated task with this ID, in memory or in the
+  /// log.
+  std::optional<TaskStatus> find(const TaskID& task_id) const;
+
+  /// Get a page of terminated tasks, starting from the most recent one.
+  ///
+  /// \param[in] offset
+  ///   The number of recent tasks to skip.
+  ///
+  /// \param[in] limit
+  ///   The maximum number of tasks to return.
+  std::vector<TaskStatus> page(std::size_t offset, std::size_t limit) const;
+
+  /// Get the tasks that terminated at or after the given time, oldest first.
+  std::vector<TaskStatus> since(
+    rmf_traffic::Time time,
+    std::size_t limit) const;
+
+  /// The number of tasks that can be queried, in memory or in the log.
+  std::size_t size() const;
+
+  /// The number of tasks that are held in memory.
+  std::size_t memory_size() const;
+
+  /// True if the history is being appended to a log file.
+  bool has_log() const;
+
+private:
+  struct Entry
+  {
+    rmf_traffic::Time time;
+    TaskStatusPtr status;
+  };
+
+  struct Record
+  {
+    int64_t time;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  // A read-only view of the log. Queries keep a copy of the mapping that they
+  // read from, so the log can be remapped while they deserialize records.
+  struct Mapping
+  {
+    const uint8_t* data;
+    std::size_t size;
+
+    Mapping(const uint8_t* data_, std::size_t size_);
+    ~Mapping();
+  };
+  using ConstMappingPtr = std::shared_ptr<const Mapping>;
+
+  // Where to find a task: either in memory, or in a record of the log
+  struct Lookup
+  {
+    TaskStatusPtr status;
+    Record record;
+  };
+
+  void _push_memory(const TaskStatusPtr& status, rmf_traffic::Time time);
+  void _open_log(const std::string& log_path);
+  void _load_log();
+  bool _append_log(
+    std::vector<uint8_t> buffer,
+    const TaskID& task_id,
+    rmf_traffic::Time time);
+  ConstMappingPtr _map_log() const;
+  std::optional<Lookup> _lookup(std::size_t index) const;
+  ConstMappingPtr _mapping_for(const std::vector<Lookup>& lookups) const;
+
+  static std::vector<uint8_t> _serialize(const TaskStatus& status);
+  static TaskStatus _read_record(const Mapping& mapping, const Record& record);
+  static std::vector<TaskStatus> _resolve(
+    const std::vector<Lookup>& lookups,
+    const ConstMappingPtr& mapping);
+
+  mutable std::mutex _mutex;
+
+  // The ring buffer of tasks in memory. The task with history index i is in
+  // slot i % _ring.size(), for the last _ring.size() indices.
+  std::vector<Entry> _ring;
+  std::size_t _total = 0;
+  DispatchTasks _terminated;
+  rmf_traffic::Time _last_time = rmf_traffic::Time(rmf_traffic::Duration(0));
+
+  // The append-only log. Each record is a header of its termination time and
+  // size, followed by the serialized TaskSummary.
+  int _log_fd = -1;
+  std::size_t _log_size = 0;
+  std::vector<Record> _records;
+  std::unordered_map<TaskID, std::size_t> _log_ids;
+  mutable ConstMappingPtr _map;
+};
+
+} // namespace rmf_task_ros2
+
+#endif // SRC__RMF_TASK_ROS2__TASK_HISTORY_HPP
@@ -53,9 +53,21 @@ Auctioneer::Implementation::Implementation(
       this->receive_proposal(*msg);
     });
 
+  batch_bid_notice_pub = node->create_publisher<BatchBidNotice>(
+    rmf_task_ros2::BatchBidNoticeTopicName, dispatch_qos);
+
+  batch_bid_proposal_sub = node->create_subscription<BatchBidProposal>(
+    rmf_task_ros2::BatchBidProposalTopicName, dispatch_qos,
+    [&](const BatchBidProposal::UniquePtr msg)
+    {
+      this->receive_batch_proposal(*msg);
+    });
+
+  // The time windows are measured with the ROS clock of the node, so that they
+  // respect simulation time.
   timer = node->create_wall_timer(std::chrono::milliseconds(200), [&]()
       {
-        this->check_bidding_process();
+        this->check_deadlines();
       });
 }
 
@@ -66,10 +78,36 @@ void Auctioneer::Implementation::start_bidding(
   RCLCPP_INFO(node->get_logger(), "Add Task [%s] to a bidding queue",
     bid_notice.task_profile.task_id.c_str());
 
-  BiddingTask bidding_task;
-  bidding_task.bid_notice = bid_notice;
-  bidding_task.start_time = node->now();
-  queue_bidding_tasks.push(bidding_task);
+  queue_bidding_tasks.push(bid_notice);
+  open_next_auctions();
+}
+
+//==============================================================================
+void Auctioneer::Implementation::open_next_auctions()
+{
+  while (!queue_bidding_tasks.empty()
+    && open_auctions.size() < max_concurrent_auctions)
+  {
+    const auto bid_notice = std::move(queue_bidding_tasks.front());
+    queue_bidding_tasks.pop();
+
+    const auto id = bid_notice.task_profile.task_id;
+    if (open_auctions.count(id))
+    {
+      RCLCPP_WARN(node->get_logger(),
+        "Task [%s] is already being auctioned", id.c_str());
+      continue;
+    }
+
+    RCLCPP_DEBUG(node->get_logger(), " - Start new bidding task: %s",
+      id.c_str());
+
+    auto& bidding_task = open_auctions[id];
+    bidding_task.bid_notice = bid_notice;
+    bidding_task.start_time = node->now();
+
+    bid_notice_pub->publish(bid_notice);
+  }
 }
 
 //==============================================================================
@@ -83,71 +121,248 @@ void Auctioneer::Implementation::receive_proposal(
 
   // check if bidding task is initiated by the auctioneer previously
   // add submited proposal to the current bidding tasks list
-  if (queue_bidding_tasks.front().bid_notice.task_profile.task_id == id)
-    queue_bidding_tasks.front().submissions.push_back(convert(msg));
+  const auto it = open_auctions.find(id);
+  if (it == open_auctions.end())
+  {
+    // The response arrived too late for this auction, so we were wrong to
+    // count this fleet as silent.
+    if (silent_bidders > 0)
+      --silent_bidders;
+
+    return;
+  }
+
+  auto& bidding_task = it->second;
+  if (!bidding_task.responded_fleets.insert(msg.fleet_name).second)
+    return;
+
+  if (!msg.no_bid)
+    bidding_task.submissions.push_back(convert(msg));
+
+  if (all_bidders_responded(bidding_task))
+    close_auction(id);
 }
 
 //==============================================================================
-// determine the winner within a bidding task instance
-void Auctioneer::Implementation::check_bidding_process()
+void Auctioneer::Implementation::close_auction(const std::string& task_id)
 {
-  if (queue_bidding_tasks.size() == 0)
+  const auto it = open_auctions.find(task_id);
+  if (it == open_auctions.end())
     return;
 
-  // Executing the task at the front queue
-  auto front_task = queue_bidding_tasks.front();
+  const auto bidding_task = std::move(it->second);
+  open_auctions.erase(it);
 
-  if (bidding_in_proccess)
+  std::optional<Submission> winner = std::nullopt;
+  if (bidding_task.submissions.size() == 0)
   {
-    if (determine_winner(front_task))
-    {
-      queue_bidding_tasks.pop();
-      bidding_in_proccess = false;
-    }
+    RCLCPP_DEBUG(node->get_logger(),
+      "Bidding task has not received any bids");
   }
   else
   {
-    RCLCPP_DEBUG(node->get_logger(), " - Start new bidding task: %s",
-      front_task.bid_notice.task_profile.task_id.c_str());
-    queue_bidding_tasks.front().start_time = node->now();
-    bid_notice_pub->publish(front_task.bid_notice);
-    bidding_in_proccess = true;
+    winner = evaluate(bidding_task.submissions);
+    RCLCPP_INFO(node->get_logger(),
+      "Determined winning Fleet Adapter: [%s], from %zu submissions",
+      winner->fleet_name.c_str(), bidding_task.submissions.size());
   }
+
+  // Call the user defined callback function
+  if (bidding_result_callback)
+    bidding_result_callback(task_id, winner);
+
+  open_next_auctions();
 }
 
 //==============================================================================
-bool Auctioneer::Implementation::determine_winner(
-  const BiddingTask& bidding_task)
+void Auctioneer::Implementation::check_deadlines()
 {
-  const auto duration = node->now() - bidding_task.start_time;
+  const auto now = node->now();
+
+  // Bidders may have gone away since the last response to an auction, so the
+  // auctions that are not expired also get checked for whether they are done.
+  std::vector<std::string> expired;
+  std::vector<std::string> done;
+  for (const auto& a : open_auctions)
+  {
+    if (now - a.second.start_time > a.second.bid_notice.time_window)
+      expired.push_back(a.first);
+    else if (all_bidders_responded(a.second))
+      done.push_back(a.first);
+  }
 
-  if (duration > bidding_task.bid_notice.time_window)
+  for (const auto& id : expired)
   {
-    auto id = bidding_task.bid_notice.task_profile.task_id;
     RCLCPP_DEBUG(node->get_logger(), "Bidding Deadline reached: %s",
       id.c_str());
+
+    const auto subscribers = bid_notice_pub->get_subscription_count();
+    const auto responded = open_auctions.at(id).responded_fleets.size();
+    silent_bidders = subscribers > responded ? subscribers - responded : 0;
+    close_auction(id);
+  }
+
+  for (const auto& id : done)
+    close_auction(id);
+
+  expired.clear();
+  done.clear();
+  for (const auto& b : open_batch_auctions)
+  {
+    if (now - b.second.start_time > b.second.batch_notice.time_window)
+      expired.push_back(b.first);
+    else if (all_batch_bidders_responded(b.second))
+      done.push_back(b.first);
+  }
+
+  for (const auto& id : expired)
+  {
+    RCLCPP_DEBUG(node->get_logger(),
+      "Bidding Deadline reached for batch: %s", id.c_str());
+
+    const auto subscribers = batch_bid_notice_pub->get_subscription_count();
+    const auto responded = open_batch_auctions.at(id).responded_fleets.size();
+    silent_batch_bidders =
+      subscribers > responded ? subscribers - responded : 0;
+    close_batch_auction(id);
+  }
+
+  for (const auto& id : done)
+    close_batch_auction(id);
+}
+
+//==============================================================================
+namespace {
+bool all_responded(
+  const std::size_t subscribers,
+  const std::size_t silent,
+  const std::size_t responded)
+{
+  // If nobody is expected to respond, then the auction needs to run until its
+  // deadline in case someone does.
+  if (subscribers <= silent)
+    return false;
+
+  return responded >= subscribers - silent;
+}
+} // anonymous namespace
+
+//==============================================================================
+bool Auctioneer::Implementation::all_bidders_responded(
+  const BiddingTask& bidding_task) const
+{
+  return all_responded(
+    bid_notice_pub->get_subscription_count(),
+    silent_bidders,
+    bidding_task.responded_fleets.size());
+}
+
+//==============================================================================
+bool Auctioneer::Implementation::all_batch_bidders_responded(
+  const BiddingBatch& batch) const
+{
+  return all_responded(
+    batch_bid_notice_pub->get_subscription_count(),
+    silent_batch_bidders,
+    batch.responded_fleets.size());
+}
+
+//==============================================================================
+void Auctioneer::Implementation::start_batch_bidding(
+  const BatchBidNotice& batch_notice)
+{
+  const auto& id = batch_notice.batch_id;
+  if (open_batch_auctions.count(id))
+  {
+    RCLCPP_WARN(node->get_logger(),
+      "Batch [%s] is already being auctioned", id.c_str());
+    return;
+  }
+
+  RCLCPP_INFO(node->get_logger(), "Start bidding for batch [%s] of %zu tasks",
+    id.c_str(), batch_notice.task_profiles.size());
+
+  auto& batch = open_batch_auctions[id];
+  batch.batch_notice = batch_notice;
+  batch.start_time = node->now();
+
+  batch_bid_notice_pub->publish(batch_notice);
+}
+
+//==============================================================================
+void Auctioneer::Implementation::receive_batch_proposal(
+  const BatchBidProposal& msg)
+{
+  RCLCPP_DEBUG(node->get_logger(),
+    "[Auctioneer] Receive %zu proposals for batch: %s | from: %s",
+    msg.proposals.size(), msg.batch_id.c_str(), msg.fleet_name.c_str());
+
+  const auto it = open_batch_auctions.find(msg.batch_id);
+  if (it == open_batch_auctions.end())
+  {
+    // The response arrived too late for this batch, so we were wrong to count
+    // this fleet as silent.
+    if (silent_batch_bidders > 0)
+      --silent_batch_bidders;
+
+    return;
+  }
+
+  auto& batch = it->second;
+  if (!batch.responded_fleets.insert(msg.fleet_name).second)
+    return;
+
+  for (const auto& proposal : msg.proposals)
+  {
+    auto submission = convert(proposal);
+    submission.fleet_name = msg.fleet_name;
+    batch.submissions[proposal.task_profile.task_id].push_back(
+      std::move(submission));
+  }
+
+  if (all_batch_bidders_responded(batch))
+    close_batch_auction(msg.batch_id);
+}
+
+//==============================================================================
+void Auctioneer::Implementation::close_batch_auction(
+  const std::string& batch_id)
+{
+  const auto it = open_batch_auctions.find(batch_id);
+  if (it == open_batch_auctions.end())
+    return;
+
+  const auto batch = std::move(it->second);
+  open_batch_auctions.erase(it);
+
+  // Every proposal of a fleet was computed from one combined plan for the
+  // whole batch, so we only resolve the winners once all the fleets have
+  // weighed in on all of the tasks. A fleet that only wins some of the tasks
+  // that it bid for will plan again for those when they are dispatched to it.
+  for (const auto& task_profile : batch.batch_notice.task_profiles)
+  {
+    const auto& task_id = task_profile.task_id;
     std::optional<Submission> winner = std::nullopt;
+    const auto s_it = batch.submissions.find(task_id);
+    if (s_it != batch.submissions.end())
+      winner = evaluate(s_it->second);
 
-    if (bidding_task.submissions.size() == 0)
+    if (winner)
     {
-      RCLCPP_DEBUG(node->get_logger(),
-        "Bidding task has not received any bids");
+      RCLCPP_INFO(node->get_logger(),
+        "Determined winning Fleet Adapter for task [%s] of batch [%s]: [%s]",
+        task_id.c_str(), batch_id.c_str(), winner->fleet_name.c_str());
     }
     else
     {
-      winner = evaluate(bidding_task.submissions);
-      RCLCPP_INFO(node->get_logger(),
-        "Determined winning Fleet Adapter: [%s], from %d submissions",
-        winner->fleet_name.c_str(), bidding_task.submissions.size());
+      RCLCPP_DEBUG(node->get_logger(),
+        "Task [%s] of batch [%s] has not received any bids",
+        task_id.c_str(), batch_id.c_str());
     }
 
-    // Call the user defined callback function
     if (bidding_result_callback)
-      bidding_result_callback(id, winner);
-
-    return true;
+      bidding_result_callback(task_id, winner);
   }
-  return false;
 }
 
 //==============================================================================
@@ -189,6 +404,25 @@ void Auctioneer::start_bidding(const BidNotice& bid_notice)
   _pimpl->start_bidding(bid_notice);
 }
 
+//==============================================================================
+void Auctioneer::start_batch_bidding(const BatchBidNotice& batch_notice)
+{
+  _pimpl->start_batch_bidding(batch_notice);
+}
+
+//==============================================================================
+void Auctioneer::set_max_concurrent_auctions(const std::size_t max)
+{
+  _pimpl->max_concurrent_auctions = std::max<std::size_t>(max, 1);
+  _pimpl->open_next_auctions();
+}
+
+//==============================================================================
+std::size_t Auctioneer::get_max_concurrent_auctions() const
+{
+  return _pimpl->max_concurrent_auctions;
+}
+
 //==============================================================================
 void Auctioneer::select_evaluator(
   std::shared_ptr<Auctioneer::Evaluator> evaluator)
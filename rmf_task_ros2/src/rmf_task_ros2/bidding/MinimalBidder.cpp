@@ -20,12 +20,14 @@
 
 #include <rmf_traffic_ros2/Time.hpp>
 #include <rmf_task_msgs/msg/bid_proposal.hpp>
+#include <rmf_task_msgs/msg/batch_bid_proposal.hpp>
 #include <rmf_task_ros2/StandardNames.hpp>
 
 namespace rmf_task_ros2 {
 namespace bidding {
 
 using BidProposal = rmf_task_msgs::msg::BidProposal;
+using BatchBidProposal = rmf_task_msgs::msg::BatchBidProposal;
 
 //==============================================================================
 BidProposal convert(const Submission& from)
@@ -55,6 +57,12 @@ public:
   using BidProposalPub = rclcpp::Publisher<BidProposal>;
   BidProposalPub::SharedPtr dispatch_proposal_pub;
 
+  using BatchBidNoticeSub = rclcpp::Subscription<BatchBidNotice>;
+  BatchBidNoticeSub::SharedPtr batch_notice_sub;
+
+  using BatchBidProposalPub = rclcpp::Publisher<BatchBidProposal>;
+  BatchBidProposalPub::SharedPtr batch_proposal_pub;
+
   Implementation(
     std::shared_ptr<rclcpp::Node> node_,
     const std::string& fleet_name_,
@@ -76,6 +84,16 @@ public:
 
     dispatch_proposal_pub = node->create_publisher<BidProposal>(
       rmf_task_ros2::BidProposalTopicName, dispatch_qos);
+
+    batch_notice_sub = node->create_subscription<BatchBidNotice>(
+      rmf_task_ros2::BatchBidNoticeTopicName, dispatch_qos,
+      [&](const BatchBidNotice::UniquePtr msg)
+      {
+        this->receive_batch_notice(*msg);
+      });
+
+    batch_proposal_pub = node->create_publisher<BatchBidProposal>(
+      rmf_task_ros2::BatchBidProposalTopicName, dispatch_qos);
   }
 
   // Callback fn when a dispatch notice is received
@@ -87,17 +105,28 @@ public:
 
     const auto task_type = (msg.task_profile.description.task_type.type);
 
+    // Always respond, so that the auctioneer does not need to wait for the
+    // time window to run out when this bidder has nothing to offer.
+    BidProposal no_bid;
+    no_bid.fleet_name = fleet_name;
+    no_bid.task_profile = msg.task_profile;
+    no_bid.no_bid = true;
+
     // check if task type is valid
     if (!valid_task_types.count(static_cast<TaskType>(task_type)))
     {
       RCLCPP_WARN(node->get_logger(), "[%s]: task type %d is not supported",
         fleet_name.c_str(), task_type);
+      dispatch_proposal_pub->publish(no_bid);
       return;
     }
 
     // check if get submission function is declared
     if (!get_submission_fn)
+    {
+      dispatch_proposal_pub->publish(no_bid);
       return;
+    }
 
     // Submit proposal
     const auto bid_submission = get_submission_fn(msg);
@@ -106,6 +135,43 @@ public:
     best_proposal.task_profile = msg.task_profile;
     dispatch_proposal_pub->publish(best_proposal);
   }
+
+  // Callback fn when a batch of dispatch notices is received. The minimal
+  // bidder has no planner of its own, so it simply asks for a submission for
+  // each task of the batch that it supports.
+  void receive_batch_notice(const BatchBidNotice& msg)
+  {
+    RCLCPP_INFO(node->get_logger(),
+      "[Bidder] Received Bidding notice for batch [%s] of %zu tasks",
+      msg.batch_id.c_str(), msg.task_profiles.size());
+
+    // Always respond, so that the auctioneer does not need to wait for the
+    // time window to run out when this bidder has nothing to offer.
+    BatchBidProposal batch_proposal;
+    batch_proposal.fleet_name = fleet_name;
+    batch_proposal.batch_id = msg.batch_id;
+
+    for (const auto& task_profile : msg.task_profiles)
+    {
+      const auto task_type = task_profile.description.task_type.type;
+      if (!valid_task_types.count(static_cast<TaskType>(task_type)))
+        continue;
+
+      if (!get_submission_fn)
+        break;
+
+      BidNotice notice;
+      notice.task_profile = task_profile;
+      notice.time_window = msg.time_window;
+
+      auto proposal = convert(get_submission_fn(notice));
+      proposal.fleet_name = fleet_name;
+      proposal.task_profile = task_profile;
+      batch_proposal.proposals.push_back(std::move(proposal));
+    }
+
+    batch_proposal_pub->publish(batch_proposal);
+  }
 };
 
 //==============================================================================
@@ -22,6 +22,10 @@
 #include <rmf_task_ros2/bidding/Submission.hpp>
 #include <rmf_task_ros2/bidding/Auctioneer.hpp>
 #include <rmf_task_msgs/msg/bid_proposal.hpp>
+#include <rmf_task_msgs/msg/batch_bid_proposal.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
 
 #include <rmf_traffic_ros2/Time.hpp>
 #include <rmf_task_ros2/StandardNames.hpp>
@@ -30,13 +34,13 @@ namespace rmf_task_ros2 {
 namespace bidding {
 
 using BidProposal = rmf_task_msgs::msg::BidProposal;
+using BatchBidProposal = rmf_task_msgs::msg::BatchBidProposal;
 
 //==============================================================================
 class Auctioneer::Implementation
 {
 public:
   std::shared_ptr<rclcpp::Node> node;
-  rclcpp::TimerBase::SharedPtr timer;
   BiddingResultCallback bidding_result_callback;
   std::shared_ptr<Evaluator> evaluator;
 
@@ -45,10 +49,32 @@ public:
     BidNotice bid_notice;
     builtin_interfaces::msg::Time start_time;
     std::vector<bidding::Submission> submissions;
+    std::unordered_set<std::string> responded_fleets;
   };
 
-  bool bidding_in_proccess = false;
-  std::queue<BiddingTask> queue_bidding_tasks;
+  std::size_t max_concurrent_auctions = 1;
+  std::queue<BidNotice> queue_bidding_tasks;
+  std::unordered_map<std::string, BiddingTask> open_auctions;
+
+  struct BiddingBatch
+  {
+    BatchBidNotice batch_notice;
+    builtin_interfaces::msg::Time start_time;
+    std::unordered_map<std::string, Submissions> submissions;
+    std::unordered_set<std::string> responded_fleets;
+  };
+
+  std::unordered_map<std::string, BiddingBatch> open_batch_auctions;
+
+  // Every subscriber of the notices is expected to respond to them, either
+  // with a proposal or with a no-bid. These count the subscribers that stayed
+  // silent through the whole time window of an auction, such as tools that are
+  // only listening in, so that later auctions do not wait for them.
+  std::size_t silent_bidders = 0;
+  std::size_t silent_batch_bidders = 0;
+
+  // Checks the deadlines of the open auctions against the ROS clock
+  rclcpp::TimerBase::SharedPtr timer;
 
   using BidNoticePub = rclcpp::Publisher<BidNotice>;
   BidNoticePub::SharedPtr bid_notice_pub;
@@ -56,6 +82,12 @@ public:
   using BidProposalSub = rclcpp::Subscription<BidProposal>;
   BidProposalSub::SharedPtr bid_proposal_sub;
 
+  using BatchBidNoticePub = rclcpp::Publisher<BatchBidNotice>;
+  BatchBidNoticePub::SharedPtr batch_bid_notice_pub;
+
+  using BatchBidProposalSub = rclcpp::Subscription<BatchBidProposal>;
+  BatchBidProposalSub::SharedPtr batch_bid_proposal_sub;
+
   Implementation(
     const std::shared_ptr<rclcpp::Node>& node_,
     BiddingResultCallback result_callback);
@@ -63,13 +95,36 @@ public:
   /// Start a bidding process
   void start_bidding(const BidNotice& bid_notice);
 
+  // Open auctions for queued tasks until the limit of concurrent auctions is
+  // reached
+  void open_next_auctions();
+
   // Receive proposal and evaluate
   void receive_proposal(const BidProposal& msg);
 
-  // determine the winner within a bidding task instance
-  void check_bidding_process();
+  // Close the auction of a task and announce its winner
+  void close_auction(const std::string& task_id);
+
+  // Close every open auction whose time window has run out, or whose bidders
+  // have all responded
+  void check_deadlines();
+
+  // True if every subscriber of the bid notices that is expected to respond
+  // has responded to an auction
+  bool all_bidders_responded(const BiddingTask& bidding_task) const;
+
+  // True if every subscriber of the batch bid notices that is expected to
+  // respond has responded to a batch
+  bool all_batch_bidders_responded(const BiddingBatch& batch) const;
+
+  /// Start a bidding process for a batch of tasks
+  void start_batch_bidding(const BatchBidNotice& batch_notice);
+
+  // Receive the proposals of a fleet for a batch of tasks
+  void receive_batch_proposal(const BatchBidProposal& msg);
 
-  bool determine_winner(const BiddingTask& bidding_task);
+  // Close the auction of a batch and announce the winner of each of its tasks
+  void close_batch_auction(const std::string& batch_id);
 
   std::optional<Submission> evaluate(const Submissions& submissions);
 
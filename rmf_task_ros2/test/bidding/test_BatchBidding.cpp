@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_task_ros2/bidding/MinimalBidder.hpp>
+#include <rmf_task_ros2/bidding/Auctioneer.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rmf_traffic_ros2/Time.hpp>
+
+#include <chrono>
+#include <rmf_utils/catch.hpp>
+
+namespace rmf_task_ros2 {
+namespace bidding {
+
+using TaskType = bidding::MinimalBidder::TaskType;
+
+//==============================================================================
+SCENARIO("Batch auction", "[BatchBidding]")
+{
+  // This time window is much longer than the test will spin for, so each
+  // batch must be closed because all the bidders responded.
+  const auto time_window =
+    rmf_traffic_ros2::convert(rmf_traffic::time::from_seconds(30.0));
+
+  rclcpp::init(0, nullptr);
+  auto node = rclcpp::Node::make_shared("test_batch_bidding");
+
+  std::vector<std::string> result_ids;
+  std::vector<std::string> result_winners;
+  rclcpp::Time close_time;
+  auto auctioneer = Auctioneer::make(
+    node,
+    [&](const std::string& task_id, const std::optional<Submission> winner)
+    {
+      result_ids.push_back(task_id);
+      result_winners.push_back(winner ? winner->fleet_name : "");
+      close_time = node->now();
+    });
+
+  std::size_t bidder1_notices = 0;
+  auto bidder1 = MinimalBidder::make(
+    node, "bidder1", { TaskType::Station, TaskType::Delivery },
+    [&](const BidNotice& notice)
+    {
+      ++bidder1_notices;
+      Submission submission;
+      submission.new_cost =
+        notice.task_profile.description.task_type.type ==
+        rmf_task_msgs::msg::TaskType::TYPE_STATION ? 10.0 : 1.0;
+      return submission;
+    });
+
+  auto bidder2 = MinimalBidder::make(
+    node, "bidder2", { TaskType::Station },
+    [](const BidNotice&)
+    {
+      Submission submission;
+      submission.new_cost = 5.0;
+      return submission;
+    });
+
+  // This bidder can only accommodate one task of the batch, but it still needs
+  // to respond for the batch to close early.
+  auto bidder3 = MinimalBidder::make(
+    node, "bidder3", { TaskType::Clean },
+    [](const BidNotice&)
+    {
+      return Submission();
+    });
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  std::promise<void> ready_promise;
+  std::shared_future<void> ready_future(ready_promise.get_future());
+
+  const std::vector<uint32_t> types = {
+    rmf_task_msgs::msg::TaskType::TYPE_STATION,
+    rmf_task_msgs::msg::TaskType::TYPE_DELIVERY,
+    rmf_task_msgs::msg::TaskType::TYPE_STATION,
+    rmf_task_msgs::msg::TaskType::TYPE_CLEAN
+  };
+
+  const auto run_batch = [&](
+    const std::string& batch_id,
+    const builtin_interfaces::msg::Duration& window,
+    const double spin_time) -> rclcpp::Duration
+    {
+      result_ids.clear();
+      result_winners.clear();
+      bidder1_notices = 0;
+
+      BatchBidNotice batch;
+      batch.batch_id = batch_id;
+      batch.time_window = window;
+      for (std::size_t i = 0; i < types.size(); ++i)
+      {
+        rmf_task_msgs::msg::TaskProfile profile;
+        profile.task_id = batch_id + "_task" + std::to_string(i);
+        profile.description.task_type.type = types[i];
+        batch.task_profiles.push_back(profile);
+      }
+
+      const auto start = node->now();
+      auctioneer->start_batch_bidding(batch);
+
+      executor.spin_until_future_complete(ready_future,
+        rmf_traffic::time::from_seconds(spin_time));
+
+      // Every task gets a result, in the order of the batch
+      REQUIRE(result_ids.size() == types.size());
+      for (std::size_t i = 0; i < types.size(); ++i)
+        CHECK(result_ids[i] == batch_id + "_task" + std::to_string(i));
+
+      CHECK(result_winners[0] == "bidder2");
+      CHECK(result_winners[1] == "bidder1");
+      CHECK(result_winners[2] == "bidder2");
+      CHECK(result_winners[3] == "bidder3");
+
+      // bidder1 was asked about each of the tasks that it supports
+      CHECK(bidder1_notices == 3);
+
+      return close_time - start;
+    };
+
+  const auto first_duration = run_batch("batch0", time_window, 3.0);
+  CHECK(first_duration < rclcpp::Duration(time_window));
+
+  const auto second_duration = run_batch("batch1", time_window, 3.0);
+  CHECK(second_duration < rclcpp::Duration(time_window));
+
+  rclcpp::shutdown();
+}
+
+} // namespace bidding
+} // namespace rmf_task_ros2
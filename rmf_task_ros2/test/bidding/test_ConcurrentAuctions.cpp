@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_task_ros2/bidding/MinimalBidder.hpp>
+#include <rmf_task_ros2/bidding/Auctioneer.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rmf_traffic_ros2/Time.hpp>
+
+#include <chrono>
+#include <unordered_set>
+#include <rmf_utils/catch.hpp>
+
+namespace rmf_task_ros2 {
+namespace bidding {
+
+using TaskType = bidding::MinimalBidder::TaskType;
+
+//==============================================================================
+SCENARIO("Concurrent auctions", "[ConcurrentAuctions]")
+{
+  const std::size_t num_tasks = 5;
+
+  // The time window is much longer than the test will spin for, so every
+  // auction must be closed because all the bidders responded.
+  const auto time_window =
+    rmf_traffic_ros2::convert(rmf_traffic::time::from_seconds(30.0));
+
+  rclcpp::init(0, nullptr);
+  auto node = rclcpp::Node::make_shared("test_concurrent_auctions");
+
+  // Keep track of how many auctions a bidder sees open at the same time
+  std::size_t max_open_notices = 0;
+  std::unordered_set<std::string> open_notices;
+
+  std::vector<std::string> result_ids;
+  std::vector<std::string> result_winners;
+  std::vector<rclcpp::Time> result_times;
+  auto auctioneer = Auctioneer::make(
+    node,
+    [&](const std::string& task_id, const std::optional<Submission> winner)
+    {
+      open_notices.erase(task_id);
+      result_ids.push_back(task_id);
+      result_winners.push_back(winner ? winner->fleet_name : "");
+      result_times.push_back(node->now());
+    });
+
+  CHECK(auctioneer->get_max_concurrent_auctions() == 1);
+
+  auto bidder1 = MinimalBidder::make(
+    node, "bidder1", { TaskType::Station },
+    [&](const BidNotice& notice)
+    {
+      open_notices.insert(notice.task_profile.task_id);
+      max_open_notices = std::max(max_open_notices, open_notices.size());
+
+      Submission submission;
+      submission.new_cost = 10.0;
+      return submission;
+    });
+
+  auto bidder2 = MinimalBidder::make(
+    node, "bidder2", { TaskType::Station },
+    [](const BidNotice&)
+    {
+      Submission submission;
+      submission.new_cost = 5.0;
+      return submission;
+    });
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  std::promise<void> ready_promise;
+  std::shared_future<void> ready_future(ready_promise.get_future());
+
+  BidNotice first_notice;
+  first_notice.task_profile.task_id = "first";
+  first_notice.task_profile.description.task_type.type =
+    rmf_task_msgs::msg::TaskType::TYPE_STATION;
+  first_notice.time_window = time_window;
+  const auto first_start = node->now();
+  auctioneer->start_bidding(first_notice);
+
+  executor.spin_until_future_complete(ready_future,
+    rmf_traffic::time::from_seconds(2.0));
+
+  REQUIRE(result_ids.size() == 1);
+  CHECK(result_ids.front() == "first");
+  CHECK(result_winners.front() == "bidder2");
+  CHECK(result_times.front() - first_start < rclcpp::Duration(time_window));
+
+  result_ids.clear();
+  result_winners.clear();
+  result_times.clear();
+  max_open_notices = 0;
+
+  WHEN("Auctions are run one at a time")
+  {
+    auctioneer->set_max_concurrent_auctions(0);
+    CHECK(auctioneer->get_max_concurrent_auctions() == 1);
+  }
+
+  WHEN("Several auctions can run at once")
+  {
+    auctioneer->set_max_concurrent_auctions(3);
+    CHECK(auctioneer->get_max_concurrent_auctions() == 3);
+  }
+
+  const auto start = node->now();
+  for (std::size_t i = 0; i < num_tasks; ++i)
+  {
+    BidNotice notice;
+    notice.task_profile.task_id = "task" + std::to_string(i);
+    notice.task_profile.description.task_type.type =
+      rmf_task_msgs::msg::TaskType::TYPE_STATION;
+    notice.time_window = time_window;
+    auctioneer->start_bidding(notice);
+  }
+
+  executor.spin_until_future_complete(ready_future,
+    rmf_traffic::time::from_seconds(3.0));
+
+  // Each auction closes as soon as both of the bidders have responded.
+  REQUIRE(result_ids.size() == num_tasks);
+  for (const auto& winner : result_winners)
+    CHECK(winner == "bidder2");
+
+  for (const auto& t : result_times)
+    CHECK(t - start < rclcpp::Duration(time_window));
+
+  CHECK(max_open_notices >= 1);
+  CHECK(max_open_notices <= auctioneer->get_max_concurrent_auctions());
+
+  rclcpp::shutdown();
+}
+
+} // namespace bidding
+} // namespace rmf_task_ros2
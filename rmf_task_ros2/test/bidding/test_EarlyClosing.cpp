@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_task_ros2/bidding/MinimalBidder.hpp>
+#include <rmf_task_ros2/bidding/Auctioneer.hpp>
+#include <rmf_task_ros2/StandardNames.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rmf_traffic_ros2/Time.hpp>
+
+#include <chrono>
+#include <rmf_utils/catch.hpp>
+
+namespace rmf_task_ros2 {
+namespace bidding {
+
+using TaskType = bidding::MinimalBidder::TaskType;
+
+//==============================================================================
+SCENARIO("Closing auctions early", "[EarlyClosing]")
+{
+  // This time window is much longer than the test will spin for, so an
+  // auction that uses it must be closed because all the bidders responded.
+  const auto time_window =
+    rmf_traffic_ros2::convert(rmf_traffic::time::from_seconds(30.0));
+
+  const auto short_time_window =
+    rmf_traffic_ros2::convert(rmf_traffic::time::from_seconds(1.0));
+
+  rclcpp::init(0, nullptr);
+  auto node = rclcpp::Node::make_shared("test_early_closing");
+
+  std::vector<std::string> result_winners;
+  rclcpp::Time close_time;
+  auto auctioneer = Auctioneer::make(
+    node,
+    [&](const std::string&, const std::optional<Submission> winner)
+    {
+      result_winners.push_back(winner ? winner->fleet_name : "");
+      close_time = node->now();
+    });
+
+  auto bidder1 = MinimalBidder::make(
+    node, "bidder1", { TaskType::Station },
+    [](const BidNotice&)
+    {
+      Submission submission;
+      submission.new_cost = 10.0;
+      return submission;
+    });
+
+  // This bidder does not support the task type of the auctions, so it will
+  // only ever respond with a no-bid.
+  auto bidder2 = MinimalBidder::make(
+    node, "bidder2", { TaskType::Clean },
+    [](const BidNotice&)
+    {
+      return Submission();
+    });
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  std::promise<void> ready_promise;
+  std::shared_future<void> ready_future(ready_promise.get_future());
+
+  const auto wait_for_subscribers = [&](const std::size_t count)
+    {
+      const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (node->count_subscribers(BidNoticeTopicName) < count
+        && std::chrono::steady_clock::now() < deadline)
+      {
+        executor.spin_until_future_complete(ready_future,
+          std::chrono::milliseconds(10));
+      }
+
+      REQUIRE(node->count_subscribers(BidNoticeTopicName) == count);
+    };
+
+  std::size_t auction_count = 0;
+  const auto run_auction = [&](
+    const builtin_interfaces::msg::Duration& window,
+    const double spin_time) -> rclcpp::Duration
+    {
+      result_winners.clear();
+
+      BidNotice notice;
+      notice.task_profile.task_id = "task" + std::to_string(auction_count++);
+      notice.task_profile.description.task_type.type =
+        rmf_task_msgs::msg::TaskType::TYPE_STATION;
+      notice.time_window = window;
+
+      const auto start = node->now();
+      auctioneer->start_bidding(notice);
+
+      executor.spin_until_future_complete(ready_future,
+        rmf_traffic::time::from_seconds(spin_time));
+
+      REQUIRE(result_winners.size() == 1);
+      return close_time - start;
+    };
+
+  wait_for_subscribers(2);
+
+  WHEN("Every subscriber responds")
+  {
+    // The no-bid of bidder2 counts as a response
+    const auto duration = run_auction(time_window, 3.0);
+    CHECK(result_winners.front() == "bidder1");
+    CHECK(duration < rclcpp::Duration(time_window));
+
+    AND_WHEN("A new fleet joins after the first auction")
+    {
+      auto bidder3 = MinimalBidder::make(
+        node, "bidder3", { TaskType::Station },
+        [](const BidNotice&)
+        {
+          Submission submission;
+          submission.new_cost = 1.0;
+          return submission;
+        });
+
+      wait_for_subscribers(3);
+
+      THEN("The next auction waits for the new fleet")
+      {
+        const auto next_duration = run_auction(time_window, 3.0);
+        CHECK(result_winners.front() == "bidder3");
+        CHECK(next_duration < rclcpp::Duration(time_window));
+      }
+    }
+  }
+
+  WHEN("A subscriber never responds")
+  {
+    using BidNoticeSub = rclcpp::Subscription<BidNotice>;
+    const BidNoticeSub::SharedPtr listener =
+      node->create_subscription<BidNotice>(
+        BidNoticeTopicName, rclcpp::ServicesQoS().reliable(),
+        [](const BidNotice::UniquePtr)
+        {
+          // Do nothing
+        });
+
+    wait_for_subscribers(3);
+
+    THEN("Only the first auction waits for its deadline")
+    {
+      const auto first_duration = run_auction(short_time_window, 2.0);
+      CHECK(result_winners.front() == "bidder1");
+      CHECK(first_duration >= rclcpp::Duration(short_time_window));
+
+      const auto next_duration = run_auction(time_window, 3.0);
+      CHECK(result_winners.front() == "bidder1");
+      CHECK(next_duration < rclcpp::Duration(time_window));
+    }
+  }
+
+  rclcpp::shutdown();
+}
+
+} // namespace bidding
+} // namespace rmf_task_ros2
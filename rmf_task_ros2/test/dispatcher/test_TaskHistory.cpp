@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "../../src/rmf_task_ros2/TaskHistory.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include <rmf_utils/catch.hpp>
+
+namespace rmf_task_ros2 {
+
+namespace {
+
+//==============================================================================
+TaskStatus make_status(std::size_t i)
+{
+  TaskStatus status;
+  status.task_profile.task_id = "Delivery" + std::to_string(i);
+  status.fleet_name = "dummy_fleet";
+  status.state = TaskStatus::State::Completed;
+  return status;
+}
+
+//==============================================================================
+rmf_traffic::Time make_time(std::size_t i)
+{
+  return rmf_traffic::Time(std::chrono::seconds(10*i));
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Task history in memory", "[TaskHistory]")
+{
+  TaskHistory history(3);
+  CHECK_FALSE(history.has_log());
+  CHECK(history.size() == 0);
+  CHECK(history.page(0, 10).empty());
+
+  for (std::size_t i = 0; i < 5; ++i)
+    history.push(make_status(i), make_time(i));
+
+  // Only the most recent tasks are kept, and the oldest are evicted first
+  CHECK(history.size() == 3);
+  CHECK(history.memory_size() == 3);
+  CHECK(history.terminated_tasks().size() == 3);
+  CHECK(history.terminated_tasks().count("Delivery2"));
+  CHECK_FALSE(history.terminated_tasks().count("Delivery1"));
+  CHECK_FALSE(history.find("Delivery0"));
+  REQUIRE(history.find("Delivery4"));
+  CHECK(history.find("Delivery4")->state == TaskStatus::State::Completed);
+
+  const auto page = history.page(1, 5);
+  REQUIRE(page.size() == 2);
+  CHECK(page[0].task_profile.task_id == "Delivery3");
+  CHECK(page[1].task_profile.task_id == "Delivery2");
+
+  const auto since = history.since(make_time(3), 5);
+  REQUIRE(since.size() == 2);
+  CHECK(since[0].task_profile.task_id == "Delivery3");
+  CHECK(since[1].task_profile.task_id == "Delivery4");
+  CHECK(history.since(make_time(3), 1).size() == 1);
+  CHECK(history.since(make_time(10), 5).empty());
+}
+
+//==============================================================================
+SCENARIO("Task history with a log", "[TaskHistory]")
+{
+  char path[] = "/tmp/rmf_task_history_XXXXXX";
+  const int fd = mkstemp(path);
+  REQUIRE(fd >= 0);
+  close(fd);
+
+  {
+    TaskHistory history(2, path);
+    CHECK(history.has_log());
+    for (std::size_t i = 0; i < 6; ++i)
+      history.push(make_status(i), make_time(i));
+
+    CHECK(history.memory_size() == 2);
+    CHECK(history.size() == 6);
+
+    // Evicted tasks are read back from the log
+    REQUIRE(history.find("Delivery1"));
+    CHECK(history.find("Delivery1")->fleet_name == "dummy_fleet");
+
+    const auto page = history.page(1, 3);
+    REQUIRE(page.size() == 3);
+    CHECK(page[0].task_profile.task_id == "Delivery4");
+    CHECK(page[2].task_profile.task_id == "Delivery2");
+
+    const auto since = history.since(make_time(1), 2);
+    REQUIRE(since.size() == 2);
+    CHECK(since[0].task_profile.task_id == "Delivery1");
+    CHECK(since[1].task_profile.task_id == "Delivery2");
+  }
+
+  {
+    // The history survives a restart
+    TaskHistory history(2, path);
+    CHECK(history.size() == 6);
+    CHECK(history.terminated_tasks().size() == 2);
+    CHECK(history.terminated_tasks().count("Delivery5"));
+    REQUIRE(history.find("Delivery0"));
+
+    history.push(make_status(6), make_time(6));
+    CHECK(history.size() == 7);
+    REQUIRE(history.page(0, 1).size() == 1);
+    CHECK(history.page(0, 1)[0].task_profile.task_id == "Delivery6");
+  }
+
+  std::remove(path);
+}
+
+//==============================================================================
+SCENARIO("Querying the task history while it grows", "[TaskHistory]")
+{
+  char path[] = "/tmp/rmf_task_history_XXXXXX";
+  const int fd = mkstemp(path);
+  REQUIRE(fd >= 0);
+  close(fd);
+
+  const std::size_t count = 200;
+  TaskHistory history(2, path);
+
+  std::atomic_bool done = false;
+  std::atomic_bool consistent = true;
+  std::thread reader(
+    [&]()
+    {
+      while (!done)
+      {
+        // Each page must hold consecutive tasks, most recent first, even
+        // though the log is remapped while it is being read.
+        const auto page = history.page(1, 5);
+        for (std::size_t i = 1; i < page.size(); ++i)
+        {
+          const auto& id = page[i].task_profile.task_id;
+          const auto& newer = page[i-1].task_profile.task_id;
+          const auto index =
+            std::stoul(id.substr(std::string("Delivery").size()));
+          if (newer != "Delivery" + std::to_string(index + 1))
+            consistent = false;
+        }
+      }
+    });
+
+  for (std::size_t i = 0; i < count; ++i)
+    history.push(make_status(i), make_time(i));
+
+  done = true;
+  reader.join();
+
+  CHECK(consistent);
+  CHECK(history.size() == count);
+  REQUIRE(history.find("Delivery0"));
+  CHECK(history.find("Delivery0")->fleet_name == "dummy_fleet");
+
+  std::remove(path);
+}
+
+} // namespace rmf_task_ros2
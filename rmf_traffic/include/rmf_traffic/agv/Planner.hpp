@@ -224,6 +224,21 @@ public:
     /// Get the saturation limit.
     rmf_utils::optional<std::size_t> saturation_limit() const;
 
+    /// Toggle safe interval planning. When this is turned on, the planner will
+    /// not queue up a separate search node for every period of
+    /// minimum_holding_time that it might wait at a waypoint. Instead it will
+    /// find the interval of time that the waypoint stays free of conflicts,
+    /// and then branch off of the earliest moment within that interval that
+    /// each outgoing lane can be traversed. This can greatly reduce the size
+    /// of the search when the schedule is crowded.
+    ///
+    /// The plans that are produced have the same format and are checked by
+    /// the same RouteValidator either way. This is turned off by default.
+    Options& safe_interval_planning(bool on);
+
+    /// Check whether safe interval planning is turned on.
+    bool safe_interval_planning() const;
+
     class Implementation;
   private:
     rmf_utils::impl_ptr<Implementation> _pimpl;
@@ -386,6 +401,43 @@ public:
   /// Get a const reference to the default planning options.
   const Options& get_default_options() const;
 
+  /// Statistics about how often the plan cache of a Planner was able to
+  /// provide a plan.
+  struct PlanCacheStatistics
+  {
+    /// The number of plan requests that were answered by the cache.
+    std::size_t hits = 0;
+
+    /// The number of plan requests that looked in the cache but needed to be
+    /// searched for.
+    std::size_t misses = 0;
+
+    /// The fraction of cache lookups that were hits. This is 0 if the cache
+    /// has never been used.
+    double hit_rate() const;
+  };
+
+  /// Set how many recent plans this Planner should remember. When a plan is
+  /// requested for a single start that matches the conditions of a remembered
+  /// plan, and the remembered plan went to the same goal, then the remembered
+  /// plan will be shifted to the new start time and checked against the
+  /// validator of the Options. If it is still valid, it will be returned
+  /// without performing a search.
+  ///
+  /// Only plans that reach their goal without any waiting or detours are
+  /// remembered, so a remembered plan that is still valid is always as good as
+  /// the plan that a search would have produced.
+  ///
+  /// The cache is turned off by default. Setting the capacity to 0 turns it
+  /// off. Changing the capacity will clear the cache and its statistics.
+  Planner& set_plan_cache_capacity(std::size_t capacity);
+
+  /// Get how many recent plans this Planner will remember.
+  std::size_t get_plan_cache_capacity() const;
+
+  /// Get the statistics of the plan cache.
+  PlanCacheStatistics get_plan_cache_statistics() const;
+
   using StartSet = std::vector<Start>;
 
   /// Produce a plan for the given starting conditions and goal. The default
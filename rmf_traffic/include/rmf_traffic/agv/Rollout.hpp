@@ -92,6 +92,91 @@ public:
       rmf_traffic::Duration span,
       rmf_utils::optional<std::size_t> max_rollouts = rmf_utils::nullopt) const;
 
+  /// An Expansion carries out the same work as expand(), but it can be done a
+  /// little at a time. Between calls to resume() you can look at the best
+  /// alternatives that have been found so far, so the expansion can be shared
+  /// with other work or cut short once its results are good enough.
+  class Expansion
+  {
+  public:
+
+    /// Keep expanding until every rollout is finished, or until the
+    /// interrupter of the Options is triggered.
+    ///
+    /// \return true if the expansion is finished, false otherwise.
+    bool resume();
+
+    /// Keep expanding for no longer than the given slice of time.
+    ///
+    /// \note At least one node will be expanded each time this is called, so
+    /// the expansion will always make progress, even for a zero slice.
+    ///
+    /// \param[in] slice
+    ///   The maximum amount of time to spend expanding before returning.
+    ///
+    /// \return true if the expansion is finished, false otherwise.
+    bool resume(rmf_traffic::Duration slice);
+
+    /// Keep expanding while listening to a new interrupt flag.
+    ///
+    /// \param[in] interrupt_flag
+    ///   A new interrupt flag to listen to while expanding.
+    ///
+    /// \return true if the expansion is finished, false otherwise.
+    bool resume(std::shared_ptr<const bool> interrupt_flag);
+
+    /// True if there is nothing left to expand.
+    bool finished() const;
+
+    /// Get the alternatives that have been found so far, ordered from best to
+    /// worst. Once the expansion is finished, this will be the same as the
+    /// result of Rollout::expand().
+    std::vector<schedule::Itinerary> alternatives() const;
+
+    class Implementation;
+  private:
+    Expansion();
+    rmf_utils::unique_impl_ptr<Implementation> _pimpl;
+  };
+
+  /// Begin expanding the Planning Result through the specified blocker, but do
+  /// not start iterating. Use Expansion::resume() to do the work.
+  ///
+  /// \param[in] blocker
+  ///   The blocking participant that should be expanded through. If this
+  ///   participant wasn't actually blocking, then the Expansion will already be
+  ///   finished and it will not have any alternatives.
+  ///
+  /// \param[in] span
+  ///   How far into the future the rollout should continue. Once a rollout
+  ///   extends this far, it will stop wherever it is.
+  ///
+  /// \param[in] options
+  ///   The options to use while expanding. NOTE: It is important to provide a
+  ///   RouteValidator that will ignore the blocker, otherwise the expansion
+  ///   might not give back any useful results.
+  ///
+  /// \param[in] max_rollouts
+  ///   The maximum number of rollouts to produce.
+  Expansion begin(
+      schedule::ParticipantId blocker,
+      rmf_traffic::Duration span,
+      const Planner::Options& options,
+      rmf_utils::optional<std::size_t> max_rollouts = rmf_utils::nullopt) const;
+
+  /// Begin expanding the Planning Result through the specified blocker, using
+  /// the Options that are already tied to the Planning Result.
+  ///
+  /// \warning The same warning applies here as for the expand() overload that
+  /// does not take in Options.
+  ///
+  /// \sa begin(schedule::ParticipantId, rmf_traffic::Duration,
+  /// const Planner::Options&, rmf_utils::optional<std::size_t>)
+  Expansion begin(
+      schedule::ParticipantId blocker,
+      rmf_traffic::Duration span,
+      rmf_utils::optional<std::size_t> max_rollouts = rmf_utils::nullopt) const;
+
   class Implementation;
 private:
   rmf_utils::impl_ptr<Implementation> _pimpl;
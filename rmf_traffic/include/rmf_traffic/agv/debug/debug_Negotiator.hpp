@@ -30,6 +30,10 @@ public:
 
   static SimpleNegotiator& enable_debug_print(SimpleNegotiator& negotiator);
 
+  /// The number of times that the negotiator has reused a previous response
+  /// instead of planning again.
+  static std::size_t reused_responses(const SimpleNegotiator& negotiator);
+
 };
 
 } // namespace agv
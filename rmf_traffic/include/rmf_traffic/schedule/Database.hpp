@@ -204,6 +204,169 @@ public:
   // TODO(MXG): This function needs unit testing
   ItineraryVersion itinerary_version(ParticipantId participant) const;
 
+  //============================================================================
+  // Maintenance API
+  //============================================================================
+
+  /// Throw away the history of changes up to the specified version. The
+  /// current routes of the participants are not affected, and the version of
+  /// the schedule does not change, but changes() will no longer be able to
+  /// give an exact Patch to a mirror that is older than this version. Use
+  /// oldest_version() to know when a mirror needs a full update instead.
+  ///
+  /// This is meant to be called periodically on a long-running Database,
+  /// together with cull(), so that the history of delayed and erased routes
+  /// does not keep growing.
+  ///
+  /// \param[in] before
+  ///   The history of changes up to and including this version will be
+  ///   discarded. If this is newer than latest_version(), then
+  ///   latest_version() will be used instead.
+  ///
+  /// \return the number of route entries that were discarded.
+  std::size_t compact(Version before);
+
+  /// Drop the itinerary changes that are waiting on an inconsistency for any
+  /// participant that has more than the specified number of them waiting. The
+  /// newest waiting change of each of those participants is kept, and the
+  /// versions of the dropped changes will be reported as inconsistencies
+  /// again, so the participant will need to retransmit them.
+  ///
+  /// \param[in] max_staged_changes
+  ///   The most changes that may be waiting on an inconsistency for one
+  ///   participant.
+  ///
+  /// \return the IDs of the participants whose changes were dropped.
+  std::vector<ParticipantId> drop_staged_changes(
+    std::size_t max_staged_changes);
+
+  /// A summary of how much data the Database is keeping for one participant.
+  struct Footprint
+  {
+    ParticipantId participant;
+
+    /// The number of routes that are currently in the itinerary
+    std::size_t active_routes;
+
+    /// The number of route entries that are being kept, including the history
+    /// of changes and the routes that have been erased but not culled yet
+    std::size_t route_entries;
+
+    /// The number of itinerary changes that are waiting on an inconsistency
+    std::size_t staged_changes;
+
+    /// A rough estimate of the memory used by the route entries, in bytes
+    std::size_t bytes;
+  };
+
+  /// Get the Footprint of each participant in the Database.
+  std::vector<Footprint> footprint() const;
+
+  //============================================================================
+  // Persistence API
+  //============================================================================
+
+  /// A compact copy of the participants and active routes of a Database,
+  /// which can be used to restore the Database after a restart. It does not
+  /// contain the history of changes.
+  struct Checkpoint
+  {
+    struct Route
+    {
+      RouteId id;
+      ConstRoutePtr route;
+
+      /// The schedule version when this route last changed
+      Version version;
+    };
+
+    struct Participant
+    {
+      ParticipantId id;
+      std::shared_ptr<const ParticipantDescription> description;
+
+      /// The itinerary version that the Database expects next from this
+      /// participant
+      ItineraryVersion expected_itinerary_version;
+
+      /// The schedule version when this participant was registered
+      Version registration_version;
+
+      std::vector<Route> routes;
+    };
+
+    Version version;
+    ParticipantId next_participant_id;
+    std::vector<Participant> participants;
+  };
+
+  /// Get a Checkpoint of the current contents of this Database.
+  Checkpoint checkpoint() const;
+
+  /// Initialize a Database from a Checkpoint. The participants keep their IDs
+  /// and itinerary versions, so their writers can continue where they left
+  /// off. Any itinerary changes that were waiting on an inconsistency are
+  /// dropped, and will be reported as inconsistencies again when the next
+  /// change arrives.
+  Database(const Checkpoint& checkpoint);
+
+  /// The oldest version that changes() can give an exact Patch from. For a
+  /// Database that was restored from a Checkpoint, this is the version of the
+  /// Checkpoint, and compact() moves it forward. A mirror that is older than
+  /// this needs a full update instead.
+  Version oldest_version() const;
+
+  /// An interface for recording the changes of a Database in the order that
+  /// they get applied. Changes that are waiting on an inconsistency are only
+  /// recorded once they are applied. Replaying the recorded changes on a
+  /// Database that was restored from a Checkpoint will produce the same
+  /// schedule versions as the original.
+  class Journal
+  {
+  public:
+
+    virtual void set(
+      ParticipantId participant,
+      const Input& itinerary,
+      ItineraryVersion version) = 0;
+
+    virtual void extend(
+      ParticipantId participant,
+      const Input& routes,
+      ItineraryVersion version) = 0;
+
+    virtual void delay(
+      ParticipantId participant,
+      Duration delay,
+      ItineraryVersion version) = 0;
+
+    virtual void erase(
+      ParticipantId participant,
+      ItineraryVersion version) = 0;
+
+    virtual void erase(
+      ParticipantId participant,
+      const std::vector<RouteId>& routes,
+      ItineraryVersion version) = 0;
+
+    virtual void register_participant(
+      ParticipantId participant,
+      const ParticipantDescription& description) = 0;
+
+    /// The current time is the one that was given to set_current_time()
+    virtual void unregister_participant(
+      ParticipantId participant,
+      Time current_time) = 0;
+
+    virtual void cull(Time time) = 0;
+
+    virtual ~Journal() = default;
+  };
+
+  /// Set a Journal that will record every change to this Database. Pass in a
+  /// nullptr to stop recording.
+  void set_journal(std::shared_ptr<Journal> journal);
+
   class Implementation;
   class Debug;
 private:
@@ -201,6 +201,17 @@ public:
       /// Return the submission on this Negotiation Table if it has one.
       const Itinerary* submission() const;
 
+      /// The latest version of the schedule that the Negotiation is viewing.
+      /// Like defunct(), this is not a snapshot; it will change whenever any
+      /// participant, including ones outside of the Negotiation, updates the
+      /// schedule.
+      Version schedule_version() const;
+
+      /// An object that is shared by every Table of the same Negotiation. This
+      /// can be used to tell whether two Viewers belong to the same
+      /// Negotiation. The pointer will expire once the Negotiation is gone.
+      std::weak_ptr<const void> negotiation_key() const;
+
       class Implementation;
     private:
       Viewer();
@@ -902,9 +902,35 @@ bool detect_conflicts(
   if (output_conflicts)
     output_conflicts->clear();
 
+  // The region does not move, so we can prepare its collision objects and
+  // bounding boxes once instead of once per spline.
+  assert(region.shape);
+  const auto& region_shapes = geometry::FinalShape::Implementation
+    ::get_collisions(*region.shape);
+  const auto& region_bounds = geometry::FinalShape::Implementation
+    ::get_bounds(*region.shape);
+  assert(region_shapes.size() == region_bounds.size());
+
+  std::vector<FclContinuousCollisionObject> region_objects;
+  std::vector<BoundingBox> region_boxes;
+  region_objects.reserve(region_shapes.size());
+  region_boxes.reserve(region_shapes.size());
+  for (std::size_t i = 0; i < region_shapes.size(); ++i)
+  {
+    region_objects.emplace_back(region_shapes[i], motion_region);
+
+    const auto& bound = region_bounds[i];
+    const Eigen::Vector2d center = region.pose * bound.center;
+    region_boxes.push_back(
+      adjust_bounding_box(BoundingBox{center, center}, bound.radius));
+  }
+
+  const double vicinity_length = vicinity->get_characteristic_length();
   for (auto it = begin_it; it != end_it; ++it)
   {
     Spline spline_trajectory{it};
+    const BoundingBox spline_box =
+      adjust_bounding_box(get_bounding_box(spline_trajectory), vicinity_length);
 
     const Time spline_start_time =
       std::max(spline_trajectory.start_time(), start_time);
@@ -921,24 +947,15 @@ bool detect_conflicts(
       vicinity_geom, motion_trajectory);
 #endif
 
-    assert(region.shape);
-    const auto& region_shapes = geometry::FinalShape::Implementation
-      ::get_collisions(*region.shape);
-    for (const auto& region_shape : region_shapes)
+    for (std::size_t i = 0; i < region_objects.size(); ++i)
     {
-#ifdef RMF_TRAFFIC__USING_FCL_0_6
-      const auto obj_region = fcl::ContinuousCollisionObjectd(
-        region_shape, motion_region);
-#else
-      const auto obj_region = fcl::ContinuousCollisionObject(
-        region_shape, motion_region);
-#endif
-
-      // TODO(MXG): We should do a broadphase test here before using
-      // fcl::collide
+      // Skip the narrowphase check for any pieces of the region that are too
+      // far away from this spline to possibly collide with it.
+      if (!overlap(spline_box, region_boxes[i]))
+        continue;
 
       FclContinuousCollisionResult result;
-      fcl::collide(&obj_trajectory, &obj_region, request, result);
+      fcl::collide(&obj_trajectory, &region_objects[i], request, result);
       if (result.is_collide)
       {
         if (!output_conflicts)
@@ -22,6 +22,8 @@
 #include <rmf_utils/math.hpp>
 #include <rmf_utils/optional.hpp>
 
+#include <ostream>
+
 namespace rmf_traffic {
 namespace agv {
 
@@ -287,6 +289,34 @@ Graph::OrientationConstraint::make(
   return rmf_utils::make_clone<DirectionConstraint>(direction, forward);
 }
 
+namespace internal {
+//==============================================================================
+bool describe(
+  std::ostream& out,
+  const Graph::OrientationConstraint& constraint)
+{
+  if (const auto* acceptable =
+    dynamic_cast<const AcceptableOrientationConstraint*>(&constraint))
+  {
+    out << "acceptable[";
+    for (const double theta : acceptable->orientations)
+      out << theta << ",";
+    out << "]";
+    return true;
+  }
+
+  if (const auto* direction =
+    dynamic_cast<const DirectionConstraint*>(&constraint))
+  {
+    out << "direction[" << static_cast<int>(direction->direction)
+        << "," << direction->R_f.angle() << "]";
+    return true;
+  }
+
+  return false;
+}
+} // namespace internal
+
 //==============================================================================
 class Graph::Lane::Door::Implementation
 {
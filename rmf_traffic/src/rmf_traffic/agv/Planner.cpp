@@ -21,6 +21,8 @@
 #include "internal_Planner.hpp"
 #include "internal_planning.hpp"
 
+#include "planning/PlanCache.hpp"
+
 namespace rmf_traffic {
 namespace agv {
 
@@ -127,6 +129,8 @@ public:
   std::function<bool()> interrupter = nullptr;
   std::shared_ptr<const bool> interrupt_flag = nullptr;
 
+  bool safe_interval_planning = false;
+
 };
 
 //==============================================================================
@@ -260,6 +264,19 @@ rmf_utils::optional<std::size_t> Planner::Options::saturation_limit() const
   return _pimpl->saturation_limit;
 }
 
+//==============================================================================
+auto Planner::Options::safe_interval_planning(const bool on) -> Options&
+{
+  _pimpl->safe_interval_planning = on;
+  return *this;
+}
+
+//==============================================================================
+bool Planner::Options::safe_interval_planning() const
+{
+  return _pimpl->safe_interval_planning;
+}
+
 //==============================================================================
 class Planner::Start::Implementation
 {
@@ -441,6 +458,13 @@ public:
 
   Configuration configuration;
 
+  std::shared_ptr<planning::PlanCache> plan_cache = nullptr;
+
+  Result generate(
+    const std::vector<Planner::Start>& starts,
+    Planner::Goal goal,
+    Planner::Options options) const;
+
 };
 
 //==============================================================================
@@ -462,6 +486,11 @@ public:
     return plan;
   }
 
+  static const planning::PlanData& get(const Plan& plan)
+  {
+    return plan._pimpl->plan;
+  }
+
 };
 
 //==============================================================================
@@ -524,6 +553,28 @@ Planner::Result Planner::Result::Implementation::setup(
   return result;
 }
 
+//==============================================================================
+Planner::Result Planner::Result::Implementation::make(
+  planning::InterfacePtr interface,
+  const std::vector<Planner::Start>& starts,
+  Planner::Goal goal,
+  Planner::Options options,
+  planning::PlanData plan)
+{
+  auto state = interface->initiate(
+        starts, std::move(goal), std::move(options));
+
+  Planner::Result result;
+  result._pimpl = rmf_utils::make_impl<Implementation>(
+    Implementation{
+      std::move(interface),
+      std::move(state),
+      Plan::Implementation::make(std::move(plan))
+    });
+
+  return result;
+}
+
 //==============================================================================
 auto Planner::Result::Implementation::get(const Result& r)
 -> const Implementation&
@@ -531,6 +582,43 @@ auto Planner::Result::Implementation::get(const Result& r)
   return *r._pimpl;
 }
 
+//==============================================================================
+Planner::Result Planner::Implementation::generate(
+  const std::vector<Planner::Start>& starts,
+  Planner::Goal goal,
+  Planner::Options options) const
+{
+  if (!plan_cache || starts.size() != 1)
+  {
+    return Result::Implementation::generate(
+      interface, starts, std::move(goal), std::move(options));
+  }
+
+  const auto& start = starts.front();
+  if (auto cached = plan_cache->find(start, goal, options.validator().get()))
+  {
+    return Result::Implementation::make(
+      interface, starts, std::move(goal), std::move(options),
+      std::move(*cached));
+  }
+
+  auto result = Result::Implementation::generate(
+    interface, starts, goal, std::move(options));
+
+  const auto& result_impl = Result::Implementation::get(result);
+  if (result_impl.plan.has_value() && result_impl.state.ideal_cost.has_value())
+  {
+    // Only plans that did not need to wait or take a detour are worth
+    // remembering. Any waiting would add at least one minimum_holding_time
+    // to the cost, so this tolerance only needs to cover rounding.
+    const auto& plan = Plan::Implementation::get(*result_impl.plan);
+    if (plan.cost <= *result_impl.state.ideal_cost + 1e-3)
+      plan_cache->insert(plan, goal);
+  }
+
+  return result;
+}
+
 //==============================================================================
 auto Planner::get_configuration() const -> const Configuration&
 {
@@ -556,11 +644,56 @@ auto Planner::get_default_options() const -> const Options&
   return _pimpl->default_options;
 }
 
+//==============================================================================
+double Planner::PlanCacheStatistics::hit_rate() const
+{
+  const std::size_t lookups = hits + misses;
+  if (lookups == 0)
+    return 0.0;
+
+  return static_cast<double>(hits)/static_cast<double>(lookups);
+}
+
+//==============================================================================
+Planner& Planner::set_plan_cache_capacity(const std::size_t capacity)
+{
+  if (capacity == 0)
+  {
+    _pimpl->plan_cache = nullptr;
+    return *this;
+  }
+
+  const auto& interpolation = _pimpl->configuration.interpolation();
+  _pimpl->plan_cache = std::make_shared<planning::PlanCache>(
+    capacity,
+    interpolation.get_translation_threshold(),
+    interpolation.get_rotation_threshold());
+
+  return *this;
+}
+
+//==============================================================================
+std::size_t Planner::get_plan_cache_capacity() const
+{
+  if (!_pimpl->plan_cache)
+    return 0;
+
+  return _pimpl->plan_cache->capacity();
+}
+
+//==============================================================================
+auto Planner::get_plan_cache_statistics() const -> PlanCacheStatistics
+{
+  if (!_pimpl->plan_cache)
+    return PlanCacheStatistics();
+
+  return _pimpl->plan_cache->statistics();
+}
+
 //==============================================================================
 Planner::Result Planner::plan(const Start& start, Goal goal) const
 {
-  return Result::Implementation::generate(
-    _pimpl->interface,
+  return _pimpl->generate(
     {start},
     std::move(goal),
     _pimpl->default_options);
@@ -572,8 +705,7 @@ Planner::Result Planner::plan(
   Goal goal,
   Options options) const
 {
-  return Result::Implementation::generate(
-    _pimpl->interface,
+  return _pimpl->generate(
     {start},
     std::move(goal),
     std::move(options));
@@ -582,8 +714,7 @@ Planner::Result Planner::plan(
 //==============================================================================
 Planner::Result Planner::plan(const StartSet& starts, Goal goal) const
 {
-  return Result::Implementation::generate(
-    _pimpl->interface,
+  return _pimpl->generate(
     starts,
     std::move(goal),
     _pimpl->default_options);
@@ -595,8 +726,7 @@ Planner::Result Planner::plan(
   Goal goal,
   Options options) const
 {
-  return Result::Implementation::generate(
-    _pimpl->interface,
+  return _pimpl->generate(
     starts,
     std::move(goal),
     std::move(options));
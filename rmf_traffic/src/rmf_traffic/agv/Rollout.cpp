@@ -31,6 +31,77 @@ public:
 
 };
 
+//==============================================================================
+class Rollout::Expansion::Implementation
+{
+public:
+
+  // This will be a nullptr if the blocker did not actually block anything
+  std::unique_ptr<planning::Interface::RolloutProgress> progress;
+
+  static Expansion make(
+      std::unique_ptr<planning::Interface::RolloutProgress> progress)
+  {
+    Expansion output;
+    output._pimpl = rmf_utils::make_unique_impl<Implementation>(
+          Implementation{std::move(progress)});
+
+    return output;
+  }
+
+};
+
+//==============================================================================
+bool Rollout::Expansion::resume()
+{
+  if (finished())
+    return true;
+
+  _pimpl->progress->resume(std::nullopt);
+  return finished();
+}
+
+//==============================================================================
+bool Rollout::Expansion::resume(rmf_traffic::Duration slice)
+{
+  if (finished())
+    return true;
+
+  _pimpl->progress->resume(std::chrono::steady_clock::now() + slice);
+  return finished();
+}
+
+//==============================================================================
+bool Rollout::Expansion::resume(std::shared_ptr<const bool> interrupt_flag)
+{
+  if (finished())
+    return true;
+
+  _pimpl->progress->options().interrupt_flag(std::move(interrupt_flag));
+  return resume();
+}
+
+//==============================================================================
+bool Rollout::Expansion::finished() const
+{
+  return !_pimpl->progress || _pimpl->progress->finished();
+}
+
+//==============================================================================
+std::vector<schedule::Itinerary> Rollout::Expansion::alternatives() const
+{
+  if (!_pimpl->progress)
+    return {};
+
+  return _pimpl->progress->alternatives();
+}
+
+//==============================================================================
+Rollout::Expansion::Expansion()
+{
+  // Do nothing
+}
+
 //==============================================================================
 Rollout::Rollout(Planner::Result result)
   : _pimpl(rmf_utils::make_impl<Implementation>(
@@ -47,32 +118,54 @@ std::vector<schedule::Itinerary> Rollout::expand(
     rmf_traffic::Duration span,
     const Planner::Options& options,
     rmf_utils::optional<std::size_t> max_rollouts) const
+{
+  auto expansion = begin(blocker, span, options, max_rollouts);
+  expansion.resume();
+  return expansion.alternatives();
+}
+
+//==============================================================================
+std::vector<schedule::Itinerary> Rollout::expand(
+    schedule::ParticipantId blocker,
+    rmf_traffic::Duration span,
+    rmf_utils::optional<std::size_t> max_rollouts) const
+{
+  return expand(blocker, span, _pimpl->result.options(), max_rollouts);
+}
+
+//==============================================================================
+auto Rollout::begin(
+    schedule::ParticipantId blocker,
+    rmf_traffic::Duration span,
+    const Planner::Options& options,
+    rmf_utils::optional<std::size_t> max_rollouts) const -> Expansion
 {
   const auto& result = Planner::Result::Implementation::get(_pimpl->result);
   const auto& blocker_map = result.state.issues.blocked_nodes;
 
   const auto block_it = blocker_map.find(blocker);
   if (block_it == blocker_map.end())
-    return {};
+    return Expansion::Implementation::make(nullptr);
 
   if (block_it->second.empty())
-    return {};
+    return Expansion::Implementation::make(nullptr);
 
-  return result.interface->rollout(
-        span,
-        block_it->second,
-        result.state.conditions.goal,
-        options,
-        max_rollouts);
+  return Expansion::Implementation::make(
+    result.interface->rollout_begin(
+      span,
+      block_it->second,
+      result.state.conditions.goal,
+      options,
+      max_rollouts));
 }
 
 //==============================================================================
-std::vector<schedule::Itinerary> Rollout::expand(
+auto Rollout::begin(
     schedule::ParticipantId blocker,
     rmf_traffic::Duration span,
-    rmf_utils::optional<std::size_t> max_rollouts) const
+    rmf_utils::optional<std::size_t> max_rollouts) const -> Expansion
 {
-  return expand(blocker, span, _pimpl->result.options(), max_rollouts);
+  return begin(blocker, span, _pimpl->result.options(), max_rollouts);
 }
 
 } // namespace agv
@@ -18,9 +18,331 @@
 #include <rmf_traffic/agv/RouteValidator.hpp>
 #include <rmf_traffic/DetectConflict.hpp>
 
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
 namespace rmf_traffic {
 namespace agv {
 
+namespace {
+//==============================================================================
+/// The routes of one map, as they were in one version of the schedule
+struct MapCandidates
+{
+  struct Candidate
+  {
+    schedule::ParticipantId participant;
+    const Route* route;
+    const Profile* profile;
+    Time start_time;
+    Time finish_time;
+  };
+
+  // The view owns the routes and descriptions that the candidates point to
+  schedule::Viewer::View view;
+  std::vector<Candidate> candidates;
+};
+
+//==============================================================================
+/// The planner will call find_conflict() many thousands of times per search
+/// while the schedule stays the same. Instead of querying the schedule each
+/// time, we query each map once per schedule version and filter the result by
+/// time window for each route that needs to be validated.
+class CandidateCache
+{
+public:
+
+  std::shared_ptr<const MapCandidates> get(
+    const schedule::Viewer& viewer,
+    const std::string& map)
+  {
+    const auto version = viewer.latest_version();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_version.has_value() || *_version != version)
+    {
+      _maps.clear();
+      _version = version;
+    }
+
+    auto& entry = _maps[map];
+    if (!entry)
+      entry = make_candidates(viewer, map);
+
+    return entry;
+  }
+
+private:
+
+  static std::shared_ptr<const MapCandidates> make_candidates(
+    const schedule::Viewer& viewer,
+    const std::string& map)
+  {
+    schedule::Query::Spacetime spacetime;
+    spacetime.query_timespan()
+        .all_maps(false)
+        .add_map(map);
+
+    auto candidates = std::make_shared<MapCandidates>(
+      MapCandidates{
+        viewer.query(spacetime, schedule::Query::Participants::make_all()),
+        {}
+      });
+
+    candidates->candidates.reserve(candidates->view.size());
+    for (const auto& v : candidates->view)
+    {
+      const auto& trajectory = v.route.trajectory();
+      if (!trajectory.start_time())
+        continue;
+
+      candidates->candidates.push_back(
+        MapCandidates::Candidate{
+          v.participant,
+          &v.route,
+          &v.description.profile(),
+          *trajectory.start_time(),
+          *trajectory.finish_time()
+        });
+    }
+
+    return candidates;
+  }
+
+  std::mutex _mutex;
+  std::optional<schedule::Version> _version;
+  std::unordered_map<std::string, std::shared_ptr<const MapCandidates>> _maps;
+};
+
+//==============================================================================
+double get_reach(const Profile& profile)
+{
+  double reach = 0.0;
+  if (const auto& footprint = profile.footprint())
+    reach = std::max(reach, footprint->get_characteristic_length());
+
+  if (const auto& vicinity = profile.vicinity())
+    reach = std::max(reach, vicinity->get_characteristic_length());
+
+  return reach;
+}
+
+//==============================================================================
+/// A region of space over an interval of time
+struct TimeBox
+{
+  Eigen::Vector2d min;
+  Eigen::Vector2d max;
+  Time start;
+  Time finish;
+
+  bool overlaps(const TimeBox& other) const
+  {
+    if (finish < other.start || other.finish < start)
+      return false;
+
+    for (int i = 0; i < 2; ++i)
+    {
+      if (max[i] < other.min[i] || other.max[i] < min[i])
+        return false;
+    }
+
+    return true;
+  }
+};
+
+//==============================================================================
+/// Get a box around each segment of the trajectory, grown by the reach of the
+/// participant that is following it. Each segment is a cubic Hermite spline,
+/// so it always stays inside the convex hull of its Bezier control points.
+std::vector<TimeBox> get_segment_boxes(
+  const Trajectory& trajectory,
+  const double reach)
+{
+  std::vector<TimeBox> boxes;
+  if (trajectory.size() < 2)
+    return boxes;
+
+  boxes.reserve(trajectory.size() - 1);
+  auto it = trajectory.begin();
+  auto prev = it++;
+  for (; it != trajectory.end(); prev = it++)
+  {
+    const double dt = time::to_seconds(it->time() - prev->time());
+    const Eigen::Vector2d p0 = prev->position().block<2, 1>(0, 0);
+    const Eigen::Vector2d p1 = it->position().block<2, 1>(0, 0);
+    const Eigen::Vector2d c0 = p0 + dt/3.0 * prev->velocity().block<2, 1>(0, 0);
+    const Eigen::Vector2d c1 = p1 - dt/3.0 * it->velocity().block<2, 1>(0, 0);
+
+    const Eigen::Vector2d min = p0.cwiseMin(p1).cwiseMin(c0).cwiseMin(c1);
+    const Eigen::Vector2d max = p0.cwiseMax(p1).cwiseMax(c0).cwiseMax(c1);
+    boxes.push_back(
+      TimeBox{
+        min.array() - reach,
+        max.array() + reach,
+        prev->time(),
+        it->time()
+      });
+  }
+
+  return boxes;
+}
+
+//==============================================================================
+/// A time-indexed occupancy grid of the routes on one map. The routes inside
+/// of a negotiation table are frozen while a participant is planning its
+/// response, so this gets built once and then each route that needs to be
+/// validated only needs a few lookups to find out which of the frozen routes
+/// could possibly conflict with it.
+class MapOccupancy
+{
+public:
+
+  static constexpr double CellSize = 2.0;
+
+  struct Occupant
+  {
+    schedule::ParticipantId participant;
+    const Route* route;
+    const Profile* profile;
+
+    // True if we cannot describe the occupancy of this route with boxes, so it
+    // should always be checked directly.
+    bool always_check;
+  };
+
+  MapOccupancy(schedule::Viewer::View view_)
+  : view(std::move(view_))
+  {
+    occupants.reserve(view.size());
+    for (const auto& v : view)
+    {
+      const std::size_t index = occupants.size();
+      const auto& trajectory = v.route.trajectory();
+      occupants.push_back(
+        Occupant{
+          v.participant,
+          &v.route,
+          &v.description.profile(),
+          trajectory.size() < 2
+        });
+
+      const double reach = get_reach(v.description.profile());
+      for (const auto& box : get_segment_boxes(trajectory, reach))
+        _insert(index, box);
+    }
+  }
+
+  /// Find which occupants might conflict with a route whose segments fit
+  /// inside of these boxes.
+  std::vector<bool> find_candidates(const std::vector<TimeBox>& boxes) const
+  {
+    std::vector<bool> candidates(occupants.size(), false);
+    for (std::size_t i = 0; i < occupants.size(); ++i)
+      candidates[i] = occupants[i].always_check;
+
+    for (const auto& box : boxes)
+    {
+      _for_each_cell(
+        box, [&](const CellKey key)
+        {
+          const auto cell_it = _cells.find(key);
+          if (cell_it == _cells.end())
+            return;
+
+          for (const std::size_t e : cell_it->second)
+          {
+            const auto& entry = _entries[e];
+            if (candidates[entry.occupant])
+              continue;
+
+            if (entry.box.overlaps(box))
+              candidates[entry.occupant] = true;
+          }
+        });
+    }
+
+    return candidates;
+  }
+
+  // The view owns the routes and descriptions that the occupants point to
+  schedule::Viewer::View view;
+  std::vector<Occupant> occupants;
+
+private:
+
+  using CellKey = uint64_t;
+
+  struct Entry
+  {
+    std::size_t occupant;
+    TimeBox box;
+  };
+
+  void _insert(const std::size_t occupant, const TimeBox& box)
+  {
+    const std::size_t e = _entries.size();
+    _entries.push_back(Entry{occupant, box});
+    _for_each_cell(
+      box, [&](const CellKey key)
+      {
+        _cells[key].push_back(e);
+      });
+  }
+
+  template<typename F>
+  static void _for_each_cell(const TimeBox& box, F&& f)
+  {
+    const int64_t x0 = static_cast<int64_t>(std::floor(box.min[0]/CellSize));
+    const int64_t x1 = static_cast<int64_t>(std::floor(box.max[0]/CellSize));
+    const int64_t y0 = static_cast<int64_t>(std::floor(box.min[1]/CellSize));
+    const int64_t y1 = static_cast<int64_t>(std::floor(box.max[1]/CellSize));
+    for (int64_t x = x0; x <= x1; ++x)
+    {
+      for (int64_t y = y0; y <= y1; ++y)
+      {
+        f((static_cast<CellKey>(static_cast<uint32_t>(x)) << 32)
+          | static_cast<CellKey>(static_cast<uint32_t>(y)));
+      }
+    }
+  }
+
+  std::vector<Entry> _entries;
+  std::unordered_map<CellKey, std::vector<std::size_t>> _cells;
+};
+
+//==============================================================================
+const double MapOccupancy::CellSize;
+
+//==============================================================================
+/// The occupancy of every map that a NegotiatingRouteValidator has been asked
+/// about. This is shared by the clones of a validator.
+class OccupancyCache
+{
+public:
+
+  template<typename MakeView>
+  std::shared_ptr<const MapOccupancy> get(
+    const std::string& map,
+    MakeView&& make_view)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& entry = _maps[map];
+    if (!entry)
+      entry = std::make_shared<MapOccupancy>(make_view());
+
+    return entry;
+  }
+
+private:
+  std::mutex _mutex;
+  std::unordered_map<std::string, std::shared_ptr<const MapOccupancy>> _maps;
+};
+
+} // anonymous namespace
+
 //==============================================================================
 class ScheduleRouteValidator::Implementation
 {
@@ -31,6 +353,10 @@ public:
   schedule::ParticipantId participant;
   Profile profile;
 
+  // This is shared by all the clones of this validator, since they will all be
+  // looking at the same schedule.
+  std::shared_ptr<CandidateCache> cache = std::make_shared<CandidateCache>();
+
 };
 
 //==============================================================================
@@ -70,6 +396,7 @@ ScheduleRouteValidator& ScheduleRouteValidator::schedule_viewer(
   const schedule::Viewer& viewer)
 {
   _pimpl->viewer = &viewer;
+  _pimpl->cache = std::make_shared<CandidateCache>();
   return *this;
 }
 
@@ -97,30 +424,26 @@ schedule::ParticipantId ScheduleRouteValidator::participant() const
 rmf_utils::optional<RouteValidator::Conflict>
 ScheduleRouteValidator::find_conflict(const Route& route) const
 {
-  // TODO(MXG): Should we use a mutable Spacetime instance to avoid the
-  // allocation here?
-  schedule::Query::Spacetime spacetime;
-  spacetime.query_timespan()
-      .all_maps(false)
-      .add_map(route.map())
-      .set_lower_time_bound(*route.trajectory().start_time())
-      .set_upper_time_bound(*route.trajectory().finish_time());
+  const auto& trajectory = route.trajectory();
+  const Time start_time = *trajectory.start_time();
+  const Time finish_time = *trajectory.finish_time();
 
-  const auto view = _pimpl->viewer->query(
-        spacetime, schedule::Query::Participants::make_all());
-
-  for (const auto& v : view)
+  const auto candidates = _pimpl->cache->get(*_pimpl->viewer, route.map());
+  for (const auto& c : candidates->candidates)
   {
-    if (v.participant == _pimpl->participant)
+    if (c.participant == _pimpl->participant)
+      continue;
+
+    if (c.finish_time < start_time || finish_time < c.start_time)
       continue;
 
     if (const auto time = rmf_traffic::DetectConflict::between(
         _pimpl->profile,
-        route.trajectory(),
-        v.description.profile(),
-        v.route.trajectory()))
+        trajectory,
+        *c.profile,
+        c.route->trajectory()))
     {
-      return Conflict{v.participant, *time};
+      return Conflict{c.participant, *time};
     }
   }
 
@@ -191,6 +514,12 @@ public:
   schedule::Negotiation::VersionedKeySequence rollouts;
   rmf_utils::optional<schedule::ParticipantId> masked = rmf_utils::nullopt;
 
+  // The routes of the table are frozen for as long as this validator is being
+  // used, so we only need to work out their occupancy once. Validators made by
+  // next() use different rollouts, so they get their own cache.
+  std::shared_ptr<OccupancyCache> occupancy =
+    std::make_shared<OccupancyCache>();
+
   static NegotiatingRouteValidator make(
     std::shared_ptr<const Generator::Implementation::Data> data,
     schedule::Negotiation::VersionedKeySequence rollouts)
@@ -379,19 +708,31 @@ bool NegotiatingRouteValidator::end() const
 rmf_utils::optional<RouteValidator::Conflict>
 NegotiatingRouteValidator::find_conflict(const Route& route) const
 {
-  // TODO(MXG): Consider if we can reduce the amount of heap allocation that's
-  // needed here.
-  schedule::Query::Spacetime spacetime;
-  spacetime.query_timespan()
-      .all_maps(false)
-      .add_map(route.map())
-      .set_lower_time_bound(*route.trajectory().start_time())
-      .set_upper_time_bound(*route.trajectory().finish_time());
-
-  const auto view = _pimpl->data->viewer->query(spacetime, _pimpl->rollouts);
-
-  for (const auto& v : view)
+  const auto occupancy = _pimpl->occupancy->get(
+    route.map(), [&]()
+    {
+      schedule::Query::Spacetime spacetime;
+      spacetime.query_timespan()
+          .all_maps(false)
+          .add_map(route.map());
+
+      return _pimpl->data->viewer->query(spacetime, _pimpl->rollouts);
+    });
+
+  // Most of the frozen routes can be ruled out by looking up the occupancy of
+  // the space and time that this route passes through. We only need to do a
+  // full collision check against the routes that remain.
+  const auto candidates = route.trajectory().size() < 2 ?
+    std::vector<bool>(occupancy->occupants.size(), true) :
+    occupancy->find_candidates(
+      get_segment_boxes(route.trajectory(), get_reach(_pimpl->data->profile)));
+
+  for (std::size_t i = 0; i < occupancy->occupants.size(); ++i)
   {
+    if (!candidates[i])
+      continue;
+
+    const auto& v = occupancy->occupants[i];
     if (_pimpl->masked && (*_pimpl->masked == v.participant))
       continue;
 
@@ -400,8 +741,8 @@ NegotiatingRouteValidator::find_conflict(const Route& route) const
     if (const auto time = rmf_traffic::DetectConflict::between(
         _pimpl->data->profile,
         route.trajectory(),
-        v.description.profile(),
-        v.route.trajectory()))
+        *v.profile,
+        v.route->trajectory()))
     {
       return Conflict{v.participant, *time};
     }
@@ -19,8 +19,13 @@
 #include <rmf_traffic/agv/Rollout.hpp>
 #include <rmf_traffic/agv/debug/debug_Negotiator.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
 namespace rmf_traffic {
 namespace agv {
@@ -162,6 +167,424 @@ Duration SimpleNegotiator::Options::minimum_holding_time() const
   return _pimpl->minimum_holding_time;
 }
 
+namespace {
+//==============================================================================
+void hash_combine(std::size_t& seed, const std::size_t value)
+{
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+//==============================================================================
+std::size_t hash_route(const Route& route)
+{
+  std::size_t seed = std::hash<std::string>()(route.map());
+  for (const auto& wp : route.trajectory())
+  {
+    hash_combine(seed, std::hash<Time::rep>()(wp.time().time_since_epoch().count()));
+    const Eigen::Vector3d p = wp.position();
+    const Eigen::Vector3d v = wp.velocity();
+    for (int i = 0; i < 3; ++i)
+    {
+      hash_combine(seed, std::hash<double>()(p[i]));
+      hash_combine(seed, std::hash<double>()(v[i]));
+    }
+  }
+
+  return seed;
+}
+
+//==============================================================================
+std::size_t hash_itinerary(const schedule::Itinerary& itinerary)
+{
+  std::size_t seed = itinerary.size();
+  for (const auto& route : itinerary)
+    hash_combine(seed, hash_route(*route));
+
+  return seed;
+}
+
+//==============================================================================
+bool same_route(const ConstRoutePtr& a, const ConstRoutePtr& b)
+{
+  if (a == b)
+    return true;
+
+  if (a->map() != b->map())
+    return false;
+
+  const auto& t_a = a->trajectory();
+  const auto& t_b = b->trajectory();
+  if (t_a.size() != t_b.size())
+    return false;
+
+  auto it_a = t_a.begin();
+  auto it_b = t_b.begin();
+  for (; it_a != t_a.end(); ++it_a, ++it_b)
+  {
+    if (it_a->time() != it_b->time())
+      return false;
+
+    if (it_a->position() != it_b->position())
+      return false;
+
+    if (it_a->velocity() != it_b->velocity())
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+bool same_itinerary(
+  const schedule::Itinerary& a,
+  const schedule::Itinerary& b)
+{
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), same_route);
+}
+
+//==============================================================================
+/// Remembers the responses that a SimpleNegotiator has given so that it does
+/// not need to plan again when it is asked to respond to a table whose
+/// accommodated itineraries match a table that it has already responded to.
+/// Responses are only kept for as long as their negotiation is alive.
+class ResponseCache
+{
+public:
+
+  using ParticipantId = schedule::ParticipantId;
+  using Version = schedule::Version;
+  using Viewer = schedule::Negotiation::Table::Viewer;
+  using Responder = schedule::Negotiator::Responder;
+  using Submission = schedule::Negotiation::Submission;
+  using Alternatives = schedule::Negotiation::Alternatives;
+
+  /// The most responses that will be kept for any one negotiation
+  static constexpr std::size_t MaxResponsesPerNegotiation = 64;
+
+  struct Response
+  {
+    enum class Type
+    {
+      Submit,
+      Reject,
+      Forfeit
+    };
+
+    Type type;
+    std::vector<Route> itinerary;
+    std::optional<Plan> plan;
+    Alternatives alternatives;
+    std::vector<ParticipantId> blockers;
+  };
+
+  using ConstResponsePtr = std::shared_ptr<const Response>;
+
+  /// Everything about a table that can influence the response of the
+  /// negotiator. Tables that were reached through a different sequence of
+  /// participants produce the same key as long as they ask the negotiator to
+  /// accommodate the same itineraries, so the order of the submissions and
+  /// the versions of the tables are left out.
+  struct Key
+  {
+    Version schedule_version;
+    ParticipantId participant;
+    std::vector<Submission> to_accommodate;
+    std::vector<std::pair<ParticipantId,
+      std::shared_ptr<const Alternatives>>> alternatives;
+    std::size_t hash;
+
+    bool operator==(const Key& other) const
+    {
+      if (hash != other.hash
+        || schedule_version != other.schedule_version
+        || participant != other.participant
+        || to_accommodate.size() != other.to_accommodate.size()
+        || alternatives.size() != other.alternatives.size())
+        return false;
+
+      for (std::size_t i = 0; i < to_accommodate.size(); ++i)
+      {
+        const auto& a = to_accommodate[i];
+        const auto& b = other.to_accommodate[i];
+        if (a.participant != b.participant
+          || !same_itinerary(a.itinerary, b.itinerary))
+          return false;
+      }
+
+      for (std::size_t i = 0; i < alternatives.size(); ++i)
+      {
+        const auto& a = alternatives[i];
+        const auto& b = other.alternatives[i];
+        if (a.first != b.first)
+          return false;
+
+        if (a.second == b.second)
+          continue;
+
+        if (!std::equal(
+            a.second->begin(), a.second->end(),
+            b.second->begin(), b.second->end(), same_itinerary))
+          return false;
+      }
+
+      return true;
+    }
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const
+    {
+      return key.hash;
+    }
+  };
+
+  static Key make_key(const Viewer& viewer)
+  {
+    Key key;
+    key.schedule_version = viewer.schedule_version();
+    key.participant = viewer.sequence().back().participant;
+
+    key.to_accommodate = viewer.base_proposals();
+    std::sort(
+      key.to_accommodate.begin(), key.to_accommodate.end(),
+      [](const Submission& a, const Submission& b)
+      {
+        return a.participant < b.participant;
+      });
+
+    for (const auto& a : viewer.alternatives())
+      key.alternatives.push_back({a.first, a.second});
+
+    std::sort(key.alternatives.begin(), key.alternatives.end());
+
+    key.hash = std::hash<Version>()(key.schedule_version);
+    hash_combine(key.hash, std::hash<ParticipantId>()(key.participant));
+    for (const auto& submission : key.to_accommodate)
+    {
+      hash_combine(key.hash, std::hash<ParticipantId>()(submission.participant));
+      hash_combine(key.hash, hash_itinerary(submission.itinerary));
+    }
+
+    for (const auto& a : key.alternatives)
+    {
+      hash_combine(key.hash, std::hash<ParticipantId>()(a.first));
+      for (const auto& itinerary : *a.second)
+        hash_combine(key.hash, hash_itinerary(itinerary));
+    }
+
+    return key;
+  }
+
+  /// Find a response that was previously given for an equivalent table of the
+  /// same negotiation.
+  ConstResponsePtr find(const Viewer& viewer, const Key& key) const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto scope_it = _scopes.find(viewer.negotiation_key());
+    if (scope_it == _scopes.end())
+      return nullptr;
+
+    const auto& responses = scope_it->second.responses;
+    const auto it = responses.find(key);
+    if (it == responses.end())
+      return nullptr;
+
+    return it->second;
+  }
+
+  void insert(const Viewer& viewer, Key key, ConstResponsePtr response)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Forget about the negotiations that are already over
+    for (auto it = _scopes.begin(); it != _scopes.end(); )
+    {
+      if (it->first.expired())
+        it = _scopes.erase(it);
+      else
+        ++it;
+    }
+
+    auto negotiation = viewer.negotiation_key();
+    if (negotiation.expired())
+      return;
+
+    auto& scope = _scopes[std::move(negotiation)];
+    const auto inserted = scope.responses.insert({key, response});
+    if (!inserted.second)
+    {
+      inserted.first->second = std::move(response);
+      return;
+    }
+
+    scope.order.push_back(std::move(key));
+    if (scope.order.size() > MaxResponsesPerNegotiation)
+    {
+      scope.responses.erase(scope.order.front());
+      scope.order.pop_front();
+    }
+  }
+
+  void count_reuse()
+  {
+    ++_reused;
+  }
+
+  std::size_t reused() const
+  {
+    return _reused;
+  }
+
+private:
+
+  struct Scope
+  {
+    std::unordered_map<Key, ConstResponsePtr, KeyHash> responses;
+
+    // The order that the responses were inserted in, so that the oldest ones
+    // can be dropped first
+    std::deque<Key> order;
+  };
+
+  using NegotiationKey = std::weak_ptr<const void>;
+
+  mutable std::mutex _mutex;
+  std::map<NegotiationKey, Scope, std::owner_less<NegotiationKey>> _scopes;
+  std::atomic_size_t _reused{0};
+};
+
+//==============================================================================
+/// Check that a previous response is still valid for the table that is being
+/// responded to.
+bool still_valid(
+  const ResponseCache::Response& response,
+  const NegotiatingRouteValidator& validator)
+{
+  if (ResponseCache::Response::Type::Submit != response.type)
+    return true;
+
+  for (const auto& route : response.itinerary)
+  {
+    if (validator.find_conflict(route))
+      return false;
+  }
+
+  return true;
+}
+
+//==============================================================================
+schedule::Negotiator::Responder::ApprovalCallback make_approval_cb(
+  const SimpleNegotiator::Options::ApprovalCallback& approval_cb,
+  const std::optional<Plan>& plan)
+{
+  if (!approval_cb || !plan.has_value())
+    return nullptr;
+
+  return [approval_cb, approved_plan = *plan]()
+    -> schedule::Negotiator::Responder::UpdateVersion
+    {
+      return approval_cb(approved_plan);
+    };
+}
+
+//==============================================================================
+/// Give a response to a responder. The approval callback is made from the
+/// current options of the negotiator instead of being remembered, so a
+/// response that gets reused always reports to whoever should be approving
+/// it now.
+void pass_response(
+  const ResponseCache::Response& response,
+  const SimpleNegotiator::Options::ApprovalCallback& approval_cb,
+  const schedule::Negotiator::Responder& responder)
+{
+  using Type = ResponseCache::Response::Type;
+  if (Type::Submit == response.type)
+  {
+    return responder.submit(
+      response.itinerary, make_approval_cb(approval_cb, response.plan));
+  }
+
+  if (Type::Reject == response.type)
+    return responder.reject(response.alternatives);
+
+  responder.forfeit(response.blockers);
+}
+
+//==============================================================================
+/// Passes along the response of the negotiator while recording it into the
+/// cache. Responses given after the negotiator was interrupted are incomplete,
+/// so they are not recorded.
+class RecordingResponder
+{
+public:
+
+  using ParticipantId = schedule::ParticipantId;
+  using Alternatives = schedule::Negotiation::Alternatives;
+
+  RecordingResponder(
+    schedule::Negotiator::ResponderPtr responder,
+    SimpleNegotiator::Options::ApprovalCallback approval_cb,
+    std::shared_ptr<ResponseCache> cache,
+    schedule::Negotiation::Table::ViewerPtr viewer,
+    ResponseCache::Key key,
+    std::function<bool()> interrupted)
+  : _responder(std::move(responder)),
+    _approval_cb(std::move(approval_cb)),
+    _cache(std::move(cache)),
+    _viewer(std::move(viewer)),
+    _key(std::move(key)),
+    _interrupted(std::move(interrupted))
+  {
+    // Do nothing
+  }
+
+  void submit(Plan plan) const
+  {
+    auto response = std::make_shared<ResponseCache::Response>();
+    response->type = ResponseCache::Response::Type::Submit;
+    response->itinerary = plan.get_itinerary();
+    response->plan = std::move(plan);
+    record_and_pass(std::move(response));
+  }
+
+  void reject(const Alternatives& alternatives) const
+  {
+    auto response = std::make_shared<ResponseCache::Response>();
+    response->type = ResponseCache::Response::Type::Reject;
+    response->alternatives = alternatives;
+    record_and_pass(std::move(response));
+  }
+
+  void forfeit(const std::vector<ParticipantId>& blockers) const
+  {
+    auto response = std::make_shared<ResponseCache::Response>();
+    response->type = ResponseCache::Response::Type::Forfeit;
+    response->blockers = blockers;
+    record_and_pass(std::move(response));
+  }
+
+private:
+
+  void record_and_pass(
+    std::shared_ptr<const ResponseCache::Response> response) const
+  {
+    if (!_interrupted())
+      _cache->insert(*_viewer, _key, response);
+
+    pass_response(*response, _approval_cb, *_responder);
+  }
+
+  schedule::Negotiator::ResponderPtr _responder;
+  SimpleNegotiator::Options::ApprovalCallback _approval_cb;
+  std::shared_ptr<ResponseCache> _cache;
+  schedule::Negotiation::Table::ViewerPtr _viewer;
+  ResponseCache::Key _key;
+  std::function<bool()> _interrupted;
+};
+
+} // anonymous namespace
+
 //==============================================================================
 class SimpleNegotiator::Implementation
 {
@@ -173,6 +596,10 @@ public:
   Planner planner;
   Options negotiator_options;
 
+  // Copies of a negotiator share one cache, because they will always give the
+  // same response to the same table.
+  std::shared_ptr<ResponseCache> response_cache;
+
   bool debug_print = false;
 
   Implementation(
@@ -184,7 +611,8 @@ public:
     goal(std::move(goal_)),
     planner_options(nullptr, options_.minimum_holding_time()),
     planner(std::move(configuration_), planner_options),
-    negotiator_options(std::move(options_))
+    negotiator_options(std::move(options_)),
+    response_cache(std::make_shared<ResponseCache>())
   {
     // Do nothing
   }
@@ -366,6 +794,22 @@ void SimpleNegotiator::respond(
 
   const auto& alternative_sets = rv_generator.alternative_sets();
 
+  auto cache_key = ResponseCache::make_key(*table_viewer);
+  const auto cached = _pimpl->response_cache->find(*table_viewer, cache_key);
+  if (cached && still_valid(*cached, rv_generator.begin()))
+  {
+    if (_pimpl->debug_print)
+    {
+      std::cout << " >>>>> Reusing a previous response" << std::endl;
+    }
+
+    _pimpl->response_cache->count_reuse();
+    return pass_response(
+      *cached,
+      Options::Implementation::get_approval_cb(_pimpl->negotiator_options),
+      *responder);
+  }
+
   auto options = _pimpl->planner_options;
 
   const auto maximum_cost_leeway =
@@ -396,7 +840,17 @@ void SimpleNegotiator::respond(
   AlternativesTracker tracker(rv_generator.alternative_sets());
 
   const auto interrupt_flag = _pimpl->planner_options.interrupt_flag();
-  while (!validators.empty() && !(interrupt_flag && *interrupt_flag))
+  const auto interrupted = [interrupt_flag]() -> bool
+    {
+      return interrupt_flag && *interrupt_flag;
+    };
+
+  const auto recorder = std::make_shared<RecordingResponder>(
+    responder,
+    Options::Implementation::get_approval_cb(_pimpl->negotiator_options),
+    _pimpl->response_cache, table_viewer, std::move(cache_key), interrupted);
+
+  while (!validators.empty() && !interrupted())
   {
     const auto validator = std::move(validators.front());
     validators.pop_front();
@@ -474,25 +928,11 @@ void SimpleNegotiator::respond(
         print_itinerary(plan->get_itinerary());
       }
 
-      Responder::ApprovalCallback responder_approval_cb;
-      auto options_approval_callback =
-          Options::Implementation::get_approval_cb(_pimpl->negotiator_options);
-      if (options_approval_callback)
-      {
-        responder_approval_cb = [
-              approval_cb = options_approval_callback,
-              approved_plan = *plan
-            ]() -> Responder::UpdateVersion
-        {
-          return approval_cb(std::move(approved_plan));
-        };
-      }
-
       if (_pimpl->debug_print)
       {
         std::cout << " >>>>> Submitting" << std::endl;
       }
-      return responder->submit(plan->get_itinerary(), responder_approval_cb);
+      return recorder->submit(*plan);
     }
 
     if (_pimpl->debug_print)
@@ -595,7 +1035,7 @@ void SimpleNegotiator::respond(
     {
       std::cout << " >>>>> Rejecting" << std::endl;
     }
-    return responder->reject(*alternatives);
+    return recorder->reject(*alternatives);
   }
 
   if (best_blockers)
@@ -604,7 +1044,7 @@ void SimpleNegotiator::respond(
     {
       std::cout << " >>>>> Forfeiting with blockers" << std::endl;
     }
-    return responder->forfeit(*best_blockers);
+    return recorder->forfeit(*best_blockers);
   }
 
   if (_pimpl->debug_print)
@@ -613,7 +1053,7 @@ void SimpleNegotiator::respond(
   }
 
   // This would be suspicious. How could the planning fail without any blockers?
-  responder->forfeit({});
+  recorder->forfeit({});
 }
 
 //==============================================================================
@@ -624,5 +1064,12 @@ SimpleNegotiator& SimpleNegotiator::Debug::enable_debug_print(
   return negotiator;
 }
 
+//==============================================================================
+std::size_t SimpleNegotiator::Debug::reused_responses(
+    const SimpleNegotiator& negotiator)
+{
+  return negotiator._pimpl->response_cache->reused();
+}
+
 } // namespace agv
 } // namespace rmf_traffic
@@ -20,6 +20,8 @@
 
 #include <rmf_traffic/agv/Graph.hpp>
 
+#include <iosfwd>
+
 namespace rmf_traffic {
 namespace agv {
 
@@ -53,6 +55,20 @@ public:
 
 };
 
+namespace internal {
+
+//==============================================================================
+/// Write a description of the orientation constraint that is unique to its
+/// type and parameters. Only the constraint types that are created by
+/// Graph::OrientationConstraint::make() can be described. For any other type,
+/// nothing will be written and this will return false. Floating point values
+/// are written using the current format flags of the stream.
+bool describe(
+  std::ostream& out,
+  const Graph::OrientationConstraint& constraint);
+
+} // namespace internal
+
 } // namespace agv
 } // namespace rmf_traffic
 #endif // SRC__RMF_TRAFFIC__AGV__INTERNAL_GRAPH_HPP
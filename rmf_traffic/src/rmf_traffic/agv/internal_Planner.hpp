@@ -51,6 +51,13 @@ public:
 
     return wp;
   }
+
+  static Waypoint shift(const Waypoint& wp, const Duration delta_t)
+  {
+    Waypoint shifted = wp;
+    shifted._pimpl->time += delta_t;
+    return shifted;
+  }
 };
 
 //==============================================================================
@@ -74,6 +81,14 @@ public:
     Planner::Goal goal,
     Planner::Options options);
 
+  /// Make a Result for a plan that was found without searching
+  static Result make(
+    planning::InterfacePtr interface,
+    const std::vector<Planner::Start>& starts,
+    Planner::Goal goal,
+    Planner::Options options,
+    planning::PlanData plan);
+
   static const Implementation& get(const Result& r);
 
 };
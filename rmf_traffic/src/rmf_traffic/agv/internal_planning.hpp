@@ -99,6 +99,35 @@ public:
     const Planner::Options& options,
     std::optional<std::size_t> max_rollouts) const = 0;
 
+  /// The state of a rollout that can be expanded a little at a time
+  class RolloutProgress
+  {
+  public:
+
+    /// Continue expanding until the rollout is finished, the interrupter of
+    /// the options is triggered, or the deadline has passed.
+    virtual void resume(std::optional<Time> deadline) = 0;
+
+    /// True if there is nothing left to expand
+    virtual bool finished() const = 0;
+
+    /// The alternatives that have been found so far, ordered from best to
+    /// worst
+    virtual std::vector<schedule::Itinerary> alternatives() const = 0;
+
+    /// The options that will be used the next time this is resumed
+    virtual Planner::Options& options() = 0;
+
+    virtual ~RolloutProgress() = default;
+  };
+
+  virtual std::unique_ptr<RolloutProgress> rollout_begin(
+    const Duration span,
+    const Issues::BlockedNodes& nodes,
+    const Planner::Goal& goal,
+    const Planner::Options& options,
+    std::optional<std::size_t> max_rollouts) const = 0;
+
   virtual const Planner::Configuration& get_configuration() const = 0;
 
   class Debugger
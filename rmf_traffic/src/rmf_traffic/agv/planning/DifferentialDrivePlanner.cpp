@@ -23,6 +23,9 @@
 
 #include <rmf_utils/math.hpp>
 
+#include <algorithm>
+#include <map>
+
 #ifdef RMF_TRAFFIC__AGV__PLANNING__DEBUG__PLANNER
 #include <iostream>
 #endif // RMF_TRAFFIC__AGV__PLANNING__DEBUG__PLANNER
@@ -371,6 +374,20 @@ public:
   using ConstSearchNodePtr = std::shared_ptr<const SearchNode>;
   using NodePtr = SearchNodePtr;
 
+  // A departure that was found while holding at a waypoint
+  struct Departure
+  {
+    // When the robot left the waypoint
+    Time time;
+
+    // Where the robot arrived after leaving
+    ConstSearchNodePtr arrival;
+  };
+
+  // The departures that were found from a waypoint, keyed by the index of the
+  // traversal and the index of its alternative
+  using DepartureMap = std::map<std::pair<std::size_t, std::size_t>, Departure>;
+
   struct SearchNode
   {
     // We use optional here because start nodes don't always have a waypoint.
@@ -393,6 +410,10 @@ public:
     std::optional<Planner::Start> start;
     SearchNodePtr parent;
 
+    // In safe interval planning, the departures that were already found while
+    // holding at this waypoint
+    std::shared_ptr<const DepartureMap> departed;
+
     double get_total_cost_estimate() const
     {
       return current_cost + remaining_cost_estimate;
@@ -739,11 +760,11 @@ public:
             }));
   }
 
-  void expand_hold(const SearchNodePtr& top, SearchQueue& queue) const
+  SearchNodePtr make_hold_node(const SearchNodePtr& top) const
   {
     const std::size_t wp_index = top->waypoint.value();
     if (_supergraph->original().waypoints[wp_index].is_passthrough_point())
-      return;
+      return nullptr;
 
     const std::string& map_name =
         _supergraph->original().waypoints[wp_index].get_map_name();
@@ -763,9 +784,9 @@ public:
     Route route{map_name, std::move(trajectory)};
 
     if (!is_valid(top, route))
-      return;
+      return nullptr;
 
-    queue.push(std::make_shared<SearchNode>(
+    return std::make_shared<SearchNode>(
        SearchNode{
          wp_index,
          p,
@@ -778,7 +799,13 @@ public:
          top->current_cost + cost,
          std::nullopt,
          top
-       }));
+       });
+  }
+
+  void expand_hold(const SearchNodePtr& top, SearchQueue& queue) const
+  {
+    if (auto node = make_hold_node(top))
+      queue.push(std::move(node));
   }
 
   SearchNodePtr rotate_to_goal(const SearchNodePtr& top) const
@@ -850,10 +877,14 @@ public:
     return true;
   }
 
-  void expand_traversal(
+  /// Queue up a node for each alternative of the traversal that is valid,
+  /// except for the alternatives listed in skip. Returns the alternatives that
+  /// were queued along with the node that each of them arrives at.
+  std::vector<std::pair<std::size_t, SearchNodePtr>> expand_traversal(
       const SearchNodePtr& top,
       const Traversal& traversal,
-      SearchQueue& queue) const
+      SearchQueue& queue,
+      const std::vector<std::size_t>& skip = {}) const
   {
     const auto initial_waypoint_index = top->waypoint.value();
     const auto& initial_waypoint =
@@ -868,8 +899,12 @@ public:
     const Eigen::Vector2d next_position = next_waypoint.get_location();
     const std::string& next_map_name = next_waypoint.get_map_name();
 
+    std::vector<std::pair<std::size_t, SearchNodePtr>> queued;
     for (std::size_t i = 0; i < traversal.alternatives.size(); ++i)
     {
+      if (std::find(skip.begin(), skip.end(), i) != skip.end())
+        continue;
+
       const auto& alt = traversal.alternatives[i];
 
 #ifdef RMF_TRAFFIC__AGV__PLANNING__DEBUG__PLANNER
@@ -1118,6 +1153,115 @@ public:
       std::cout << " ^^^^^^^^^^^^^^ Pushing" << std::endl;
 #endif // RMF_TRAFFIC__AGV__PLANNING__DEBUG__PLANNER
       queue.push(node);
+      queued.push_back({i, node});
+    }
+
+    return queued;
+  }
+
+  /// Check whether the robot could stay where it arrived until the given time
+  bool can_wait_until(const SearchNode& arrival, const Time finish_time) const
+  {
+    const std::string& map_name =
+        _supergraph->original().waypoints[arrival.waypoint.value()]
+        .get_map_name();
+
+    const Eigen::Vector3d position{
+      arrival.position.x(), arrival.position.y(), arrival.yaw};
+    const Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+
+    Trajectory trajectory;
+    trajectory.insert(arrival.time, position, zero);
+    trajectory.insert(finish_time, position, zero);
+
+    return !_validator->find_conflict({map_name, std::move(trajectory)});
+  }
+
+  /// Expand a node in safe interval planning mode. Departing later along the
+  /// same way can only arrive later, so each way of leaving a waypoint does
+  /// not need to be tried again while the robot could have waited at the
+  /// destination of the earlier departure instead. Each hold carries along
+  /// the departures that were already found, and before they get skipped,
+  /// their destination is checked for whether it is still free up until the
+  /// moment that departing now would arrive there. Once that fails, the safe
+  /// interval of the destination is over, so the departures are tried again in
+  /// case they can reach the next one. Departures towards a passthrough point
+  /// are never kept, because the robot cannot wait there.
+  void expand_safe_interval(const SearchNodePtr& top, SearchQueue& queue) const
+  {
+    const std::size_t wp_index = top->waypoint.value();
+    DepartureMap departed = top->departed ? *top->departed : DepartureMap();
+
+    if (wp_index == _goal_waypoint)
+    {
+      // If there is no goal yaw, then is_finished should have caught this node
+      assert(_goal_yaw.has_value());
+
+      if (auto node = rotate_to_goal(top))
+        queue.push(std::move(node));
+    }
+    else
+    {
+      const auto traversals = _supergraph->traversals_from(wp_index);
+      for (std::size_t t = 0; t < traversals->size(); ++t)
+      {
+        const auto& traversal = (*traversals)[t];
+
+        // All the alternatives of a traversal arrive at the same waypoint, so
+        // one check from the earliest arrival until the latest moment that
+        // departing now would arrive covers all of them.
+        std::vector<std::size_t> skip;
+        const auto begin = departed.lower_bound({t, 0});
+        const auto end = departed.lower_bound({t+1, 0});
+        if (begin != end)
+        {
+          const SearchNode* earliest = nullptr;
+          std::optional<Time> latest;
+          for (auto it = begin; it != end; ++it)
+          {
+            const auto& arrival = *it->second.arrival;
+            if (!earliest || arrival.time < earliest->time)
+              earliest = &arrival;
+
+            const auto finish = arrival.time + (top->time - it->second.time);
+            if (!latest.has_value() || *latest < finish)
+              latest = finish;
+
+            skip.push_back(it->first.second);
+          }
+
+          if (!can_wait_until(*earliest, *latest))
+          {
+            departed.erase(begin, end);
+            skip.clear();
+          }
+        }
+
+        const auto queued = expand_traversal(top, traversal, queue, skip);
+
+        const bool can_wait_at_destination =
+          !_supergraph->original().waypoints[traversal.finish_waypoint_index]
+          .is_passthrough_point();
+
+        if (can_wait_at_destination)
+        {
+          for (const auto& q : queued)
+            departed.insert({{t, q.first}, Departure{top->time, q.second}});
+        }
+      }
+    }
+
+    // The robot needs to keep holding here for as long as it can, because the
+    // destinations of the departures that were found might close later on.
+    if (auto hold = make_hold_node(top))
+    {
+      if (!departed.empty())
+      {
+        hold->departed =
+          std::make_shared<const DepartureMap>(std::move(departed));
+      }
+
+      queue.push(std::move(hold));
     }
   }
 
@@ -1237,6 +1381,12 @@ public:
       return;
     }
 
+    if (_validator && _safe_interval_planning)
+    {
+      expand_safe_interval(top, queue);
+      return;
+    }
+
     if (_validator)
     {
       // There will never be a reason to hold if there is no validator.
@@ -1515,10 +1665,8 @@ public:
         .at(*waypoint_index).is_holding_point();
   }
 
-  std::vector<schedule::Itinerary> rollout(
-      const Duration max_span,
-      const Issues::BlockedNodes& nodes,
-      std::optional<std::size_t> max_rollouts) const
+  static std::vector<RolloutEntry> make_rollout_queue(
+      const Issues::BlockedNodes& nodes)
   {
     std::vector<RolloutEntry> rollout_queue;
     for (const auto& void_node : nodes)
@@ -1571,16 +1719,144 @@ public:
         break;
     }
 
-    std::unordered_map<NodePtr, ConstRoutePtr> route_map;
-    std::vector<schedule::Itinerary> alternatives;
+    return rollout_queue;
+  }
 
-    Issues::BlockerMap temp_blocked_nodes;
+  ScheduledDifferentialDriveExpander(
+    State::Internal* internal,
+    Issues& issues,
+    std::shared_ptr<const Supergraph> supergraph,
+    DifferentialDriveHeuristicAdapter heuristic,
+    const Planner::Goal& goal,
+    const Planner::Options& options)
+  : _internal(static_cast<InternalState*>(internal)),
+    _issues(&issues),
+    _supergraph(std::move(supergraph)),
+    _heuristic(std::move(heuristic)),
+    _goal_waypoint(goal.waypoint()),
+    _goal_yaw(rmf_utils::pointer_to_opt(goal.orientation())),
+    _validator(options.validator().get()),
+    _holding_time(options.minimum_holding_time()),
+    _safe_interval_planning(options.safe_interval_planning()),
+    _saturation_limit(options.saturation_limit()),
+    _maximum_cost_estimate(options.maximum_cost_estimate()),
+    _interrupter(options.interrupter())
+  {
+    const auto& angular = _supergraph->traits().rotational();
+    _w_nom = angular.get_nominal_velocity();
+    _alpha_nom = angular.get_nominal_acceleration();
+    _rotation_threshold = _supergraph->options().rotation_thresh;
+  }
 
-    SearchQueue search_queue;
+  class RolloutProgress : public Interface::RolloutProgress
+  {
+  public:
+
+    RolloutProgress(
+        Duration max_span_,
+        std::optional<std::size_t> max_rollouts_,
+        std::shared_ptr<const Supergraph> supergraph_,
+        CacheManagerPtr<DifferentialDriveHeuristic> cache_,
+        Planner::Goal goal_,
+        Planner::Options options_,
+        std::vector<RolloutEntry> rollout_queue_)
+    : max_span(max_span_),
+      max_rollouts(max_rollouts_),
+      supergraph(std::move(supergraph_)),
+      cache(std::move(cache_)),
+      goal(std::move(goal_)),
+      _options(std::move(options_)),
+      rollout_queue(std::move(rollout_queue_))
+    {
+      // Do nothing
+    }
+
+    void resume(std::optional<Time> deadline) final
+    {
+      ScheduledDifferentialDriveExpander expander{
+        &internal,
+        issues,
+        supergraph,
+        DifferentialDriveHeuristicAdapter{
+          cache->get(),
+          supergraph,
+          goal.waypoint(),
+          rmf_utils::pointer_to_opt(goal.orientation())
+        },
+        goal,
+        _options
+      };
+
+      expander.rollout(*this, deadline);
+    }
+
+    bool finished() const final
+    {
+      return rollout_queue.empty();
+    }
+
+    std::vector<schedule::Itinerary> alternatives() const final
+    {
+      std::vector<schedule::Itinerary> alternatives;
+      auto finished = finished_rollouts;
+      while (!finished.empty())
+      {
+        auto node = finished.top();
+        finished.pop();
+
+        schedule::Itinerary itinerary;
+        auto [routes, _] =
+            reconstruct_routes(reconstruct_nodes(node), max_span);
+        for (auto& r : routes)
+        {
+          assert(r.trajectory().size() > 0);
+          itinerary.emplace_back(std::make_shared<Route>(std::move(r)));
+        }
+
+        assert(!itinerary.empty());
+        alternatives.emplace_back(std::move(itinerary));
+      }
+
+      return alternatives;
+    }
+
+    Planner::Options& options() final
+    {
+      return _options;
+    }
+
+    Duration max_span;
+    std::optional<std::size_t> max_rollouts;
+    std::shared_ptr<const Supergraph> supergraph;
+    CacheManagerPtr<DifferentialDriveHeuristic> cache;
+    Planner::Goal goal;
+    Planner::Options _options;
+
+    InternalState internal;
+    Issues issues;
+    std::vector<RolloutEntry> rollout_queue;
     SearchQueue finished_rollouts;
+  };
 
+  void rollout(RolloutProgress& progress, std::optional<Time> deadline) const
+  {
+    auto& rollout_queue = progress.rollout_queue;
+    auto& finished_rollouts = progress.finished_rollouts;
+    const auto max_span = progress.max_span;
+    const auto max_rollouts = progress.max_rollouts;
+
+    // We always take at least one step so that every slice makes progress,
+    // even if the deadline has already passed.
+    bool first_step = true;
+    SearchQueue search_queue;
     while (!rollout_queue.empty() && !(_interrupter && _interrupter()))
     {
+      if (!first_step && deadline.has_value()
+        && *deadline < std::chrono::steady_clock::now())
+        return;
+
+      first_step = false;
+
       const auto top = rollout_queue.back();
       rollout_queue.pop_back();
 
@@ -1596,7 +1872,12 @@ public:
         finished_rollouts.push(top.node);
 
         if (max_rollouts && *max_rollouts <= finished_rollouts.size())
+        {
+          // We have all the rollouts that we want, so there is nothing left to
+          // expand.
+          rollout_queue.clear();
           break;
+        }
 
         continue;
       }
@@ -1613,50 +1894,6 @@ public:
         search_queue.pop();
       }
     }
-
-    while (!finished_rollouts.empty())
-    {
-      auto node = finished_rollouts.top();
-      finished_rollouts.pop();
-
-      schedule::Itinerary itinerary;
-      auto [routes, _] = reconstruct_routes(reconstruct_nodes(node), max_span);
-      for (auto& r : routes)
-      {
-        assert(r.trajectory().size() > 0);
-        itinerary.emplace_back(std::make_shared<Route>(std::move(r)));
-      }
-
-      assert(!itinerary.empty());
-      alternatives.emplace_back(std::move(itinerary));
-    }
-
-    return alternatives;
-  }
-
-  ScheduledDifferentialDriveExpander(
-    State::Internal* internal,
-    Issues& issues,
-    std::shared_ptr<const Supergraph> supergraph,
-    DifferentialDriveHeuristicAdapter heuristic,
-    const Planner::Goal& goal,
-    const Planner::Options& options)
-  : _internal(static_cast<InternalState*>(internal)),
-    _issues(&issues),
-    _supergraph(std::move(supergraph)),
-    _heuristic(std::move(heuristic)),
-    _goal_waypoint(goal.waypoint()),
-    _goal_yaw(rmf_utils::pointer_to_opt(goal.orientation())),
-    _validator(options.validator().get()),
-    _holding_time(options.minimum_holding_time()),
-    _saturation_limit(options.saturation_limit()),
-    _maximum_cost_estimate(options.maximum_cost_estimate()),
-    _interrupter(options.interrupter())
-  {
-    const auto& angular = _supergraph->traits().rotational();
-    _w_nom = angular.get_nominal_velocity();
-    _alpha_nom = angular.get_nominal_acceleration();
-    _rotation_threshold = _supergraph->options().rotation_thresh;
   }
 
   class Debugger : public Interface::Debugger
@@ -1857,6 +2094,7 @@ private:
   std::optional<double> _goal_yaw;
   const RouteValidator* _validator;
   Duration _holding_time;
+  bool _safe_interval_planning;
   std::optional<std::size_t> _saturation_limit;
   std::optional<double> _maximum_cost_estimate;
   std::function<bool()> _interrupter;
@@ -1870,12 +2108,15 @@ DifferentialDrivePlanner::DifferentialDrivePlanner(
     Planner::Configuration config)
   : _config(std::move(config))
 {
-  _supergraph = Supergraph::make(
+  // Planners with the same configuration share their Supergraph and heuristic
+  // caches so that the caches are only stored once and get warmed together.
+  _shared = PlannerCacheRegistry::get().acquire(
         Graph::Implementation::get(_config.graph()),
         _config.vehicle_traits(),
         _config.interpolation());
 
-  _cache = DifferentialDriveHeuristic::make_manager(_supergraph);
+  _supergraph = _shared->supergraph;
+  _cache = _shared->heuristic;
 }
 
 //==============================================================================
@@ -1971,25 +2212,29 @@ std::vector<schedule::Itinerary> DifferentialDrivePlanner::rollout(
   const Planner::Options& options,
   std::optional<std::size_t> max_rollouts) const
 {
-  using InternalState = ScheduledDifferentialDriveExpander::InternalState;
-  InternalState internal;
-  Issues issues;
+  auto progress = rollout_begin(span, nodes, goal, options, max_rollouts);
+  progress->resume(std::nullopt);
+  return progress->alternatives();
+}
 
-  ScheduledDifferentialDriveExpander expander{
-    &internal,
-    issues,
+//==============================================================================
+auto DifferentialDrivePlanner::rollout_begin(
+  const Duration span,
+  const Issues::BlockedNodes& nodes,
+  const Planner::Goal& goal,
+  const Planner::Options& options,
+  std::optional<std::size_t> max_rollouts) const
+-> std::unique_ptr<RolloutProgress>
+{
+  using Expander = ScheduledDifferentialDriveExpander;
+  return std::make_unique<Expander::RolloutProgress>(
+    span,
+    max_rollouts,
     _supergraph,
-    DifferentialDriveHeuristicAdapter{
-      _cache->get(),
-      _supergraph,
-      goal.waypoint(),
-      rmf_utils::pointer_to_opt(goal.orientation())
-    },
+    _cache,
     goal,
-    options
-  };
-
-  return expander.rollout(span, nodes, max_rollouts);
+    options,
+    Expander::make_rollout_queue(nodes));
 }
 
 //==============================================================================
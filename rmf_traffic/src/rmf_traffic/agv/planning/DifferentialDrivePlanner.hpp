@@ -21,6 +21,7 @@
 #include "../internal_planning.hpp"
 
 #include "DifferentialDriveHeuristic.hpp"
+#include "PlannerCacheRegistry.hpp"
 
 namespace rmf_traffic {
 namespace agv {
@@ -47,6 +48,13 @@ public:
     const Planner::Options& options,
     std::optional<std::size_t> max_rollouts) const final;
 
+  std::unique_ptr<RolloutProgress> rollout_begin(
+    const Duration span,
+    const Issues::BlockedNodes& nodes,
+    const Planner::Goal& goal,
+    const Planner::Options& options,
+    std::optional<std::size_t> max_rollouts) const final;
+
   const Planner::Configuration& get_configuration() const final;
 
   std::unique_ptr<Debugger> debug_begin(
@@ -60,6 +68,7 @@ public:
 
 private:
   Planner::Configuration _config;
+  PlannerCacheRegistry::ConstEntryPtr _shared;
   std::shared_ptr<const Supergraph> _supergraph;
   CacheManagerPtr<DifferentialDriveHeuristic> _cache;
 };
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "PlanCache.hpp"
+
+#include <rmf_utils/math.hpp>
+
+#include <algorithm>
+
+namespace rmf_traffic {
+namespace agv {
+namespace planning {
+
+//==============================================================================
+PlanCache::PlanCache(
+  const std::size_t capacity,
+  const double translation_thresh,
+  const double rotation_thresh)
+: _capacity(capacity),
+  _translation_thresh(translation_thresh),
+  _rotation_thresh(rotation_thresh)
+{
+  // Do nothing
+}
+
+//==============================================================================
+std::size_t PlanCache::capacity() const
+{
+  return _capacity;
+}
+
+//==============================================================================
+std::optional<PlanData> PlanCache::find(
+  const Planner::Start& start,
+  const Planner::Goal& goal,
+  const RouteValidator* validator)
+{
+  std::optional<PlanData> plan;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _entries.find({start.waypoint(), goal.waypoint()});
+    if (it != _entries.end())
+    {
+      for (auto& entry : it->second)
+      {
+        if (matches(entry.plan.start, start) && matches(entry.goal, goal))
+        {
+          entry.last_used = ++_use_counter;
+          plan = entry.plan;
+          break;
+        }
+      }
+    }
+  }
+
+  if (plan)
+  {
+    const Duration delta_t = start.time() - plan->start.time();
+    for (auto& route : plan->routes)
+    {
+      if (route.trajectory().size() > 0)
+        route.trajectory().front().adjust_times(delta_t);
+    }
+
+    for (auto& wp : plan->waypoints)
+      wp = Plan::Waypoint::Implementation::shift(wp, delta_t);
+
+    plan->start = start;
+
+    if (validator)
+    {
+      for (const auto& route : plan->routes)
+      {
+        if (route.trajectory().size() < 2)
+          continue;
+
+        if (validator->find_conflict(route))
+        {
+          plan = std::nullopt;
+          break;
+        }
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (plan)
+    ++_statistics.hits;
+  else
+    ++_statistics.misses;
+
+  return plan;
+}
+
+//==============================================================================
+void PlanCache::insert(const PlanData& plan, const Planner::Goal& goal)
+{
+  if (_capacity == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto& entries = _entries[{plan.start.waypoint(), goal.waypoint()}];
+  const auto it = std::find_if(
+    entries.begin(), entries.end(),
+    [&](const Entry& entry)
+    {
+      return matches(entry.plan.start, plan.start)
+      && matches(entry.goal, goal);
+    });
+
+  if (it != entries.end())
+  {
+    it->plan = plan;
+    it->last_used = ++_use_counter;
+    return;
+  }
+
+  entries.push_back(Entry{plan, goal, ++_use_counter});
+  ++_size;
+
+  while (_size > _capacity)
+  {
+    // Evict whichever plan has gone the longest without being used
+    auto oldest_key = _entries.end();
+    std::size_t oldest_index = 0;
+    for (auto key_it = _entries.begin(); key_it != _entries.end(); ++key_it)
+    {
+      for (std::size_t i = 0; i < key_it->second.size(); ++i)
+      {
+        if (oldest_key == _entries.end()
+          || key_it->second[i].last_used
+          < oldest_key->second[oldest_index].last_used)
+        {
+          oldest_key = key_it;
+          oldest_index = i;
+        }
+      }
+    }
+
+    assert(oldest_key != _entries.end());
+    auto& oldest_entries = oldest_key->second;
+    oldest_entries.erase(oldest_entries.begin() + oldest_index);
+    if (oldest_entries.empty())
+      _entries.erase(oldest_key);
+
+    --_size;
+  }
+}
+
+//==============================================================================
+auto PlanCache::statistics() const -> Statistics
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _statistics;
+}
+
+//==============================================================================
+bool PlanCache::matches(
+  const Planner::Start& a,
+  const Planner::Start& b) const
+{
+  if (a.waypoint() != b.waypoint())
+    return false;
+
+  if (a.lane() != b.lane())
+    return false;
+
+  const auto& location_a = a.location();
+  const auto& location_b = b.location();
+  if (location_a.has_value() != location_b.has_value())
+    return false;
+
+  if (location_a.has_value()
+    && _translation_thresh < (*location_a - *location_b).norm())
+    return false;
+
+  const double yaw_diff =
+    rmf_utils::wrap_to_pi(a.orientation() - b.orientation());
+  return std::abs(yaw_diff) <= _rotation_thresh;
+}
+
+//==============================================================================
+bool PlanCache::matches(
+  const Planner::Goal& a,
+  const Planner::Goal& b)
+{
+  if (a.waypoint() != b.waypoint())
+    return false;
+
+  const double* const orientation_a = a.orientation();
+  const double* const orientation_b = b.orientation();
+  if (!orientation_a || !orientation_b)
+    return !orientation_a && !orientation_b;
+
+  return *orientation_a == *orientation_b;
+}
+
+} // namespace planning
+} // namespace agv
+} // namespace rmf_traffic
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC__AGV__PLANNING__PLANCACHE_HPP
+#define SRC__RMF_TRAFFIC__AGV__PLANNING__PLANCACHE_HPP
+
+#include "../internal_Planner.hpp"
+
+#include <unordered_map>
+
+namespace rmf_traffic {
+namespace agv {
+namespace planning {
+
+//==============================================================================
+/// A cache of recent plans that reached their goal at the ideal cost, i.e.
+/// without any waiting or detours. When a robot asks for a plan from the same
+/// start conditions to the same goal, the cached plan can be shifted to the new
+/// start time. If the shifted plan passes the validator then it is exactly as
+/// good as anything the search could produce, so the search can be skipped.
+class PlanCache
+{
+public:
+
+  using Statistics = Planner::PlanCacheStatistics;
+
+  /// Constructor
+  ///
+  /// \param[in] capacity
+  ///   The maximum number of plans to remember
+  ///
+  /// \param[in] translation_thresh
+  ///   Start locations that are closer than this will be treated as equal
+  ///
+  /// \param[in] rotation_thresh
+  ///   Start orientations that are closer than this will be treated as equal
+  PlanCache(
+    std::size_t capacity,
+    double translation_thresh,
+    double rotation_thresh);
+
+  /// The maximum number of plans that will be remembered
+  std::size_t capacity() const;
+
+  /// Look for a plan that began from equivalent conditions and went to the
+  /// same goal. If one is found, it will be shifted to begin at start.time(),
+  /// and then each of its routes will be checked by the validator. A nullopt
+  /// will be returned if there is no such plan or if it has a conflict.
+  std::optional<PlanData> find(
+    const Planner::Start& start,
+    const Planner::Goal& goal,
+    const RouteValidator* validator);
+
+  /// Remember a plan. This should only be given plans whose cost is equal to
+  /// the ideal cost of their search.
+  void insert(const PlanData& plan, const Planner::Goal& goal);
+
+  /// Get the statistics of this cache
+  Statistics statistics() const;
+
+private:
+
+  bool matches(
+    const Planner::Start& a,
+    const Planner::Start& b) const;
+
+  static bool matches(
+    const Planner::Goal& a,
+    const Planner::Goal& b);
+
+  // The start waypoint and goal waypoint
+  using Key = std::pair<std::size_t, std::size_t>;
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const
+    {
+      return std::hash<std::size_t>()(key.first)
+        ^ (std::hash<std::size_t>()(key.second) << 1);
+    }
+  };
+
+  struct Entry
+  {
+    PlanData plan;
+    Planner::Goal goal;
+    std::size_t last_used;
+  };
+
+  std::size_t _capacity;
+  double _translation_thresh;
+  double _rotation_thresh;
+
+  mutable std::mutex _mutex;
+  std::unordered_map<Key, std::vector<Entry>, KeyHash> _entries;
+  std::size_t _size = 0;
+  std::size_t _use_counter = 0;
+  Statistics _statistics;
+};
+
+} // namespace planning
+} // namespace agv
+} // namespace rmf_traffic
+
+#endif // SRC__RMF_TRAFFIC__AGV__PLANNING__PLANCACHE_HPP
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "PlannerCacheRegistry.hpp"
+
+#include <sstream>
+
+namespace rmf_traffic {
+namespace agv {
+namespace planning {
+
+namespace {
+//==============================================================================
+class EventDescriber : public Graph::Lane::Executor
+{
+public:
+
+  EventDescriber(std::ostream& out)
+  : _out(out)
+  {
+    // Do nothing
+  }
+
+  void execute(const DoorOpen& open) final
+  {
+    door("door_open", open);
+  }
+
+  void execute(const DoorClose& close) final
+  {
+    door("door_close", close);
+  }
+
+  void execute(const LiftSessionBegin& begin) final
+  {
+    lift("lift_begin", begin);
+  }
+
+  void execute(const LiftDoorOpen& open) final
+  {
+    lift("lift_door_open", open);
+  }
+
+  void execute(const LiftSessionEnd& end) final
+  {
+    lift("lift_end", end);
+  }
+
+  void execute(const LiftMove& move) final
+  {
+    lift("lift_move", move);
+  }
+
+  void execute(const Dock& dock) final
+  {
+    _out << "dock[" << dock.dock_name().size() << ":" << dock.dock_name()
+         << "," << dock.duration().count() << "]";
+  }
+
+  void execute(const Wait& wait) final
+  {
+    _out << "wait[" << wait.duration().count() << "]";
+  }
+
+private:
+
+  void door(const char* type, const Graph::Lane::Door& door)
+  {
+    _out << type << "[" << door.name().size() << ":" << door.name()
+         << "," << door.duration().count() << "]";
+  }
+
+  void lift(const char* type, const Graph::Lane::LiftSession& session)
+  {
+    _out << type << "["
+         << session.lift_name().size() << ":" << session.lift_name() << ","
+         << session.floor_name().size() << ":" << session.floor_name() << ","
+         << session.duration().count() << "]";
+  }
+
+  std::ostream& _out;
+};
+
+//==============================================================================
+bool describe(std::ostream& out, const Graph::Lane::Node& node)
+{
+  out << node.waypoint_index() << "(";
+  if (const auto* event = node.event())
+  {
+    EventDescriber describer(out);
+    event->execute(describer);
+  }
+
+  out << ";";
+  if (const auto* constraint = node.orientation_constraint())
+  {
+    if (!internal::describe(out, *constraint))
+      return false;
+  }
+
+  out << ")";
+  return true;
+}
+
+//==============================================================================
+void describe(std::ostream& out, const VehicleTraits::Limits& limits)
+{
+  out << limits.get_nominal_velocity() << ","
+      << limits.get_nominal_acceleration();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+PlannerCacheRegistry& PlannerCacheRegistry::get()
+{
+  static PlannerCacheRegistry registry;
+  return registry;
+}
+
+//==============================================================================
+auto PlannerCacheRegistry::acquire(
+    const Graph::Implementation& graph,
+    const VehicleTraits& traits,
+    const Interpolate::Options::Implementation& interpolate) -> ConstEntryPtr
+{
+  const auto make_entry = [&]()
+    {
+      auto supergraph = Supergraph::make(graph, traits, interpolate);
+      auto heuristic = DifferentialDriveHeuristic::make_manager(supergraph);
+      return std::make_shared<const Entry>(
+        Entry{std::move(supergraph), std::move(heuristic)});
+    };
+
+  auto key = make_key(graph, traits, interpolate);
+  if (!key.has_value())
+    return make_entry();
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto& weak_entry = _entries[*key];
+  if (auto entry = weak_entry.lock())
+    return entry;
+
+  // Clear out any entries whose planners have all been destroyed
+  for (auto it = _entries.begin(); it != _entries.end(); )
+  {
+    if (it->second.expired() && &it->second != &weak_entry)
+      it = _entries.erase(it);
+    else
+      ++it;
+  }
+
+  // We build the entry while holding the lock so that two planners which are
+  // constructed at the same time do not each build their own copy.
+  auto entry = make_entry();
+  weak_entry = entry;
+  return entry;
+}
+
+//==============================================================================
+std::size_t PlannerCacheRegistry::size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::size_t count = 0;
+  for (const auto& entry : _entries)
+  {
+    if (!entry.second.expired())
+      ++count;
+  }
+
+  return count;
+}
+
+//==============================================================================
+std::optional<std::string> PlannerCacheRegistry::make_key(
+    const Graph::Implementation& graph,
+    const VehicleTraits& traits,
+    const Interpolate::Options::Implementation& interpolate)
+{
+  std::ostringstream out;
+  // hexfloat guarantees that different values never produce the same text
+  out << std::hexfloat;
+
+  out << "interpolate{" << interpolate.always_stop << ","
+      << interpolate.translation_thresh << ","
+      << interpolate.rotation_thresh << ","
+      << interpolate.corner_angle_thresh << "}";
+
+  out << "traits{";
+  describe(out, traits.linear());
+  out << ";";
+  describe(out, traits.rotational());
+  out << ";" << static_cast<int>(traits.get_steering());
+  if (const auto* differential = traits.get_differential())
+  {
+    const auto& forward = differential->get_forward();
+    out << ";" << forward[0] << "," << forward[1] << ","
+        << differential->is_reversible();
+  }
+  out << "}";
+
+  out << "waypoints{";
+  for (const auto& wp : graph.waypoints)
+  {
+    const auto& location = wp.get_location();
+    out << wp.get_map_name().size() << ":" << wp.get_map_name() << ","
+        << location[0] << "," << location[1] << ","
+        << wp.is_holding_point() << wp.is_passthrough_point()
+        << wp.is_parking_spot() << wp.is_charger();
+
+    if (const auto* name = wp.name())
+      out << "," << name->size() << ":" << *name;
+
+    out << ";";
+  }
+  out << "}";
+
+  out << "lanes{";
+  for (const auto& lane : graph.lanes)
+  {
+    if (!describe(out, lane.entry()))
+      return std::nullopt;
+
+    out << "->";
+    if (!describe(out, lane.exit()))
+      return std::nullopt;
+
+    out << ";";
+  }
+  out << "}";
+
+  return out.str();
+}
+
+} // namespace planning
+} // namespace agv
+} // namespace rmf_traffic
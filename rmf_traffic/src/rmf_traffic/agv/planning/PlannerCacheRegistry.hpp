@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC__AGV__PLANNING__PLANNERCACHEREGISTRY_HPP
+#define SRC__RMF_TRAFFIC__AGV__PLANNING__PLANNERCACHEREGISTRY_HPP
+
+#include "DifferentialDriveHeuristic.hpp"
+
+namespace rmf_traffic {
+namespace agv {
+namespace planning {
+
+//==============================================================================
+/// A process-wide registry of the internals that planners build from their
+/// configuration. Planners whose graph, vehicle kinematics, and interpolation
+/// options are identical will share one Supergraph and one set of heuristic
+/// caches, so the caches only need to be stored once and they get warmed up by
+/// every planner that uses them.
+///
+/// Entries are addressed by their content, not by the identity of the objects
+/// that they came from, so two fleets that load the same nav graph separately
+/// will still share an entry. An entry is released as soon as the last planner
+/// that uses it is destroyed.
+class PlannerCacheRegistry
+{
+public:
+
+  struct Entry
+  {
+    std::shared_ptr<const Supergraph> supergraph;
+    CacheManagerPtr<DifferentialDriveHeuristic> heuristic;
+  };
+
+  using ConstEntryPtr = std::shared_ptr<const Entry>;
+
+  /// Get the registry for this process.
+  static PlannerCacheRegistry& get();
+
+  /// Get the entry that matches the given configuration, or create it if one
+  /// does not exist yet.
+  ConstEntryPtr acquire(
+    const Graph::Implementation& graph,
+    const VehicleTraits& traits,
+    const Interpolate::Options::Implementation& interpolate);
+
+  /// The number of entries that are currently alive.
+  std::size_t size() const;
+
+  /// Make the key that identifies a planner configuration. This will return
+  /// a nullopt if the graph contains a custom OrientationConstraint, because
+  /// there is no way to tell whether two custom constraints are equivalent.
+  ///
+  /// The profile of the vehicle is not part of the key, because neither the
+  /// Supergraph nor the heuristics make any use of it.
+  static std::optional<std::string> make_key(
+    const Graph::Implementation& graph,
+    const VehicleTraits& traits,
+    const Interpolate::Options::Implementation& interpolate);
+
+private:
+  PlannerCacheRegistry() = default;
+
+  mutable std::mutex _mutex;
+  std::unordered_map<std::string, std::weak_ptr<const Entry>> _entries;
+};
+
+} // namespace planning
+} // namespace agv
+} // namespace rmf_traffic
+
+#endif // SRC__RMF_TRAFFIC__AGV__PLANNING__PLANNERCACHEREGISTRY_HPP
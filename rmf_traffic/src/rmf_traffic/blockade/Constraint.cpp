@@ -16,6 +16,7 @@
 */
 
 #include "Constraint.hpp"
+#include "ConstraintProgram.hpp"
 
 #include <vector>
 #include <cassert>
@@ -154,6 +155,12 @@ public:
     return str.str();
   }
 
+  std::size_t compile(ConstraintProgram& program) const final
+  {
+    return program.add_blockage(
+      _blocked_by, _blocker_hold_point, _end_condition);
+  }
+
 private:
 
   bool _evaluate_can_hold(const ReservedRange& range) const
@@ -299,6 +306,11 @@ public:
     return str.str();
   }
 
+  std::size_t compile(ConstraintProgram& program) const final
+  {
+    return program.add_passed(_participant, _index);
+  }
+
 private:
 
   bool _evaluate(const ReservedRange& range) const
@@ -351,6 +363,11 @@ public:
     return "True";
   }
 
+  std::size_t compile(ConstraintProgram& program) const final
+  {
+    return program.add_always_valid();
+  }
+
 };
 
 //==============================================================================
@@ -441,6 +458,17 @@ std::string AndConstraint::detail(const State& state) const
   return str.str();
 }
 
+//==============================================================================
+std::size_t AndConstraint::compile(ConstraintProgram& program) const
+{
+  std::vector<std::size_t> children;
+  children.reserve(_constraints.size());
+  for (const auto& c : _constraints)
+    children.push_back(program.compile(*c));
+
+  return program.add_and(children);
+}
+
 //==============================================================================
 OrConstraint::OrConstraint(const std::vector<ConstConstraintPtr>& constraints)
 {
@@ -532,6 +560,17 @@ std::string OrConstraint::detail(const State& state) const
   return str.str();
 }
 
+//==============================================================================
+std::size_t OrConstraint::compile(ConstraintProgram& program) const
+{
+  std::vector<std::size_t> children;
+  children.reserve(_constraints.size());
+  for (const auto& c : _constraints)
+    children.push_back(program.compile(*c));
+
+  return program.add_or(children);
+}
+
 namespace {
 
 //==============================================================================
@@ -28,6 +28,8 @@
 namespace rmf_traffic {
 namespace blockade {
 
+class ConstraintProgram;
+
 //==============================================================================
 using State = std::unordered_map<ParticipantId, ReservedRange>;
 
@@ -46,6 +48,10 @@ public:
 
   virtual std::string detail(const State& state) const = 0;
 
+  /// Add the instructions for this Constraint to a ConstraintProgram and
+  /// return the index of the instruction that gives its result.
+  virtual std::size_t compile(ConstraintProgram& program) const = 0;
+
   virtual ~Constraint() = default;
 };
 
@@ -95,6 +101,7 @@ public:
   const std::unordered_set<std::size_t>& dependencies() const final;
   std::optional<bool> partial_evaluate(const State& state) const final;
   std::string detail(const State& state) const final;
+  std::size_t compile(ConstraintProgram& program) const final;
 
 private:
   std::unordered_set<ConstConstraintPtr> _constraints;
@@ -114,6 +121,7 @@ public:
   const std::unordered_set<std::size_t>& dependencies() const final;
   std::optional<bool> partial_evaluate(const State& state) const final;
   std::string detail(const State &state) const final;
+  std::size_t compile(ConstraintProgram& program) const final;
 
 private:
   std::unordered_set<ConstConstraintPtr> _constraints;
@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ConstraintProgram.hpp"
+#include "conflicts.hpp"
+
+#include <algorithm>
+
+namespace rmf_traffic {
+namespace blockade {
+
+//==============================================================================
+ConstraintProgram::ConstraintProgram(const Blockers& should_go)
+{
+  for (const auto& p : should_go)
+  {
+    _slot(p.first);
+    auto& roots = _roots[p.first];
+    for (const auto& c : p.second)
+    {
+      roots.push_back(
+        Root{c.first, static_cast<uint32_t>(compile(*c.second))});
+    }
+
+    std::sort(roots.begin(), roots.end(), [](const Root& a, const Root& b)
+      {
+        return a.checkpoint < b.checkpoint;
+      });
+  }
+
+  // The addresses of the constraints are only meaningful while we are
+  // compiling them.
+  _compiled.clear();
+}
+
+//==============================================================================
+void ConstraintProgram::set_range(
+    const ParticipantId participant,
+    const ReservedRange& range)
+{
+  const auto it = _slots.find(participant);
+  if (it == _slots.end())
+  {
+    // Nothing depends on this participant
+    return;
+  }
+
+  const auto slot = it->second;
+  auto& current = _ranges[slot];
+  if (_present[slot] && current.begin == range.begin && current.end == range.end)
+    return;
+
+  current = range;
+  _present[slot] = true;
+  _invalidate(slot);
+}
+
+//==============================================================================
+void ConstraintProgram::erase(const ParticipantId participant)
+{
+  const auto it = _slots.find(participant);
+  if (it == _slots.end())
+    return;
+
+  _present[it->second] = false;
+  _invalidate(it->second);
+}
+
+//==============================================================================
+bool ConstraintProgram::has_constraints(const ParticipantId participant) const
+{
+  return _roots.find(participant) != _roots.end();
+}
+
+//==============================================================================
+std::optional<std::size_t> ConstraintProgram::find_blocked(
+    const ParticipantId participant)
+{
+  const auto r_it = _roots.find(participant);
+  if (r_it == _roots.end())
+    return std::nullopt;
+
+  const auto& range = _range(_slots.at(participant));
+  const auto& roots = r_it->second;
+  auto it = std::lower_bound(
+    roots.begin(), roots.end(), range.begin,
+    [](const Root& root, const std::size_t checkpoint)
+    {
+      return root.checkpoint < checkpoint;
+    });
+
+  for (; it != roots.end() && it->checkpoint < range.end; ++it)
+  {
+    if (!_evaluate(it->instruction))
+      return it->checkpoint;
+  }
+
+  return std::nullopt;
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::evaluation_count() const
+{
+  return _evaluation_count;
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::compile(const Constraint& constraint)
+{
+  const auto it = _compiled.find(&constraint);
+  if (it != _compiled.end())
+    return it->second;
+
+  const auto index = constraint.compile(*this);
+  _compiled.insert({&constraint, index});
+  return index;
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_always_valid()
+{
+  Instruction instruction;
+  instruction.op = Instruction::AlwaysValid;
+  return _add(instruction, {});
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_blockage(
+    const std::size_t blocked_by,
+    const std::optional<std::size_t> blocker_hold_point,
+    const std::optional<BlockageEndCondition> end_condition)
+{
+  Instruction instruction;
+  instruction.op = Instruction::Blockage;
+  instruction.slot_a = _slot(blocked_by);
+  if (blocker_hold_point.has_value())
+  {
+    instruction.has_hold = true;
+    instruction.value_a = *blocker_hold_point;
+  }
+
+  if (end_condition.has_value())
+  {
+    instruction.has_end = true;
+    instruction.value_b = end_condition->index;
+    instruction.end_has_reached =
+        end_condition->condition == BlockageEndCondition::HasReached;
+  }
+
+  return _add(instruction, {instruction.slot_a});
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_passed(
+    const std::size_t participant,
+    const std::size_t index)
+{
+  Instruction instruction;
+  instruction.op = Instruction::Passed;
+  instruction.slot_a = _slot(participant);
+  instruction.value_b = index;
+  return _add(instruction, {instruction.slot_a});
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_behind(
+    const std::size_t is_behind,
+    const std::size_t is_in_front,
+    std::shared_ptr<const Timeline> timeline)
+{
+  Instruction instruction;
+  instruction.op = Instruction::Behind;
+  instruction.slot_a = _slot(is_behind);
+  instruction.slot_b = _slot(is_in_front);
+  instruction.first = static_cast<uint32_t>(_timelines.size());
+  _timelines.emplace_back(std::move(timeline));
+  return _add(instruction, {instruction.slot_a, instruction.slot_b});
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_and(const std::vector<std::size_t>& children)
+{
+  Instruction instruction;
+  instruction.op = Instruction::And;
+  instruction.first = static_cast<uint32_t>(_children.size());
+  instruction.count = static_cast<uint32_t>(children.size());
+  for (const auto c : children)
+    _children.push_back(static_cast<uint32_t>(c));
+
+  const auto index = _add(instruction, {});
+  for (const auto c : children)
+    _parents[c].push_back(static_cast<uint32_t>(index));
+
+  return index;
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::add_or(const std::vector<std::size_t>& children)
+{
+  const auto index = add_and(children);
+  _instructions[index].op = Instruction::Or;
+  return index;
+}
+
+//==============================================================================
+uint32_t ConstraintProgram::_slot(const std::size_t participant)
+{
+  const auto insertion =
+      _slots.insert({participant, static_cast<uint32_t>(_participants.size())});
+
+  if (insertion.second)
+  {
+    _participants.push_back(participant);
+    _ranges.push_back(ReservedRange{0, 0});
+    _present.push_back(false);
+    _readers.emplace_back();
+  }
+
+  return insertion.first->second;
+}
+
+//==============================================================================
+std::size_t ConstraintProgram::_add(
+    Instruction instruction,
+    std::vector<uint32_t> reads)
+{
+  const auto index = _instructions.size();
+  _instructions.push_back(instruction);
+  _results.push_back(Unknown);
+  _parents.emplace_back();
+
+  std::sort(reads.begin(), reads.end());
+  reads.erase(std::unique(reads.begin(), reads.end()), reads.end());
+  for (const auto slot : reads)
+    _readers[slot].push_back(static_cast<uint32_t>(index));
+
+  return index;
+}
+
+//==============================================================================
+void ConstraintProgram::_invalidate(const uint32_t slot)
+{
+  // An instruction whose result is already unknown does not need to be
+  // expanded, because no known result was derived from it.
+  std::vector<uint32_t> queue = _readers[slot];
+  while (!queue.empty())
+  {
+    const auto i = queue.back();
+    queue.pop_back();
+
+    if (_results[i] == Unknown)
+      continue;
+
+    _results[i] = Unknown;
+    const auto& parents = _parents[i];
+    queue.insert(queue.end(), parents.begin(), parents.end());
+  }
+}
+
+//==============================================================================
+bool ConstraintProgram::_evaluate(const uint32_t i)
+{
+  if (_results[i] != Unknown)
+    return _results[i] == True;
+
+  ++_evaluation_count;
+  const auto& instruction = _instructions[i];
+  bool value = true;
+  switch (instruction.op)
+  {
+    case Instruction::AlwaysValid:
+    {
+      value = true;
+      break;
+    }
+    case Instruction::Blockage:
+    {
+      const auto& range = _range(instruction.slot_a);
+      const bool can_hold =
+          instruction.has_hold && range.end <= instruction.value_a;
+
+      bool has_reached = false;
+      if (instruction.has_end)
+      {
+        const std::size_t index = instruction.value_b;
+        if (range.begin < index)
+          has_reached = false;
+        else if (index < range.end)
+          has_reached = true;
+        else
+          has_reached = instruction.end_has_reached && index == range.begin;
+      }
+
+      value = can_hold || has_reached;
+      break;
+    }
+    case Instruction::Passed:
+    {
+      const auto& range = _range(instruction.slot_a);
+      const std::size_t index = instruction.value_b;
+      if (index < range.begin)
+        value = true;
+      else if (range.begin < index)
+        value = false;
+      else
+        value = index < range.end;
+
+      break;
+    }
+    case Instruction::Behind:
+    {
+      value = _timelines[instruction.first]->is_behind(
+        _range(instruction.slot_a), _range(instruction.slot_b));
+      break;
+    }
+    case Instruction::And:
+    {
+      value = true;
+      for (uint32_t c = 0; c < instruction.count; ++c)
+      {
+        if (!_evaluate(_children[instruction.first + c]))
+        {
+          value = false;
+          break;
+        }
+      }
+      break;
+    }
+    case Instruction::Or:
+    {
+      value = instruction.count == 0;
+      for (uint32_t c = 0; c < instruction.count; ++c)
+      {
+        if (_evaluate(_children[instruction.first + c]))
+        {
+          value = true;
+          break;
+        }
+      }
+      break;
+    }
+  }
+
+  _results[i] = value ? True : False;
+  return value;
+}
+
+//==============================================================================
+const ReservedRange& ConstraintProgram::_range(const uint32_t slot) const
+{
+  if (!_present[slot])
+  {
+    throw std::runtime_error(
+            "Failed to evaluate a blockade constraint because participant "
+            + std::to_string(_participants[slot])
+            + " is missing from the state.");
+  }
+
+  return _ranges[slot];
+}
+
+} // namespace blockade
+} // namespace rmf_traffic
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC__BLOCKADE__CONSTRAINTPROGRAM_HPP
+#define SRC__RMF_TRAFFIC__BLOCKADE__CONSTRAINTPROGRAM_HPP
+
+#include "Constraint.hpp"
+
+#include <vector>
+
+namespace rmf_traffic {
+namespace blockade {
+
+class Timeline;
+
+//==============================================================================
+/// A flattened form of a set of constraints. Every Constraint of the forest is
+/// compiled into one instruction of a flat array, and constraints that are
+/// shared between several checkpoints (like the gridlock constraint) are only
+/// compiled once.
+///
+/// The program keeps its own copy of the reserved range of each participant.
+/// The result of each instruction is cached until the range of a participant
+/// that it depends on is changed, so after set_range() is called, only the
+/// instructions that depend on that participant get evaluated again.
+class ConstraintProgram
+{
+public:
+
+  /// Create an empty program
+  ConstraintProgram() = default;
+
+  /// Compile the constraints for each checkpoint of each participant
+  ConstraintProgram(const Blockers& should_go);
+
+  /// Set the reserved range of a participant
+  void set_range(ParticipantId participant, const ReservedRange& range);
+
+  /// Remove a participant from the state
+  void erase(ParticipantId participant);
+
+  /// Check whether this participant has any constraints
+  bool has_constraints(ParticipantId participant) const;
+
+  /// Find the first checkpoint in the current reserved range of the
+  /// participant whose constraint is not satisfied. If every constraint is
+  /// satisfied, this will return a nullopt.
+  std::optional<std::size_t> find_blocked(ParticipantId participant);
+
+  /// The number of instructions that have been evaluated by this program.
+  /// This is used to measure how much work is being saved by the caching.
+  std::size_t evaluation_count() const;
+
+  /// The following functions are used by Constraint::compile(~) to add
+  /// instructions to the program. Each of them returns the index of the
+  /// instruction that was added.
+  std::size_t compile(const Constraint& constraint);
+
+  std::size_t add_always_valid();
+
+  std::size_t add_blockage(
+    std::size_t blocked_by,
+    std::optional<std::size_t> blocker_hold_point,
+    std::optional<BlockageEndCondition> end_condition);
+
+  std::size_t add_passed(std::size_t participant, std::size_t index);
+
+  std::size_t add_behind(
+    std::size_t is_behind,
+    std::size_t is_in_front,
+    std::shared_ptr<const Timeline> timeline);
+
+  std::size_t add_and(const std::vector<std::size_t>& children);
+
+  std::size_t add_or(const std::vector<std::size_t>& children);
+
+private:
+
+  struct Instruction
+  {
+    enum Op : uint8_t
+    {
+      AlwaysValid,
+      Blockage,
+      Passed,
+      Behind,
+      And,
+      Or
+    };
+
+    Op op;
+
+    // The participant slots that this instruction reads from
+    uint32_t slot_a = 0;
+    uint32_t slot_b = 0;
+
+    // Blockage: hold point and end condition. Passed: index in value_b.
+    bool has_hold = false;
+    bool has_end = false;
+    bool end_has_reached = false;
+    std::size_t value_a = 0;
+    std::size_t value_b = 0;
+
+    // Behind: index into _timelines. And/Or: range of _children.
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+
+  enum Result : int8_t
+  {
+    Unknown = -1,
+    False = 0,
+    True = 1
+  };
+
+  struct Root
+  {
+    std::size_t checkpoint;
+    uint32_t instruction;
+  };
+
+  uint32_t _slot(std::size_t participant);
+  std::size_t _add(Instruction instruction, std::vector<uint32_t> reads);
+  void _invalidate(uint32_t slot);
+  bool _evaluate(uint32_t instruction);
+  const ReservedRange& _range(uint32_t slot) const;
+
+  // Instructions
+  std::vector<Instruction> _instructions;
+  std::vector<uint32_t> _children;
+  std::vector<std::shared_ptr<const Timeline>> _timelines;
+  std::unordered_map<const Constraint*, std::size_t> _compiled;
+
+  // Dependency index: the parents of each instruction, and the leaf
+  // instructions that read from each slot
+  std::vector<std::vector<uint32_t>> _parents;
+  std::vector<std::vector<uint32_t>> _readers;
+
+  // State
+  std::unordered_map<std::size_t, uint32_t> _slots;
+  std::vector<std::size_t> _participants;
+  std::vector<ReservedRange> _ranges;
+  std::vector<bool> _present;
+  std::vector<Result> _results;
+
+  // Roots of each participant, sorted by checkpoint
+  std::unordered_map<std::size_t, std::vector<Root>> _roots;
+
+  std::size_t _evaluation_count = 0;
+};
+
+} // namespace blockade
+} // namespace rmf_traffic
+
+#endif // SRC__RMF_TRAFFIC__BLOCKADE__CONSTRAINTPROGRAM_HPP
@@ -19,6 +19,8 @@
 
 #include <rmf_utils/Modular.hpp>
 
+#include "ConstraintProgram.hpp"
+#include "SegmentGrid.hpp"
 #include "conflicts.hpp"
 
 #include <list>
@@ -73,6 +75,32 @@ Moderator::Assignments::Assignments()
   // Do nothing
 }
 
+namespace {
+//==============================================================================
+bool same_path(
+    const Writer::Reservation& a,
+    const Writer::Reservation& b)
+{
+  if (a.radius != b.radius)
+    return false;
+
+  if (a.path.size() != b.path.size())
+    return false;
+
+  for (std::size_t i=0; i < a.path.size(); ++i)
+  {
+    const auto& c_a = a.path[i];
+    const auto& c_b = b.path[i];
+    if (c_a.position != c_b.position
+        || c_a.can_hold != c_b.can_hold
+        || c_a.map_name != c_b.map_name)
+      return false;
+  }
+
+  return true;
+}
+} // anonymous namespace
+
 //==============================================================================
 class Moderator::Implementation
 {
@@ -107,10 +135,19 @@ public:
   Assignments assignments;
   std::unordered_map<ParticipantId, Status> statuses;
 
+  // The brackets of each pair of paths are stored in peer_blockers and
+  // peer_alignment until one of the two paths changes. The grid lets us skip
+  // the bracket calculations for pairs of paths that are nowhere near each
+  // other.
+  SegmentGrid grid;
   PeerToPeerBlockers peer_blockers;
   PeerToPeerAlignment peer_alignment;
   FinalConstraints final_constraints;
 
+  // The should_go constraints compiled into a form that only re-evaluates the
+  // constraints whose participants have changed their ranges
+  ConstraintProgram constraint_program;
+
   Implementation(
       std::function<void(std::string)> info,
       std::function<void(std::string)> debug,
@@ -139,24 +176,18 @@ public:
     if (r_it->second.id != check.reservation_id)
       return Finished;
 
-    auto state = assignments.ranges();
-    auto& s = state.at(check.participant_id);
+    const auto s = assignments.ranges().at(check.participant_id);
     if (check.checkpoint < s.end)
       return Finished;
 
-    const auto constraints_it =
-        final_constraints.should_go.find(check.participant_id);
-    if (constraints_it == final_constraints.should_go.end())
+    if (!constraint_program.has_constraints(check.participant_id))
     {
       // There are no constraints for this participant, so we will just allow it
       // to go all the way.
-      Assignments::Implementation::modify(assignments)
-          .ranges[check.participant_id].end = check.checkpoint + 1;
+      set_range_end(check.participant_id, check.checkpoint + 1);
       return Finished;
     }
 
-    const auto& constraints = constraints_it->second;
-
     const std::size_t current_end = s.end;
     const std::size_t i_max = (check.checkpoint+1) - (current_end+1);
     for (std::size_t i=0; i <= i_max; ++i)
@@ -167,47 +198,64 @@ public:
       // we cannot even reserve current_end+1, then the participant is stuck for
       // now.
       const std::size_t check_end = check.checkpoint+1 - i;
-      s.end = check_end;
+      constraint_program.set_range(
+        check.participant_id, ReservedRange{s.begin, check_end});
 
-      // TODO(MXG): We could probably get slightly better performance here if
-      // should_go used an ordered std::map instead of std::unordered_map.
-      bool acceptable = true;
-      for (std::size_t c=s.begin; c < s.end; ++c)
+      const auto blocked = constraint_program.find_blocked(check.participant_id);
+      if (blocked.has_value())
       {
-        const auto it = constraints.find(c);
-        if (it != constraints.end() && !it->second->evaluate(state))
+        if (debug_logger)
         {
-          if (debug_logger)
-          {
-            std::stringstream str;
-            const std::string P = toul(check.participant_id);
-            str << "Cannot reserve [" << P << s.begin
-                << " -> " << P << check_end
-                << "]. Blocked at " << P << c << " by: "
-                << it->second->detail(state);
-            debug_logger(str.str());
-          }
-
-          acceptable = false;
-          break;
+          auto state = assignments.ranges();
+          state.at(check.participant_id).end = check_end;
+
+          const auto c = *blocked;
+          const auto& constraint =
+              final_constraints.should_go.at(check.participant_id).at(c);
+
+          std::stringstream str;
+          const std::string P = toul(check.participant_id);
+          str << "Cannot reserve [" << P << s.begin
+              << " -> " << P << check_end
+              << "]. Blocked at " << P << c << " by: "
+              << constraint->detail(state);
+          debug_logger(str.str());
         }
+
+        continue;
       }
 
-      if (acceptable)
-      {
-        Assignments::Implementation::modify(assignments)
-            .ranges[check.participant_id].end = check_end;
+      set_range_end(check.participant_id, check_end);
 
-        if (i==0)
-          return Finished;
+      if (i==0)
+        return Finished;
 
-        return Incomplete;
-      }
+      return Incomplete;
     }
 
+    // Put the program back to the range that the participant actually has
+    constraint_program.set_range(check.participant_id, s);
     return Skip;
   }
 
+  void set_range_end(const ParticipantId participant_id, const std::size_t end)
+  {
+    auto& range = Assignments::Implementation::modify(assignments)
+        .ranges[participant_id];
+    range.end = end;
+    constraint_program.set_range(participant_id, range);
+  }
+
+  void compile_constraints()
+  {
+    final_constraints = compute_final_ShouldGo_constraints(
+          peer_blockers, peer_alignment);
+
+    constraint_program = ConstraintProgram(final_constraints.should_go);
+    for (const auto& r : assignments.ranges())
+      constraint_program.set_range(r.first, r.second);
+  }
+
   void process_ready_queue()
   {
     auto next = ready_queue.begin();
@@ -258,7 +306,29 @@ public:
       info_logger(str.str());
     }
 
-    current_reservation.reservation = reservation;
+    // If only the reservation ID has changed, then every bracket that we have
+    // already computed for this path is still valid.
+    if (inserted || !same_path(current_reservation.reservation, reservation))
+    {
+      current_reservation.reservation = reservation;
+      compute_constraints(participant_id, reservation);
+    }
+
+    Assignments::Implementation::modify(assignments).ranges
+        .insert_or_assign(participant_id, ReservedRange{0, 0});
+    constraint_program.set_range(participant_id, ReservedRange{0, 0});
+
+    statuses[participant_id] = Status{reservation_id, std::nullopt, 0, false};
+
+    process_ready_queue();
+  }
+
+  void compute_constraints(
+      const ParticipantId participant_id,
+      const Reservation& reservation)
+  {
+    grid.insert(participant_id, reservation.path, reservation.radius);
+    const auto neighbors = grid.neighbors(participant_id);
 
     const auto peer_blocker_insertion =
         peer_blockers.insert({participant_id, {}});
@@ -280,6 +350,15 @@ public:
       if (other_participant == participant_id)
         continue;
 
+      if (neighbors.count(other_participant) == 0)
+      {
+        // These paths cannot have any brackets, so we only need to clear out
+        // anything that was left over from the previous path.
+        peer_blockers[other_participant].erase(participant_id);
+        peer_alignment[other_participant].erase(participant_id);
+        continue;
+      }
+
       const auto& other_reservation = other_r.second.reservation;
 
       const auto brackets = compute_brackets(
@@ -321,15 +400,7 @@ public:
       other_aligned_map = std::move(alignments.at(1));
     }
 
-    final_constraints = compute_final_ShouldGo_constraints(
-          peer_blockers, peer_alignment);
-
-    Assignments::Implementation::modify(assignments).ranges
-        .insert_or_assign(participant_id, ReservedRange{0, 0});
-
-    statuses[participant_id] = Status{reservation_id, std::nullopt, 0, false};
-
-    process_ready_queue();
+    compile_constraints();
   }
 
   void ready(
@@ -402,6 +473,8 @@ public:
     if (checkpoint < range.end)
       range.end = checkpoint;
 
+    constraint_program.set_range(participant_id, range);
+
     if (new_ready.has_value())
     {
       for (auto r_it = ready_queue.begin(); r_it != ready_queue.end(); ++r_it)
@@ -491,6 +564,7 @@ public:
     status.last_reached = checkpoint;
 
     range.begin = checkpoint;
+    constraint_program.set_range(participant_id, range);
 
     process_ready_queue();
   }
@@ -527,6 +601,7 @@ public:
 
     last_known_reservation.erase(participant_id);
     statuses.erase(participant_id);
+    grid.erase(participant_id);
     peer_blockers.erase(participant_id);
     peer_alignment.erase(participant_id);
     Assignments::Implementation::modify(assignments)
@@ -538,8 +613,7 @@ public:
     for (auto& peer : peer_alignment)
       peer.second.erase(participant_id);
 
-    final_constraints = compute_final_ShouldGo_constraints(
-          peer_blockers, peer_alignment);
+    compile_constraints();
 
     process_ready_queue();
   }
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "SegmentGrid.hpp"
+
+#include <cmath>
+
+namespace rmf_traffic {
+namespace blockade {
+
+namespace {
+//==============================================================================
+double distance_to_segment(
+    const Eigen::Vector2d& p,
+    const Eigen::Vector2d& start,
+    const Eigen::Vector2d& finish)
+{
+  const Eigen::Vector2d n = finish - start;
+  const double c = n.dot(n);
+  if (c == 0.0)
+    return (p - start).norm();
+
+  const double u = std::max(0.0, std::min(1.0, n.dot(p - start)/c));
+  return (u*n + start - p).norm();
+}
+} // anonymous namespace
+
+//==============================================================================
+const double SegmentGrid::DefaultCellSize;
+
+//==============================================================================
+SegmentGrid::SegmentGrid(const double cell_size)
+  : _cell_size(cell_size)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void SegmentGrid::insert(
+    const ParticipantId participant,
+    const std::vector<Writer::Checkpoint>& path,
+    const double radius)
+{
+  erase(participant);
+  auto& occupancy = _occupancy[participant];
+
+  // A cell belongs to a segment if any point of the cell is within the radius
+  // of the segment. We test that conservatively by checking the distance from
+  // the center of the cell against the radius plus half the cell diagonal.
+  const double half_diagonal = std::sqrt(2.0)*_cell_size/2.0;
+  const double reach = radius + half_diagonal;
+
+  for (std::size_t i=1; i < path.size(); ++i)
+  {
+    const auto& start = path[i-1];
+    const auto& finish = path[i];
+    if (start.map_name != finish.map_name)
+      continue;
+
+    auto& cells = _maps[start.map_name];
+
+    const Eigen::Vector2d lower =
+        start.position.cwiseMin(finish.position).array() - radius;
+    const Eigen::Vector2d upper =
+        start.position.cwiseMax(finish.position).array() + radius;
+
+    const auto x_min = static_cast<int64_t>(std::floor(lower.x()/_cell_size));
+    const auto x_max = static_cast<int64_t>(std::floor(upper.x()/_cell_size));
+    const auto y_min = static_cast<int64_t>(std::floor(lower.y()/_cell_size));
+    const auto y_max = static_cast<int64_t>(std::floor(upper.y()/_cell_size));
+
+    for (auto x = x_min; x <= x_max; ++x)
+    {
+      for (auto y = y_min; y <= y_max; ++y)
+      {
+        const Eigen::Vector2d center =
+            _cell_size * Eigen::Vector2d(x + 0.5, y + 0.5);
+
+        if (distance_to_segment(center, start.position, finish.position)
+            > reach)
+          continue;
+
+        const auto key = _key(x, y);
+        if (cells[key].insert(participant).second)
+          occupancy.push_back({start.map_name, key});
+      }
+    }
+  }
+}
+
+//==============================================================================
+void SegmentGrid::erase(const ParticipantId participant)
+{
+  const auto it = _occupancy.find(participant);
+  if (it == _occupancy.end())
+    return;
+
+  for (const auto& o : it->second)
+  {
+    auto& cells = _maps.at(o.map);
+    const auto c_it = cells.find(o.cell);
+    c_it->second.erase(participant);
+    if (c_it->second.empty())
+      cells.erase(c_it);
+  }
+
+  _occupancy.erase(it);
+}
+
+//==============================================================================
+std::unordered_set<ParticipantId> SegmentGrid::neighbors(
+    const ParticipantId participant) const
+{
+  std::unordered_set<ParticipantId> output;
+  const auto it = _occupancy.find(participant);
+  if (it == _occupancy.end())
+    return output;
+
+  for (const auto& o : it->second)
+  {
+    for (const auto other : _maps.at(o.map).at(o.cell))
+    {
+      if (other != participant)
+        output.insert(other);
+    }
+  }
+
+  return output;
+}
+
+//==============================================================================
+auto SegmentGrid::_key(const int64_t x, const int64_t y) const -> CellKey
+{
+  return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32)
+      | static_cast<CellKey>(static_cast<uint32_t>(y));
+}
+
+} // namespace blockade
+} // namespace rmf_traffic
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC__BLOCKADE__SEGMENTGRID_HPP
+#define SRC__RMF_TRAFFIC__BLOCKADE__SEGMENTGRID_HPP
+
+#include <rmf_traffic/blockade/Writer.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace rmf_traffic {
+namespace blockade {
+
+//==============================================================================
+/// A uniform grid that records which cells are touched by the path of each
+/// participant. Two paths can only produce conflict or alignment brackets if
+/// one of their segments comes within (radius_a + radius_b) of a segment of
+/// the other, and whenever that happens, the two paths will share at least one
+/// cell of this grid. The grid can therefore be used to rule out pairs of paths
+/// before doing any bracket calculations on them.
+class SegmentGrid
+{
+public:
+
+  static constexpr double DefaultCellSize = 2.0;
+
+  SegmentGrid(double cell_size = DefaultCellSize);
+
+  /// Insert the path of a participant, replacing any path that was previously
+  /// inserted for it.
+  void insert(
+    ParticipantId participant,
+    const std::vector<Writer::Checkpoint>& path,
+    double radius);
+
+  /// Remove the path of a participant.
+  void erase(ParticipantId participant);
+
+  /// Get the other participants whose paths share a cell with the path of
+  /// the given participant.
+  std::unordered_set<ParticipantId> neighbors(ParticipantId participant) const;
+
+private:
+
+  using CellKey = uint64_t;
+  using Cells = std::unordered_map<CellKey, std::unordered_set<ParticipantId>>;
+
+  struct Occupancy
+  {
+    std::string map;
+    CellKey cell;
+  };
+
+  CellKey _key(int64_t x, int64_t y) const;
+
+  double _cell_size;
+  std::unordered_map<std::string, Cells> _maps;
+  std::unordered_map<ParticipantId, std::vector<Occupancy>> _occupancy;
+};
+
+} // namespace blockade
+} // namespace rmf_traffic
+
+#endif // SRC__RMF_TRAFFIC__BLOCKADE__SEGMENTGRID_HPP
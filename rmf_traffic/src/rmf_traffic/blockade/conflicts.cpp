@@ -15,6 +15,7 @@
  *
 */
 
+#include "ConstraintProgram.hpp"
 #include "conflicts.hpp"
 #include "geometry.hpp"
 
@@ -182,6 +183,11 @@ public:
     return str.str();
   }
 
+  std::size_t compile(ConstraintProgram& program) const final
+  {
+    return program.add_behind(_is_behind, _is_in_front, _timeline);
+  }
+
 private:
 
   const ReservedRange& get_range(
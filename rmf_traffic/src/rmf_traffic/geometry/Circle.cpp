@@ -42,9 +42,9 @@ public:
   CollisionGeometries make_fcl() const final
   {
     #ifdef RMF_TRAFFIC__USING_FCL_0_6
-    return {std::make_shared<fcl::Sphered>(_radius)};
+    return {with_local_aabb(std::make_shared<fcl::Sphered>(_radius))};
     #else
-    return {std::make_shared<fcl::Sphere>(_radius)};
+    return {with_local_aabb(std::make_shared<fcl::Sphere>(_radius))};
     #endif
   }
 
@@ -22,6 +22,24 @@
 namespace rmf_traffic {
 namespace geometry {
 
+//==============================================================================
+BoundingCircles compute_bounding_circles(const CollisionGeometries& geometries)
+{
+  BoundingCircles bounds;
+  bounds.reserve(geometries.size());
+  for (const auto& geometry : geometries)
+  {
+    const auto& center = geometry->aabb_center;
+    bounds.push_back(
+      BoundingCircle{
+        Eigen::Vector2d(center[0], center[1]),
+        geometry->aabb_radius
+      });
+  }
+
+  return bounds;
+}
+
 //==============================================================================
 Shape::Internal* Shape::_get_internal()
 {
@@ -27,6 +27,8 @@
 #include <fcl/collision_object.h>
 #endif
 
+#include <Eigen/Geometry>
+
 #include <vector>
 
 namespace rmf_traffic {
@@ -39,6 +41,33 @@ using CollisionGeometryPtr = std::shared_ptr<fcl::CollisionGeometry>;
 #endif
 using CollisionGeometries = std::vector<CollisionGeometryPtr>;
 
+//==============================================================================
+/// A circle that contains one of the collision geometries of a shape, expressed
+/// in the frame of the shape.
+struct BoundingCircle
+{
+  Eigen::Vector2d center;
+  double radius;
+};
+using BoundingCircles = std::vector<BoundingCircle>;
+
+//==============================================================================
+/// Compute the local bounding volume of a collision geometry that has just been
+/// created. FCL caches the bounding volume inside of the geometry without any
+/// synchronization, so this must be done before the geometry can be shared
+/// with anything else.
+template<typename Geometry>
+std::shared_ptr<Geometry> with_local_aabb(std::shared_ptr<Geometry> geometry)
+{
+  geometry->computeLocalAABB();
+  return geometry;
+}
+
+//==============================================================================
+/// Get a circle that contains each collision geometry. The geometries must
+/// already have their local bounding volumes computed by with_local_aabb().
+BoundingCircles compute_bounding_circles(const CollisionGeometries& geometries);
+
 //==============================================================================
 /// \brief Implementations of this class must be created by the child classes of
 /// Shape, and then passed to the constructor of Shape.
@@ -46,6 +75,8 @@ class Shape::Internal
 {
 public:
 
+  /// Create the collision geometries of this shape. Each geometry must be
+  /// passed through with_local_aabb() when it is created.
   virtual CollisionGeometries make_fcl() const = 0;
 
   virtual ~Internal() = default;
@@ -63,21 +94,31 @@ public:
 
   double _characteristic_length;
 
+  // One bounding circle for each entry in _collisions
+  BoundingCircles _bounds;
+
   static const CollisionGeometries& get_collisions(const FinalShape& shape)
   {
     return shape._pimpl->_collisions;
   }
 
+  static const BoundingCircles& get_bounds(const FinalShape& shape)
+  {
+    return shape._pimpl->_bounds;
+  }
+
   static FinalShape make_final_shape(
     rmf_utils::impl_ptr<const Shape> shape,
     CollisionGeometries collisions,
     double characteristic_length)
   {
     FinalShape result;
+    auto bounds = compute_bounding_circles(collisions);
     result._pimpl = rmf_utils::make_impl<Implementation>(
       Implementation{std::move(shape),
         std::move(collisions),
-        std::move(characteristic_length)});
+        std::move(characteristic_length),
+        std::move(bounds)});
     return result;
   }
 
@@ -99,10 +140,12 @@ public:
     double characteristic_length)
   {
     FinalConvexShape result;
+    auto bounds = compute_bounding_circles(collisions);
     result._pimpl = rmf_utils::make_impl<FinalShape::Implementation>(
       FinalShape::Implementation{std::move(shape),
         std::move(collisions),
-        characteristic_length});
+        characteristic_length,
+        std::move(bounds)});
     return result;
   }
 };
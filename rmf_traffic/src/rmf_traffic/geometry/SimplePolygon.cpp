@@ -26,6 +26,9 @@
 #include <fcl/shape/geometric_shapes.h>
 #endif
 
+#include <iostream>
+#include <mutex>
+#include <optional>
 #include <sstream>
 
 namespace rmf_traffic {
@@ -127,226 +130,130 @@ bool compute_intersection(
 using Triangle = std::array<std::size_t, 3>;
 
 //==============================================================================
-struct AliasVertex
+double cross_product_2D(const Eigen::Vector2d& v0, const Eigen::Vector2d& v1)
 {
-  std::size_t original_index;
-  Eigen::Vector2d point;
-};
-using Subpolygon = std::vector<AliasVertex>;
+  return v0[0]*v1[1] - v0[1]*v1[0];
+}
 
 //==============================================================================
-bool is_polygon_ear(
-  const Subpolygon& polygon,
-  const Triangle& triangle)
+/// Twice the signed area of the polygon. This is positive if the polygon winds
+/// counter-clockwise.
+double compute_signed_area_x2(const std::vector<Eigen::Vector2d>& polygon)
 {
-  using EdgeInfo = SimplePolygon::EdgeInfo;
-
-  const std::size_t a0 = triangle[0];
-  const std::size_t a1 = triangle[2]; // yes, [2] is intended
-  const EdgeInfo edge_a =
-    EdgeInfo{{a0, a1}, {polygon[a0].point, polygon[a1].point}};
-
-  for (std::size_t b0 = 0; b0 < polygon.size(); ++b0)
+  double area = 0.0;
+  for (std::size_t i = 0; i < polygon.size(); ++i)
   {
-    const std::size_t b1 = (b0 == polygon.size()-1) ? 0 : b0+1;
-
-    // Ignore any edges that are in contact with the edge we care about.
-    if (b0 == a0 || b0 == a1 || b1 == a0 || b1 == a1)
-      continue;
-
-    const EdgeInfo edge_b =
-      EdgeInfo{{b0, b1}, {polygon[b0].point, polygon[b1].point}};
-
-    if (compute_intersection(edge_a, edge_b))
-      return false;
+    const std::size_t i_next = i+1 == polygon.size() ? 0 : i+1;
+    area += cross_product_2D(polygon[i], polygon[i_next]);
   }
 
-  return true;
+  return area;
 }
 
 //==============================================================================
-std::size_t find_deepest_reflex_point(
-  const Subpolygon& polygon,
-  const Triangle& triangle)
+/// Check whether p is inside of (or on the boundary of) the triangle a-b-c,
+/// whose winding is given by the sign of orientation.
+bool is_inside_triangle(
+  const Eigen::Vector2d& p,
+  const Eigen::Vector2d& a,
+  const Eigen::Vector2d& b,
+  const Eigen::Vector2d& c,
+  const double orientation)
 {
-  // Reference: https://en.wikipedia.org/wiki/Barycentric_coordinate_system#Barycentric_coordinates_on_triangles
-  // Simpler form: https://stackoverflow.com/a/2049712
-
-  const Eigen::Vector2d p_pivot = polygon[triangle[1]].point;
-  const Eigen::Vector2d p_preceding = polygon[triangle[0]].point;
-  const Eigen::Vector2d p_successive = polygon[triangle[2]].point;
-
-  const Eigen::Matrix2d M_inv = [&]()
-    {
-      Eigen::Matrix2d output;
-      output.block<2, 1>(0, 0) = p_preceding - p_pivot;
-      output.block<2, 1>(0, 0) = p_successive - p_pivot;
-      return output.inverse();
-    } ();
-
-  const Eigen::Vector2d diagonal = (p_successive - p_preceding).normalized();
-
-  // deepest is initialized to a virtually impossible value. A polygon this big
-  // would be absurd.
-  std::size_t deepest_index = static_cast<std::size_t>(-1);
-  double deepest_value = -std::numeric_limits<double>::infinity();
-  for (std::size_t i = 0; i < polygon.size(); ++i)
-  {
-    // Skip any indices that are part of the triangle
-    if (i == triangle[0] || i == triangle[1] || i == triangle[2])
-      continue;
-
-    const Eigen::Vector2d p = polygon[i].point;
-
-    // Check if the point is inside the triangle, and skip to the next index
-    // if it is not.
-    const Eigen::Vector2d s = M_inv * (p - p_pivot);
-    if (s[0] + s[1] > 1.0 || s[0] < 0.0 || s[1] < 0.0)
-      continue;
-
-    // If the point is inside the triangle, then compute its depth (distance
-    // from the nearest point on the diagonal line waypoint).
-    const Eigen::Vector2d p_rel = p - p_preceding;
-    const double depth = (p_rel - diagonal.dot(p_rel) * diagonal).norm();
-
-    // Compare the depth to the others, and find the deepest
-    if (depth > deepest_value)
-    {
-      deepest_index = i;
-      deepest_value = depth;
-    }
-  }
-
-  return deepest_index;
+  return orientation * cross_product_2D(b - a, p - a) >= 0.0
+    && orientation * cross_product_2D(c - b, p - b) >= 0.0
+    && orientation * cross_product_2D(a - c, p - c) >= 0.0;
 }
 
 //==============================================================================
-std::array<Subpolygon, 2> split_subpolygon(
-  const Subpolygon& original,
-  const std::array<std::size_t, 2>& edge)
+/// Triangulate the polygon by clipping ears. Every triangle has the same
+/// winding as the original polygon.
+std::vector<Triangle> decompose_polygon(
+  const std::vector<Eigen::Vector2d>& polygon)
 {
-  std::array<Subpolygon, 2> output;
-
-  const std::size_t split_start = std::min(edge[0], edge[1]);
-  const std::size_t split_end = std::max(edge[0], edge[1]);
+  std::vector<std::size_t> remaining;
+  for (std::size_t i = 0; i < polygon.size(); ++i)
+    remaining.push_back(i);
 
-  Subpolygon& output_0 = output[0];
-  for (std::size_t i = 0; i < original.size(); ++i)
+  if ((polygon.back() - polygon.front()).norm() < 1e-8)
   {
-    output_0.push_back(original[i]);
-    if (i == split_start)
-    {
-      // When we reach the split, just jump the value of i to the index that
-      // comes before the endpoint of the split. Then on the next iteration of
-      // this loop, the variable i will have the same value as split_end.
-      i = split_end-1;
-    }
+    // If the first and last point are very very close, we will effectively
+    // snap them together by deleting the last one.
+    remaining.pop_back();
   }
 
-  Subpolygon& output_1 = output[1];
-  for (std::size_t i = split_start; i <= split_end; ++i)
-    output_1.push_back(original[i]);
-
-  return output;
-}
+  const double orientation =
+    compute_signed_area_x2(polygon) < 0.0 ? -1.0 : 1.0;
 
-//==============================================================================
-Triangle get_original_indices(
-  const Subpolygon& polygon,
-  const Triangle& triangle)
-{
-  return Triangle{
-    polygon[triangle[0]].original_index,
-    polygon[triangle[1]].original_index,
-    polygon[triangle[2]].original_index
-  };
-}
+  std::vector<Triangle> triangles;
+  while (remaining.size() > 3)
+  {
+    const std::size_t N = remaining.size();
+    bool clipped = false;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      const std::size_t i_prev = i == 0 ? N-1 : i-1;
+      const std::size_t i_next = i+1 == N ? 0 : i+1;
 
-//==============================================================================
-std::vector<Triangle> decompose_polygon(
-  const std::vector<Eigen::Vector2d>& polygon)
-{
-  std::vector<Subpolygon> subpolygon_queue;
+      const Eigen::Vector2d& a = polygon[remaining[i_prev]];
+      const Eigen::Vector2d& b = polygon[remaining[i]];
+      const Eigen::Vector2d& c = polygon[remaining[i_next]];
 
-  // Creat the initial sub-polygon to analyze
-  subpolygon_queue.emplace_back(
-    [&polygon]() -> Subpolygon
-    {
-      Subpolygon sp;
-      for (std::size_t i = 0; i < polygon.size(); ++i)
-        sp.emplace_back(AliasVertex{i, polygon[i]});
+      const double turn = orientation * cross_product_2D(b - a, c - b);
+      if (std::abs(turn) < 1e-12)
+      {
+        // This vertex is collinear with its neighbors, so it does not
+        // contribute any area. Drop it without making a triangle.
+        remaining.erase(remaining.begin() + i);
+        clipped = true;
+        break;
+      }
 
-      if ( (sp.back().point - sp.front().point).norm() < 1e-8)
+      if (turn < 0.0)
       {
-        // If the first and last point are very very close, we will effective snap
-        // them together by deleting the last one.
-        sp.pop_back();
+        // This is a reflex vertex, so it cannot be the tip of an ear
+        continue;
       }
 
-      return sp;
-    } ());
+      bool is_ear = true;
+      for (std::size_t j = 0; j < N; ++j)
+      {
+        if (j == i_prev || j == i || j == i_next)
+          continue;
 
-  std::vector<Triangle> triangles;
-  while (!subpolygon_queue.empty())
-  {
-    Subpolygon next_polygon = subpolygon_queue.back();
-    subpolygon_queue.pop_back();
+        if (is_inside_triangle(polygon[remaining[j]], a, b, c, orientation))
+        {
+          is_ear = false;
+          break;
+        }
+      }
 
-    const std::size_t N = next_polygon.size();
-    if (N == 3)
-    {
-      triangles.push_back(get_original_indices(next_polygon, {0, 1, 2}));
-      continue;
+      if (!is_ear)
+        continue;
+
+      triangles.push_back(
+        {remaining[i_prev], remaining[i], remaining[i_next]});
+      remaining.erase(remaining.begin() + i);
+      clipped = true;
+      break;
     }
-    else if (N < 3)
+
+    if (!clipped)
     {
+      // Every simple polygon has at least two ears, so this can only happen
+      // if the polygon was not simple.
       std::cerr << "[rmf_traffic::geometry::decompose_polygon] "
-                << "A subpolygon has an incorrect number of vertices: " << N
-                << ". This is a bug that should never happen. Please report "
-                << "this to the developers!" << std::endl;
+                << "Unable to find an ear in a subpolygon with " << N
+                << " vertices. This is a bug that should never happen. Please "
+                << "report this to the developers!" << std::endl;
       throw InvalidSimplePolygonException(N);
     }
-
-    const std::size_t pivot_point = N-2;
-    const Triangle next_triangle = {pivot_point-1, pivot_point, pivot_point+1};
-    if (is_polygon_ear(next_polygon, next_triangle))
-    {
-      // If the triangle is an ear (not intersected by any other lines of the
-      // polygon), then we can just snip it off.
-      triangles.push_back(get_original_indices(next_polygon, next_triangle));
-
-      // Removing the last two vertices will snip off the ear while leaving the
-      // remaining polygon untouched.
-      next_polygon.resize(N-2);
-      subpolygon_queue.emplace_back(std::move(next_polygon));
-      continue;
-    }
-
-    // If the polgyon is not an ear, we should find its deepest reflex point,
-    // and then slice the polygon along the line that joins the deepest reflex
-    // point to the triangle's pivot point.
-
-    // NOTE(MXG): It might be possible to improve performance here by
-    // remembering which line segments crossed the diagonal during the
-    // computation of is_polygon_ear(~) and using that to narrow down which
-    // vertices to look at when computing the deepest reflext point.
-    const std::size_t reflex_point =
-      find_deepest_reflex_point(next_polygon, next_triangle);
-
-    const auto new_subpolygons = split_subpolygon(
-      next_polygon, {pivot_point, reflex_point});
-
-    for (auto&& new_subpolygon : new_subpolygons)
-      subpolygon_queue.emplace_back(std::move(new_subpolygon));
   }
 
-  return triangles;
-}
+  if (remaining.size() == 3)
+    triangles.push_back({remaining[0], remaining[1], remaining[2]});
 
-//==============================================================================
-double cross_product_2D(const Eigen::Vector2d& v0, const Eigen::Vector2d& v1)
-{
-  return v0[0]*v1[1] - v0[1]*v1[0];
+  return triangles;
 }
 
 //==============================================================================
@@ -375,7 +282,9 @@ bool is_polygon_convex(const std::vector<Eigen::Vector2d>& polygon)
     e_previous = ei;
   }
 
-  return true;
+  // The turn from the last edge back into the first edge also needs to match
+  const bool is_ccw = cross_product_2D(e_previous, e0) > 0.0;
+  return is_ccw == must_be_ccw;
 }
 
 #ifdef RMF_TRAFFIC__USING_FCL_0_6
@@ -420,8 +329,8 @@ public:
       (*fcl_points)[2*i + 1] = FclVec3(p[0], p[1], 1.0);
     }
 
-    return std::make_shared<ConvexWrapper>(
-      std::move(fcl_points));
+    return with_local_aabb<FclConvexType>(
+      std::make_shared<ConvexWrapper>(std::move(fcl_points)));
   }
 
   std::shared_ptr<PointArray> point_storage;
@@ -436,25 +345,102 @@ std::shared_ptr<FclConvexType> make_convex(
 }
 
 //==============================================================================
-std::vector<std::shared_ptr<FclConvexType>> make_triangulation(
-  const std::vector<Eigen::Vector2d>& polygon)
+using ConvexPiece = std::vector<std::size_t>;
+
+//==============================================================================
+std::vector<Eigen::Vector2d> get_points(
+  const std::vector<Eigen::Vector2d>& polygon,
+  const ConvexPiece& piece)
 {
-  const std::vector<Triangle> triangles = decompose_polygon(polygon);
+  std::vector<Eigen::Vector2d> points;
+  points.reserve(piece.size());
+  for (const std::size_t index : piece)
+    points.push_back(polygon[index]);
 
-  std::vector<std::shared_ptr<FclConvexType>> triangulation;
+  return points;
+}
 
-  std::vector<Eigen::Vector2d> points;
-  points.reserve(3);
-  for (const Triangle& triangle : triangles)
+//==============================================================================
+/// If the two pieces share an edge, return the pieces joined together along
+/// that edge. Otherwise return a nullopt.
+std::optional<ConvexPiece> join_pieces(
+  const ConvexPiece& piece_a,
+  const ConvexPiece& piece_b)
+{
+  const std::size_t N_a = piece_a.size();
+  const std::size_t N_b = piece_b.size();
+  for (std::size_t i = 0; i < N_a; ++i)
+  {
+    const std::size_t u = piece_a[i];
+    const std::size_t v = piece_a[(i+1) % N_a];
+    for (std::size_t j = 0; j < N_b; ++j)
+    {
+      // The pieces all have the same winding as the original polygon, so a
+      // shared edge will be traversed in opposite directions by the two pieces.
+      if (piece_b[j] != v || piece_b[(j+1) % N_b] != u)
+        continue;
+
+      // Go around piece A starting from v and ending at u, and then go around
+      // piece B from the vertex after u up to the vertex before v.
+      ConvexPiece joined;
+      joined.reserve(N_a + N_b - 2);
+      for (std::size_t k = 1; k <= N_a; ++k)
+        joined.push_back(piece_a[(i+k) % N_a]);
+
+      for (std::size_t k = 2; k < N_b; ++k)
+        joined.push_back(piece_b[(j+k) % N_b]);
+
+      return joined;
+    }
+  }
+
+  return std::nullopt;
+}
+
+//==============================================================================
+/// Triangulate the polygon and then greedily join neighboring pieces as long as
+/// the joined piece remains convex (Hertel-Mehlhorn). This never gives back
+/// more pieces than the triangulation, and it usually gives back far fewer,
+/// which means fewer narrowphase collision checks for each conflict check.
+std::vector<ConvexPiece> decompose_into_convex_pieces(
+  const std::vector<Eigen::Vector2d>& polygon)
+{
+  std::vector<ConvexPiece> pieces;
+  for (const Triangle& triangle : decompose_polygon(polygon))
+    pieces.emplace_back(triangle.begin(), triangle.end());
+
+  bool joined_any = true;
+  while (joined_any)
   {
-    points.clear();
-    for (const std::size_t index : triangle)
-      points.push_back(polygon[index]);
+    joined_any = false;
+    for (std::size_t a = 0; a < pieces.size() && !joined_any; ++a)
+    {
+      for (std::size_t b = a+1; b < pieces.size(); ++b)
+      {
+        auto joined = join_pieces(pieces[a], pieces[b]);
+        if (!joined || !is_polygon_convex(get_points(polygon, *joined)))
+          continue;
 
-    triangulation.push_back(ConvexWrapper::make(points));
+        pieces[a] = std::move(*joined);
+        pieces.erase(pieces.begin() + b);
+        joined_any = true;
+        break;
+      }
+    }
   }
 
-  return triangulation;
+  return pieces;
+}
+
+//==============================================================================
+std::vector<std::shared_ptr<FclConvexType>> make_convex_decomposition(
+  const std::vector<Eigen::Vector2d>& polygon)
+{
+  std::vector<std::shared_ptr<FclConvexType>> decomposition;
+  for (const ConvexPiece& piece : decompose_into_convex_pieces(polygon))
+    decomposition.push_back(ConvexWrapper::make(get_points(polygon, piece)));
+
+  return decomposition;
 }
 
 } // anonymous namespace
@@ -500,6 +486,26 @@ public:
     // Do nothing
   }
 
+  SimplePolygonInternal(const SimplePolygonInternal& other)
+  : _points(other._points),
+    _decomposition(other._get_decomposition())
+  {
+    // Do nothing
+  }
+
+  SimplePolygonInternal& operator=(const SimplePolygonInternal& other)
+  {
+    if (this == &other)
+      return *this;
+
+    auto decomposition = other._get_decomposition();
+    _points = other._points;
+
+    std::lock_guard<std::mutex> lock(_decomposition_mutex);
+    _decomposition = std::move(decomposition);
+    return *this;
+  }
+
   bool check_self_intersections(Intersections* intersections) const
   {
     if (intersections)
@@ -566,6 +572,15 @@ public:
 
   CollisionGeometries make_fcl() const final
   {
+    // The validation and decomposition of a polygon are expensive, so we hang
+    // on to the result and give it back again for as long as the points of the
+    // polygon are unchanged. The FCL geometries, including their cached
+    // bounding volumes, are never modified after they are created, so it is
+    // safe for many FinalShapes to share them.
+    const auto cached = _get_decomposition();
+    if (cached && cached->points == _points)
+      return cached->shapes;
+
     except_on_invalid_polygon();
 
     CollisionGeometries shapes;
@@ -575,16 +590,38 @@ public:
     }
     else
     {
-      const auto triangles = make_triangulation(_points);
-      shapes.reserve(triangles.size());
-      for (auto&& triangle : triangles)
-        shapes.push_back(std::move(triangle));
+      const auto pieces = make_convex_decomposition(_points);
+      shapes.reserve(pieces.size());
+      for (auto&& piece : pieces)
+        shapes.push_back(std::move(piece));
     }
 
+    auto decomposition = std::make_shared<const Decomposition>(
+      Decomposition{_points, shapes});
+
+    std::lock_guard<std::mutex> lock(_decomposition_mutex);
+    _decomposition = std::move(decomposition);
     return shapes;
   }
 
   std::vector<Eigen::Vector2d> _points;
+
+private:
+
+  struct Decomposition
+  {
+    std::vector<Eigen::Vector2d> points;
+    CollisionGeometries shapes;
+  };
+
+  std::shared_ptr<const Decomposition> _get_decomposition() const
+  {
+    std::lock_guard<std::mutex> lock(_decomposition_mutex);
+    return _decomposition;
+  }
+
+  mutable std::mutex _decomposition_mutex;
+  mutable std::shared_ptr<const Decomposition> _decomposition;
 };
 
 //==============================================================================
@@ -22,6 +22,7 @@
 #include "debug_Database.hpp"
 #include "internal_Snapshot.hpp"
 
+#include "../TrajectoryInternal.hpp"
 #include "../detail/internal_bidirectional_iterator.hpp"
 
 #include <rmf_traffic/schedule/Database.hpp>
@@ -159,6 +160,11 @@ public:
 
   Version schedule_version = 0;
 
+  /// The oldest version that we have a full history of changes for
+  Version oldest_version = 0;
+
+  std::shared_ptr<Journal> journal;
+
   struct CullInfo
   {
     Change::Cull cull;
@@ -337,6 +343,49 @@ public:
     // argument is sometimes a reference to the active_routes field.
   }
 
+  /// Discard a chain of transitions along with the route entries that they
+  /// hold on to. We unravel the chain one entry at a time, because letting it
+  /// get destructed on its own would recurse once for every entry, and a route
+  /// that has been delayed many times could overflow the stack.
+  ///
+  /// \return the number of route entries that were discarded.
+  static std::size_t discard_history(TransitionPtr transition)
+  {
+    std::size_t count = 0;
+    while (transition)
+    {
+      ++count;
+      const RouteEntryPtr predecessor =
+        std::move(transition->predecessor.entry);
+
+      // This will also remove the predecessor from the timeline
+      transition.reset();
+
+      transition = std::move(predecessor->transition);
+    }
+
+    return count;
+  }
+
+  /// A rough estimate of how much memory a route entry is using
+  static std::size_t estimate_bytes(const RouteEntry& entry)
+  {
+    std::size_t bytes = sizeof(RouteEntry) + sizeof(RouteStorage)
+      + sizeof(Timeline<RouteEntry>::Handle);
+
+    if (entry.transition)
+      bytes += sizeof(Transition);
+
+    if (entry.route)
+    {
+      bytes += sizeof(Route) + entry.route->trajectory().size()
+        * (sizeof(internal::WaypointElement)
+        + sizeof(internal::OrderMap::Element));
+    }
+
+    return bytes;
+  }
+
   ParticipantId get_next_participant_id()
   {
     // This will cycle through the set of currently active participant IDs until
@@ -362,6 +411,61 @@ public:
     // *INDENT-ON*
   }
 
+  ParticipantId next_participant_id() const
+  {
+    return _next_participant_id;
+  }
+
+  void restore(const Checkpoint& checkpoint)
+  {
+    schedule_version = checkpoint.version;
+    oldest_version = checkpoint.version;
+    _next_participant_id = checkpoint.next_participant_id;
+
+    for (const auto& p : checkpoint.participants)
+    {
+      participant_ids.insert(p.id);
+
+      auto tracker = Inconsistencies::Implementation::register_participant(
+        inconsistencies, p.id);
+      tracker->restore(p.expected_itinerary_version);
+
+      auto& state = states.insert(
+        std::make_pair(
+          p.id,
+          ParticipantState{
+            {},
+            std::move(tracker),
+            {},
+            p.description,
+            p.registration_version
+          })).first->second;
+
+      descriptions.insert({p.id, p.description});
+      add_participant_version[p.registration_version] = p.id;
+
+      // The restored routes have no transitions, because the history of
+      // changes before the checkpoint is not kept.
+      for (const auto& r : p.routes)
+      {
+        RouteStorage& entry_storage = state.storage[r.id];
+        entry_storage.entry = std::make_shared<RouteEntry>(
+          RouteEntry{
+            r.route,
+            p.id,
+            r.id,
+            p.description,
+            r.version,
+            nullptr,
+            RouteEntryPtr()
+          });
+
+        entry_storage.timeline_handle = timeline.insert(entry_storage.entry);
+        state.active_routes.insert(r.id);
+      }
+    }
+  }
+
 private:
   ParticipantId _next_participant_id = 0;
 };
@@ -450,6 +554,9 @@ void Database::set(
 
   // Insert the new routes into the current itinerary
   _pimpl->insert_items(participant, state, entries, input);
+
+  if (_pimpl->journal)
+    _pimpl->journal->set(participant, input, version);
 }
 
 //==============================================================================
@@ -496,6 +603,9 @@ void Database::extend(
   ++_pimpl->schedule_version;
 
   _pimpl->insert_items(participant, state, entries, input);
+
+  if (_pimpl->journal)
+    _pimpl->journal->extend(participant, input, version);
 }
 
 //==============================================================================
@@ -533,6 +643,9 @@ void Database::delay(
   //======== All validation is complete ===========
   ++_pimpl->schedule_version;
   _pimpl->apply_delay(participant, state, delay);
+
+  if (_pimpl->journal)
+    _pimpl->journal->delay(participant, delay, version);
 }
 
 //==============================================================================
@@ -570,6 +683,9 @@ void Database::erase(
   ++_pimpl->schedule_version;
   _pimpl->erase_routes(participant, state, state.active_routes);
   state.active_routes.clear();
+
+  if (_pimpl->journal)
+    _pimpl->journal->erase(participant, version);
 }
 
 //==============================================================================
@@ -625,6 +741,9 @@ void Database::erase(
   _pimpl->erase_routes(participant, state, route_set);
   for (const RouteId id : routes)
     state.active_routes.erase(id);
+
+  if (_pimpl->journal)
+    _pimpl->journal->erase(participant, routes, version);
 }
 
 //==============================================================================
@@ -654,6 +773,10 @@ ParticipantId Database::register_participant(
   _pimpl->descriptions.insert({id, description_ptr});
 
   _pimpl->add_participant_version[version] = id;
+
+  if (_pimpl->journal)
+    _pimpl->journal->register_participant(id, *description_ptr);
+
   return id;
 }
 
@@ -698,6 +821,9 @@ void Database::unregister_participant(
   const Version version = ++_pimpl->schedule_version;
   _pimpl->remove_participant_version[version] = {participant, initial_version};
   _pimpl->remove_participant_time[_pimpl->current_time] = version;
+
+  if (_pimpl->journal)
+    _pimpl->journal->unregister_participant(participant, _pimpl->current_time);
 }
 
 //==============================================================================
@@ -1180,6 +1306,17 @@ Version Database::cull(Time time)
   _pimpl->timeline.inspect(
     spacetime, Query::Participants::make_all(), inspector);
 
+  const auto p_cull_begin = _pimpl->remove_participant_time.begin();
+  const auto p_cull_end = _pimpl->remove_participant_time.upper_bound(time);
+
+  if (inspector.routes.empty() && p_cull_begin == p_cull_end)
+  {
+    // Nothing finished before the cull time, so the schedule keeps its current
+    // version and nobody needs to hear about this cull.
+    _pimpl->timeline.cull(time);
+    return _pimpl->schedule_version;
+  }
+
   // TODO(MXG) This iterating could probably be made more efficient by grouping
   // together the culls of each participant.
   for (const auto& route : inspector.routes)
@@ -1197,8 +1334,6 @@ Version Database::cull(Time time)
   _pimpl->timeline.cull(time);
 
   // Erase all trace of participants that were removed before the culling time.
-  const auto p_cull_begin = _pimpl->remove_participant_time.begin();
-  const auto p_cull_end = _pimpl->remove_participant_time.upper_bound(time);
   for (auto p_cull_it = p_cull_begin; p_cull_it != p_cull_end; ++p_cull_it)
   {
     const auto remove_it =
@@ -1220,6 +1355,9 @@ Version Database::cull(Time time)
     _pimpl->schedule_version
   };
 
+  if (_pimpl->journal)
+    _pimpl->journal->cull(time);
+
   return _pimpl->schedule_version;
 }
 
@@ -1245,5 +1383,181 @@ ItineraryVersion Database::itinerary_version(ParticipantId participant) const
   return p_it->second.tracker->last_known_version();
 }
 
+//==============================================================================
+std::size_t Database::compact(Version before)
+{
+  Implementation& impl = *_pimpl;
+  if (rmf_utils::modular(impl.schedule_version).less_than(before))
+    before = impl.schedule_version;
+
+  if (!rmf_utils::modular(impl.oldest_version).less_than(before))
+    return 0;
+
+  // Any mirror that can still get a Patch after this compaction will have
+  // seen every change up to the version called "before", so no route entry
+  // that was replaced before then will ever be needed again.
+  std::size_t discarded = 0;
+  for (auto& p : impl.states)
+  {
+    auto& storage = p.second.storage;
+    for (auto r_it = storage.begin(); r_it != storage.end(); )
+    {
+      Implementation::RouteEntry* entry = r_it->second.entry.get();
+      if (!entry)
+      {
+        // This is left over from an input that was rejected for having a
+        // colliding route ID.
+        r_it = storage.erase(r_it);
+        continue;
+      }
+
+      if (!entry->route
+        && rmf_utils::modular(entry->schedule_version)
+        .less_than_or_equal(before))
+      {
+        // This route was erased before the horizon, so every mirror that can
+        // still get a Patch already knows that it is gone.
+        discarded += 1 + Implementation::discard_history(
+          std::move(entry->transition));
+        r_it = storage.erase(r_it);
+        continue;
+      }
+
+      while (entry->transition
+        && rmf_utils::modular(before).less_than(entry->schedule_version))
+      {
+        entry = entry->transition->predecessor.entry.get();
+      }
+
+      discarded += Implementation::discard_history(
+        std::move(entry->transition));
+      ++r_it;
+    }
+  }
+
+  // Mirrors that are newer than the horizon have already been told about
+  // these participants being unregistered.
+  impl.remove_participant_version.erase(
+    impl.remove_participant_version.begin(),
+    impl.remove_participant_version.upper_bound(before));
+
+  for (auto t_it = impl.remove_participant_time.begin();
+    t_it != impl.remove_participant_time.end(); )
+  {
+    if (t_it->second <= before)
+      t_it = impl.remove_participant_time.erase(t_it);
+    else
+      ++t_it;
+  }
+
+  impl.oldest_version = before;
+  return discarded;
+}
+
+//==============================================================================
+std::vector<ParticipantId> Database::drop_staged_changes(
+  const std::size_t max_staged_changes)
+{
+  std::vector<ParticipantId> participants;
+  for (auto& p : _pimpl->states)
+  {
+    InconsistencyTracker& tracker = *p.second.tracker;
+    if (tracker.staged_changes() <= max_staged_changes)
+      continue;
+
+    if (tracker.drop_staged_changes() > 0)
+      participants.push_back(p.first);
+  }
+
+  return participants;
+}
+
+//==============================================================================
+auto Database::footprint() const -> std::vector<Footprint>
+{
+  std::vector<Footprint> footprints;
+  footprints.reserve(_pimpl->states.size());
+  for (const auto& p : _pimpl->states)
+  {
+    const Implementation::ParticipantState& state = p.second;
+    Footprint usage{
+      p.first,
+      state.active_routes.size(),
+      0,
+      state.tracker->staged_changes(),
+      0
+    };
+
+    for (const auto& r : state.storage)
+    {
+      const Implementation::RouteEntry* entry = r.second.entry.get();
+      while (entry)
+      {
+        ++usage.route_entries;
+        usage.bytes += Implementation::estimate_bytes(*entry);
+        entry = entry->transition ?
+          entry->transition->predecessor.entry.get() : nullptr;
+      }
+    }
+
+    footprints.push_back(usage);
+  }
+
+  return footprints;
+}
+
+//==============================================================================
+auto Database::checkpoint() const -> Checkpoint
+{
+  Checkpoint checkpoint;
+  checkpoint.version = _pimpl->schedule_version;
+  checkpoint.next_participant_id = _pimpl->next_participant_id();
+  checkpoint.participants.reserve(_pimpl->states.size());
+
+  for (const auto& p : _pimpl->states)
+  {
+    const Implementation::ParticipantState& state = p.second;
+
+    Checkpoint::Participant participant{
+      p.first,
+      state.description,
+      state.tracker->expected_version(),
+      state.initial_schedule_version,
+      {}
+    };
+
+    participant.routes.reserve(state.active_routes.size());
+    for (const RouteId route : state.active_routes)
+    {
+      const auto& entry = state.storage.at(route).entry;
+      participant.routes.push_back(
+        {route, entry->route, entry->schedule_version});
+    }
+
+    checkpoint.participants.emplace_back(std::move(participant));
+  }
+
+  return checkpoint;
+}
+
+//==============================================================================
+Database::Database(const Checkpoint& checkpoint)
+: _pimpl(rmf_utils::make_unique_impl<Implementation>())
+{
+  _pimpl->restore(checkpoint);
+}
+
+//==============================================================================
+Version Database::oldest_version() const
+{
+  return _pimpl->oldest_version;
+}
+
+//==============================================================================
+void Database::set_journal(std::shared_ptr<Journal> journal)
+{
+  _pimpl->journal = std::move(journal);
+}
+
 } // namespace schedule
 } // namespace rmf_traffic
@@ -67,6 +67,40 @@ InconsistencyTracker::Ticket::~Ticket()
   }
 }
 
+//==============================================================================
+void InconsistencyTracker::restore(const ItineraryVersion expected_version)
+{
+  _ranges.clear();
+  _changes.clear();
+  _ready = false;
+  _expected_version = expected_version;
+  if (expected_version != 0)
+    _last_known_version = expected_version - 1;
+}
+
+//==============================================================================
+std::size_t InconsistencyTracker::drop_staged_changes()
+{
+  using Range = Inconsistencies::Ranges::Range;
+
+  if (_changes.size() < 2)
+    return 0;
+
+  // Every staged change comes at or after the expected version, so once we
+  // forget about them, everything from the expected version up to the newest
+  // change is missing. We keep the newest change so that the highest version
+  // we have received is still on record.
+  const std::size_t dropped = _changes.size() - 1;
+  const ItineraryVersion newest = _changes.rbegin()->first;
+  _changes.erase(_changes.begin(), --_changes.end());
+
+  _ranges.clear();
+  _ranges.insert(Range{_expected_version, newest - 1});
+  _ready = false;
+
+  return dropped;
+}
+
 //==============================================================================
 auto InconsistencyTracker::check(
   const ItineraryVersion version,
@@ -125,6 +125,25 @@ public:
     return _last_known_version;
   }
 
+  /// Reset the tracker so that it expects the given version next, as if every
+  /// version before it has been received. This is used when a Database gets
+  /// restored from a checkpoint.
+  void restore(ItineraryVersion expected_version);
+
+  /// The number of changes that are waiting for an inconsistency to be fixed
+  std::size_t staged_changes() const
+  {
+    return _changes.size();
+  }
+
+  /// Drop every change that is waiting for an inconsistency to be fixed,
+  /// except for the newest one. The versions of the dropped changes will be
+  /// reported as inconsistencies again, so the participant will need to
+  /// retransmit them.
+  ///
+  /// \return the number of changes that were dropped
+  std::size_t drop_staged_changes();
+
 private:
 
   void _apply_changes();
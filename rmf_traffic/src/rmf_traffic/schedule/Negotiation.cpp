@@ -148,6 +148,7 @@ public:
   bool rejected;
   bool forfeited;
   rmf_utils::optional<Itinerary> itinerary;
+  std::weak_ptr<const void> negotiation_key;
 
   Viewer::View query(
     const Query::Spacetime& spacetime,
@@ -1070,6 +1071,18 @@ const Itinerary* Negotiation::Table::Viewer::submission() const
   return nullptr;
 }
 
+//==============================================================================
+Version Negotiation::Table::Viewer::schedule_version() const
+{
+  return _pimpl->schedule_viewer->latest_version();
+}
+
+//==============================================================================
+std::weak_ptr<const void> Negotiation::Table::Viewer::negotiation_key() const
+{
+  return _pimpl->negotiation_key;
+}
+
 //==============================================================================
 Negotiation::Table::Viewer::Viewer()
 {
@@ -1099,7 +1112,8 @@ auto Negotiation::Table::viewer() const -> ViewerPtr
       _pimpl->defunct.get(),
       _pimpl->rejected,
       _pimpl->forfeited,
-      _pimpl->itinerary));
+      _pimpl->itinerary,
+      _pimpl->weak_negotiation_data));
 
   return _pimpl->cached_table_viewer;
 }
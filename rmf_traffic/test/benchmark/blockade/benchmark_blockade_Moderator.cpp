@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_utils/catch.hpp>
+
+#include <rmf_traffic/blockade/Moderator.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+
+namespace {
+//==============================================================================
+/// Make L-shaped paths through a grid of lanes, like the aisles of a
+/// warehouse. Every path starts from a different intersection.
+std::vector<rmf_traffic::blockade::Writer::Checkpoint> make_warehouse_path(
+  std::mt19937& rng,
+  std::set<std::pair<int, int>>& used_starts,
+  const int grid_size,
+  const std::size_t num_checkpoints,
+  const double spacing)
+{
+  std::uniform_int_distribution<int> cell(0, grid_size-1);
+  std::pair<int, int> start;
+  do
+  {
+    start = {cell(rng), cell(rng)};
+  } while (!used_starts.insert(start).second);
+
+  const int dx = rng() % 2 == 0 ? 1 : -1;
+  const int dy = rng() % 2 == 0 ? 1 : -1;
+  const std::size_t horizontal = rng() % num_checkpoints;
+
+  std::vector<rmf_traffic::blockade::Writer::Checkpoint> path;
+  int x = start.first;
+  int y = start.second;
+  for (std::size_t i = 0; i < num_checkpoints; ++i)
+  {
+    path.push_back({Eigen::Vector2d(x*spacing, y*spacing), "warehouse", true});
+    if (i < horizontal)
+      x += dx;
+    else
+      y += dy;
+  }
+
+  return path;
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Benchmark the blockade moderator", "[.benchmark]")
+{
+  using namespace rmf_traffic::blockade;
+  using Clock = std::chrono::steady_clock;
+
+  const auto ms = [](const Clock::duration d)
+    {
+      return std::chrono::duration_cast<
+        std::chrono::duration<double, std::milli>>(d).count();
+    };
+
+  std::cout << std::setw(14) << "participants"
+            << std::setw(13) << "checkpoints"
+            << std::setw(12) << "set [ms]"
+            << std::setw(14) << "per set [ms]"
+            << std::setw(12) << "run [ms]"
+            << std::setw(10) << "calls"
+            << std::setw(10) << "arrived" << std::endl;
+
+  for (const std::size_t N : {10, 40, 120})
+  {
+    for (const std::size_t K : {10, 30})
+    {
+      std::mt19937 rng(N*1000 + K);
+      std::set<std::pair<int, int>> used_starts;
+
+      std::vector<Writer::Reservation> reservations;
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        reservations.push_back(
+          {make_warehouse_path(rng, used_starts, 40, K, 3.0), 0.4});
+      }
+
+      Moderator moderator;
+
+      const auto set_start = Clock::now();
+      for (std::size_t i = 0; i < N; ++i)
+        moderator.set(i, 0, reservations[i]);
+      const auto set_time = Clock::now() - set_start;
+
+      // Drive every participant forward as far as the moderator allows
+      std::vector<std::size_t> reached(N, 0);
+      std::size_t calls = 0;
+      std::size_t arrived = 0;
+      const auto run_start = Clock::now();
+      for (std::size_t round = 0; round < 4*K && arrived < N; ++round)
+      {
+        arrived = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+          const std::size_t goal = reservations[i].path.size() - 1;
+          if (reached[i] >= goal)
+          {
+            ++arrived;
+            continue;
+          }
+
+          const auto& range = moderator.assignments().ranges().at(i);
+          if (reached[i] + 1 <= range.end)
+            moderator.reached(i, 0, ++reached[i]);
+          else
+            moderator.ready(i, 0, reached[i]);
+
+          ++calls;
+        }
+      }
+      const auto run_time = Clock::now() - run_start;
+
+      std::cout << std::setw(14) << N
+                << std::setw(13) << K
+                << std::setw(12) << ms(set_time)
+                << std::setw(14) << ms(set_time)/N
+                << std::setw(12) << ms(run_time)
+                << std::setw(10) << calls
+                << std::setw(10) << arrived << std::endl;
+
+      CHECK(arrived > 0);
+    }
+  }
+}
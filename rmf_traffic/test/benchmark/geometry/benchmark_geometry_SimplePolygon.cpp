@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_utils/catch.hpp>
+
+#include <src/rmf_traffic/DetectConflictInternal.hpp>
+#include <src/rmf_traffic/geometry/Box.hpp>
+#include <src/rmf_traffic/geometry/SimplePolygon.hpp>
+
+#include <rmf_traffic/geometry/Circle.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+//==============================================================================
+/// Make a comb-shaped polygon, like a row of shelves that are joined along
+/// their back. Every tooth of the comb makes the polygon more concave.
+std::vector<Eigen::Vector2d> make_comb(const std::size_t teeth)
+{
+  const double width = 1.0;
+  const double gap = 2.0;
+  const double depth = 6.0;
+
+  std::vector<Eigen::Vector2d> points;
+  points.push_back({0.0, 0.0});
+  for (std::size_t i = 0; i < teeth; ++i)
+  {
+    const double x = i*(width + gap);
+    if (i > 0)
+      points.push_back({x, -1.0});
+
+    points.push_back({x, -depth});
+    points.push_back({x + width, -depth});
+    if (i+1 < teeth)
+      points.push_back({x + width, -1.0});
+  }
+  points.push_back({(teeth-1)*(width + gap) + width, 0.0});
+
+  return points;
+}
+
+//==============================================================================
+/// A trajectory that zig-zags through the gaps between the teeth of the comb
+/// without touching any of them.
+rmf_traffic::Trajectory make_zig_zag(
+  const rmf_traffic::Time start,
+  const std::size_t teeth)
+{
+  using namespace std::chrono_literals;
+  rmf_traffic::Trajectory trajectory;
+  rmf_traffic::Time t = start;
+  for (std::size_t i = 0; i+1 < teeth; ++i)
+  {
+    const double x = i*3.0 + 2.0;
+    trajectory.insert(t, {x, -8.0, 0.0}, Eigen::Vector3d::Zero());
+    t += 10s;
+    trajectory.insert(t, {x, -2.5, 0.0}, Eigen::Vector3d::Zero());
+    t += 10s;
+    trajectory.insert(t, {x, -8.0, 0.0}, Eigen::Vector3d::Zero());
+    t += 10s;
+  }
+
+  return trajectory;
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Benchmark conflict checks against polygons", "[.benchmark]")
+{
+  using namespace rmf_traffic::geometry;
+  using Clock = std::chrono::steady_clock;
+
+  const auto us = [](const Clock::duration d)
+    {
+      return std::chrono::duration_cast<
+        std::chrono::duration<double, std::micro>>(d).count();
+    };
+
+  const std::size_t Repetitions = 200;
+
+  // Only convex shapes can be used for a participant footprint, so a Box
+  // stands in for a polygon footprint, such as a forklift.
+  const std::vector<std::pair<std::string, ConstFinalConvexShapePtr>>
+  footprints = {
+    {"circle", make_final_convex<Circle>(0.4)},
+    {"box", make_final_convex<Box>(1.2, 0.8)}
+  };
+
+  std::cout << std::setw(10) << "footprint"
+            << std::setw(8) << "teeth"
+            << std::setw(10) << "vertices"
+            << std::setw(8) << "pieces"
+            << std::setw(16) << "finalize [us]"
+            << std::setw(18) << "refinalize [us]"
+            << std::setw(13) << "check [us]" << std::endl;
+
+  for (const auto& footprint : footprints)
+  {
+    const rmf_traffic::Profile profile{footprint.second};
+    for (const std::size_t teeth : {2, 5, 10, 20})
+    {
+      const SimplePolygon polygon(make_comb(teeth));
+
+      const auto finalize_start = Clock::now();
+      const auto shape = std::make_shared<FinalShape>(polygon.finalize());
+      const auto finalize_time = Clock::now() - finalize_start;
+
+      // Finalizing the same polygon again should reuse its decomposition
+      const auto refinalize_start = Clock::now();
+      for (std::size_t i = 0; i < Repetitions; ++i)
+        polygon.finalize();
+      const auto refinalize_time = Clock::now() - refinalize_start;
+
+      const std::size_t pieces =
+        FinalShape::Implementation::get_collisions(*shape).size();
+
+      const auto trajectory = make_zig_zag(Clock::now(), teeth);
+      const rmf_traffic::internal::Spacetime region{
+        nullptr, nullptr, Eigen::Isometry2d::Identity(), shape
+      };
+
+      bool any_conflict = false;
+      const auto check_start = Clock::now();
+      for (std::size_t i = 0; i < Repetitions; ++i)
+      {
+        any_conflict |= rmf_traffic::internal::detect_conflicts(
+          profile, trajectory, region);
+      }
+      const auto check_time = Clock::now() - check_start;
+
+      std::cout << std::setw(10) << footprint.first
+                << std::setw(8) << teeth
+                << std::setw(10) << polygon.get_num_points()
+                << std::setw(8) << pieces
+                << std::setw(16) << us(finalize_time)
+                << std::setw(18) << us(refinalize_time)/Repetitions
+                << std::setw(13) << us(check_time)/Repetitions << std::endl;
+
+      CHECK_FALSE(any_conflict);
+    }
+  }
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "test/unit/schedule/utils_Database.hpp"
+
+#include <rmf_traffic/schedule/Database.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+//==============================================================================
+rmf_traffic::schedule::Writer::Input make_itinerary(
+  const rmf_traffic::Time start,
+  const std::size_t participant,
+  const std::size_t routes,
+  const std::size_t waypoints,
+  rmf_traffic::RouteId& next_route_id)
+{
+  using namespace std::chrono_literals;
+
+  rmf_traffic::schedule::Writer::Input itinerary;
+  for (std::size_t r = 0; r < routes; ++r)
+  {
+    rmf_traffic::Trajectory trajectory;
+    for (std::size_t w = 0; w < waypoints; ++w)
+    {
+      trajectory.insert(
+        start + (r*waypoints + w)*10s,
+        Eigen::Vector3d(static_cast<double>(w), participant, 0.0),
+        Eigen::Vector3d::Zero());
+    }
+
+    itinerary.push_back(
+      {
+        next_route_id++,
+        std::make_shared<rmf_traffic::Route>("L1", std::move(trajectory))
+      });
+  }
+
+  return itinerary;
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Benchmark restoring the schedule database", "[.benchmark]")
+{
+  using namespace rmf_traffic::schedule;
+  using namespace std::chrono_literals;
+  using Clock = std::chrono::steady_clock;
+
+  const auto ms = [](const Clock::duration d)
+    {
+      return std::chrono::duration_cast<
+        std::chrono::duration<double, std::milli>>(d).count();
+    };
+
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(0.5)
+  };
+
+  std::cout << std::setw(14) << "participants"
+            << std::setw(8) << "routes"
+            << std::setw(10) << "journal"
+            << std::setw(18) << "checkpoint [ms]"
+            << std::setw(15) << "restore [ms]"
+            << std::setw(14) << "replay [ms]"
+            << std::setw(15) << "rebuild [ms]" << std::endl;
+
+  for (const std::size_t N : {10, 100, 1000})
+  {
+    for (const std::size_t R : {1, 10})
+    {
+      const std::size_t waypoints = 20;
+      const std::size_t J = 10*N;
+      const auto start = Clock::now();
+
+      Database db;
+      std::vector<ParticipantId> participants;
+      std::vector<rmf_traffic::RouteId> next_route_ids(N, 0);
+      std::vector<ItineraryVersion> versions(N, 0);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        participants.push_back(db.register_participant(
+            ParticipantDescription{
+              "participant_" + std::to_string(i),
+              "benchmark",
+              ParticipantDescription::Rx::Responsive,
+              profile
+            }));
+
+        db.set(
+          participants.back(),
+          make_itinerary(start, i, R, waypoints, next_route_ids[i]),
+          versions[i]++);
+      }
+
+      const auto checkpoint_start = Clock::now();
+      const auto checkpoint = db.checkpoint();
+      const auto checkpoint_time = Clock::now() - checkpoint_start;
+
+      // Keep changing the schedule after the checkpoint, the way fleets would
+      auto journal = std::make_shared<ReplayJournal>();
+      db.set_journal(journal);
+      for (std::size_t j = 0; j < J; ++j)
+      {
+        const std::size_t i = j % N;
+        if (j % 4 == 0)
+        {
+          db.set(
+            participants[i],
+            make_itinerary(start, i, R, waypoints, next_route_ids[i]),
+            versions[i]++);
+        }
+        else
+        {
+          db.delay(participants[i], 1s, versions[i]++);
+        }
+      }
+
+      const auto restore_start = Clock::now();
+      Database restored(checkpoint);
+      const auto restore_time = Clock::now() - restore_start;
+
+      const auto replay_start = Clock::now();
+      journal->replay(restored);
+      const auto replay_time = Clock::now() - replay_start;
+      CHECK(restored.latest_version() == db.latest_version());
+
+      // For comparison, this is roughly what happens today when every
+      // participant has to register again and resend its itinerary.
+      const auto rebuild_start = Clock::now();
+      Database rebuilt;
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        const auto id = rebuilt.register_participant(
+          *db.get_participant(participants[i]));
+
+        rmf_traffic::RouteId route_id = 0;
+        rebuilt.set(id, make_itinerary(start, i, R, waypoints, route_id), 0);
+      }
+      const auto rebuild_time = Clock::now() - rebuild_start;
+
+      std::cout << std::setw(14) << N
+                << std::setw(8) << R
+                << std::setw(10) << J
+                << std::setw(18) << ms(checkpoint_time)
+                << std::setw(15) << ms(restore_time)
+                << std::setw(14) << ms(replay_time)
+                << std::setw(15) << ms(rebuild_time) << std::endl;
+    }
+  }
+}
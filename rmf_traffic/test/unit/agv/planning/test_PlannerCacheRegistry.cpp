@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <src/rmf_traffic/agv/planning/PlannerCacheRegistry.hpp>
+
+#include <rmf_traffic/agv/Planner.hpp>
+
+#include "../../utils_Trajectory.hpp"
+
+#include <rmf_utils/catch.hpp>
+
+namespace {
+//==============================================================================
+class CustomConstraint : public rmf_traffic::agv::Graph::OrientationConstraint
+{
+public:
+
+  bool apply(Eigen::Vector3d&, const Eigen::Vector2d&) const final
+  {
+    return true;
+  }
+
+  rmf_utils::clone_ptr<OrientationConstraint> clone() const final
+  {
+    return rmf_utils::make_clone<CustomConstraint>(*this);
+  }
+};
+
+//==============================================================================
+rmf_traffic::agv::Graph make_graph(const double offset = 0.0)
+{
+  using Lane = rmf_traffic::agv::Graph::Lane;
+  rmf_traffic::agv::Graph graph;
+  const std::string test_map = "test_map";
+  graph.add_waypoint(test_map, {0, 0}); // 0
+  graph.add_waypoint(test_map, {5 + offset, 0}); // 1
+  graph.add_waypoint(test_map, {5, 5}).set_holding_point(true); // 2
+  graph.add_key("charger", 2);
+
+  graph.add_lane(0, 1);
+  graph.add_lane(1, 0);
+  graph.add_lane({1, Lane::Event::make(Lane::Wait(std::chrono::seconds(5)))},
+    2);
+  graph.add_lane(2, 1);
+
+  return graph;
+}
+
+//==============================================================================
+const rmf_traffic::agv::VehicleTraits traits(
+  {1.0, 0.7}, {0.6, 0.5}, create_test_profile(UnitCircle));
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Planners with identical configurations share their caches")
+{
+  using rmf_traffic::agv::Graph;
+  using rmf_traffic::agv::Interpolate;
+  using rmf_traffic::agv::planning::PlannerCacheRegistry;
+
+  auto& registry = PlannerCacheRegistry::get();
+  const auto initial_size = registry.size();
+
+  const Interpolate::Options options;
+  const auto& interp = Interpolate::Options::Implementation::get(options);
+
+  const auto graph_a = make_graph();
+  const auto graph_b = make_graph();
+
+  const auto entry_a = registry.acquire(
+    Graph::Implementation::get(graph_a), traits, interp);
+  const auto entry_b = registry.acquire(
+    Graph::Implementation::get(graph_b), traits, interp);
+
+  CHECK(entry_a == entry_b);
+  CHECK(registry.size() == initial_size + 1);
+
+  WHEN("A waypoint is moved")
+  {
+    const auto graph_c = make_graph(1e-9);
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_c), traits, interp);
+    CHECK(entry_c != entry_a);
+  }
+
+  WHEN("The lane events are different")
+  {
+    auto graph_c = make_graph();
+    graph_c.get_lane(0).entry().event(
+      Graph::Lane::Event::make(Graph::Lane::Wait(std::chrono::seconds(1))));
+
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_c), traits, interp);
+    CHECK(entry_c != entry_a);
+  }
+
+  WHEN("The vehicle traits are different")
+  {
+    auto other_traits = traits;
+    other_traits.linear().set_nominal_velocity(1.5);
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_a), other_traits, interp);
+    CHECK(entry_c != entry_a);
+  }
+
+  WHEN("Only the vehicle profile is different")
+  {
+    auto other_traits = traits;
+    other_traits.profile() = create_test_profile(UnitBox);
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_a), other_traits, interp);
+    CHECK(entry_c == entry_a);
+  }
+
+  WHEN("The interpolation options are different")
+  {
+    const auto other_options = Interpolate::Options().set_always_stop(true);
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_a), traits,
+      Interpolate::Options::Implementation::get(other_options));
+    CHECK(entry_c != entry_a);
+  }
+
+  WHEN("The graph has a custom orientation constraint")
+  {
+    auto graph_c = make_graph();
+    const rmf_utils::clone_ptr<Graph::OrientationConstraint> custom =
+      rmf_utils::make_clone<CustomConstraint>();
+    graph_c.add_lane(0, {2, custom});
+    CHECK_FALSE(PlannerCacheRegistry::make_key(
+        Graph::Implementation::get(graph_c), traits, interp).has_value());
+
+    const auto entry_c = registry.acquire(
+      Graph::Implementation::get(graph_c), traits, interp);
+    const auto entry_d = registry.acquire(
+      Graph::Implementation::get(graph_c), traits, interp);
+    CHECK(entry_c != entry_d);
+  }
+}
+
+//==============================================================================
+SCENARIO("Registry entries are released with their last planner")
+{
+  using rmf_traffic::agv::planning::PlannerCacheRegistry;
+
+  auto& registry = PlannerCacheRegistry::get();
+  const auto initial_size = registry.size();
+
+  const auto graph = make_graph(0.5);
+  rmf_traffic::agv::Planner::Configuration config(graph, traits);
+
+  {
+    const rmf_traffic::agv::Planner planner_a(
+      config, rmf_traffic::agv::Planner::Options(nullptr));
+    const rmf_traffic::agv::Planner planner_b(
+      config, rmf_traffic::agv::Planner::Options(nullptr));
+    CHECK(registry.size() == initial_size + 1);
+  }
+
+  CHECK(registry.size() == initial_size);
+}
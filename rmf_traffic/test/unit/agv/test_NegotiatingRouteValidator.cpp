@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_traffic/agv/RouteValidator.hpp>
+#include <rmf_traffic/geometry/Circle.hpp>
+#include <rmf_traffic/schedule/Database.hpp>
+#include <rmf_traffic/schedule/Negotiation.hpp>
+#include <rmf_traffic/DetectConflict.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <random>
+
+using namespace std::chrono_literals;
+
+namespace {
+//==============================================================================
+rmf_traffic::Route make_route(
+  const std::string& map,
+  const rmf_traffic::Time start,
+  const Eigen::Vector3d& p0,
+  const Eigen::Vector3d& p1)
+{
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(start, p0, Eigen::Vector3d::Zero());
+  trajectory.insert(start + 10s, p1, Eigen::Vector3d::Zero());
+  return rmf_traffic::Route{map, std::move(trajectory)};
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("NegotiatingRouteValidator agrees with direct conflict checks")
+{
+  const auto database = std::make_shared<rmf_traffic::schedule::Database>();
+
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(0.5)
+  };
+
+  const auto make_participant = [&](const std::string& name)
+    {
+      return rmf_traffic::schedule::make_participant(
+        rmf_traffic::schedule::ParticipantDescription{
+          name,
+          "test_NegotiatingRouteValidator",
+          rmf_traffic::schedule::ParticipantDescription::Rx::Responsive,
+          profile
+        },
+        database);
+    };
+
+  auto p1 = make_participant("p1");
+  auto p2 = make_participant("p2");
+
+  const std::string map = "test_map";
+  const auto now = std::chrono::steady_clock::now();
+
+  // Fill the schedule with routes from participants that are not part of the
+  // negotiation. They will be frozen into the table.
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> coord(-20.0, 20.0);
+  std::uniform_int_distribution<int> delay(0, 60);
+  std::vector<rmf_traffic::schedule::Participant> others;
+  std::vector<rmf_traffic::Route> other_routes;
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    others.push_back(make_participant("other_" + std::to_string(i)));
+    const auto route = make_route(
+      map, now + std::chrono::seconds(delay(rng)),
+      {coord(rng), coord(rng), 0.0}, {coord(rng), coord(rng), 0.0});
+    others.back().set({route});
+    other_routes.push_back(route);
+  }
+
+  const auto negotiation = rmf_traffic::schedule::Negotiation::make(
+    database, {p1.id(), p2.id()});
+  REQUIRE(negotiation);
+
+  const auto table = negotiation->table(p2.id(), {});
+  const auto validator =
+    rmf_traffic::agv::NegotiatingRouteValidator::Generator(
+    table->viewer(), profile).begin();
+
+  std::size_t conflicts = 0;
+  for (std::size_t i = 0; i < 200; ++i)
+  {
+    const auto route = make_route(
+      map, now + std::chrono::seconds(delay(rng)),
+      {coord(rng), coord(rng), 0.0}, {coord(rng), coord(rng), 0.0});
+
+    bool expect_conflict = false;
+    for (const auto& other : other_routes)
+    {
+      if (rmf_traffic::DetectConflict::between(
+          profile, route.trajectory(), profile, other.trajectory()))
+      {
+        expect_conflict = true;
+        break;
+      }
+    }
+
+    const auto conflict = validator.find_conflict(route);
+    CHECK(conflict.has_value() == expect_conflict);
+    if (conflict)
+      ++conflicts;
+
+    // Routes on another map can never conflict with these
+    auto other_map_route = route;
+    other_map_route.map("other_map");
+    CHECK_FALSE(validator.find_conflict(other_map_route));
+  }
+
+  // Make sure the scenario actually exercised both outcomes
+  CHECK(conflicts > 0);
+  CHECK(conflicts < 200);
+}
@@ -20,6 +20,7 @@
 #include <rmf_traffic/DetectConflict.hpp>
 #include <rmf_traffic/agv/Planner.hpp>
 #include <rmf_traffic/agv/SimpleNegotiator.hpp>
+#include <rmf_traffic/agv/debug/debug_Negotiator.hpp>
 #include <rmf_traffic/geometry/Circle.hpp>
 #include <rmf_traffic/schedule/Database.hpp>
 #include <rmf_traffic/schedule/Negotiation.hpp>
@@ -46,6 +47,29 @@ void print_proposal(
   }
 }
 
+//==============================================================================
+struct RecordingResponder : rmf_traffic::schedule::Negotiator::Responder
+{
+  mutable rmf_utils::optional<std::vector<rmf_traffic::Route>> itinerary;
+
+  void submit(
+    std::vector<rmf_traffic::Route> itinerary_,
+    ApprovalCallback) const final
+  {
+    itinerary = std::move(itinerary_);
+  }
+
+  void reject(const Alternatives&) const final
+  {
+    // Do nothing
+  }
+
+  void forfeit(const std::vector<ParticipantId>&) const final
+  {
+    // Do nothing
+  }
+};
+
 //==============================================================================
 SCENARIO("Test Plan Negotiation Between Two Participants")
 {
@@ -310,6 +334,53 @@ SCENARIO("Test Plan Negotiation Between Two Participants")
 
       CHECK(negotiation->complete());
     }
+
+    GIVEN("Negotiator #1 is asked to respond to the same table again")
+    {
+      using Debug = rmf_traffic::agv::SimpleNegotiator::Debug;
+
+      const auto table = negotiation->table(p1.id(), {});
+      negotiator_1.respond(
+        table->viewer(),
+        rmf_traffic::schedule::SimpleResponder::make(table));
+
+      const auto* submission = table->viewer()->submission();
+      REQUIRE(submission);
+      CHECK(Debug::reused_responses(negotiator_1) == 0);
+
+      auto responder = std::make_shared<RecordingResponder>();
+      negotiator_1.respond(table->viewer(), responder);
+
+      CHECK(Debug::reused_responses(negotiator_1) == 1);
+      REQUIRE(responder->itinerary.has_value());
+      REQUIRE(responder->itinerary->size() == submission->size());
+      for (std::size_t i = 0; i < submission->size(); ++i)
+      {
+        const auto& expected = submission->at(i)->trajectory();
+        const auto& actual = responder->itinerary->at(i).trajectory();
+        REQUIRE(actual.size() == expected.size());
+        CHECK(actual.back().time() == expected.back().time());
+        CHECK((actual.back().position() - expected.back().position()).norm()
+          == Approx(0.0));
+      }
+
+      WHEN("The schedule changes")
+      {
+        const auto plan_3 = planner.plan(
+          rmf_traffic::agv::Plan::Start(start_time, 0, 90.0*M_PI/180.0),
+          rmf_traffic::agv::Plan::Goal(10));
+        REQUIRE(plan_3);
+        p3.set(plan_3->get_itinerary());
+
+        responder = std::make_shared<RecordingResponder>();
+        negotiator_1.respond(table->viewer(), responder);
+
+        // The participant outside of the negotiation might be in the way now,
+        // so the negotiator needs to plan again.
+        CHECK(Debug::reused_responses(negotiator_1) == 1);
+        CHECK(responder->itinerary.has_value());
+      }
+    }
   }
 
   WHEN("Participants Head-to-Head")
@@ -398,6 +469,123 @@ SCENARIO("Test Plan Negotiation Between Two Participants")
   }
 }
 
+//==============================================================================
+SCENARIO("Equivalent tables share one response")
+{
+  using namespace std::chrono_literals;
+  using Debug = rmf_traffic::agv::SimpleNegotiator::Debug;
+
+  auto database = std::make_shared<rmf_traffic::schedule::Database>();
+
+  rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(0.5)
+  };
+
+  const auto make_participant = [&](const std::string& name)
+    {
+      return rmf_traffic::schedule::make_participant(
+        rmf_traffic::schedule::ParticipantDescription{
+          name,
+          "test_Negotiator",
+          rmf_traffic::schedule::ParticipantDescription::Rx::Responsive,
+          profile
+        },
+        database);
+    };
+
+  auto p_a = make_participant("participant a");
+  auto p_b = make_participant("participant b");
+  auto p_c = make_participant("participant c");
+
+  // Three parallel lanes that are far enough apart that the participants
+  // never get in each other's way
+  const std::string test_map_name = "test_map";
+  rmf_traffic::agv::Graph graph;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    graph.add_waypoint(test_map_name, {0.0, 10.0*i});
+    graph.add_waypoint(test_map_name, {10.0, 10.0*i});
+    graph.add_lane(2*i, 2*i+1);
+    graph.add_lane(2*i+1, 2*i);
+  }
+
+  const rmf_traffic::agv::VehicleTraits traits{
+    {0.7, 0.3},
+    {1.0, 0.45},
+    profile
+  };
+
+  const rmf_traffic::agv::Planner::Configuration configuration{graph, traits};
+  const auto start_time = std::chrono::steady_clock::now();
+
+  const auto make_negotiator = [&](const std::size_t lane)
+    {
+      return rmf_traffic::agv::SimpleNegotiator{
+        rmf_traffic::agv::Plan::Start(start_time, 2*lane, 0.0),
+        rmf_traffic::agv::Plan::Goal(2*lane+1),
+        configuration,
+        rmf_traffic::agv::SimpleNegotiator::Options(
+          nullptr, nullptr, rmf_utils::nullopt, rmf_utils::nullopt, 1s)
+      };
+    };
+
+  auto negotiator_a = make_negotiator(0);
+  auto negotiator_b = make_negotiator(1);
+  auto negotiator_c = make_negotiator(2);
+
+  auto negotiation = std::make_shared<rmf_traffic::schedule::Negotiation>(
+    *rmf_traffic::schedule::Negotiation::make(
+      database, {p_a.id(), p_b.id(), p_c.id()}));
+
+  const auto respond = [&](
+    rmf_traffic::agv::SimpleNegotiator& negotiator,
+    const rmf_traffic::schedule::Negotiation::TablePtr& table)
+    {
+      REQUIRE(table);
+      negotiator.respond(
+        table->viewer(),
+        rmf_traffic::schedule::SimpleResponder::make(table));
+      REQUIRE(table->submission());
+    };
+
+  respond(negotiator_a, negotiation->table(p_a.id(), {}));
+  respond(negotiator_b, negotiation->table(p_b.id(), {p_a.id()}));
+  respond(negotiator_b, negotiation->table(p_b.id(), {}));
+  respond(negotiator_a, negotiation->table(p_a.id(), {p_b.id()}));
+
+  WHEN("Participant C responds to tables that were reached in different orders")
+  {
+    const auto table_ab = negotiation->table(p_c.id(), {p_a.id(), p_b.id()});
+    const auto table_ba = negotiation->table(p_c.id(), {p_b.id(), p_a.id()});
+    REQUIRE(table_ab);
+    REQUIRE(table_ba);
+    REQUIRE(table_ab != table_ba);
+
+    const auto reused_before = Debug::reused_responses(negotiator_c);
+    respond(negotiator_c, table_ab);
+    CHECK(Debug::reused_responses(negotiator_c) == reused_before);
+
+    respond(negotiator_c, table_ba);
+
+    THEN("Only one plan is made for both tables")
+    {
+      CHECK(Debug::reused_responses(negotiator_c) == reused_before + 1);
+
+      const auto& submission_ab = *table_ab->submission();
+      const auto& submission_ba = *table_ba->submission();
+      REQUIRE(submission_ab.size() == submission_ba.size());
+      for (std::size_t i = 0; i < submission_ab.size(); ++i)
+      {
+        const auto& t_ab = submission_ab[i]->trajectory();
+        const auto& t_ba = submission_ba[i]->trajectory();
+        REQUIRE(t_ab.size() == t_ba.size());
+        CHECK(t_ab.back().time() == t_ba.back().time());
+      }
+    }
+  }
+}
+
 //==============================================================================
 SCENARIO("Multi-participant negotiation")
 {
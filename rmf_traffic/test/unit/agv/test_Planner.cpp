@@ -56,6 +56,37 @@ make_test_schedule_validator(
     std::move(profile));
 }
 
+//==============================================================================
+/// Counts how many routes get checked by the validator that it wraps
+class CountingValidator : public rmf_traffic::agv::RouteValidator
+{
+public:
+
+  CountingValidator(
+    rmf_utils::clone_ptr<rmf_traffic::agv::RouteValidator> validator,
+    std::shared_ptr<std::size_t> count)
+  : _validator(std::move(validator)),
+    _count(std::move(count))
+  {
+    // Do nothing
+  }
+
+  rmf_utils::optional<Conflict> find_conflict(const Route& route) const final
+  {
+    ++(*_count);
+    return _validator->find_conflict(route);
+  }
+
+  std::unique_ptr<RouteValidator> clone() const final
+  {
+    return std::make_unique<CountingValidator>(*this);
+  }
+
+private:
+  rmf_utils::clone_ptr<rmf_traffic::agv::RouteValidator> _validator;
+  std::shared_ptr<std::size_t> _count;
+};
+
 void display_path(const rmf_traffic::agv::Plan::Result& plan)
 {
   std::vector<std::size_t> plan_indices;
@@ -546,6 +577,13 @@ SCENARIO("Test Options", "[options]")
     CHECK(set_max_cost_estimate_options.maximum_cost_estimate().value()
       == Approx(local_maximum_cost_estimate));
   }
+
+  WHEN("Toggle safe interval planning")
+  {
+    CHECK_FALSE(default_options.safe_interval_planning());
+    default_options.safe_interval_planning(true);
+    CHECK(default_options.safe_interval_planning());
+  }
 }
 
 SCENARIO("Maximum Cost Estimates", "[maximum_cost_estimate]")
@@ -3153,3 +3191,320 @@ SCENARIO("Close start", "[close_start]")
   CHECK(visited_wps.count(5));
   CHECK(visited_wps.count(4));
 }
+
+SCENARIO("Safe interval planning", "[safe_interval]")
+{
+  using namespace std::chrono_literals;
+  using Planner = rmf_traffic::agv::Planner;
+
+  const std::string test_map_name = "test_map";
+  rmf_traffic::agv::Graph graph;
+  graph.add_waypoint(test_map_name, { 0, 0}); // 0
+  graph.add_waypoint(test_map_name, { 5, 0}); // 1
+  graph.add_waypoint(test_map_name, {10, 0}).set_passthrough_point(true); // 2
+  graph.add_waypoint(test_map_name, {15, 0}); // 3
+  graph.add_waypoint(test_map_name, {10, -5}); // 4
+  graph.add_waypoint(test_map_name, {10, 5}); // 5
+
+  auto add_bidir_lane = [&](const std::size_t w0, const std::size_t w1)
+    {
+      graph.add_lane(w0, w1);
+      graph.add_lane(w1, w0);
+    };
+
+  add_bidir_lane(0, 1);
+  add_bidir_lane(1, 2);
+  add_bidir_lane(2, 3);
+  add_bidir_lane(4, 2);
+  add_bidir_lane(2, 5);
+
+  const rmf_traffic::Profile profile = create_test_profile(UnitCircle);
+  const rmf_traffic::agv::VehicleTraits traits(
+    {0.7, 0.3}, {1.0, 0.45}, profile);
+
+  rmf_traffic::schedule::Database database;
+  const auto p_obs = database.register_participant(
+    rmf_traffic::schedule::ParticipantDescription{
+      "obstacle",
+      "test_Planner",
+      rmf_traffic::schedule::ParticipantDescription::Rx::Unresponsive,
+      profile
+    });
+
+  // The obstacle crosses the corridor right when the robot would want to pass
+  // through waypoint 2, and then it lingers at waypoint 5 for a while.
+  const rmf_traffic::Time time = std::chrono::steady_clock::now();
+  rmf_traffic::Trajectory obstacle;
+  obstacle.insert(time, {10.0, -20.0, M_PI_2}, {0.0, 0.0, 0.0});
+  obstacle.insert(time + 25s, {10.0, 5.0, M_PI_2}, {0.0, 0.0, 0.0});
+  obstacle.insert(time + 40s, {10.0, 5.0, M_PI_2}, {0.0, 0.0, 0.0});
+  database.extend(
+    p_obs,
+    {{0, std::make_shared<rmf_traffic::Route>(test_map_name, obstacle)}},
+    0);
+
+  const Planner planner{
+    Planner::Configuration{graph, traits},
+    Planner::Options{make_test_schedule_validator(database, profile)}
+  };
+
+  const auto start = Planner::Start{time, 0, 0.0};
+  const auto goal = Planner::Goal{3};
+
+  const auto standard_result = planner.plan(start, goal);
+  REQUIRE(standard_result);
+
+  auto sipp_options = planner.get_default_options();
+  sipp_options.safe_interval_planning(true);
+  const auto sipp_result = planner.plan(start, goal, sipp_options);
+  REQUIRE(sipp_result);
+
+  for (const auto* result : {&standard_result, &sipp_result})
+  {
+    const auto& plan = **result;
+    REQUIRE(plan.get_itinerary().size() == 1);
+    const auto& t = plan.get_itinerary().front().trajectory();
+
+    const Eigen::Vector2d p_initial = t.front().position().block<2, 1>(0, 0);
+    CHECK((p_initial - Eigen::Vector2d(0, 0)).norm() == Approx(0.0));
+
+    const Eigen::Vector2d p_final = t.back().position().block<2, 1>(0, 0);
+    CHECK((p_final - Eigen::Vector2d(15, 0)).norm() == Approx(0.0));
+
+    CHECK_FALSE(rmf_traffic::DetectConflict::between(
+        profile, t, profile, obstacle));
+  }
+
+  // Both modes search over departures that are spaced apart by the minimum
+  // holding time, so they should arrive at about the same time.
+  const auto standard_arrival =
+    *standard_result->get_itinerary().front().trajectory().finish_time();
+  const auto sipp_arrival =
+    *sipp_result->get_itinerary().front().trajectory().finish_time();
+  const auto holding_time = planner.get_default_options().minimum_holding_time();
+  CHECK(sipp_arrival <= standard_arrival + holding_time);
+  CHECK(standard_arrival <= sipp_arrival + holding_time);
+
+  // Safe interval planning should not try the same departure again after it
+  // has already been found, so it needs to check fewer routes.
+  const auto standard_count = std::make_shared<std::size_t>(0);
+  auto standard_options = planner.get_default_options();
+  standard_options.validator(
+    rmf_utils::make_clone<CountingValidator>(
+      make_test_schedule_validator(database, profile), standard_count));
+  REQUIRE(planner.plan(start, goal, standard_options));
+
+  const auto sipp_count = std::make_shared<std::size_t>(0);
+  sipp_options.validator(
+    rmf_utils::make_clone<CountingValidator>(
+      make_test_schedule_validator(database, profile), sipp_count));
+  REQUIRE(planner.plan(start, goal, sipp_options));
+
+  CHECK(*sipp_count > 0);
+  CHECK(*sipp_count < *standard_count);
+}
+
+SCENARIO("Safe interval planning when a destination closes", "[safe_interval]")
+{
+  using namespace std::chrono_literals;
+  using Planner = rmf_traffic::agv::Planner;
+
+  const std::string test_map_name = "test_map";
+  rmf_traffic::agv::Graph graph;
+  graph.add_waypoint(test_map_name, { 0, 0}); // 0
+  graph.add_waypoint(test_map_name, { 5, 0}); // 1
+  graph.add_waypoint(test_map_name, {10, 0}); // 2
+
+  // The robot cannot come back to waypoint 0 once it has left
+  graph.add_lane(0, 1);
+  graph.add_lane(1, 2);
+  graph.add_lane(2, 1);
+
+  const rmf_traffic::Profile profile = create_test_profile(UnitCircle);
+  const rmf_traffic::agv::VehicleTraits traits(
+    {0.7, 0.3}, {1.0, 0.45}, profile);
+
+  rmf_traffic::schedule::Database database;
+  const auto register_obstacle = [&](const std::string& name)
+    {
+      return database.register_participant(
+        rmf_traffic::schedule::ParticipantDescription{
+          name,
+          "test_Planner",
+          rmf_traffic::schedule::ParticipantDescription::Rx::Unresponsive,
+          profile
+        });
+    };
+
+  // The goal is occupied for the first minute. Waypoint 1 is free when the
+  // robot first gets there, but another obstacle arrives there shortly after
+  // and stays until the goal is free again. A robot that rushes to waypoint 1
+  // would be trapped there, so it has to wait at waypoint 0 instead.
+  const rmf_traffic::Time time = std::chrono::steady_clock::now();
+  const auto p_goal = register_obstacle("goal obstacle");
+  rmf_traffic::Trajectory goal_obstacle;
+  goal_obstacle.insert(time, {10.0, 0.0, 0.0}, {0.0, 0.0, 0.0});
+  goal_obstacle.insert(time + 60s, {10.0, 0.0, 0.0}, {0.0, 0.0, 0.0});
+  database.extend(
+    p_goal,
+    {{0, std::make_shared<rmf_traffic::Route>(test_map_name, goal_obstacle)}},
+    0);
+
+  const auto p_middle = register_obstacle("middle obstacle");
+  rmf_traffic::Trajectory middle_obstacle;
+  middle_obstacle.insert(time, {5.0, -30.0, M_PI_2}, {0.0, 0.0, 0.0});
+  middle_obstacle.insert(time + 20s, {5.0, 0.0, M_PI_2}, {0.0, 0.0, 0.0});
+  middle_obstacle.insert(time + 60s, {5.0, 0.0, M_PI_2}, {0.0, 0.0, 0.0});
+  database.extend(
+    p_middle,
+    {{0, std::make_shared<rmf_traffic::Route>(test_map_name, middle_obstacle)}},
+    0);
+
+  const Planner planner{
+    Planner::Configuration{graph, traits},
+    Planner::Options{make_test_schedule_validator(database, profile)}
+  };
+
+  const auto start = Planner::Start{time, 0, 0.0};
+  const auto goal = Planner::Goal{2};
+
+  auto sipp_options = planner.get_default_options();
+  sipp_options.safe_interval_planning(true);
+
+  const auto standard_result = planner.plan(start, goal);
+  const auto sipp_result = planner.plan(start, goal, sipp_options);
+  REQUIRE(standard_result);
+  REQUIRE(sipp_result);
+
+  for (const auto* result : {&standard_result, &sipp_result})
+  {
+    const auto& plan = **result;
+    for (const auto& route : plan.get_itinerary())
+    {
+      const auto& t = route.trajectory();
+      CHECK_FALSE(rmf_traffic::DetectConflict::between(
+          profile, t, profile, goal_obstacle));
+      CHECK_FALSE(rmf_traffic::DetectConflict::between(
+          profile, t, profile, middle_obstacle));
+    }
+
+    const auto& t = plan.get_itinerary().back().trajectory();
+    const Eigen::Vector2d p_final = t.back().position().block<2, 1>(0, 0);
+    CHECK((p_final - Eigen::Vector2d(10, 0)).norm() == Approx(0.0));
+    CHECK(*t.finish_time() > time + 60s);
+  }
+}
+
+SCENARIO("Plan cache", "[plan_cache]")
+{
+  using namespace std::chrono_literals;
+  using Planner = rmf_traffic::agv::Planner;
+
+  const std::string test_map_name = "test_map";
+  rmf_traffic::agv::Graph graph;
+  graph.add_waypoint(test_map_name, { 0, 0}); // 0
+  graph.add_waypoint(test_map_name, { 5, 0}); // 1
+  graph.add_waypoint(test_map_name, {10, 0}); // 2
+  graph.add_waypoint(test_map_name, {10, 5}); // 3
+
+  auto add_bidir_lane = [&](const std::size_t w0, const std::size_t w1)
+    {
+      graph.add_lane(w0, w1);
+      graph.add_lane(w1, w0);
+    };
+
+  add_bidir_lane(0, 1);
+  add_bidir_lane(1, 2);
+  add_bidir_lane(2, 3);
+
+  const rmf_traffic::Profile profile = create_test_profile(UnitCircle);
+  const rmf_traffic::agv::VehicleTraits traits(
+    {0.7, 0.3}, {1.0, 0.45}, profile);
+
+  rmf_traffic::schedule::Database database;
+
+  Planner planner{
+    Planner::Configuration{graph, traits},
+    Planner::Options{make_test_schedule_validator(database, profile)}
+  };
+
+  CHECK(planner.get_plan_cache_capacity() == 0);
+  CHECK(planner.get_plan_cache_statistics().hit_rate() == 0.0);
+  planner.set_plan_cache_capacity(10);
+  CHECK(planner.get_plan_cache_capacity() == 10);
+
+  const rmf_traffic::Time time = std::chrono::steady_clock::now();
+  const auto goal = Planner::Goal{3};
+
+  const auto first = planner.plan(Planner::Start{time, 0, 0.0}, goal);
+  REQUIRE(first);
+  CHECK(planner.get_plan_cache_statistics().hits == 0);
+  CHECK(planner.get_plan_cache_statistics().misses == 1);
+
+  const auto& first_trajectory = first->get_itinerary().front().trajectory();
+
+  // The same request a minute later should be answered by the cache
+  const auto later = time + 1min;
+  const auto second = planner.plan(Planner::Start{later, 0, 0.0}, goal);
+  REQUIRE(second);
+  CHECK(planner.get_plan_cache_statistics().hits == 1);
+  CHECK(planner.get_plan_cache_statistics().hit_rate() == Approx(0.5));
+
+  REQUIRE(second->get_itinerary().size() == first->get_itinerary().size());
+  const auto& second_trajectory = second->get_itinerary().front().trajectory();
+  REQUIRE(second_trajectory.size() == first_trajectory.size());
+  CHECK(*second_trajectory.start_time() == later);
+  CHECK(second_trajectory.duration() == first_trajectory.duration());
+  CHECK(second->get_start().time() == later);
+  CHECK(second->get_cost() == Approx(first->get_cost()));
+
+  REQUIRE(second->get_waypoints().size() == first->get_waypoints().size());
+  for (std::size_t i = 0; i < second->get_waypoints().size(); ++i)
+  {
+    const auto& wp_first = first->get_waypoints()[i];
+    const auto& wp_second = second->get_waypoints()[i];
+    CHECK(wp_second.time() - wp_first.time() == later - time);
+    CHECK(wp_second.graph_index() == wp_first.graph_index());
+  }
+
+  // A start orientation that is far off from the cached one cannot use the
+  // cached plan
+  const auto turned = planner.plan(Planner::Start{later, 0, M_PI/2.0}, goal);
+  REQUIRE(turned);
+  CHECK(planner.get_plan_cache_statistics().hits == 1);
+  CHECK(planner.get_plan_cache_statistics().misses == 2);
+
+  // If the time-shifted plan has a conflict, then a new plan must be searched
+  // for, and it must avoid the conflict.
+  const auto blocked_time = time + 2min;
+  const auto p_obs = database.register_participant(
+    rmf_traffic::schedule::ParticipantDescription{
+      "obstacle",
+      "test_Planner",
+      rmf_traffic::schedule::ParticipantDescription::Rx::Unresponsive,
+      profile
+    });
+
+  rmf_traffic::Trajectory obstacle;
+  obstacle.insert(blocked_time, {10.0, 0.0, 0.0}, {0.0, 0.0, 0.0});
+  obstacle.insert(blocked_time + 40s, {10.0, 0.0, 0.0}, {0.0, 0.0, 0.0});
+  database.extend(
+    p_obs,
+    {{0, std::make_shared<rmf_traffic::Route>(test_map_name, obstacle)}},
+    0);
+
+  const auto blocked = planner.plan(Planner::Start{blocked_time, 0, 0.0}, goal);
+  REQUIRE(blocked);
+  CHECK(planner.get_plan_cache_statistics().hits == 1);
+  CHECK(planner.get_plan_cache_statistics().misses == 3);
+  CHECK_FALSE(rmf_traffic::DetectConflict::between(
+      profile, blocked->get_itinerary().front().trajectory(),
+      profile, obstacle));
+  CHECK(first_trajectory.duration()
+    < blocked->get_itinerary().front().trajectory().duration());
+
+  // Changing the capacity clears the cache
+  planner.set_plan_cache_capacity(5);
+  CHECK(planner.get_plan_cache_statistics().hits == 0);
+  CHECK(planner.get_plan_cache_statistics().misses == 0);
+}
@@ -241,6 +241,91 @@ SCENARIO("Test Rollout on graph with side routes")
   const auto alternatives = rollout_1.expand(
     p0.id(), 30s, rmf_traffic::agv::Planner::Options{nullptr, 10s});
 
+  const auto same_alternatives = [](
+    const std::vector<rmf_traffic::schedule::Itinerary>& a,
+    const std::vector<rmf_traffic::schedule::Itinerary>& b)
+    {
+      if (a.size() != b.size())
+        return false;
+
+      for (std::size_t i = 0; i < a.size(); ++i)
+      {
+        if (a[i].size() != b[i].size())
+          return false;
+
+        for (std::size_t j = 0; j < a[i].size(); ++j)
+        {
+          const auto& r_a = *a[i][j];
+          const auto& r_b = *b[i][j];
+          if (r_a.map() != r_b.map())
+            return false;
+
+          const auto& t_a = r_a.trajectory();
+          const auto& t_b = r_b.trajectory();
+          if (t_a.size() != t_b.size())
+            return false;
+
+          for (std::size_t k = 0; k < t_a.size(); ++k)
+          {
+            if (t_a[k].time() != t_b[k].time())
+              return false;
+
+            if ((t_a[k].position() - t_b[k].position()).norm() > 1e-8)
+              return false;
+          }
+        }
+      }
+
+      return true;
+    };
+
+  // Expanding the rollout one slice at a time should give the same result
+  {
+    auto expansion = rollout_1.begin(
+      p0.id(), 30s, rmf_traffic::agv::Planner::Options{nullptr, 10s});
+
+    std::size_t slices = 0;
+    std::size_t last_count = 0;
+    while (!expansion.resume(rmf_traffic::Duration(0)))
+    {
+      ++slices;
+
+      // The alternatives that are streamed out should only ever grow
+      const auto count = expansion.alternatives().size();
+      CHECK(last_count <= count);
+      last_count = count;
+    }
+
+    CHECK(slices > 0);
+    CHECK(expansion.finished());
+    CHECK(same_alternatives(expansion.alternatives(), alternatives));
+  }
+
+  // Interrupting the rollout should leave it unfinished
+  {
+    const auto interrupt_flag = std::make_shared<bool>(true);
+    auto expansion = rollout_1.begin(
+      p0.id(), 30s,
+      rmf_traffic::agv::Planner::Options{nullptr, 10s, interrupt_flag});
+
+    CHECK_FALSE(expansion.resume());
+    CHECK_FALSE(expansion.finished());
+
+    // Swapping in a new flag lets the expansion carry on where it left off
+    CHECK(expansion.resume(std::make_shared<bool>(false)));
+    CHECK(same_alternatives(expansion.alternatives(), alternatives));
+  }
+
+  // Expanding through a participant that was not blocking gives nothing
+  {
+    auto expansion = rollout_1.begin(
+      p1.id(), 30s, rmf_traffic::agv::Planner::Options{nullptr, 10s});
+
+    CHECK(expansion.finished());
+    CHECK(expansion.resume());
+    CHECK(expansion.alternatives().empty());
+  }
+
   bool found_plan = false;
 //  std::size_t alterantive_count = 0;
 //  std::cout << "Found " << alternatives.size() << " alterantives" << std::endl;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_traffic/agv/RouteValidator.hpp>
+#include <rmf_traffic/geometry/Circle.hpp>
+#include <rmf_traffic/schedule/Database.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+using namespace std::chrono_literals;
+
+namespace {
+//==============================================================================
+/// A viewer that forwards to a Database and counts how often it gets queried
+class CountingViewer : public rmf_traffic::schedule::Viewer
+{
+public:
+
+  CountingViewer(const rmf_traffic::schedule::Database& database)
+  : _database(database)
+  {
+    // Do nothing
+  }
+
+  View query(const rmf_traffic::schedule::Query& parameters) const final
+  {
+    ++queries;
+    return _database.query(parameters);
+  }
+
+  View query(
+    const rmf_traffic::schedule::Query::Spacetime& spacetime,
+    const rmf_traffic::schedule::Query::Participants& participants) const final
+  {
+    ++queries;
+    return _database.query(spacetime, participants);
+  }
+
+  const std::unordered_set<rmf_traffic::schedule::ParticipantId>&
+  participant_ids() const final
+  {
+    return _database.participant_ids();
+  }
+
+  std::shared_ptr<const rmf_traffic::schedule::ParticipantDescription>
+  get_participant(rmf_traffic::schedule::ParticipantId id) const final
+  {
+    return _database.get_participant(id);
+  }
+
+  rmf_traffic::schedule::Version latest_version() const final
+  {
+    return _database.latest_version();
+  }
+
+  mutable std::size_t queries = 0;
+
+private:
+  const rmf_traffic::schedule::Database& _database;
+};
+
+//==============================================================================
+rmf_traffic::Route make_route(
+  const std::string& map,
+  const rmf_traffic::Time start,
+  const Eigen::Vector3d& p0,
+  const Eigen::Vector3d& p1)
+{
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(start, p0, Eigen::Vector3d::Zero());
+  trajectory.insert(start + 10s, p1, Eigen::Vector3d::Zero());
+  return rmf_traffic::Route{map, std::move(trajectory)};
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("ScheduleRouteValidator reuses its queries until the schedule changes")
+{
+  const auto database = std::make_shared<rmf_traffic::schedule::Database>();
+
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(0.5)
+  };
+
+  auto obstacle = rmf_traffic::schedule::make_participant(
+    rmf_traffic::schedule::ParticipantDescription{
+      "obstacle",
+      "test_ScheduleRouteValidator",
+      rmf_traffic::schedule::ParticipantDescription::Rx::Unresponsive,
+      profile
+    },
+    database);
+
+  const std::string map = "test_map";
+  const auto now = std::chrono::steady_clock::now();
+
+  // The obstacle sits at the origin from now until 10s from now
+  obstacle.set({make_route(map, now, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0})});
+
+  CountingViewer viewer(*database);
+  const rmf_traffic::agv::ScheduleRouteValidator validator(
+    viewer, obstacle.id() + 1, profile);
+
+  const auto crossing = make_route(
+    map, now, {-5.0, 0.0, 0.0}, {5.0, 0.0, 0.0});
+
+  const auto conflict = validator.find_conflict(crossing);
+  REQUIRE(conflict);
+  CHECK(conflict->participant == obstacle.id());
+  CHECK(viewer.queries == 1);
+
+  // Routes that are on a different map or that happen at a different time do
+  // not conflict, and validating them does not query the same map again.
+  CHECK_FALSE(validator.find_conflict(
+      make_route("other_map", now, {-5.0, 0.0, 0.0}, {5.0, 0.0, 0.0})));
+  CHECK_FALSE(validator.find_conflict(
+      make_route(map, now + 20s, {-5.0, 0.0, 0.0}, {5.0, 0.0, 0.0})));
+  CHECK(validator.find_conflict(crossing));
+  CHECK(viewer.queries == 2);
+
+  // Clones share the cache of the validator they came from
+  const auto clone = validator.clone();
+  CHECK(clone->find_conflict(crossing));
+  CHECK(viewer.queries == 2);
+
+  // The participant itself is ignored
+  rmf_traffic::agv::ScheduleRouteValidator self_validator(
+    viewer, obstacle.id(), profile);
+  CHECK_FALSE(self_validator.find_conflict(crossing));
+
+  WHEN("The schedule changes")
+  {
+    // Move the obstacle out of the way
+    obstacle.set({make_route(map, now, {0.0, 5.0, 0.0}, {0.0, 5.0, 0.0})});
+
+    const auto queries_before = viewer.queries;
+    CHECK_FALSE(validator.find_conflict(crossing));
+    CHECK(viewer.queries == queries_before + 1);
+
+    // Move it back into the way
+    obstacle.set({make_route(map, now, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0})});
+    CHECK(validator.find_conflict(crossing));
+    CHECK(viewer.queries == queries_before + 2);
+  }
+}
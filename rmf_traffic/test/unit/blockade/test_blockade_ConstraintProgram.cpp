@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_utils/catch.hpp>
+
+#include <src/rmf_traffic/blockade/ConstraintProgram.hpp>
+#include <src/rmf_traffic/blockade/conflicts.hpp>
+
+#include "utils_blockade_scenarios.hpp"
+
+#include <random>
+
+namespace {
+//==============================================================================
+using Checkpoint = rmf_traffic::blockade::Writer::Checkpoint;
+
+//==============================================================================
+rmf_traffic::blockade::Blockers make_final_constraints(
+  const std::vector<std::vector<Checkpoint>>& paths,
+  const double radius,
+  const double max_angle)
+{
+  using namespace rmf_traffic::blockade;
+
+  PeerToPeerBlockers peer_blockers;
+  PeerToPeerAlignment peer_alignment;
+  for (std::size_t i=0; i < paths.size()-1; ++i)
+  {
+    for (std::size_t j=i+1; j < paths.size(); ++j)
+    {
+      const auto brackets = compute_brackets(
+        paths[i], radius, paths[j], radius, max_angle);
+
+      auto blockers = compute_blockers(
+        brackets.conflicts, i, paths[i].size(), j, paths[j].size());
+      peer_blockers[i][j] = std::move(blockers.at(0));
+      peer_blockers[j][i] = std::move(blockers.at(1));
+
+      auto alignments = compute_alignments(brackets.alignments);
+      peer_alignment[i][j] = std::move(alignments.at(0));
+      peer_alignment[j][i] = std::move(alignments.at(1));
+    }
+  }
+
+  return compute_final_ShouldGo_constraints(
+    peer_blockers, peer_alignment).should_go;
+}
+
+//==============================================================================
+std::optional<std::size_t> find_blocked_by_tree(
+  const rmf_traffic::blockade::Blockers& should_go,
+  const rmf_traffic::blockade::State& state,
+  const std::size_t participant)
+{
+  const auto it = should_go.find(participant);
+  if (it == should_go.end())
+    return std::nullopt;
+
+  const auto& range = state.at(participant);
+  for (std::size_t c = range.begin; c < range.end; ++c)
+  {
+    const auto c_it = it->second.find(c);
+    if (c_it != it->second.end() && !c_it->second->evaluate(state))
+      return c;
+  }
+
+  return std::nullopt;
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Compiled constraints agree with the constraint tree")
+{
+  using namespace rmf_traffic::blockade;
+
+  const double radius = 0.1;
+  const double max_angle = 5.0*M_PI/180.0;
+
+  std::vector<GridlockScenario> scenarios = {
+    flyby_uturn(),
+    fourway_standoff(),
+    threeway_standoff_with_redundant_leg(),
+    threeway_standoff_with_additional_conflict(),
+    crisscrossing_paths()
+  };
+
+  std::mt19937 rng(7);
+
+  for (std::size_t s = 0; s < scenarios.size(); ++s)
+  {
+    CAPTURE(s);
+    const auto& paths = scenarios[s].paths;
+    const auto should_go = make_final_constraints(paths, radius, max_angle);
+
+    ConstraintProgram program(should_go);
+    State state;
+    for (std::size_t p = 0; p < paths.size(); ++p)
+    {
+      state[p] = ReservedRange{0, 0};
+      program.set_range(p, state[p]);
+    }
+
+    // Change one participant at a time so that the results which were cached
+    // for the other participants get reused.
+    for (std::size_t k = 0; k < 500; ++k)
+    {
+      const std::size_t p = rng() % paths.size();
+      const std::size_t n = paths[p].size();
+      const std::size_t begin = rng() % n;
+      const std::size_t end = begin + rng() % (n - begin);
+      state[p] = ReservedRange{begin, end};
+      program.set_range(p, state[p]);
+
+      for (std::size_t q = 0; q < paths.size(); ++q)
+      {
+        CAPTURE(k);
+        CAPTURE(q);
+        CHECK(program.find_blocked(q) == find_blocked_by_tree(
+          should_go, state, q));
+      }
+    }
+  }
+}
+
+//==============================================================================
+SCENARIO("Compiled constraints only re-evaluate what changed")
+{
+  using namespace rmf_traffic::blockade;
+
+  Blockers should_go;
+  should_go[0][1] = blockage(1, 0, std::nullopt);
+  should_go[1][1] = blockage(0, 0, std::nullopt);
+  should_go[2][1] = passed(3, 2);
+
+  ConstraintProgram program(should_go);
+  for (std::size_t p = 0; p < 4; ++p)
+    program.set_range(p, ReservedRange{0, 2});
+
+  for (std::size_t p = 0; p < 3; ++p)
+    CHECK(program.find_blocked(p) == 1);
+
+  const auto count = program.evaluation_count();
+
+  // Nothing has changed, so nothing should be evaluated
+  for (std::size_t p = 0; p < 3; ++p)
+    CHECK(program.find_blocked(p) == 1);
+
+  CHECK(program.evaluation_count() == count);
+
+  // Only the constraint that depends on participant 3 needs to be evaluated
+  program.set_range(3, ReservedRange{3, 3});
+  CHECK_FALSE(program.find_blocked(2).has_value());
+  CHECK(program.find_blocked(0) == 1);
+  CHECK(program.evaluation_count() == count + 1);
+
+  WHEN("A participant is erased")
+  {
+    program.erase(1);
+    CHECK_THROWS(program.find_blocked(0));
+  }
+}
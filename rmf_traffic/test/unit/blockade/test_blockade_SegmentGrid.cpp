@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_utils/catch.hpp>
+
+#include <src/rmf_traffic/blockade/SegmentGrid.hpp>
+#include <src/rmf_traffic/blockade/conflicts.hpp>
+
+#include <random>
+
+namespace {
+//==============================================================================
+std::vector<rmf_traffic::blockade::Writer::Checkpoint> make_path(
+  const std::vector<Eigen::Vector2d>& positions,
+  const std::string& map = "test_map")
+{
+  std::vector<rmf_traffic::blockade::Writer::Checkpoint> path;
+  for (const auto& p : positions)
+    path.push_back({p, map, true});
+
+  return path;
+}
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Segment grid finds nearby paths")
+{
+  using namespace rmf_traffic::blockade;
+
+  SegmentGrid grid;
+  const double radius = 0.5;
+
+  grid.insert(0, make_path({{0, 0}, {20, 0}}), radius);
+  grid.insert(1, make_path({{0, 0.9}, {20, 0.9}}), radius);
+  grid.insert(2, make_path({{0, 30}, {20, 30}}), radius);
+  grid.insert(3, make_path({{0, 0}, {20, 0}}, "other_map"), radius);
+
+  CHECK(grid.neighbors(0) == std::unordered_set<ParticipantId>({1}));
+  CHECK(grid.neighbors(1) == std::unordered_set<ParticipantId>({0}));
+  CHECK(grid.neighbors(2).empty());
+  CHECK(grid.neighbors(3).empty());
+
+  WHEN("A path is moved")
+  {
+    grid.insert(2, make_path({{10, -10}, {10, 10}}), radius);
+    CHECK(grid.neighbors(2) == std::unordered_set<ParticipantId>({0, 1}));
+    CHECK(grid.neighbors(0) == std::unordered_set<ParticipantId>({1, 2}));
+  }
+
+  WHEN("A path is erased")
+  {
+    grid.erase(1);
+    CHECK(grid.neighbors(0).empty());
+    CHECK(grid.neighbors(1).empty());
+  }
+}
+
+//==============================================================================
+SCENARIO("Segment grid never rules out paths that have brackets")
+{
+  using namespace rmf_traffic::blockade;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> radius(0.1, 1.5);
+
+  const std::size_t N = 40;
+  std::vector<std::vector<Writer::Checkpoint>> paths;
+  std::vector<double> radii;
+
+  SegmentGrid grid(1.0);
+  for (std::size_t i=0; i < N; ++i)
+  {
+    std::vector<Eigen::Vector2d> positions;
+    for (std::size_t k=0; k < 4; ++k)
+      positions.push_back({position(rng)/4.0 + i, position(rng)/4.0});
+
+    paths.push_back(make_path(positions));
+    radii.push_back(radius(rng));
+    grid.insert(i, paths.back(), radii.back());
+  }
+
+  for (std::size_t i=0; i < N; ++i)
+  {
+    const auto neighbors = grid.neighbors(i);
+    for (std::size_t j=0; j < N; ++j)
+    {
+      if (i == j)
+        continue;
+
+      const auto brackets = compute_brackets(
+        paths[i], radii[i], paths[j], radii[j], 1.0*M_PI/180.0);
+
+      if (!brackets.conflicts.empty() || !brackets.alignments.empty())
+      {
+        CAPTURE(i);
+        CAPTURE(j);
+        CHECK(neighbors.count(j) > 0);
+      }
+    }
+  }
+}
@@ -24,6 +24,8 @@
 #include "src/rmf_traffic/schedule/debug_Viewer.hpp"
 #include "src/rmf_traffic/schedule/debug_Database.hpp"
 
+#include <rmf_traffic/schedule/Mirror.hpp>
+
 #include <rmf_utils/catch.hpp>
 
 using namespace std::chrono_literals;
@@ -224,6 +226,11 @@ SCENARIO("Test Database Conflicts")
       const auto cull_time = time + 5min;
       CHECK(rmf_traffic::schedule::Database::Debug::current_entry_history_count(
           db) == 2);
+
+      // Nothing finished before this time, so the version stays the same
+      CHECK(db.cull(time - 1h) == dbv);
+      CHECK(db.latest_version() == dbv);
+
       const auto v = db.cull(cull_time);
       CHECK(rmf_traffic::schedule::Database::Debug::current_entry_history_count(
           db) == 1);
@@ -301,3 +308,236 @@ SCENARIO("Test Database Conflicts")
     }
   }
 }
+
+SCENARIO("Restore a Database from a checkpoint and a journal")
+{
+  using namespace rmf_traffic::schedule;
+
+  const rmf_traffic::Time time = std::chrono::steady_clock::now();
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(1.0)
+  };
+
+  const auto make_description = [&](const std::string& name)
+    {
+      return ParticipantDescription{
+        name,
+        "test_Database",
+        ParticipantDescription::Rx::Responsive,
+        profile
+      };
+    };
+
+  rmf_traffic::Trajectory t;
+  t.insert(time, Eigen::Vector3d{-5, 0, 0}, Eigen::Vector3d{0, 0, 0});
+  t.insert(time + 10s, Eigen::Vector3d{5, 0, 0}, Eigen::Vector3d{0, 0, 0});
+
+  Database db;
+  const auto p1 = db.register_participant(make_description("p1"));
+  const auto p2 = db.register_participant(make_description("p2"));
+  db.set(p1, create_test_input(0, t), 0);
+  db.set(p2, create_test_input(0, t), 0);
+  db.delay(p1, 5s, 1);
+
+  const auto checkpoint = db.checkpoint();
+  CHECK(checkpoint.version == db.latest_version());
+  REQUIRE(checkpoint.participants.size() == 2);
+
+  auto journal = std::make_shared<ReplayJournal>();
+  db.set_journal(journal);
+
+  // Change the database after the checkpoint was taken
+  db.extend(p1, create_test_input(1, t), 2);
+  db.delay(p2, 2s, 1);
+  db.erase(p2, {0}, 2);
+  const auto p3 = db.register_participant(make_description("p3"));
+  db.set(p3, create_test_input(0, t), 0);
+
+  // A change that arrives out of order only gets journaled once it is applied
+  db.delay(p1, 1s, 4);
+  CHECK(journal->changes.size() == 5);
+  db.delay(p1, 1s, 3);
+  CHECK(journal->changes.size() == 7);
+
+  db.set_current_time(time);
+  db.unregister_participant(p3);
+
+  Database restored(checkpoint);
+  CHECK(restored.oldest_version() == checkpoint.version);
+  CHECK(restored.latest_version() == checkpoint.version);
+  CHECK(restored.participant_ids().size() == 2);
+  CHECK(restored.itinerary_version(p1) == 1);
+
+  // A mirror that is up to date with the checkpoint gets the same patch from
+  // both databases
+  const auto query_all = rmf_traffic::schedule::query_all();
+  CHECK(restored.changes(query_all, checkpoint.version).size() == 0);
+
+  journal->replay(restored);
+  CHECK(restored.latest_version() == db.latest_version());
+  CHECK(restored.participant_ids() == db.participant_ids());
+  CHECK(restored.itinerary_version(p1) == db.itinerary_version(p1));
+  CHECK(restored.itinerary_version(p2) == db.itinerary_version(p2));
+  CHECK(restored.get_itinerary(p1)->size() == db.get_itinerary(p1)->size());
+  CHECK(restored.get_itinerary(p2)->size() == db.get_itinerary(p2)->size());
+
+  const auto expected = db.changes(query_all, checkpoint.version);
+  const auto patch = restored.changes(query_all, checkpoint.version);
+  CHECK(patch.size() == expected.size());
+  CHECK(patch.registered().size() == expected.registered().size());
+  CHECK(patch.unregistered().size() == expected.unregistered().size());
+  CHECK(patch.latest_version() == expected.latest_version());
+
+  // The writers can continue from their last itinerary versions
+  restored.delay(p1, 1s, 5);
+  CHECK(restored.latest_version() == db.latest_version() + 1);
+  CHECK(restored.inconsistencies().find(p1)->ranges.size() == 0);
+
+  // A writer that had a change waiting on an inconsistency will be asked for
+  // it again
+  Database gap_db;
+  const auto g1 = gap_db.register_participant(make_description("g1"));
+  gap_db.set(g1, create_test_input(0, t), 0);
+  gap_db.delay(g1, 1s, 2);
+  Database gap_restored(gap_db.checkpoint());
+  CHECK(gap_restored.itinerary_version(g1) == 0);
+  gap_restored.delay(g1, 1s, 3);
+  CHECK(gap_restored.inconsistencies().find(g1)->ranges.size() == 1);
+}
+
+SCENARIO("Compact the history of a Database")
+{
+  using namespace rmf_traffic::schedule;
+
+  const rmf_traffic::Time time = std::chrono::steady_clock::now();
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(1.0)
+  };
+
+  const auto make_description = [&](const std::string& name)
+    {
+      return ParticipantDescription{
+        name,
+        "test_Database",
+        ParticipantDescription::Rx::Responsive,
+        profile
+      };
+    };
+
+  rmf_traffic::Trajectory t;
+  t.insert(time, Eigen::Vector3d{-5, 0, 0}, Eigen::Vector3d{0, 0, 0});
+  t.insert(time + 10s, Eigen::Vector3d{5, 0, 0}, Eigen::Vector3d{0, 0, 0});
+
+  const auto query_all = rmf_traffic::schedule::query_all();
+
+  const auto finish_time = [](const ItineraryViewer& viewer, ParticipantId p)
+    {
+      const auto itinerary = viewer.get_itinerary(p);
+      REQUIRE(itinerary);
+      REQUIRE(itinerary->size() == 1);
+      return *itinerary->front()->trajectory().finish_time();
+    };
+
+  const auto entries = [](const Database& db, ParticipantId p)
+    {
+      for (const auto& footprint : db.footprint())
+      {
+        if (footprint.participant == p)
+          return footprint.route_entries;
+      }
+
+      return std::size_t(0);
+    };
+
+  Database db;
+  const auto p1 = db.register_participant(make_description("p1"));
+  const auto p2 = db.register_participant(make_description("p2"));
+  db.set(p1, create_test_input(0, t), 0);
+  db.set(p2, create_test_input(0, t), 0);
+  db.extend(p2, create_test_input(1, t), 1);
+
+  for (ItineraryVersion v = 1; v <= 5; ++v)
+    db.delay(p1, 1s, v);
+
+  Mirror mirror;
+  mirror.update(db.changes(query_all, rmf_utils::nullopt));
+  const Version mirror_version = db.latest_version();
+
+  for (ItineraryVersion v = 6; v <= 10; ++v)
+    db.delay(p1, 1s, v);
+
+  db.erase(p2, {1}, 2);
+  const auto p3 = db.register_participant(make_description("p3"));
+  db.set_current_time(time);
+  db.unregister_participant(p3);
+
+  CHECK(entries(db, p1) == 11);
+  CHECK(entries(db, p2) == 3);
+  CHECK(Database::Debug::current_removed_participant_count(db) == 1);
+
+  // Only the history from before the mirror's version is discarded, so the
+  // mirror can still catch up with a patch
+  CHECK(db.compact(mirror_version) == 5);
+  CHECK(db.oldest_version() == mirror_version);
+  CHECK(entries(db, p1) == 6);
+  CHECK(entries(db, p2) == 3);
+
+  mirror.update(db.changes(query_all, mirror_version));
+  CHECK(mirror.latest_version() == db.latest_version());
+  CHECK(finish_time(mirror, p1) == finish_time(db, p1));
+  CHECK(mirror.get_itinerary(p2)->size() == 1);
+
+  // Compacting to the latest version leaves nothing but the current routes
+  const Version latest_version = db.latest_version();
+  CHECK(db.compact(latest_version + 10) == 7);
+  CHECK(db.oldest_version() == latest_version);
+  CHECK(db.latest_version() == latest_version);
+  CHECK(entries(db, p1) == 1);
+  CHECK(entries(db, p2) == 1);
+  CHECK(Database::Debug::current_removed_participant_count(db) == 0);
+  CHECK(db.compact(latest_version) == 0);
+  CHECK(db.changes(query_all, latest_version).size() == 0);
+
+  // The database keeps working after it has been compacted
+  db.delay(p1, 1s, 11);
+  db.erase(p2, {0}, 3);
+  mirror.update(db.changes(query_all, latest_version));
+  CHECK(mirror.latest_version() == db.latest_version());
+  CHECK(finish_time(mirror, p1) == finish_time(db, p1));
+  CHECK(finish_time(db, p1) == *t.finish_time() + 11s);
+  CHECK(mirror.get_itinerary(p2)->empty());
+
+  Mirror fresh_mirror;
+  fresh_mirror.update(db.changes(query_all, rmf_utils::nullopt));
+  CHECK(finish_time(fresh_mirror, p1) == finish_time(db, p1));
+
+  // The culling still finds the routes that were compacted
+  db.cull(*t.finish_time() + 1h);
+  CHECK(Database::Debug::current_entry_history_count(db) == 0);
+
+  // Changes that are stuck behind an inconsistency can be dropped, and the
+  // participant will be asked to retransmit them
+  const auto g = db.register_participant(make_description("g"));
+  db.set(g, create_test_input(0, t), 0);
+  for (ItineraryVersion v = 2; v <= 4; ++v)
+    db.delay(g, 1s, v);
+
+  CHECK(db.footprint().size() == 3);
+  CHECK(db.drop_staged_changes(3).empty());
+  const auto dropped = db.drop_staged_changes(1);
+  REQUIRE(dropped.size() == 1);
+  CHECK(dropped.front() == g);
+
+  const auto& ranges = db.inconsistencies().find(g)->ranges;
+  REQUIRE(ranges.size() == 1);
+  CHECK(ranges.begin()->lower == 1);
+  CHECK(ranges.begin()->upper == 3);
+
+  for (ItineraryVersion v = 1; v <= 3; ++v)
+    db.delay(g, 1s, v);
+
+  CHECK(ranges.size() == 0);
+  CHECK(finish_time(db, g) == *t.finish_time() + 4s);
+}
@@ -83,4 +83,96 @@ inline rmf_traffic::schedule::Writer::Input create_test_input(
 }
 
 
+/// A Journal that keeps the changes of a Database so they can be replayed on a
+/// Database that was restored from a checkpoint.
+class ReplayJournal : public rmf_traffic::schedule::Database::Journal
+{
+public:
+
+  using Database = rmf_traffic::schedule::Database;
+  using ParticipantId = rmf_traffic::schedule::ParticipantId;
+  using ItineraryVersion = rmf_traffic::schedule::ItineraryVersion;
+  using Input = rmf_traffic::schedule::Writer::Input;
+
+  void set(
+    ParticipantId participant,
+    const Input& itinerary,
+    ItineraryVersion version) final
+  {
+    changes.push_back(
+      [=](Database& db) { db.set(participant, itinerary, version); });
+  }
+
+  void extend(
+    ParticipantId participant,
+    const Input& routes,
+    ItineraryVersion version) final
+  {
+    changes.push_back(
+      [=](Database& db) { db.extend(participant, routes, version); });
+  }
+
+  void delay(
+    ParticipantId participant,
+    rmf_traffic::Duration delay,
+    ItineraryVersion version) final
+  {
+    changes.push_back(
+      [=](Database& db) { db.delay(participant, delay, version); });
+  }
+
+  void erase(
+    ParticipantId participant,
+    ItineraryVersion version) final
+  {
+    changes.push_back(
+      [=](Database& db) { db.erase(participant, version); });
+  }
+
+  void erase(
+    ParticipantId participant,
+    const std::vector<rmf_traffic::RouteId>& routes,
+    ItineraryVersion version) final
+  {
+    changes.push_back(
+      [=](Database& db) { db.erase(participant, routes, version); });
+  }
+
+  void register_participant(
+    ParticipantId participant,
+    const rmf_traffic::schedule::ParticipantDescription& description) final
+  {
+    changes.push_back(
+      [=](Database& db)
+      {
+        CHECK(db.register_participant(description) == participant);
+      });
+  }
+
+  void unregister_participant(
+    ParticipantId participant,
+    rmf_traffic::Time current_time) final
+  {
+    changes.push_back(
+      [=](Database& db)
+      {
+        db.set_current_time(current_time);
+        db.unregister_participant(participant);
+      });
+  }
+
+  void cull(rmf_traffic::Time time) final
+  {
+    changes.push_back([=](Database& db) { db.cull(time); });
+  }
+
+  void replay(Database& db) const
+  {
+    for (const auto& change : changes)
+      change(db);
+  }
+
+  std::vector<std::function<void(Database&)>> changes;
+};
+
 #endif //RMF_TRAFFIC__TEST__UNIT__SCHEDULE__UTILS_TRAJECTORY_HPP
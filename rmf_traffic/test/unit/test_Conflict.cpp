@@ -18,6 +18,7 @@
 #include "utils_Conflict.hpp"
 #include "utils_Trajectory.hpp"
 #include "src/rmf_traffic/DetectConflictInternal.hpp"
+#include "src/rmf_traffic/geometry/SimplePolygon.hpp"
 
 #include <rmf_utils/catch.hpp>
 #include <iostream>
@@ -532,4 +533,65 @@ SCENARIO("DetectConflict unit tests")
   }
 }
 
+//==============================================================================
+SCENARIO("Detect conflicts with a concave region")
+{
+  const rmf_traffic::Time begin_time = std::chrono::steady_clock::now();
+  const auto circle = rmf_traffic::geometry::make_final_convex<
+    rmf_traffic::geometry::Circle>(0.2);
+  const rmf_traffic::Profile profile{circle};
+
+  // A U-shaped region whose notch spans 2 < x < 4 and 2 < y < 6
+  const auto u_shape = rmf_traffic::geometry::make_final<
+    rmf_traffic::geometry::SimplePolygon>(
+    std::vector<Eigen::Vector2d>{
+      {0.0, 0.0}, {6.0, 0.0}, {6.0, 6.0}, {4.0, 6.0},
+      {4.0, 2.0}, {2.0, 2.0}, {2.0, 6.0}, {0.0, 6.0}
+    });
+
+  // The U is not convex, so it must be broken into more than one piece, but
+  // it never needs more than three convex pieces.
+  const auto num_pieces = rmf_traffic::geometry::FinalShape::Implementation
+    ::get_collisions(*u_shape).size();
+  CHECK(num_pieces > 1);
+  CHECK(num_pieces <= 3);
+
+  const std::vector<Eigen::Isometry2d> poses = {
+    Eigen::Isometry2d::Identity(),
+    Eigen::Translation2d(Eigen::Vector2d(-7.0, 3.0))
+    * Eigen::Rotation2Dd(M_PI/2.0)
+  };
+
+  for (const auto& pose : poses)
+  {
+    const auto make_trajectory = [&](const double end_y)
+      {
+        rmf_traffic::Trajectory trajectory;
+        const Eigen::Vector2d p0 = pose * Eigen::Vector2d(3.0, 10.0);
+        const Eigen::Vector2d p1 = pose * Eigen::Vector2d(3.0, end_y);
+        trajectory.insert(
+          begin_time,
+          Eigen::Vector3d(p0[0], p0[1], 0.0),
+          Eigen::Vector3d::Zero());
+        trajectory.insert(
+          begin_time + 10s,
+          Eigen::Vector3d(p1[0], p1[1], 0.0),
+          Eigen::Vector3d::Zero());
+        return trajectory;
+      };
+
+    const rmf_traffic::internal::Spacetime region{
+      nullptr, nullptr, pose, u_shape
+    };
+
+    // Stopping inside the notch of the U does not touch the region
+    CHECK_FALSE(rmf_traffic::internal::detect_conflicts(
+        profile, make_trajectory(3.0), region));
+
+    // Passing through the bottom of the U does
+    CHECK(rmf_traffic::internal::detect_conflicts(
+        profile, make_trajectory(1.0), region));
+  }
+}
+
 // A useful website for playing with 2D cubic splines: https://www.desmos.com/calculator/
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Checks that schedule followers stay consistent with the schedule node. This
+// keeps a mirror of the schedule node and a mirror of each follower, and
+// compares them periodically. It can also create some participants that keep
+// changing their itineraries, so that the followers have something to follow.
+
+#include <rmf_traffic_ros2/schedule/MirrorManager.hpp>
+#include <rmf_traffic_ros2/schedule/Writer.hpp>
+
+#include <rmf_traffic/geometry/Circle.hpp>
+
+#include <rclcpp/executors.hpp>
+#include <rclcpp/node.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+//==============================================================================
+class ReplicationCheck : public rclcpp::Node
+{
+public:
+
+  using MirrorManager = rmf_traffic_ros2::schedule::MirrorManager;
+  using MirrorManagerFuture = rmf_traffic_ros2::schedule::MirrorManagerFuture;
+
+  struct Mirror
+  {
+    std::string name;
+    rmf_utils::optional<MirrorManagerFuture> future;
+    rmf_utils::optional<MirrorManager> manager;
+  };
+
+  ReplicationCheck()
+  : rclcpp::Node("schedule_replication_check")
+  {
+    const auto followers = declare_parameter<std::vector<std::string>>(
+      "followers", std::vector<std::string>());
+    const auto participants = declare_parameter<int>("participants", 0);
+
+    add_mirror("");
+    for (const auto& follower : followers)
+      add_mirror(follower);
+
+    writer = rmf_traffic_ros2::schedule::Writer::make(*this);
+    for (int i = 0; i < participants; ++i)
+      add_participant(i);
+
+    using namespace std::chrono_literals;
+    write_timer = create_wall_timer(500ms, [=]() { this->write(); });
+    check_timer = create_wall_timer(2s, [=]() { this->check(); });
+  }
+
+  void add_mirror(std::string follower)
+  {
+    MirrorManager::Options options;
+    options.follower(follower);
+
+    Mirror mirror;
+    mirror.name = follower.empty() ? "schedule node" : follower;
+    mirror.future = rmf_traffic_ros2::schedule::make_mirror(
+      *this, rmf_traffic::schedule::query_all(), std::move(options));
+
+    mirrors.emplace_back(std::move(mirror));
+  }
+
+  void add_participant(int i)
+  {
+    rmf_traffic::schedule::ParticipantDescription description{
+      "participant_" + std::to_string(i),
+      "schedule_replication_check",
+      rmf_traffic::schedule::ParticipantDescription::Rx::Unresponsive,
+      rmf_traffic::Profile{
+        rmf_traffic::geometry::make_final_convex<
+          rmf_traffic::geometry::Circle>(0.5)
+      }
+    };
+
+    writer->async_make_participant(
+      std::move(description),
+      [=](rmf_traffic::schedule::Participant participant)
+      {
+        this->participants.emplace_back(std::move(participant));
+      });
+  }
+
+  void write()
+  {
+    using namespace std::chrono_literals;
+    const auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < participants.size(); ++i)
+    {
+      rmf_traffic::Trajectory t;
+      t.insert(now, {0.0, static_cast<double>(i), 0.0}, {0.0, 0.0, 0.0});
+      t.insert(now + 30s, {30.0, static_cast<double>(i), 0.0}, {0, 0, 0});
+      participants[i].set({{"test_map", std::move(t)}});
+    }
+  }
+
+  using Summary = std::vector<std::tuple<
+        rmf_traffic::schedule::ParticipantId,
+        std::string,
+        std::size_t,
+        rmf_traffic::Time>>;
+
+  static Summary summarize(const rmf_traffic::schedule::Viewer& viewer)
+  {
+    Summary summary;
+    for (const auto p : viewer.participant_ids())
+    {
+      const auto itinerary = viewer.get_itinerary(p);
+      if (!itinerary)
+        continue;
+
+      for (const auto& route : *itinerary)
+      {
+        summary.emplace_back(
+          p,
+          route->map(),
+          route->trajectory().size(),
+          *route->trajectory().finish_time());
+      }
+    }
+
+    std::sort(summary.begin(), summary.end());
+    return summary;
+  }
+
+  void check()
+  {
+    for (auto& mirror : mirrors)
+    {
+      if (mirror.manager)
+        continue;
+
+      if (mirror.future->wait_for(std::chrono::seconds(0))
+        == std::future_status::ready)
+      {
+        mirror.manager = mirror.future->get();
+        mirror.future = rmf_utils::nullopt;
+      }
+    }
+
+    if (!mirrors.front().manager)
+      return;
+
+    const auto& leader = mirrors.front().manager->viewer();
+    const auto leader_version = leader.latest_version();
+    const auto leader_summary = summarize(leader);
+    for (std::size_t i = 1; i < mirrors.size(); ++i)
+    {
+      const auto& mirror = mirrors[i];
+      if (!mirror.manager)
+      {
+        RCLCPP_INFO(get_logger(), "[" + mirror.name + "] is not ready yet");
+        continue;
+      }
+
+      const auto& viewer = mirror.manager->viewer();
+      if (viewer.latest_version() != leader_version)
+      {
+        // The mirrors are updated at different moments, so this is only a
+        // problem if it keeps happening.
+        RCLCPP_INFO(
+          get_logger(),
+          "[" + mirror.name + "] is at version ["
+          + std::to_string(viewer.latest_version()) + "] while the schedule "
+          "node is at [" + std::to_string(leader_version) + "]");
+        continue;
+      }
+
+      if (summarize(viewer) == leader_summary)
+      {
+        RCLCPP_INFO(
+          get_logger(),
+          "[" + mirror.name + "] is consistent at version ["
+          + std::to_string(leader_version) + "] with ["
+          + std::to_string(leader_summary.size()) + "] routes");
+      }
+      else
+      {
+        RCLCPP_ERROR(
+          get_logger(),
+          "[" + mirror.name + "] is INCONSISTENT at version ["
+          + std::to_string(leader_version) + "]");
+      }
+    }
+  }
+
+  std::vector<Mirror> mirrors;
+  rmf_traffic_ros2::schedule::WriterPtr writer;
+  std::vector<rmf_traffic::schedule::Participant> participants;
+  rclcpp::TimerBase::SharedPtr write_timer;
+  rclcpp::TimerBase::SharedPtr check_timer;
+};
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+  rclcpp::init(argc, argv);
+  rclcpp::spin(std::make_shared<ReplicationCheck>());
+  rclcpp::shutdown();
+}
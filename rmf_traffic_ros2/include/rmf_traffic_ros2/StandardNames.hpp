@@ -37,6 +37,9 @@ const std::string MirrorUpdateServiceName = Prefix + "mirror_update";
 const std::string MirrorWakeupTopicName = Prefix + "mirror_wakeup";
 const std::string ScheduleInconsistencyTopicName = Prefix +
   "schedule_inconsistency";
+const std::string ScheduleJournalTopicName = Prefix + "schedule_journal";
+const std::string ScheduleCheckpointServiceName = Prefix +
+  "schedule_checkpoint";
 const std::string NegotiationAckTopicName = Prefix +
   "negotiation_ack";
 const std::string NegotiationRepeatTopicName = Prefix +
@@ -63,6 +63,16 @@ public:
     /// Toggle the choice to wakeup on an update.
     Options& update_on_wakeup(bool choice);
 
+    /// The fully qualified name of the schedule follower node that the mirror
+    /// gets its updates from. When empty, the mirror gets its updates from
+    /// the schedule node itself.
+    const std::string& follower() const;
+
+    /// Get mirror updates from the schedule follower node with this fully
+    /// qualified name, e.g. "/rmf_traffic_schedule_follower". Queries are
+    /// still registered with the schedule node.
+    Options& follower(std::string node_name);
+
     class Implementation;
   private:
     rmf_utils::impl_ptr<Implementation> _pimpl;
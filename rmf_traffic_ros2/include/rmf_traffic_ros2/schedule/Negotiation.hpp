@@ -68,6 +68,25 @@ public:
   /// Get the current timeout duration setting.
   rmf_traffic::Duration timeout_duration() const;
 
+  /// Respond to independent negotiation tables in parallel using a pool of
+  /// threads. This only has an effect when no Worker was given to the
+  /// constructor, and it requires the registered Negotiators to be safe to use
+  /// from several threads at once.
+  ///
+  /// The negotiators of all the tables that are waiting for a response are run
+  /// on the pool at the same time, but their responses are applied in the same
+  /// order that the tables would be visited without the pool. A response is
+  /// thrown out and computed again if its table changed in the meantime, so
+  /// the outcome of the negotiation is the same either way.
+  ///
+  /// \param[in] num_threads
+  ///   The number of threads to respond with. Pass in 0 (the default) to
+  ///   respond to one table at a time on the thread that received the message.
+  Negotiation& parallel_responses(std::size_t num_threads);
+
+  /// Get the number of threads that are used to respond to tables in parallel.
+  std::size_t parallel_responses() const;
+
   using TableViewPtr = rmf_traffic::schedule::Negotiation::Table::ViewerPtr;
   using StatusUpdateCallback =
     std::function<void (uint64_t conflict_version, TableViewPtr table_view)>;
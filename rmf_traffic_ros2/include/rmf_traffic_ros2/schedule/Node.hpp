@@ -27,6 +27,16 @@ namespace schedule {
 std::shared_ptr<rclcpp::Node> make_node(
   const rclcpp::NodeOptions& options = rclcpp::NodeOptions());
 
+/// Make a follower of the ScheduleNode. The follower keeps an identical copy
+/// of the schedule database and serves mirror updates from it, which takes the
+/// load of the mirrors off of the ScheduleNode. The ScheduleNode must have its
+/// schedule_replication parameter set to true.
+///
+/// Use MirrorManager::Options::follower() to have a mirror get its updates
+/// from a follower.
+std::shared_ptr<rclcpp::Node> make_follower_node(
+  const rclcpp::NodeOptions& options = rclcpp::NodeOptions());
+
 } // namespace schedule
 } // namespace rmf_traffic_ros2
 
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__CONFLICTCHECK_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__CONFLICTCHECK_HPP
+
+#include <rmf_traffic/DetectConflict.hpp>
+#include <rmf_traffic/schedule/Database.hpp>
+#include <rmf_traffic/schedule/Mirror.hpp>
+
+#include <rmf_utils/Modular.hpp>
+#include <rmf_utils/optional.hpp>
+
+#include <cassert>
+#include <unordered_set>
+#include <vector>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// Tracks which changes of the database have been checked for conflicts.
+///
+/// The changes are copied out of the database while it is locked, and are then
+/// checked against a mirror of the database after the lock is released, so
+/// the schedule writers never wait for the conflict checks.
+class ConflictCheck
+{
+public:
+
+  using ParticipantId = rmf_traffic::schedule::ParticipantId;
+  using Version = rmf_traffic::schedule::Version;
+  using ConflictSet = std::unordered_set<ParticipantId>;
+
+  /// True if the database has changes that have not been copied out yet. The
+  /// database must be locked while this is called.
+  bool has_new_changes(const rmf_traffic::schedule::Database& database) const
+  {
+    return !_last_checked_version
+      || database.latest_version() > *_last_checked_version;
+  }
+
+  /// Copy out the changes that have not been checked yet. The database must be
+  /// locked while this is called.
+  void copy_changes(const rmf_traffic::schedule::Database& database)
+  {
+    if (_last_checked_version && rmf_utils::modular(*_last_checked_version)
+      .less_than(database.oldest_version()))
+    {
+      // The history that the mirror needs has been compacted, so start over
+      // with a full update.
+      _mirror = rmf_traffic::schedule::Mirror();
+      _last_checked_version = rmf_utils::nullopt;
+    }
+
+    // The patch and the view hold their own references to the routes, so they
+    // stay valid after the database is unlocked.
+    const auto query_all = rmf_traffic::schedule::query_all();
+    _next_patch = database.changes(query_all, _last_checked_version);
+    _view_changes = _last_checked_version ?
+      database.query(query_all, *_last_checked_version) :
+      database.query(query_all);
+  }
+
+  /// Update the mirror with the changes that were copied out last, and find
+  /// the participants whose itineraries conflict with those changes. The
+  /// database does not need to be locked. If the mirror cannot be updated, an
+  /// exception is thrown and the same changes will be copied out again.
+  std::vector<ConflictSet> check()
+  {
+    assert(_next_patch);
+    _mirror.update(*_next_patch);
+    _last_checked_version = _next_patch->latest_version();
+    _next_patch = rmf_utils::nullopt;
+
+    return get_conflicts(_view_changes, _mirror);
+  }
+
+  /// The latest version of the database that has been checked
+  const rmf_utils::optional<Version>& last_checked_version() const
+  {
+    return _last_checked_version;
+  }
+
+  /// Find the participants in the viewer whose itineraries conflict with the
+  /// changes.
+  static std::vector<ConflictSet> get_conflicts(
+    const rmf_traffic::schedule::Viewer::View& view_changes,
+    const rmf_traffic::schedule::ItineraryViewer& viewer)
+  {
+    std::vector<ConflictSet> conflicts;
+    const auto& participants = viewer.participant_ids();
+    for (const auto participant : participants)
+    {
+      const auto itinerary = *viewer.get_itinerary(participant);
+      const auto& description = *viewer.get_participant(participant);
+      for (auto vc = view_changes.begin(); vc != view_changes.end(); ++vc)
+      {
+        if (vc->participant == participant)
+        {
+          // There's no need to check a participant against itself
+          continue;
+        }
+
+        for (const auto& route : itinerary)
+        {
+          assert(route);
+          if (route->map() != vc->route.map())
+            continue;
+
+          if (rmf_traffic::DetectConflict::between(
+              vc->description.profile(),
+              vc->route.trajectory(),
+              description.profile(),
+              route->trajectory()))
+          {
+            conflicts.push_back({participant, vc->participant});
+          }
+        }
+      }
+    }
+
+    return conflicts;
+  }
+
+private:
+  rmf_traffic::schedule::Mirror _mirror;
+
+  // The first patch is a full update, since a database that was recovered from
+  // disk does not have the history from version 0.
+  rmf_utils::optional<Version> _last_checked_version;
+
+  rmf_utils::optional<rmf_traffic::schedule::Patch> _next_patch;
+  rmf_traffic::schedule::Viewer::View _view_changes;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__CONFLICTCHECK_HPP
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "EntryJournal.hpp"
+
+#include <rmf_traffic_ros2/Route.hpp>
+#include <rmf_traffic_ros2/schedule/ParticipantDescription.hpp>
+#include <rmf_traffic_ros2/schedule/Query.hpp>
+#include <rmf_traffic_ros2/schedule/Writer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+namespace {
+
+using Entry = rmf_traffic_msgs::msg::ScheduleJournalEntry;
+
+//==============================================================================
+rmf_traffic::Time to_time(int64_t nanoseconds)
+{
+  return rmf_traffic::Time(rmf_traffic::Duration(nanoseconds));
+}
+
+} // anonymous namespace
+
+//==============================================================================
+rmf_traffic_msgs::msg::ScheduleCheckpoint convert(
+  const rmf_traffic::schedule::Database::Checkpoint& checkpoint,
+  const ScheduleState::QueryMap& queries,
+  uint64_t last_query_id)
+{
+  rmf_traffic_msgs::msg::ScheduleCheckpoint msg;
+  msg.version = checkpoint.version;
+  msg.next_participant_id = checkpoint.next_participant_id;
+  msg.participants.reserve(checkpoint.participants.size());
+  for (const auto& p : checkpoint.participants)
+  {
+    rmf_traffic_msgs::msg::ScheduleCheckpointParticipant participant;
+    participant.participant_id = p.id;
+    participant.description = convert(*p.description);
+    participant.expected_itinerary_version = p.expected_itinerary_version;
+    participant.registration_version = p.registration_version;
+    participant.routes.reserve(p.routes.size());
+    for (const auto& r : p.routes)
+    {
+      rmf_traffic_msgs::msg::ScheduleCheckpointRoute route;
+      route.id = r.id;
+      route.route = convert(*r.route);
+      route.version = r.version;
+      participant.routes.emplace_back(std::move(route));
+    }
+
+    msg.participants.emplace_back(std::move(participant));
+  }
+
+  msg.queries.reserve(queries.size());
+  for (const auto& q : queries)
+  {
+    rmf_traffic_msgs::msg::ScheduleCheckpointQuery query;
+    query.query_id = q.first;
+    query.query = convert(q.second);
+    msg.queries.emplace_back(std::move(query));
+  }
+  msg.last_query_id = last_query_id;
+
+  return msg;
+}
+
+//==============================================================================
+ScheduleState restore(const rmf_traffic_msgs::msg::ScheduleCheckpoint& msg)
+{
+  using Database = rmf_traffic::schedule::Database;
+
+  Database::Checkpoint checkpoint;
+  checkpoint.version = msg.version;
+  checkpoint.next_participant_id = msg.next_participant_id;
+  checkpoint.participants.reserve(msg.participants.size());
+  for (const auto& p : msg.participants)
+  {
+    Database::Checkpoint::Participant participant;
+    participant.id = p.participant_id;
+    participant.description =
+      std::make_shared<rmf_traffic::schedule::ParticipantDescription>(
+      convert(p.description));
+    participant.expected_itinerary_version = p.expected_itinerary_version;
+    participant.registration_version = p.registration_version;
+    participant.routes.reserve(p.routes.size());
+    for (const auto& r : p.routes)
+    {
+      participant.routes.push_back(
+        {
+          r.id,
+          std::make_shared<rmf_traffic::Route>(convert(r.route)),
+          r.version
+        });
+    }
+
+    checkpoint.participants.emplace_back(std::move(participant));
+  }
+
+  ScheduleState state;
+  state.database = std::make_shared<Database>(checkpoint);
+  for (const auto& q : msg.queries)
+    state.queries.insert({q.query_id, convert(q.query)});
+
+  state.last_query_id = msg.last_query_id;
+  return state;
+}
+
+//==============================================================================
+void apply(const Entry& entry, ScheduleState& state)
+{
+  auto& db = *state.database;
+  switch (entry.type)
+  {
+    case Entry::TYPE_SET:
+      db.set(entry.participant, convert(entry.routes),
+        entry.itinerary_version);
+      break;
+    case Entry::TYPE_EXTEND:
+      db.extend(entry.participant, convert(entry.routes),
+        entry.itinerary_version);
+      break;
+    case Entry::TYPE_DELAY:
+      db.delay(entry.participant, rmf_traffic::Duration(entry.delay),
+        entry.itinerary_version);
+      break;
+    case Entry::TYPE_ERASE:
+      db.erase(entry.participant, entry.route_ids, entry.itinerary_version);
+      break;
+    case Entry::TYPE_CLEAR:
+      db.erase(entry.participant, entry.itinerary_version);
+      break;
+    case Entry::TYPE_REGISTER_PARTICIPANT:
+    {
+      const auto id = db.register_participant(convert(entry.description));
+      if (id != entry.participant)
+      {
+        throw std::runtime_error(
+                "[rmf_traffic_ros2::schedule::apply] Registered participant ["
+                + std::to_string(id) + "] instead of ["
+                + std::to_string(entry.participant) + "]");
+      }
+      break;
+    }
+    case Entry::TYPE_UNREGISTER_PARTICIPANT:
+      db.set_current_time(to_time(entry.time));
+      db.unregister_participant(entry.participant);
+      break;
+    case Entry::TYPE_CULL:
+      db.cull(to_time(entry.time));
+      break;
+    case Entry::TYPE_REGISTER_QUERY:
+      state.queries.erase(entry.query_id);
+      state.queries.insert({entry.query_id, convert(entry.query)});
+      state.last_query_id = std::max(state.last_query_id, entry.query_id);
+      break;
+    case Entry::TYPE_UNREGISTER_QUERY:
+      state.queries.erase(entry.query_id);
+      break;
+    default:
+      throw std::runtime_error(
+              "[rmf_traffic_ros2::schedule::apply] Unknown journal entry type ["
+              + std::to_string(entry.type) + "]");
+  }
+}
+
+//==============================================================================
+void EntryJournal::add_sink(Sink sink)
+{
+  _sinks.emplace_back(std::move(sink));
+}
+
+//==============================================================================
+void EntryJournal::register_query(
+  uint64_t query_id,
+  const rmf_traffic::schedule::Query& query)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_REGISTER_QUERY;
+  entry.query_id = query_id;
+  entry.query = convert(query);
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::unregister_query(uint64_t query_id)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_UNREGISTER_QUERY;
+  entry.query_id = query_id;
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::set(
+  ParticipantId participant,
+  const Input& itinerary,
+  ItineraryVersion version)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_SET;
+  entry.participant = participant;
+  entry.itinerary_version = version;
+  entry.routes = convert(itinerary);
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::extend(
+  ParticipantId participant,
+  const Input& routes,
+  ItineraryVersion version)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_EXTEND;
+  entry.participant = participant;
+  entry.itinerary_version = version;
+  entry.routes = convert(routes);
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::delay(
+  ParticipantId participant,
+  rmf_traffic::Duration delay,
+  ItineraryVersion version)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_DELAY;
+  entry.participant = participant;
+  entry.itinerary_version = version;
+  entry.delay = delay.count();
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::erase(
+  ParticipantId participant,
+  ItineraryVersion version)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_CLEAR;
+  entry.participant = participant;
+  entry.itinerary_version = version;
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::erase(
+  ParticipantId participant,
+  const std::vector<rmf_traffic::RouteId>& routes,
+  ItineraryVersion version)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_ERASE;
+  entry.participant = participant;
+  entry.itinerary_version = version;
+  entry.route_ids = routes;
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::register_participant(
+  ParticipantId participant,
+  const rmf_traffic::schedule::ParticipantDescription& description)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_REGISTER_PARTICIPANT;
+  entry.participant = participant;
+  entry.description = convert(description);
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::unregister_participant(
+  ParticipantId participant,
+  rmf_traffic::Time current_time)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_UNREGISTER_PARTICIPANT;
+  entry.participant = participant;
+  entry.time = current_time.time_since_epoch().count();
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::cull(rmf_traffic::Time time)
+{
+  Entry entry;
+  entry.type = Entry::TYPE_CULL;
+  entry.time = time.time_since_epoch().count();
+  _record(entry);
+}
+
+//==============================================================================
+void EntryJournal::_record(const Entry& entry)
+{
+  for (const auto& sink : _sinks)
+    sink(entry);
+}
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
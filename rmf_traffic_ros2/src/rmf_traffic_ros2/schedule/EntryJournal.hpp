@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__ENTRYJOURNAL_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__ENTRYJOURNAL_HPP
+
+#include <rmf_traffic/schedule/Database.hpp>
+
+#include <rmf_traffic_msgs/msg/schedule_checkpoint.hpp>
+#include <rmf_traffic_msgs/msg/schedule_journal_entry.hpp>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// A schedule database along with the queries that mirrors have registered
+/// for it. This is everything that needs to be carried over when the database
+/// is saved to disk or copied to a follower.
+struct ScheduleState
+{
+  using QueryMap = std::unordered_map<uint64_t, rmf_traffic::schedule::Query>;
+
+  std::shared_ptr<rmf_traffic::schedule::Database> database;
+  QueryMap queries;
+  uint64_t last_query_id = 0;
+};
+
+//==============================================================================
+/// Turn a checkpoint of the database and its queries into a message
+rmf_traffic_msgs::msg::ScheduleCheckpoint convert(
+  const rmf_traffic::schedule::Database::Checkpoint& checkpoint,
+  const ScheduleState::QueryMap& queries,
+  uint64_t last_query_id);
+
+//==============================================================================
+/// Restore the database and its queries from a checkpoint message
+ScheduleState restore(const rmf_traffic_msgs::msg::ScheduleCheckpoint& msg);
+
+//==============================================================================
+/// Apply a journal entry to the state. This throws a std::runtime_error if the
+/// entry does not fit the state.
+void apply(
+  const rmf_traffic_msgs::msg::ScheduleJournalEntry& entry,
+  ScheduleState& state);
+
+//==============================================================================
+/// A Journal that turns every change of the database into a
+/// ScheduleJournalEntry message and passes it to each of its sinks. The
+/// entries are produced in the order that the changes get applied, so
+/// applying them to a copy of the database will reproduce the same versions.
+class EntryJournal : public rmf_traffic::schedule::Database::Journal
+{
+public:
+
+  using Entry = rmf_traffic_msgs::msg::ScheduleJournalEntry;
+  using Sink = std::function<void(const Entry&)>;
+  using ParticipantId = rmf_traffic::schedule::ParticipantId;
+  using ItineraryVersion = rmf_traffic::schedule::ItineraryVersion;
+  using Input = rmf_traffic::schedule::Writer::Input;
+
+  /// Add a sink for the entries. This must not be called while the database
+  /// could be changing.
+  void add_sink(Sink sink);
+
+  /// Record that a mirror has registered a query
+  void register_query(
+    uint64_t query_id,
+    const rmf_traffic::schedule::Query& query);
+
+  /// Record that a mirror has unregistered its query
+  void unregister_query(uint64_t query_id);
+
+  // Documentation inherited from Journal
+  void set(
+    ParticipantId participant,
+    const Input& itinerary,
+    ItineraryVersion version) final;
+
+  // Documentation inherited from Journal
+  void extend(
+    ParticipantId participant,
+    const Input& routes,
+    ItineraryVersion version) final;
+
+  // Documentation inherited from Journal
+  void delay(
+    ParticipantId participant,
+    rmf_traffic::Duration delay,
+    ItineraryVersion version) final;
+
+  // Documentation inherited from Journal
+  void erase(
+    ParticipantId participant,
+    ItineraryVersion version) final;
+
+  // Documentation inherited from Journal
+  void erase(
+    ParticipantId participant,
+    const std::vector<rmf_traffic::RouteId>& routes,
+    ItineraryVersion version) final;
+
+  // Documentation inherited from Journal
+  void register_participant(
+    ParticipantId participant,
+    const rmf_traffic::schedule::ParticipantDescription& description) final;
+
+  // Documentation inherited from Journal
+  void unregister_participant(
+    ParticipantId participant,
+    rmf_traffic::Time current_time) final;
+
+  // Documentation inherited from Journal
+  void cull(rmf_traffic::Time time) final;
+
+private:
+  void _record(const Entry& entry);
+
+  std::vector<Sink> _sinks;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__ENTRYJOURNAL_HPP
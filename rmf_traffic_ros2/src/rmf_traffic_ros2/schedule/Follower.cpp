@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "internal_Follower.hpp"
+
+#include <rmf_traffic_ros2/StandardNames.hpp>
+#include <rmf_traffic_ros2/schedule/Node.hpp>
+#include <rmf_traffic_ros2/schedule/Patch.hpp>
+
+#include <rmf_utils/Modular.hpp>
+
+#include <algorithm>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+ScheduleFollower::ScheduleFollower(const rclcpp::NodeOptions& options)
+: Node("rmf_traffic_schedule_follower", options),
+  checkpoint_request_time(get_clock()->now())
+{
+  max_backlog = static_cast<std::size_t>(
+    declare_parameter<int>("max_backlog", 10000));
+
+  const double history_horizon_sec =
+    declare_parameter<double>("schedule_history_horizon", 600.0);
+  history_horizon = HistoryHorizon(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(std::max(0.0, history_horizon_sec))));
+
+  const double maintenance_period_sec =
+    declare_parameter<double>("schedule_maintenance_period", 60.0);
+  compaction_timer = create_wall_timer(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(std::max(1.0, maintenance_period_sec))),
+    [=]() { this->compact(); });
+
+  checkpoint_client = create_client<GetScheduleCheckpoint>(
+    rmf_traffic_ros2::ScheduleCheckpointServiceName);
+
+  journal_sub = create_subscription<JournalEntry>(
+    rmf_traffic_ros2::ScheduleJournalTopicName,
+    rclcpp::SystemDefaultsQoS().reliable().keep_last(1000),
+    [=](const JournalEntry::UniquePtr msg)
+    {
+      this->receive_entry(*msg);
+    });
+
+  mirror_update_service = create_service<MirrorUpdate>(
+    "~/" + rmf_traffic_ros2::MirrorUpdateServiceName,
+    [=](const request_id_ptr request_header,
+    const MirrorUpdate::Request::SharedPtr request,
+    const MirrorUpdate::Response::SharedPtr response)
+    {
+      this->mirror_update(request_header, request, response);
+    });
+
+  mirror_wakeup_publisher = create_publisher<MirrorWakeup>(
+    "~/" + rmf_traffic_ros2::MirrorWakeupTopicName,
+    rclcpp::SystemDefaultsQoS());
+
+  // Keep asking for a checkpoint until the schedule node is available, and ask
+  // again if a request goes unanswered for too long.
+  checkpoint_timer = create_wall_timer(
+    std::chrono::seconds(1), [=]()
+    {
+      if (synced)
+        return;
+
+      const auto waited = get_clock()->now() - checkpoint_request_time;
+      if (waiting_for_checkpoint && waited < rclcpp::Duration(10, 0))
+        return;
+
+      this->request_checkpoint();
+    });
+
+  RCLCPP_INFO(
+    get_logger(),
+    "Providing mirror updates on [" + std::string(get_fully_qualified_name())
+    + "/" + rmf_traffic_ros2::MirrorUpdateServiceName + "]");
+}
+
+//==============================================================================
+void ScheduleFollower::receive_entry(const JournalEntry& entry)
+{
+  if (!synced)
+  {
+    if (backlog.size() >= max_backlog)
+    {
+      // The checkpoint will cover the entries that we drop here. If it does
+      // not, the gap will be noticed and we will ask for another checkpoint.
+      backlog.clear();
+    }
+
+    backlog.push_back(entry);
+    if (!waiting_for_checkpoint)
+      request_checkpoint();
+
+    return;
+  }
+
+  if (entry.session != session)
+  {
+    RCLCPP_INFO(
+      get_logger(),
+      "The schedule node has restarted. Requesting a new checkpoint.");
+    resync(entry);
+    return;
+  }
+
+  if (entry.sequence <= sequence)
+  {
+    // This entry was already included in the checkpoint
+    return;
+  }
+
+  if (entry.sequence != sequence + 1)
+  {
+    RCLCPP_WARN(
+      get_logger(),
+      "Missed schedule journal entries [" + std::to_string(sequence + 1)
+      + "] to [" + std::to_string(entry.sequence - 1)
+      + "]. Requesting a new checkpoint.");
+    resync(entry);
+    return;
+  }
+
+  const auto version = state.database->latest_version();
+  try
+  {
+    apply(entry, state);
+  }
+  catch (const std::exception& e)
+  {
+    RCLCPP_ERROR(
+      get_logger(),
+      std::string("Failed to apply a schedule journal entry: ") + e.what()
+      + ". Requesting a new checkpoint.");
+    synced = false;
+    backlog.clear();
+    request_checkpoint();
+    return;
+  }
+
+  sequence = entry.sequence;
+  if (state.database->latest_version() != version)
+    wakeup_mirrors();
+}
+
+//==============================================================================
+void ScheduleFollower::request_checkpoint()
+{
+  if (!checkpoint_client->service_is_ready())
+    return;
+
+  const uint64_t request_id = ++checkpoint_request;
+  waiting_for_checkpoint = true;
+  checkpoint_request_time = get_clock()->now();
+
+  checkpoint_client->async_send_request(
+    std::make_shared<GetScheduleCheckpoint::Request>(),
+    [=](const rclcpp::Client<GetScheduleCheckpoint>::SharedFuture response)
+    {
+      if (request_id != checkpoint_request)
+        return;
+
+      this->receive_checkpoint(*response.get());
+    });
+}
+
+//==============================================================================
+void ScheduleFollower::receive_checkpoint(
+  const GetScheduleCheckpoint::Response& response)
+{
+  waiting_for_checkpoint = false;
+
+  try
+  {
+    state = restore(response.checkpoint);
+  }
+  catch (const std::exception& e)
+  {
+    RCLCPP_ERROR(
+      get_logger(),
+      std::string("Failed to restore the schedule checkpoint: ") + e.what());
+    return;
+  }
+
+  session = response.session;
+  sequence = response.journal_sequence;
+  synced = true;
+  history_horizon.clear();
+
+  RCLCPP_INFO(
+    get_logger(),
+    "Following schedule version ["
+    + std::to_string(state.database->latest_version()) + "] with ["
+    + std::to_string(state.database->participant_ids().size())
+    + "] participants");
+
+  const auto pending = std::move(backlog);
+  backlog.clear();
+  for (const auto& entry : pending)
+  {
+    // Entries from before a restart of the schedule node are stale
+    if (entry.session != session)
+      continue;
+
+    receive_entry(entry);
+    if (!synced)
+      return;
+  }
+
+  wakeup_mirrors();
+}
+
+//==============================================================================
+void ScheduleFollower::resync(const JournalEntry& entry)
+{
+  // Keep serving the old copy of the schedule until the new one arrives
+  synced = false;
+  backlog.clear();
+  backlog.push_back(entry);
+  request_checkpoint();
+}
+
+//==============================================================================
+void ScheduleFollower::compact()
+{
+  if (!synced)
+    return;
+
+  const auto horizon = history_horizon.update(
+    std::chrono::steady_clock::now(), state.database->latest_version());
+  if (!horizon)
+    return;
+
+  const std::size_t discarded = state.database->compact(*horizon);
+  if (discarded > 0)
+  {
+    RCLCPP_DEBUG(
+      get_logger(),
+      "Discarded [" + std::to_string(discarded)
+      + "] entries of old schedule history");
+  }
+}
+
+//==============================================================================
+void ScheduleFollower::mirror_update(
+  const request_id_ptr& /*request_header*/,
+  const MirrorUpdate::Request::SharedPtr& request,
+  const MirrorUpdate::Response::SharedPtr& response)
+{
+  if (!state.database)
+  {
+    response->error = "The follower has not received the schedule yet";
+    return;
+  }
+
+  const auto query_it = state.queries.find(request->query_id);
+  if (query_it == state.queries.end())
+  {
+    // The query may have been registered so recently that its journal entry
+    // has not arrived yet, so the mirror should simply try again later.
+    response->error = "Unrecognized query_id: "
+      + std::to_string(request->query_id);
+    return;
+  }
+
+  rmf_utils::optional<rmf_traffic::schedule::Version> version;
+  if (!request->initial_request)
+    version = request->latest_mirror_version;
+
+  if (version && rmf_utils::modular(*version).less_than(
+      state.database->oldest_version()))
+  {
+    version = rmf_utils::nullopt;
+    response->full_update = true;
+  }
+
+  response->patch = rmf_traffic_ros2::convert(
+    state.database->changes(query_it->second, version));
+}
+
+//==============================================================================
+void ScheduleFollower::wakeup_mirrors()
+{
+  MirrorWakeup msg;
+  msg.latest_version = state.database->latest_version();
+  mirror_wakeup_publisher->publish(msg);
+}
+
+//==============================================================================
+std::shared_ptr<rclcpp::Node> make_follower_node(
+  const rclcpp::NodeOptions& options)
+{
+  return std::make_shared<ScheduleFollower>(options);
+}
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__HISTORYHORIZON_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__HISTORYHORIZON_HPP
+
+#include <rmf_traffic/schedule/Version.hpp>
+
+#include <rmf_utils/optional.hpp>
+
+#include <chrono>
+#include <deque>
+#include <utility>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// Keeps track of when the schedule reached each version, so that the history
+/// of changes can be compacted up to the version that was the latest one a
+/// certain amount of time ago. Mirrors that have not been updated within that
+/// amount of time will need a full update.
+class HistoryHorizon
+{
+public:
+
+  using Clock = std::chrono::steady_clock;
+  using Version = rmf_traffic::schedule::Version;
+
+  HistoryHorizon(std::chrono::nanoseconds duration = std::chrono::hours(1))
+  : _duration(duration)
+  {
+    // Do nothing
+  }
+
+  /// Record the latest version of the schedule, and get the version that was
+  /// the latest one at the start of the horizon, if that is known yet.
+  rmf_utils::optional<Version> update(Clock::time_point now, Version latest)
+  {
+    rmf_utils::optional<Version> horizon;
+    while (!_versions.empty() && _versions.front().first + _duration <= now)
+    {
+      horizon = _versions.front().second;
+      _versions.pop_front();
+    }
+
+    _versions.emplace_back(now, latest);
+    return horizon;
+  }
+
+  /// Forget the recorded versions. This should be used when the schedule
+  /// gets replaced by a different copy.
+  void clear()
+  {
+    _versions.clear();
+  }
+
+private:
+  std::chrono::nanoseconds _duration;
+  std::deque<std::pair<Clock::time_point, Version>> _versions;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__HISTORYHORIZON_HPP
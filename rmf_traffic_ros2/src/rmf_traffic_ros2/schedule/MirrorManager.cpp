@@ -41,6 +41,19 @@ using UnregisterQueryClient = rclcpp::Client<UnregisterQuery>::SharedPtr;
 using MirrorWakeup = rmf_traffic_msgs::msg::MirrorWakeup;
 using MirrorWakeupSub = rclcpp::Subscription<MirrorWakeup>::SharedPtr;
 
+//==============================================================================
+/// Get the name of a topic or service that the mirror gets its updates from.
+/// Followers provide these in their own private namespace.
+std::string mirror_name(
+  const MirrorManager::Options& options,
+  const std::string& name)
+{
+  if (options.follower().empty())
+    return name;
+
+  return options.follower() + "/" + name;
+}
+
 //==============================================================================
 class MirrorManager::Implementation
 {
@@ -75,7 +88,7 @@ public:
     mirror(std::make_shared<rmf_traffic::schedule::Mirror>())
   {
     mirror_wakeup_sub = node.create_subscription<MirrorWakeup>(
-      MirrorWakeupTopicName, rclcpp::SystemDefaultsQoS(),
+      mirror_name(options, MirrorWakeupTopicName), rclcpp::SystemDefaultsQoS(),
       [&](const MirrorWakeup::SharedPtr msg)
       {
         trigger_wakeup(msg->latest_version);
@@ -114,9 +127,25 @@ public:
 
     const auto future = mirror_update_client->async_send_request(
       request_msg,
-      [&](const MirrorUpdateFuture response_future)
+      [&, was_initial = request_msg->initial_request](
+        const MirrorUpdateFuture response_future)
       {
         const auto response = response_future.get();
+        if (!response->error.empty())
+        {
+          // Nothing gets applied, so try again on the next wakeup. This can
+          // happen when a follower has not caught up to the query yet.
+          RCLCPP_WARN(
+            node.get_logger(),
+            "[rmf_traffic_ros2::MirrorManager] Failed to update the mirror: "
+            + response->error);
+
+          if (was_initial)
+            initial_request = true;
+
+          waiting_for_reply = false;
+          return;
+        }
 
         try
         {
@@ -129,15 +158,25 @@ public:
             + std::to_string(response->patch.latest_version)
             + "]: " + std::to_string(patch.size()) + " changes");
 
+          // A full update replaces everything that the mirror has, e.g. after
+          // the schedule node was restored from a checkpoint.
+          const auto apply = [&]()
+            {
+              if (response->full_update)
+                *mirror = rmf_traffic::schedule::Mirror();
+
+              mirror->update(patch);
+            };
+
           std::mutex* update_mutex = options.update_mutex();
           if (update_mutex)
           {
             std::lock_guard<std::mutex> lock(*update_mutex);
-            mirror->update(patch);
+            apply();
           }
           else
           {
-            mirror->update(patch);
+            apply();
           }
 
           waiting_for_reply = false;
@@ -185,6 +224,8 @@ public:
 
   bool update_on_wakeup;
 
+  std::string follower;
+
 };
 
 //==============================================================================
@@ -194,7 +235,8 @@ MirrorManager::Options::Options(
 : _pimpl(rmf_utils::make_impl<Implementation>(
       Implementation{
         update_mutex,
-        update_on_wakeup
+        update_on_wakeup,
+        ""
       }))
 {
   // Do nothing
@@ -226,6 +268,19 @@ auto MirrorManager::Options::update_on_wakeup(bool choice) -> Options&
   return *this;
 }
 
+//==============================================================================
+const std::string& MirrorManager::Options::follower() const
+{
+  return _pimpl->follower;
+}
+
+//==============================================================================
+auto MirrorManager::Options::follower(std::string node_name) -> Options&
+{
+  _pimpl->follower = std::move(node_name);
+  return *this;
+}
+
 //==============================================================================
 const rmf_traffic::schedule::Viewer& MirrorManager::viewer() const
 {
@@ -301,8 +356,8 @@ public:
     register_query_client =
       node.create_client<RegisterQuery>(RegisterQueryServiceName);
 
-    mirror_update_client =
-      node.create_client<MirrorUpdate>(MirrorUpdateServiceName);
+    mirror_update_client = node.create_client<MirrorUpdate>(
+      mirror_name(options, MirrorUpdateServiceName));
 
     unregister_query_client =
       node.create_client<UnregisterQuery>(UnregisterQueryServiceName);
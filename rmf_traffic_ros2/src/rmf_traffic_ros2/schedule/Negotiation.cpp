@@ -16,6 +16,7 @@
 */
 
 #include "NegotiationRoom.hpp"
+#include "ResponseQueue.hpp"
 
 #include <rmf_traffic_ros2/Route.hpp>
 #include <rmf_traffic_ros2/schedule/Itinerary.hpp>
@@ -212,6 +213,7 @@ public:
   rclcpp::Node& node;
   std::shared_ptr<const rmf_traffic::schedule::Snappable> viewer;
   std::shared_ptr<Worker> worker;
+  std::unique_ptr<ThreadPool> response_pool;
   rmf_traffic::Duration timeout = std::chrono::seconds(15);
 
   using Repeat = rmf_traffic_msgs::msg::NegotiationRepeat;
@@ -422,45 +424,26 @@ public:
       std::vector<TablePtr> queue,
       Version conflict_version)
   {
-    while (!queue.empty())
-    {
-      const auto top = queue.back();
-      queue.pop_back();
-
-      if (top->defunct())
-        continue;
-
-      if (!top->submission())
+    // The pool is only used when the negotiation is synchronous. With a
+    // worker, the negotiators respond asynchronously instead.
+    ResponseQueue(
+      [this](const ParticipantId p) -> rmf_traffic::schedule::Negotiator*
       {
-        const auto n_it = negotiators->find(top->participant());
+        const auto n_it = negotiators->find(p);
         if (n_it == negotiators->end())
-          continue;
-
-        // TODO(MXG): Make this limit configurable
-        if (top->version() > 3)
-        {
-          // Give up on this table at this point to avoid an infinite loop
-          top->forfeit(top->version());
-          publish_forfeit(conflict_version, *top);
-          continue;
-        }
+          return nullptr;
 
-        const auto& negotiator = n_it->second;
-        negotiator->respond(
-              top->viewer(), Responder::make(this, conflict_version, top));
-      }
-
-      if (top->submission())
+        return n_it->second.get();
+      },
+      [this, conflict_version](const TablePtr& table)
       {
-        for (const auto& c : top->children())
-          queue.push_back(c);
-      }
-      else if (const auto& parent = top->parent())
+        return Responder::make(this, conflict_version, table);
+      },
+      [this, conflict_version](const TablePtr& table)
       {
-        if (parent->rejected())
-          queue.push_back(parent);
-      }
-    }
+        publish_forfeit(conflict_version, *table);
+      },
+      worker ? nullptr : response_pool.get()).respond(std::move(queue));
   }
 
   void receive_notice(const Notice& msg)
@@ -1080,6 +1063,26 @@ rmf_traffic::Duration Negotiation::timeout_duration() const
   return _pimpl->timeout;
 }
 
+//==============================================================================
+Negotiation& Negotiation::parallel_responses(const std::size_t num_threads)
+{
+  if (num_threads == 0)
+    _pimpl->response_pool = nullptr;
+  else
+    _pimpl->response_pool = std::make_unique<ThreadPool>(num_threads);
+
+  return *this;
+}
+
+//==============================================================================
+std::size_t Negotiation::parallel_responses() const
+{
+  if (!_pimpl->response_pool)
+    return 0;
+
+  return _pimpl->response_pool->size();
+}
+
 //==============================================================================
 Negotiation::TableViewPtr Negotiation::table_view(
     uint64_t conflict_version,
@@ -16,6 +16,7 @@
 */
 
 #include "internal_Node.hpp"
+#include "ConflictCheck.hpp"
 
 #include <cstring>
 
@@ -30,60 +31,18 @@
 #include <rmf_traffic_ros2/schedule/ParticipantDescription.hpp>
 #include <rmf_traffic_ros2/schedule/Inconsistencies.hpp>
 
-#include <rmf_traffic/DetectConflict.hpp>
-#include <rmf_traffic/schedule/Mirror.hpp>
-
 #include <rmf_utils/optional.hpp>
 
 #include <unordered_map>
+#include <unordered_set>
 
 namespace rmf_traffic_ros2 {
 namespace schedule {
 
-//==============================================================================
-std::vector<ScheduleNode::ConflictSet> get_conflicts(
-  const rmf_traffic::schedule::Viewer::View& view_changes,
-  const rmf_traffic::schedule::ItineraryViewer& viewer)
-{
-  std::vector<ScheduleNode::ConflictSet> conflicts;
-  const auto& participants = viewer.participant_ids();
-  for (const auto participant : participants)
-  {
-    const auto itinerary = *viewer.get_itinerary(participant);
-    const auto& description = *viewer.get_participant(participant);
-    for (auto vc = view_changes.begin(); vc != view_changes.end(); ++vc)
-    {
-      if (vc->participant == participant)
-      {
-        // There's no need to check a participant against itself
-        continue;
-      }
-
-      for (const auto& route : itinerary)
-      {
-        assert(route);
-        if (route->map() != vc->route.map())
-          continue;
-
-        if (rmf_traffic::DetectConflict::between(
-            vc->description.profile(),
-            vc->route.trajectory(),
-            description.profile(),
-            route->trajectory()))
-        {
-          conflicts.push_back({participant, vc->participant});
-        }
-      }
-    }
-  }
-
-  return conflicts;
-}
-
 //==============================================================================
 ScheduleNode::ScheduleNode(const rclcpp::NodeOptions& options)
 : Node("rmf_traffic_schedule_node", options),
-  database(std::make_shared<rmf_traffic::schedule::Database>()),
+  database(recover_database()),
   active_conflicts(database)
 {
   // TODO(MXG): As soon as possible, all of these services should be made
@@ -129,6 +88,105 @@ ScheduleNode::ScheduleNode(const rclcpp::NodeOptions& options)
     const MirrorUpdate::Response::SharedPtr response)
     { this->mirror_update(request_header, request, response); });
 
+  const double batch_window_sec =
+    declare_parameter<double>("writer_batch_window", 0.0);
+  writer_batch_window = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(std::max(0.0, batch_window_sec)));
+
+  if (writer_batch_window > std::chrono::nanoseconds(0))
+  {
+    RCLCPP_INFO(
+      get_logger(),
+      "Itinerary changes will be applied in batches every ["
+      + std::to_string(batch_window_sec) + "] seconds");
+
+    batch_timer = create_wall_timer(
+      writer_batch_window, [=]() { this->flush_changes(); });
+    batch_timer->cancel();
+  }
+
+  const double retention_sec =
+    declare_parameter<double>("schedule_retention", 600.0);
+  schedule_retention = std::chrono::duration_cast<rmf_traffic::Duration>(
+    std::chrono::duration<double>(std::max(0.0, retention_sec)));
+
+  const double history_horizon_sec =
+    declare_parameter<double>("schedule_history_horizon", 600.0);
+  history_horizon = HistoryHorizon(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(std::max(0.0, history_horizon_sec))));
+
+  max_staged_changes = static_cast<std::size_t>(
+    std::max(1, declare_parameter<int>("schedule_max_staged_changes", 1000)));
+
+  const double maintenance_period_sec =
+    declare_parameter<double>("schedule_maintenance_period", 60.0);
+  maintenance_timer = create_wall_timer(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(std::max(1.0, maintenance_period_sec))),
+    [=]() { this->maintain_database(); });
+
+  if (persistence)
+  {
+    const double checkpoint_period_sec =
+      declare_parameter<double>("schedule_checkpoint_period", 60.0);
+
+    journal = std::make_shared<EntryJournal>();
+    journal->add_sink(
+      [persistence = persistence](const JournalEntry& entry)
+      {
+        persistence->append(entry);
+      });
+
+    last_checkpoint_version = database->latest_version();
+    checkpoint_timer = create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(std::max(1.0, checkpoint_period_sec))),
+      [=]() { this->checkpoint(); });
+  }
+
+  if (declare_parameter<bool>("schedule_replication", false))
+  {
+    RCLCPP_INFO(
+      get_logger(),
+      "Publishing schedule changes for followers on ["
+      + rmf_traffic_ros2::ScheduleJournalTopicName + "]");
+
+    // Followers must never mistake the entries of a restarted schedule node
+    // for a continuation of the entries that they already have.
+    journal_session = static_cast<uint64_t>(
+      std::chrono::system_clock::now().time_since_epoch().count());
+
+    if (!journal)
+      journal = std::make_shared<EntryJournal>();
+
+    journal_pub = create_publisher<JournalEntry>(
+      rmf_traffic_ros2::ScheduleJournalTopicName,
+      rclcpp::SystemDefaultsQoS().reliable().keep_last(1000));
+
+    journal->add_sink(
+      [=](const JournalEntry& entry)
+      {
+        auto msg = entry;
+        msg.session = journal_session;
+        msg.sequence = ++journal_sequence;
+        journal_pub->publish(std::move(msg));
+      });
+
+    get_schedule_checkpoint_service =
+      create_service<GetScheduleCheckpoint>(
+      rmf_traffic_ros2::ScheduleCheckpointServiceName,
+      [=](const request_id_ptr request_header,
+      const GetScheduleCheckpoint::Request::SharedPtr request,
+      const GetScheduleCheckpoint::Response::SharedPtr response)
+      {
+        this->get_schedule_checkpoint(request_header, request, response);
+      });
+  }
+
+  if (journal)
+    database->set_journal(journal);
+
   mirror_wakeup_publisher =
     create_publisher<MirrorWakeup>(
     rmf_traffic_ros2::MirrorWakeupTopicName,
@@ -230,49 +288,40 @@ ScheduleNode::ScheduleNode(const rclcpp::NodeOptions& options)
   conflict_check_thread = std::thread(
     [&]()
     {
-      rmf_traffic::schedule::Mirror mirror;
-      const auto query_all = rmf_traffic::schedule::query_all();
-      Version last_checked_version = 0;
-
+      ConflictCheck conflict_check;
       while (rclcpp::ok(get_node_options().context()) && !conflict_check_quit)
       {
-        rmf_utils::optional<rmf_traffic::schedule::Patch> next_patch;
-        rmf_traffic::schedule::Viewer::View view_changes;
-
         // Use this scope to minimize how long we lock the database for
         {
           std::unique_lock<std::mutex> lock(database_mutex);
           conflict_check_cv.wait_for(lock, std::chrono::milliseconds(100), [&]()
           {
-            return (database->latest_version() > last_checked_version)
+            return conflict_check.has_new_changes(*database)
             && !conflict_check_quit;
           });
 
-          if (database->latest_version() == last_checked_version
-          || conflict_check_quit)
+          if (!conflict_check.has_new_changes(*database) || conflict_check_quit)
           {
             // This is a casual wakeup to check if we're supposed to quit yet
             continue;
           }
 
-          next_patch = database->changes(query_all, last_checked_version);
+          // Only copy out what we need while the database is locked. The
+          // mirror gets updated after the writers have been let back in.
+          conflict_check.copy_changes(*database);
+        }
 
-          // TODO(MXG): Check whether the database really needs to remain locked
-          // during this update.
-          try
-          {
-            mirror.update(*next_patch);
-            view_changes = database->query(query_all, last_checked_version);
-            last_checked_version = next_patch->latest_version();
-          }
-          catch (const std::exception& e)
-          {
-            RCLCPP_ERROR(get_logger(), e.what());
-            continue;
-          }
+        std::vector<ConflictSet> conflicts;
+        try
+        {
+          conflicts = conflict_check.check();
+        }
+        catch (const std::exception& e)
+        {
+          RCLCPP_ERROR(get_logger(), e.what());
+          continue;
         }
 
-        const auto conflicts = get_conflicts(view_changes, mirror);
         std::unordered_map<Version, const Negotiation*> new_negotiations;
         for (const auto& conflict : conflicts)
         {
@@ -304,6 +353,103 @@ ScheduleNode::~ScheduleNode()
   conflict_check_quit = true;
   if (conflict_check_thread.joinable())
     conflict_check_thread.join();
+
+  if (checkpoint_write.valid())
+    checkpoint_write.wait();
+}
+
+//==============================================================================
+std::shared_ptr<rmf_traffic::schedule::Database>
+ScheduleNode::recover_database()
+{
+  const std::string directory =
+    declare_parameter<std::string>("schedule_persistence_dir", "");
+  if (directory.empty())
+    return std::make_shared<rmf_traffic::schedule::Database>();
+
+  persistence = std::make_shared<Persistence>(directory);
+  auto recovery = persistence->recover();
+  registered_queries = std::move(recovery.queries);
+  last_query_id = recovery.last_query_id;
+
+  RCLCPP_INFO(
+    get_logger(),
+    "Recovered schedule version [" + std::to_string(
+      recovery.database->latest_version()) + "] with ["
+    + std::to_string(recovery.database->participant_ids().size())
+    + "] participants and [" + std::to_string(registered_queries.size())
+    + "] queries from [" + directory + "] after replaying ["
+    + std::to_string(recovery.journal_entries) + "] journal entries");
+
+  return recovery.database;
+}
+
+//==============================================================================
+void ScheduleNode::checkpoint()
+{
+  if (checkpoint_write.valid()
+    && checkpoint_write.wait_for(std::chrono::seconds(0))
+    != std::future_status::ready)
+  {
+    // The last checkpoint is still being written
+    return;
+  }
+
+  rmf_traffic::schedule::Database::Checkpoint checkpoint;
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+    if (database->latest_version() == last_checkpoint_version)
+      return;
+
+    // Start the new journal while the database is still locked so that no
+    // change can slip in between the checkpoint and the journal.
+    checkpoint = database->checkpoint();
+    persistence->rotate(checkpoint.version);
+  }
+
+  last_checkpoint_version = checkpoint.version;
+  checkpoint_write = std::async(
+    std::launch::async,
+    [persistence = persistence,
+    checkpoint = std::move(checkpoint),
+    queries = registered_queries,
+    last_query_id = last_query_id,
+    logger = get_logger()]()
+    {
+      try
+      {
+        persistence->write_checkpoint(checkpoint, queries, last_query_id);
+      }
+      catch (const std::exception& e)
+      {
+        RCLCPP_ERROR(
+          logger,
+          std::string("Failed to write a schedule checkpoint: ") + e.what());
+      }
+    });
+}
+
+//==============================================================================
+void ScheduleNode::get_schedule_checkpoint(
+  const request_id_ptr& /*request_header*/,
+  const GetScheduleCheckpoint::Request::SharedPtr& /*request*/,
+  const GetScheduleCheckpoint::Response::SharedPtr& response)
+{
+  rmf_traffic::schedule::Database::Checkpoint checkpoint;
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+    checkpoint = database->checkpoint();
+    response->journal_sequence = journal_sequence;
+  }
+
+  response->session = journal_session;
+  response->checkpoint =
+    convert(checkpoint, registered_queries, last_query_id);
+
+  RCLCPP_INFO(
+    get_logger(),
+    "Sent a checkpoint of schedule version ["
+    + std::to_string(checkpoint.version) + "] to a follower");
 }
 
 //==============================================================================
@@ -331,9 +477,12 @@ void ScheduleNode::register_query(
   } while (registered_queries.find(query_id) != registered_queries.end());
 
   last_query_id = query_id;
-  registered_queries.insert(
+  const auto inserted = registered_queries.insert(
     std::make_pair(query_id, rmf_traffic_ros2::convert(request->query)));
 
+  if (journal)
+    journal->register_query(query_id, inserted.first->second);
+
   response->query_id = query_id;
   RCLCPP_INFO(
     get_logger(),
@@ -362,6 +511,9 @@ void ScheduleNode::unregister_query(
   registered_queries.erase(it);
   response->confirmation = true;
 
+  if (journal)
+    journal->unregister_query(request->query_id);
+
   RCLCPP_INFO(
     get_logger(),
     "[" + std::to_string(request->query_id) + "] Unregistered query");
@@ -425,6 +577,9 @@ void ScheduleNode::unregister_participant(
     const std::string name = p->name();
     const std::string owner = p->owner();
 
+    // The database uses the current time to decide when the record of this
+    // participant can be culled.
+    database->set_current_time(rmf_traffic_ros2::convert(get_clock()->now()));
     database->unregister_participant(request->participant_id);
     response->confirmation = true;
 
@@ -444,6 +599,83 @@ void ScheduleNode::unregister_participant(
   }
 }
 
+//==============================================================================
+void ScheduleNode::maintain_database()
+{
+  std::size_t discarded = 0;
+  bool culled = false;
+  std::vector<ParticipantId> dropped;
+  std::vector<rmf_traffic::schedule::Database::Footprint> footprints;
+  {
+    std::lock_guard<std::mutex> lock(database_mutex);
+
+    // The database keeps its version when there is nothing older than the
+    // cutoff, in which case the mirrors do not need to be woken up.
+    if (schedule_retention > rmf_traffic::Duration(0))
+    {
+      const auto previous_version = database->latest_version();
+      culled = database->cull(
+        rmf_traffic_ros2::convert(get_clock()->now()) - schedule_retention)
+        != previous_version;
+    }
+
+    const auto horizon = history_horizon.update(
+      std::chrono::steady_clock::now(), database->latest_version());
+    if (horizon)
+      discarded = database->compact(*horizon);
+
+    dropped = database->drop_staged_changes(max_staged_changes);
+    for (const auto p : dropped)
+      publish_inconsistencies(p);
+
+    footprints = database->footprint();
+
+    if (culled)
+      wakeup_mirrors();
+  }
+
+  for (const auto p : dropped)
+  {
+    RCLCPP_WARN(
+      get_logger(),
+      "Participant [" + std::to_string(p) + "] had more than ["
+      + std::to_string(max_staged_changes) + "] itinerary changes waiting "
+      "on an inconsistency. They have been dropped and will need to be "
+      "retransmitted.");
+  }
+
+  std::size_t route_entries = 0;
+  std::size_t bytes = 0;
+  for (const auto& f : footprints)
+  {
+    route_entries += f.route_entries;
+    bytes += f.bytes;
+
+    RCLCPP_DEBUG(
+      get_logger(),
+      "Participant [" + std::to_string(f.participant) + "] has ["
+      + std::to_string(f.active_routes) + "] active routes, ["
+      + std::to_string(f.route_entries) + "] route entries, ["
+      + std::to_string(f.staged_changes) + "] staged changes, and uses about ["
+      + std::to_string(f.bytes / 1024) + "] KiB");
+  }
+
+  const std::string summary =
+    "The schedule holds [" + std::to_string(route_entries)
+    + "] route entries for [" + std::to_string(footprints.size())
+    + "] participants using about [" + std::to_string(bytes / 1024)
+    + "] KiB after " + (culled ? "culling expired routes and " : "")
+    + "discarding [" + std::to_string(discarded)
+    + "] entries of old history";
+
+  // The per-participant footprints are only for debugging, and the summary is
+  // only worth reporting when maintenance actually threw something away.
+  if (culled || discarded > 0)
+    RCLCPP_INFO(get_logger(), summary);
+  else
+    RCLCPP_DEBUG(get_logger(), summary);
+}
+
 //==============================================================================
 void ScheduleNode::mirror_update(
   const std::shared_ptr<rmw_request_id_t>& /*request_header*/,
@@ -465,6 +697,15 @@ void ScheduleNode::mirror_update(
   if (!request->initial_request)
     version = request->latest_mirror_version;
 
+  if (version && rmf_utils::modular(*version).less_than(
+      database->oldest_version()))
+  {
+    // The database no longer has the history that this mirror needs, so it
+    // gets the whole schedule instead.
+    version = rmf_utils::nullopt;
+    response->full_update = true;
+  }
+
   response->patch =
     rmf_traffic_ros2::convert(database->changes(query_it->second, version));
 }
@@ -472,83 +713,151 @@ void ScheduleNode::mirror_update(
 //==============================================================================
 void ScheduleNode::itinerary_set(const ItinerarySet& set)
 {
-  std::unique_lock<std::mutex> lock(database_mutex);
   assert(!set.itinerary.empty());
-  database->set(
-    set.participant,
-    rmf_traffic_ros2::convert(set.itinerary),
-    set.itinerary_version);
-
-  publish_inconsistencies(set.participant);
-
-  std::lock_guard<std::mutex> lock2(active_conflicts_mutex);
-  active_conflicts.check(set.participant, set.itinerary_version);
-  wakeup_mirrors();
+  receive_change(
+    {
+      set.participant,
+      [participant = set.participant,
+      itinerary = rmf_traffic_ros2::convert(set.itinerary),
+      version = set.itinerary_version](
+        rmf_traffic::schedule::Database& database)
+      {
+        database.set(participant, itinerary, version);
+        return version;
+      }
+    });
 }
 
 //==============================================================================
 void ScheduleNode::itinerary_extend(const ItineraryExtend& extend)
 {
-  std::unique_lock<std::mutex> lock(database_mutex);
-  database->extend(
-    extend.participant,
-    rmf_traffic_ros2::convert(extend.routes),
-    extend.itinerary_version);
-
-  publish_inconsistencies(extend.participant);
-
-  std::lock_guard<std::mutex> lock2(active_conflicts_mutex);
-  active_conflicts.check(
-    extend.participant, database->itinerary_version(extend.participant));
-  wakeup_mirrors();
+  receive_change(
+    {
+      extend.participant,
+      [participant = extend.participant,
+      routes = rmf_traffic_ros2::convert(extend.routes),
+      version = extend.itinerary_version](
+        rmf_traffic::schedule::Database& database)
+      {
+        database.extend(participant, routes, version);
+        return database.itinerary_version(participant);
+      }
+    });
 }
 
 //==============================================================================
 void ScheduleNode::itinerary_delay(const ItineraryDelay& delay)
 {
-  std::unique_lock<std::mutex> lock(database_mutex);
-  database->delay(
-    delay.participant,
-    rmf_traffic::Duration(delay.delay),
-    delay.itinerary_version);
+  receive_change(
+    {
+      delay.participant,
+      [participant = delay.participant,
+      duration = rmf_traffic::Duration(delay.delay),
+      version = delay.itinerary_version](
+        rmf_traffic::schedule::Database& database)
+      {
+        database.delay(participant, duration, version);
+        return database.itinerary_version(participant);
+      }
+    });
+}
 
-  publish_inconsistencies(delay.participant);
+//==============================================================================
+void ScheduleNode::itinerary_erase(const ItineraryErase& erase)
+{
+  receive_change(
+    {
+      erase.participant,
+      [participant = erase.participant,
+      routes = std::vector<rmf_traffic::RouteId>(
+        erase.routes.begin(), erase.routes.end()),
+      version = erase.itinerary_version](
+        rmf_traffic::schedule::Database& database)
+      {
+        database.erase(participant, routes, version);
+        return database.itinerary_version(participant);
+      }
+    });
+}
 
-  std::lock_guard<std::mutex> lock2(active_conflicts_mutex);
-  active_conflicts.check(
-    delay.participant, database->itinerary_version(delay.participant));
-  wakeup_mirrors();
+//==============================================================================
+void ScheduleNode::itinerary_clear(const ItineraryClear& clear)
+{
+  receive_change(
+    {
+      clear.participant,
+      [participant = clear.participant, version = clear.itinerary_version](
+        rmf_traffic::schedule::Database& database)
+      {
+        database.erase(participant, version);
+        return database.itinerary_version(participant);
+      }
+    });
 }
 
 //==============================================================================
-void ScheduleNode::itinerary_erase(const ItineraryErase& erase)
+void ScheduleNode::receive_change(WriterChange change)
 {
-  std::unique_lock<std::mutex> lock(database_mutex);
-  database->erase(
-    erase.participant,
-    std::vector<rmf_traffic::RouteId>(
-      erase.routes.begin(), erase.routes.end()),
-    erase.itinerary_version);
+  if (!batch_timer)
+    return apply_changes({std::move(change)});
 
-  publish_inconsistencies(erase.participant);
+  // The timer is only armed while a batch is being collected, so the first
+  // change of each batch starts the window.
+  if (pending_changes.empty())
+    batch_timer->reset();
 
-  std::lock_guard<std::mutex> lock2(active_conflicts_mutex);
-  active_conflicts.check(
-    erase.participant, database->itinerary_version(erase.participant));
-  wakeup_mirrors();
+  pending_changes.emplace_back(std::move(change));
 }
 
 //==============================================================================
-void ScheduleNode::itinerary_clear(const ItineraryClear& clear)
+void ScheduleNode::flush_changes()
+{
+  batch_timer->cancel();
+  if (pending_changes.empty())
+    return;
+
+  std::vector<WriterChange> changes;
+  changes.swap(pending_changes);
+  apply_changes(changes);
+}
+
+//==============================================================================
+void ScheduleNode::apply_changes(const std::vector<WriterChange>& changes)
 {
+  std::vector<std::pair<ParticipantId, ItineraryVersion>> updated;
+  updated.reserve(changes.size());
+
   std::unique_lock<std::mutex> lock(database_mutex);
-  database->erase(clear.participant, clear.itinerary_version);
+  for (const auto& change : changes)
+  {
+    try
+    {
+      updated.push_back({change.participant, change.apply(*database)});
+    }
+    catch (const std::exception& e)
+    {
+      RCLCPP_ERROR(
+        get_logger(),
+        "Failed to apply itinerary change for participant ["
+        + std::to_string(change.participant) + "]: " + e.what());
+    }
+  }
+
+  if (updated.empty())
+    return;
 
-  publish_inconsistencies(clear.participant);
+  // Only report the inconsistencies of each participant once per batch
+  std::unordered_set<ParticipantId> reported;
+  for (const auto& u : updated)
+  {
+    if (reported.insert(u.first).second)
+      publish_inconsistencies(u.first);
+  }
 
   std::lock_guard<std::mutex> lock2(active_conflicts_mutex);
-  active_conflicts.check(
-    clear.participant, database->itinerary_version(clear.participant));
+  for (const auto& u : updated)
+    active_conflicts.check(u.first, u.second);
+
   wakeup_mirrors();
 }
 
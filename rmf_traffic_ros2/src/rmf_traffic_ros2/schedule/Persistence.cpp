@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "Persistence.hpp"
+
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+namespace {
+
+using CheckpointMsg = rmf_traffic_msgs::msg::ScheduleCheckpoint;
+
+const std::string CheckpointFile = "checkpoint";
+const std::string JournalPrefix = "journal-";
+
+//==============================================================================
+template<typename Msg>
+std::vector<uint8_t> serialize(const Msg& msg)
+{
+  static const rclcpp::Serialization<Msg> serializer;
+  rclcpp::SerializedMessage serialized;
+  serializer.serialize_message(&msg, &serialized);
+  const auto& rcl_msg = serialized.get_rcl_serialized_message();
+  return std::vector<uint8_t>(
+    rcl_msg.buffer, rcl_msg.buffer + rcl_msg.buffer_length);
+}
+
+//==============================================================================
+template<typename Msg>
+Msg deserialize(const uint8_t* data, std::size_t size)
+{
+  static const rclcpp::Serialization<Msg> serializer;
+  rclcpp::SerializedMessage serialized(size);
+  auto& rcl_msg = serialized.get_rcl_serialized_message();
+  std::memcpy(rcl_msg.buffer, data, size);
+  rcl_msg.buffer_length = size;
+
+  Msg msg;
+  serializer.deserialize_message(&serialized, &msg);
+  return msg;
+}
+
+//==============================================================================
+bool read_file(const std::string& path, std::vector<uint8_t>& data)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+
+  data.assign(
+    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+//==============================================================================
+bool write_all(int fd, const uint8_t* data, std::size_t size)
+{
+  std::size_t written = 0;
+  while (written < size)
+  {
+    const auto n = ::write(fd, data + written, size - written);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    written += static_cast<std::size_t>(n);
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+Persistence::Persistence(std::string directory)
+: _directory(std::move(directory))
+{
+  if (::mkdir(_directory.c_str(), 0755) != 0 && errno != EEXIST)
+  {
+    throw std::runtime_error(
+            "[rmf_traffic_ros2::schedule::Persistence] Unable to create the "
+            "directory [" + _directory + "]: " + std::strerror(errno));
+  }
+}
+
+//==============================================================================
+Persistence::~Persistence()
+{
+  if (_journal_fd >= 0)
+    ::close(_journal_fd);
+}
+
+//==============================================================================
+auto Persistence::recover() -> Recovery
+{
+  Recovery recovery;
+
+  std::vector<uint8_t> data;
+  if (read_file(_directory + "/" + CheckpointFile, data) && !data.empty())
+  {
+    static_cast<ScheduleState&>(recovery) =
+      restore(deserialize<CheckpointMsg>(data.data(), data.size()));
+  }
+  else
+  {
+    recovery.database = std::make_shared<Database>();
+  }
+
+  // Follow the chain of journals. Each journal is named after the version that
+  // it starts from, so the next one is named after the version that the
+  // previous one ended on.
+  std::unordered_set<Version> replayed;
+  while (true)
+  {
+    const Version version = recovery.database->latest_version();
+    if (!replayed.insert(version).second)
+      break;
+
+    if (!_replay(version, recovery))
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _open_journal(recovery.database->latest_version());
+  return recovery;
+}
+
+//==============================================================================
+void Persistence::rotate(Version version)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (version == _journal_version && _journal_fd >= 0)
+    return;
+
+  _open_journal(version);
+}
+
+//==============================================================================
+void Persistence::write_checkpoint(
+  const Database::Checkpoint& checkpoint,
+  const ScheduleState::QueryMap& queries,
+  uint64_t last_query_id)
+{
+  const auto data = serialize(convert(checkpoint, queries, last_query_id));
+
+  // Write to a temporary file and then rename it, so that a crash in the
+  // middle of writing cannot corrupt the last good checkpoint.
+  const std::string tmp_path = _directory + "/" + CheckpointFile + ".tmp";
+  const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    throw std::runtime_error(
+            "[rmf_traffic_ros2::schedule::Persistence] Unable to open ["
+            + tmp_path + "]: " + std::strerror(errno));
+  }
+
+  if (!write_all(fd, data.data(), data.size()))
+  {
+    const std::string error = std::strerror(errno);
+    ::close(fd);
+    throw std::runtime_error(
+            "[rmf_traffic_ros2::schedule::Persistence] Unable to write ["
+            + tmp_path + "]: " + error);
+  }
+
+  ::fsync(fd);
+  ::close(fd);
+
+  const std::string path = _directory + "/" + CheckpointFile;
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+  {
+    throw std::runtime_error(
+            "[rmf_traffic_ros2::schedule::Persistence] Unable to replace ["
+            + path + "]: " + std::strerror(errno));
+  }
+
+  // The journals that start before this checkpoint are no longer needed
+  DIR* dir = ::opendir(_directory.c_str());
+  if (!dir)
+    return;
+
+  while (const dirent* entry = ::readdir(dir))
+  {
+    const std::string name = entry->d_name;
+    if (name.compare(0, JournalPrefix.size(), JournalPrefix) != 0)
+      continue;
+
+    const std::string suffix = name.substr(JournalPrefix.size());
+    if (suffix.empty()
+      || suffix.find_first_not_of("0123456789") != std::string::npos)
+      continue;
+
+    if (std::stoull(suffix) < checkpoint.version)
+      std::remove((_directory + "/" + name).c_str());
+  }
+
+  ::closedir(dir);
+}
+
+//==============================================================================
+std::string Persistence::_journal_path(Version version) const
+{
+  return _directory + "/" + JournalPrefix + std::to_string(version);
+}
+
+//==============================================================================
+void Persistence::_open_journal(Version version)
+{
+  if (_journal_fd >= 0)
+    ::close(_journal_fd);
+
+  const std::string path = _journal_path(version);
+  _journal_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (_journal_fd < 0)
+  {
+    throw std::runtime_error(
+            "[rmf_traffic_ros2::schedule::Persistence] Unable to open ["
+            + path + "]: " + std::strerror(errno));
+  }
+
+  _journal_version = version;
+}
+
+//==============================================================================
+void Persistence::append(const JournalEntry& entry)
+{
+  const auto data = serialize(entry);
+  const uint64_t size = data.size();
+
+  std::vector<uint8_t> record(sizeof(size) + data.size());
+  std::memcpy(record.data(), &size, sizeof(size));
+  std::memcpy(record.data() + sizeof(size), data.data(), data.size());
+
+  // The records are not synced to disk one by one. The operating system will
+  // still write them out if the schedule node crashes, and the checkpoints
+  // are synced.
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_journal_fd < 0)
+    return;
+
+  if (!write_all(_journal_fd, record.data(), record.size()))
+  {
+    // Stop journaling rather than leave a gap in the middle of the journal.
+    // The next checkpoint will capture the changes and start a new journal.
+    ::close(_journal_fd);
+    _journal_fd = -1;
+  }
+}
+
+//==============================================================================
+bool Persistence::_replay(Version version, Recovery& recovery) const
+{
+  const std::string path = _journal_path(version);
+  std::vector<uint8_t> data;
+  if (!read_file(path, data))
+    return false;
+
+  std::size_t offset = 0;
+  while (offset + sizeof(uint64_t) <= data.size())
+  {
+    uint64_t size;
+    std::memcpy(&size, data.data() + offset, sizeof(size));
+    const std::size_t begin = offset + sizeof(size);
+    if (size > data.size() - begin)
+      break;
+
+    const auto entry = deserialize<JournalEntry>(data.data() + begin, size);
+    offset = begin + size;
+    ++recovery.journal_entries;
+
+    try
+    {
+      apply(entry, recovery);
+    }
+    catch (const std::exception& e)
+    {
+      throw std::runtime_error(
+              "[rmf_traffic_ros2::schedule::Persistence] Failed to replay ["
+              + path + "]: " + e.what());
+    }
+  }
+
+  if (offset < data.size())
+  {
+    // The schedule node was stopped in the middle of writing an entry, so
+    // drop the partial entry before anything else gets appended after it.
+    if (::truncate(path.c_str(), static_cast<off_t>(offset)) != 0)
+    {
+      throw std::runtime_error(
+              "[rmf_traffic_ros2::schedule::Persistence] Unable to repair ["
+              + path + "]: " + std::strerror(errno));
+    }
+  }
+
+  return true;
+}
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__PERSISTENCE_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__PERSISTENCE_HPP
+
+#include "EntryJournal.hpp"
+
+#include <mutex>
+#include <string>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// Saves the schedule database to a directory on disk so that the schedule node
+/// can recover it after a restart.
+///
+/// Every entry of the EntryJournal gets appended to a journal file. Every so
+/// often, a compact checkpoint of the database is written and a new journal is
+/// started. Each journal is named after the schedule version that it starts
+/// from, so recovering is a matter of loading the checkpoint and then
+/// replaying the chain of journals that follows it.
+class Persistence
+{
+public:
+
+  using Database = rmf_traffic::schedule::Database;
+  using Version = rmf_traffic::schedule::Version;
+  using JournalEntry = rmf_traffic_msgs::msg::ScheduleJournalEntry;
+
+  struct Recovery : ScheduleState
+  {
+    std::size_t journal_entries = 0;
+  };
+
+  /// Constructor
+  ///
+  /// \param[in] directory
+  ///   The directory to keep the checkpoint and journals in. It will be
+  ///   created if it does not exist.
+  Persistence(std::string directory);
+
+  ~Persistence();
+
+  /// Load the last checkpoint and replay the journals that follow it, then
+  /// start appending to the journal of the recovered version. If there is
+  /// nothing to recover, this will give back an empty database.
+  Recovery recover();
+
+  /// Start a new journal for the given version. This must be called while the
+  /// database is locked, right after its checkpoint was taken, so that no
+  /// change can fall between the checkpoint and the new journal.
+  void rotate(Version version);
+
+  /// Write a checkpoint to disk and remove the journals that it makes
+  /// redundant. This does not need the database to be locked.
+  void write_checkpoint(
+    const Database::Checkpoint& checkpoint,
+    const ScheduleState::QueryMap& queries,
+    uint64_t last_query_id);
+
+  /// Append an entry to the current journal. This can be used as a sink of an
+  /// EntryJournal.
+  void append(const JournalEntry& entry);
+
+private:
+  std::string _journal_path(Version version) const;
+  void _open_journal(Version version);
+  bool _replay(Version version, Recovery& recovery) const;
+
+  std::string _directory;
+  std::mutex _mutex;
+  int _journal_fd = -1;
+  Version _journal_version = 0;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__PERSISTENCE_HPP
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ResponseQueue.hpp"
+
+#include <cassert>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+namespace {
+//==============================================================================
+/// A responder that holds onto the response of a negotiator so that it can be
+/// passed along to the real Responder later.
+class DeferredResponder : public rmf_traffic::schedule::Negotiator::Responder
+{
+public:
+
+  enum class Type
+  {
+    None,
+    Submit,
+    Reject,
+    Forfeit
+  };
+
+  void submit(
+    std::vector<rmf_traffic::Route> itinerary_,
+    std::function<UpdateVersion()> approval_callback_) const final
+  {
+    type = Type::Submit;
+    itinerary = std::move(itinerary_);
+    approval_callback = std::move(approval_callback_);
+  }
+
+  void reject(const Alternatives& alternatives_) const final
+  {
+    type = Type::Reject;
+    alternatives = alternatives_;
+  }
+
+  void forfeit(const std::vector<ParticipantId>& blockers_) const final
+  {
+    type = Type::Forfeit;
+    blockers = blockers_;
+  }
+
+  void pass_to(const Responder& responder) const
+  {
+    switch (type)
+    {
+      case Type::Submit:
+        return responder.submit(
+          std::move(itinerary), std::move(approval_callback));
+      case Type::Reject:
+        return responder.reject(alternatives);
+      case Type::Forfeit:
+        return responder.forfeit(blockers);
+      case Type::None:
+        // If the negotiator never responded, the Responder will forfeit on
+        // its own when it gets destructed.
+        return;
+    }
+  }
+
+private:
+  mutable Type type = Type::None;
+  mutable std::vector<rmf_traffic::Route> itinerary;
+  mutable std::function<UpdateVersion()> approval_callback;
+  mutable Alternatives alternatives;
+  mutable std::vector<ParticipantId> blockers;
+};
+} // anonymous namespace
+
+//==============================================================================
+struct ResponseQueue::Prepared
+{
+  // The table is considered unchanged as long as it still has the same viewer
+  // and version as when the response was prepared.
+  rmf_traffic::schedule::Negotiation::Table::ViewerPtr viewer;
+  rmf_traffic::schedule::Version version;
+  std::shared_ptr<DeferredResponder> deferred;
+  std::future<void> finished;
+
+  bool matches(const TablePtr& table) const
+  {
+    return viewer == table->viewer() && version == table->version();
+  }
+};
+
+//==============================================================================
+ResponseQueue::ResponseQueue(
+  GetNegotiator get_negotiator,
+  MakeResponder make_responder,
+  Forfeited forfeited,
+  ThreadPool* pool)
+: _get_negotiator(std::move(get_negotiator)),
+  _make_responder(std::move(make_responder)),
+  _forfeited(std::move(forfeited)),
+  _pool(pool)
+{
+  // Do nothing
+}
+
+//==============================================================================
+void ResponseQueue::respond(std::vector<TablePtr> queue)
+{
+  _prepared.clear();
+
+  while (!queue.empty())
+  {
+    const auto top = queue.back();
+
+    if (_pool && _needs_response(top))
+    {
+      const auto it = _prepared.find(top);
+      if (it == _prepared.end() || !it->second->matches(top))
+        _prepare(queue);
+    }
+
+    queue.pop_back();
+
+    if (top->defunct())
+      continue;
+
+    if (!top->submission())
+    {
+      const auto negotiator = _get_negotiator(top->participant());
+      if (!negotiator)
+        continue;
+
+      if (top->version() > MaxTableVersion)
+      {
+        // Give up on this table at this point to avoid an infinite loop
+        top->forfeit(top->version());
+        _forfeited(top);
+        continue;
+      }
+
+      if (_pool)
+      {
+        const auto it = _prepared.find(top);
+        assert(it != _prepared.end() && it->second->matches(top));
+        const auto prepared = it->second;
+        _prepared.erase(it);
+
+        // This passes along any exception that the negotiator threw, at the
+        // same point where the serial walk would have thrown it.
+        prepared->finished.get();
+        prepared->deferred->pass_to(*_make_responder(top));
+      }
+      else
+      {
+        negotiator->respond(top->viewer(), _make_responder(top));
+      }
+    }
+
+    if (top->submission())
+    {
+      for (const auto& c : top->children())
+        queue.push_back(c);
+    }
+    else if (const auto& parent = top->parent())
+    {
+      if (parent->rejected())
+        queue.push_back(parent);
+    }
+  }
+
+  _prepared.clear();
+}
+
+//==============================================================================
+void ResponseQueue::_prepare(const std::vector<TablePtr>& queue)
+{
+  std::vector<std::shared_ptr<Prepared>> batch;
+  for (const auto& table : queue)
+  {
+    const auto negotiator = _needs_response(table);
+    if (!negotiator)
+      continue;
+
+    auto& prepared = _prepared[table];
+    if (prepared && prepared->matches(table))
+      continue;
+
+    // The viewer is made on this thread so that the pool threads only ever
+    // read from it.
+    auto viewer = table->viewer();
+    auto deferred = std::make_shared<DeferredResponder>();
+    auto finished = _pool->push(
+      [negotiator, viewer, deferred]()
+      {
+        negotiator->respond(viewer, deferred);
+      });
+
+    prepared = std::make_shared<Prepared>(
+      Prepared{
+        std::move(viewer),
+        table->version(),
+        std::move(deferred),
+        std::move(finished)
+      });
+
+    batch.push_back(prepared);
+  }
+
+  // Nothing in the negotiation may change while the negotiators are reading
+  // from it, so we wait for all of them before applying any response.
+  for (const auto& prepared : batch)
+    prepared->finished.wait();
+}
+
+//==============================================================================
+auto ResponseQueue::_needs_response(const TablePtr& table) const
+-> Negotiator*
+{
+  if (table->defunct() || table->submission())
+    return nullptr;
+
+  if (table->version() > MaxTableVersion)
+    return nullptr;
+
+  return _get_negotiator(table->participant());
+}
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__RESPONSEQUEUE_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__RESPONSEQUEUE_HPP
+
+#include "ThreadPool.hpp"
+
+#include <rmf_traffic/schedule/Negotiation.hpp>
+#include <rmf_traffic/schedule/Negotiator.hpp>
+
+#include <unordered_map>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// Walk through a queue of negotiation tables, giving a response to every
+/// table that needs one, until the queue is empty. The queue is used as a
+/// stack: the last table is visited first, and the follow-up tables of each
+/// response (the children of a submission, or the parent of a rejection) are
+/// pushed on top of it.
+///
+/// When a ThreadPool is given, the negotiators of every table that is waiting
+/// in the queue are run ahead of time on the pool, and the walk waits for all
+/// of them before it continues. The responses are then applied in exactly the
+/// order that the walk visits their tables, so the negotiation evolves the
+/// same way that it would without the pool. A response that was computed
+/// ahead of time is only used if its table has not changed since then;
+/// otherwise the table gets a fresh response.
+class ResponseQueue
+{
+public:
+
+  using TablePtr = rmf_traffic::schedule::Negotiation::TablePtr;
+  using Negotiator = rmf_traffic::schedule::Negotiator;
+  using ResponderPtr = Negotiator::ResponderPtr;
+  using ParticipantId = rmf_traffic::schedule::ParticipantId;
+
+  /// Get the negotiator for a participant, or nullptr if this process does
+  /// not have one for it.
+  using GetNegotiator = std::function<Negotiator*(ParticipantId)>;
+
+  /// Make the responder that a table's response should be given to.
+  using MakeResponder = std::function<ResponderPtr(const TablePtr&)>;
+
+  /// Called when a table is forfeited because it has been revised too often.
+  using Forfeited = std::function<void(const TablePtr&)>;
+
+  /// Tables whose version goes above this limit are forfeited to avoid an
+  /// infinite loop.
+  // TODO(MXG): Make this limit configurable
+  static constexpr rmf_traffic::schedule::Version MaxTableVersion = 3;
+
+  ResponseQueue(
+    GetNegotiator get_negotiator,
+    MakeResponder make_responder,
+    Forfeited forfeited,
+    ThreadPool* pool = nullptr);
+
+  /// Respond to the queue until it is empty.
+  void respond(std::vector<TablePtr> queue);
+
+private:
+
+  /// A response that was computed ahead of time
+  struct Prepared;
+
+  /// Run the negotiators of every table in the queue that does not already
+  /// have a prepared response, and wait for all of them to finish.
+  void _prepare(const std::vector<TablePtr>& queue);
+
+  /// Get the negotiator of a table if the table needs a response from it.
+  Negotiator* _needs_response(const TablePtr& table) const;
+
+  GetNegotiator _get_negotiator;
+  MakeResponder _make_responder;
+  Forfeited _forfeited;
+  ThreadPool* _pool;
+  std::unordered_map<TablePtr, std::shared_ptr<Prepared>> _prepared;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__RESPONSEQUEUE_HPP
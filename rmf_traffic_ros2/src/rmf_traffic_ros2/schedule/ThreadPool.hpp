@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__THREADPOOL_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// A fixed-size pool of threads that runs jobs in the order they were pushed.
+class ThreadPool
+{
+public:
+
+  ThreadPool(std::size_t num_threads)
+  {
+    _threads.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i)
+      _threads.emplace_back([this]() { spin(); });
+  }
+
+  /// Push a job into the pool. The returned future will become ready once the
+  /// job is finished. Any exception thrown by the job will be passed along
+  /// through the future.
+  std::future<void> push(std::function<void()> job)
+  {
+    std::packaged_task<void()> task(std::move(job));
+    auto future = task.get_future();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _jobs.emplace_back(std::move(task));
+    }
+
+    _cv.notify_one();
+    return future;
+  }
+
+  std::size_t size() const
+  {
+    return _threads.size();
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _quit = true;
+    }
+
+    _cv.notify_all();
+    for (auto& thread : _threads)
+    {
+      if (thread.joinable())
+        thread.join();
+    }
+  }
+
+private:
+
+  void spin()
+  {
+    for (;;)
+    {
+      std::packaged_task<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [&]() { return _quit || !_jobs.empty(); });
+        if (_jobs.empty())
+          return;
+
+        task = std::move(_jobs.front());
+        _jobs.pop_front();
+      }
+
+      task();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::packaged_task<void()>> _jobs;
+  std::vector<std::thread> _threads;
+  bool _quit = false;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__THREADPOOL_HPP
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef SRC__RMF_TRAFFIC_ROS2__SCHEDULE__INTERNAL_FOLLOWER_HPP
+#define SRC__RMF_TRAFFIC_ROS2__SCHEDULE__INTERNAL_FOLLOWER_HPP
+
+#include "EntryJournal.hpp"
+#include "HistoryHorizon.hpp"
+
+#include <rclcpp/node.hpp>
+
+#include <rmf_traffic_msgs/msg/mirror_wakeup.hpp>
+#include <rmf_traffic_msgs/msg/schedule_journal_entry.hpp>
+
+#include <rmf_traffic_msgs/srv/get_schedule_checkpoint.hpp>
+#include <rmf_traffic_msgs/srv/mirror_update.hpp>
+
+#include <vector>
+
+namespace rmf_traffic_ros2 {
+namespace schedule {
+
+//==============================================================================
+/// Keeps an identical copy of the schedule database by following the journal
+/// entries that the ScheduleNode publishes, and serves MirrorUpdate requests
+/// from that copy. The follower starts from a checkpoint of the ScheduleNode,
+/// and asks for a new checkpoint whenever it misses an entry or the
+/// ScheduleNode restarts.
+///
+/// The follower provides its mirror update service and mirror wakeup topic in
+/// its own private namespace, so several followers can run side by side.
+class ScheduleFollower : public rclcpp::Node
+{
+public:
+
+  ScheduleFollower(const rclcpp::NodeOptions& options);
+
+  using request_id_ptr = std::shared_ptr<rmw_request_id_t>;
+
+  using JournalEntry = rmf_traffic_msgs::msg::ScheduleJournalEntry;
+  using JournalEntrySub = rclcpp::Subscription<JournalEntry>;
+  void receive_entry(const JournalEntry& entry);
+  JournalEntrySub::SharedPtr journal_sub;
+
+  using GetScheduleCheckpoint = rmf_traffic_msgs::srv::GetScheduleCheckpoint;
+  using GetScheduleCheckpointClient = rclcpp::Client<GetScheduleCheckpoint>;
+  void request_checkpoint();
+  void receive_checkpoint(const GetScheduleCheckpoint::Response& response);
+  GetScheduleCheckpointClient::SharedPtr checkpoint_client;
+  rclcpp::TimerBase::SharedPtr checkpoint_timer;
+
+  /// Drop the current copy of the schedule and start over from a new
+  /// checkpoint, keeping this entry for after the checkpoint arrives.
+  void resync(const JournalEntry& entry);
+
+  using MirrorUpdate = rmf_traffic_msgs::srv::MirrorUpdate;
+  using MirrorUpdateService = rclcpp::Service<MirrorUpdate>;
+  void mirror_update(
+    const request_id_ptr& request_header,
+    const MirrorUpdate::Request::SharedPtr& request,
+    const MirrorUpdate::Response::SharedPtr& response);
+  MirrorUpdateService::SharedPtr mirror_update_service;
+
+  using MirrorWakeup = rmf_traffic_msgs::msg::MirrorWakeup;
+  using MirrorWakeupPublisher = rclcpp::Publisher<MirrorWakeup>;
+  void wakeup_mirrors();
+  MirrorWakeupPublisher::SharedPtr mirror_wakeup_publisher;
+
+  /// Compact the history of changes that is older than the history horizon.
+  /// Culling is not needed here, because the culls of the ScheduleNode arrive
+  /// as journal entries.
+  void compact();
+  HistoryHorizon history_horizon;
+  rclcpp::TimerBase::SharedPtr compaction_timer;
+
+  // The database is null until the first checkpoint has arrived
+  ScheduleState state;
+  uint64_t session = 0;
+  uint64_t sequence = 0;
+  bool synced = false;
+
+  // Entries that arrived while waiting for a checkpoint
+  std::vector<JournalEntry> backlog;
+  std::size_t max_backlog = 10000;
+
+  // Only the response to the latest checkpoint request gets used
+  uint64_t checkpoint_request = 0;
+  bool waiting_for_checkpoint = false;
+  rclcpp::Time checkpoint_request_time;
+};
+
+} // namespace schedule
+} // namespace rmf_traffic_ros2
+
+#endif // SRC__RMF_TRAFFIC_ROS2__SCHEDULE__INTERNAL_FOLLOWER_HPP
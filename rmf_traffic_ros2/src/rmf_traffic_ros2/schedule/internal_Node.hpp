@@ -19,6 +19,9 @@
 #define SRC__RMF_TRAFFIC_SCHEDULE__SCHEDULENODE_HPP
 
 #include "NegotiationRoom.hpp"
+#include "EntryJournal.hpp"
+#include "HistoryHorizon.hpp"
+#include "Persistence.hpp"
 
 #include <rmf_traffic/schedule/Database.hpp>
 #include <rmf_traffic/schedule/Negotiation.hpp>
@@ -44,6 +47,7 @@
 
 #include <rmf_traffic_msgs/msg/schedule_inconsistency.hpp>
 
+#include <rmf_traffic_msgs/srv/get_schedule_checkpoint.hpp>
 #include <rmf_traffic_msgs/srv/mirror_update.hpp>
 #include <rmf_traffic_msgs/srv/register_query.hpp>
 #include <rmf_traffic_msgs/srv/mirror_update.h>
@@ -55,6 +59,8 @@
 
 #include <rmf_utils/Modular.hpp>
 
+#include <functional>
+#include <future>
 #include <set>
 #include <unordered_map>
 
@@ -157,9 +163,37 @@ public:
 
   void wakeup_mirrors();
 
-  // TODO(MXG): Consider using libguarded instead of a database_mutex
-  std::mutex database_mutex;
-  std::shared_ptr<rmf_traffic::schedule::Database> database;
+  using ParticipantId = rmf_traffic::schedule::ParticipantId;
+  using ItineraryVersion = rmf_traffic::schedule::ItineraryVersion;
+
+  /// A change from a schedule writer that still needs to be applied to the
+  /// database
+  struct WriterChange
+  {
+    ParticipantId participant;
+
+    /// Apply the change to the database and return the itinerary version that
+    /// the active conflicts should be checked against. This will be called
+    /// while database_mutex is locked.
+    std::function<ItineraryVersion(rmf_traffic::schedule::Database&)> apply;
+  };
+
+  /// Apply the change right away, or add it to the current batch if batching
+  /// is turned on.
+  void receive_change(WriterChange change);
+
+  /// Apply a set of changes while locking the database once, and then wake up
+  /// the mirrors and the conflict checker once for the whole set.
+  void apply_changes(const std::vector<WriterChange>& changes);
+
+  /// Apply all the changes in the current batch
+  void flush_changes();
+
+  // How long to collect writer changes before applying them as one batch. When
+  // this is zero, every change gets applied as soon as it arrives.
+  std::chrono::nanoseconds writer_batch_window = std::chrono::nanoseconds(0);
+  std::vector<WriterChange> pending_changes;
+  rclcpp::TimerBase::SharedPtr batch_timer;
 
   using QueryMap =
     std::unordered_map<uint64_t, rmf_traffic::schedule::Query>;
@@ -168,6 +202,54 @@ public:
   std::size_t last_query_id = 0;
   QueryMap registered_queries;
 
+  /// Load the database from the schedule_persistence_dir if that parameter is
+  /// set. The registered queries are recovered along with it, so this must be
+  /// called after they have been initialized.
+  std::shared_ptr<rmf_traffic::schedule::Database> recover_database();
+
+  /// Take a checkpoint of the database and write it to disk in the background
+  void checkpoint();
+
+  // This is only set when the schedule is being saved to disk
+  std::shared_ptr<Persistence> persistence;
+  rclcpp::TimerBase::SharedPtr checkpoint_timer;
+  std::future<void> checkpoint_write;
+  rmf_traffic::schedule::Version last_checkpoint_version = 0;
+
+  // This is only set when the database changes are being saved to disk or
+  // published to followers
+  std::shared_ptr<EntryJournal> journal;
+
+  using JournalEntry = rmf_traffic_msgs::msg::ScheduleJournalEntry;
+  using JournalEntryPub = rclcpp::Publisher<JournalEntry>;
+  JournalEntryPub::SharedPtr journal_pub;
+  uint64_t journal_session = 0;
+  uint64_t journal_sequence = 0;
+
+  using GetScheduleCheckpoint = rmf_traffic_msgs::srv::GetScheduleCheckpoint;
+  using GetScheduleCheckpointService = rclcpp::Service<GetScheduleCheckpoint>;
+  void get_schedule_checkpoint(
+    const request_id_ptr& request_header,
+    const GetScheduleCheckpoint::Request::SharedPtr& request,
+    const GetScheduleCheckpoint::Response::SharedPtr& response);
+  GetScheduleCheckpointService::SharedPtr get_schedule_checkpoint_service;
+
+  /// Cull the routes that finished before the retention period, compact the
+  /// history of changes that is older than the history horizon, and report how
+  /// much data the schedule is holding for each participant.
+  void maintain_database();
+
+  // Routes that finished longer ago than this get culled. Nothing gets culled
+  // when this is zero.
+  rmf_traffic::Duration schedule_retention = rmf_traffic::Duration(0);
+  HistoryHorizon history_horizon;
+  std::size_t max_staged_changes = 1000;
+  rclcpp::TimerBase::SharedPtr maintenance_timer;
+
+  // TODO(MXG): Consider using libguarded instead of a database_mutex
+  std::mutex database_mutex;
+  std::shared_ptr<rmf_traffic::schedule::Database> database;
+
   // TODO(MXG): Make this a separate node
   std::thread conflict_check_thread;
   std::condition_variable conflict_check_cv;
@@ -207,8 +289,6 @@ public:
   ConflictConclusionPub::SharedPtr conflict_conclusion_pub;
 
   using Version = rmf_traffic::schedule::Version;
-  using ItineraryVersion = rmf_traffic::schedule::ItineraryVersion;
-  using ParticipantId = rmf_traffic::schedule::ParticipantId;
   using ConflictSet = std::unordered_set<ParticipantId>;
 
   using Negotiation = rmf_traffic::schedule::Negotiation;
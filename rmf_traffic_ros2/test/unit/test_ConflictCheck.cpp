@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "rmf_traffic_ros2/schedule/ConflictCheck.hpp"
+
+#include <rmf_traffic/geometry/Circle.hpp>
+#include <rmf_traffic/schedule/Participant.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <algorithm>
+
+namespace {
+
+using ConflictCheck = rmf_traffic_ros2::schedule::ConflictCheck;
+
+//==============================================================================
+rmf_traffic::Trajectory make_trajectory(
+  const rmf_traffic::Time start,
+  const Eigen::Vector3d& from,
+  const Eigen::Vector3d& to)
+{
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(start, from, Eigen::Vector3d::Zero());
+  trajectory.insert(
+    start + std::chrono::seconds(10), to, Eigen::Vector3d::Zero());
+  return trajectory;
+}
+
+//==============================================================================
+bool has_conflict(
+  const std::vector<ConflictCheck::ConflictSet>& conflicts,
+  const ConflictCheck::ConflictSet& expected)
+{
+  return std::find(conflicts.begin(), conflicts.end(), expected)
+    != conflicts.end();
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Conflict checks see every change")
+{
+  auto database = std::make_shared<rmf_traffic::schedule::Database>();
+
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(1.0)
+  };
+
+  const auto make_participant = [&](const std::string& name)
+    {
+      return rmf_traffic::schedule::make_participant(
+        rmf_traffic::schedule::ParticipantDescription{
+          name,
+          "test_ConflictCheck",
+          rmf_traffic::schedule::ParticipantDescription::Rx::Responsive,
+          profile
+        },
+        database);
+    };
+
+  auto a = make_participant("a");
+  auto b = make_participant("b");
+  auto c = make_participant("c");
+
+  const auto now = std::chrono::steady_clock::now();
+  const Eigen::Vector3d left{0.0, 0.0, 0.0};
+  const Eigen::Vector3d right{10.0, 0.0, 0.0};
+
+  // a and b drive head on at each other on the same map, while c drives the
+  // same path as a on a different map.
+  const auto a_route = [&](const rmf_traffic::Time start)
+    {
+      return rmf_traffic::Route("L1", make_trajectory(start, left, right));
+    };
+
+  const auto b_route = [&](const rmf_traffic::Time start)
+    {
+      return rmf_traffic::Route("L1", make_trajectory(start, right, left));
+    };
+
+  const auto c_route = [&](const rmf_traffic::Time start)
+    {
+      return rmf_traffic::Route("L2", make_trajectory(start, left, right));
+    };
+
+  const ConflictCheck::ConflictSet a_b = {a.id(), b.id()};
+  const ConflictCheck::ConflictSet a_c = {a.id(), c.id()};
+  const ConflictCheck::ConflictSet b_c = {b.id(), c.id()};
+
+  ConflictCheck checker;
+  CHECK(checker.has_new_changes(*database));
+
+  WHEN("Changes arrive while the previous ones are being checked")
+  {
+    a.set({a_route(now)});
+    checker.copy_changes(*database);
+
+    // These changes arrive after the changes were copied out, but before the
+    // mirror gets updated.
+    b.set({b_route(now)});
+    c.set({c_route(now)});
+
+    const auto first = checker.check();
+    CHECK(first.empty());
+
+    THEN("The next check sees them")
+    {
+      REQUIRE(checker.has_new_changes(*database));
+      checker.copy_changes(*database);
+      const auto second = checker.check();
+      CHECK(has_conflict(second, a_b));
+      CHECK_FALSE(has_conflict(second, a_c));
+      CHECK_FALSE(has_conflict(second, b_c));
+
+      CHECK_FALSE(checker.has_new_changes(*database));
+      REQUIRE(checker.last_checked_version());
+      CHECK(*checker.last_checked_version() == database->latest_version());
+    }
+  }
+
+  WHEN("A burst of changes is checked a few at a time")
+  {
+    std::size_t checks = 0;
+    std::vector<ConflictCheck::ConflictSet> last_conflicts;
+    for (std::size_t i = 0; i < 30; ++i)
+    {
+      const auto start = now + std::chrono::seconds(5*i);
+      if (i % 3 == 0)
+        a.set({a_route(start)});
+      else if (i % 3 == 1)
+        b.set({b_route(start)});
+      else
+        c.set({c_route(start)});
+
+      if (i % 4 == 3)
+      {
+        checker.copy_changes(*database);
+        last_conflicts = checker.check();
+        ++checks;
+      }
+    }
+
+    THEN("The last check catches up with the database")
+    {
+      CHECK(checks > 1);
+      REQUIRE(checker.has_new_changes(*database));
+      checker.copy_changes(*database);
+      last_conflicts = checker.check();
+
+      CHECK_FALSE(checker.has_new_changes(*database));
+      REQUIRE(checker.last_checked_version());
+      CHECK(*checker.last_checked_version() == database->latest_version());
+
+      // The last route of b was not checked before, and it crosses the last
+      // route of a. The last route of c is on a different map.
+      CHECK(has_conflict(last_conflicts, a_b));
+      CHECK_FALSE(has_conflict(last_conflicts, a_c));
+      CHECK_FALSE(has_conflict(last_conflicts, b_c));
+    }
+  }
+}
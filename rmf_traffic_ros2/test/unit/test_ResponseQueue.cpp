@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <rmf_traffic_ros2/schedule/ResponseQueue.hpp>
+
+#include <rmf_traffic/agv/SimpleNegotiator.hpp>
+#include <rmf_traffic/geometry/Circle.hpp>
+#include <rmf_traffic/schedule/Database.hpp>
+#include <rmf_traffic/schedule/Participant.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <map>
+
+namespace {
+
+using ParticipantId = rmf_traffic::schedule::ParticipantId;
+using Negotiation = rmf_traffic::schedule::Negotiation;
+using ResponseQueue = rmf_traffic_ros2::schedule::ResponseQueue;
+
+//==============================================================================
+struct Intention
+{
+  rmf_traffic::agv::Plan::Start start;
+  rmf_traffic::agv::Plan::Goal goal;
+};
+
+//==============================================================================
+struct Outcome
+{
+  using Sequence = std::vector<std::pair<ParticipantId, std::size_t>>;
+
+  /// The tables in the order that they were responded to
+  std::vector<Sequence> visited;
+
+  /// The tables that were forfeited for being revised too often
+  std::vector<Sequence> forfeited;
+
+  bool ready = false;
+  bool complete = false;
+
+  /// The waypoints of each participant in the chosen proposal
+  std::map<ParticipantId, std::vector<Eigen::Vector3d>> positions;
+  std::map<ParticipantId, std::vector<rmf_traffic::Time>> times;
+};
+
+//==============================================================================
+Outcome::Sequence to_sequence(const Negotiation::VersionedKeySequence& keys)
+{
+  Outcome::Sequence sequence;
+  for (const auto& k : keys)
+    sequence.push_back({k.participant, k.version});
+
+  return sequence;
+}
+
+//==============================================================================
+Outcome negotiate(
+  const std::shared_ptr<rmf_traffic::schedule::Database>& database,
+  const std::map<ParticipantId, Intention>& intentions,
+  const rmf_traffic::agv::Planner::Configuration& configuration,
+  rmf_traffic_ros2::schedule::ThreadPool* pool)
+{
+  // Each run gets its own negotiators so that nothing is shared between the
+  // serial and the parallel runs.
+  std::map<ParticipantId, std::unique_ptr<rmf_traffic::agv::SimpleNegotiator>>
+  negotiators;
+  std::vector<ParticipantId> participants;
+  for (const auto& i : intentions)
+  {
+    negotiators[i.first] =
+      std::make_unique<rmf_traffic::agv::SimpleNegotiator>(
+      i.second.start, i.second.goal, configuration);
+    participants.push_back(i.first);
+  }
+
+  const auto negotiation = Negotiation::make_shared(database, participants);
+  REQUIRE(negotiation);
+
+  Outcome outcome;
+  ResponseQueue queue(
+    [&negotiators](const ParticipantId p)
+    -> rmf_traffic::schedule::Negotiator*
+    {
+      const auto it = negotiators.find(p);
+      if (it == negotiators.end())
+        return nullptr;
+
+      return it->second.get();
+    },
+    [&outcome](const Negotiation::TablePtr& table)
+    {
+      outcome.visited.push_back(to_sequence(table->sequence()));
+      return rmf_traffic::schedule::SimpleResponder::make(table);
+    },
+    [&outcome](const Negotiation::TablePtr& table)
+    {
+      outcome.forfeited.push_back(to_sequence(table->sequence()));
+    },
+    pool);
+
+  std::vector<Negotiation::TablePtr> roots;
+  for (const auto p : participants)
+    roots.push_back(negotiation->table(p, {}));
+
+  queue.respond(roots);
+
+  outcome.ready = negotiation->ready();
+  outcome.complete = negotiation->complete();
+  if (outcome.ready)
+  {
+    const auto best =
+      negotiation->evaluate(rmf_traffic::schedule::QuickestFinishEvaluator());
+    REQUIRE(best);
+
+    for (const auto& submission : best->proposal())
+    {
+      auto& positions = outcome.positions[submission.participant];
+      auto& times = outcome.times[submission.participant];
+      for (const auto& route : submission.itinerary)
+      {
+        for (const auto& wp : route->trajectory())
+        {
+          positions.push_back(wp.position());
+          times.push_back(wp.time());
+        }
+      }
+    }
+  }
+
+  return outcome;
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("Parallel responses match serial responses")
+{
+  const std::size_t num_threads = GENERATE(1, 2, 4);
+
+  auto database = std::make_shared<rmf_traffic::schedule::Database>();
+
+  const rmf_traffic::Profile profile{
+    rmf_traffic::geometry::make_final_convex<
+      rmf_traffic::geometry::Circle>(1.0)
+  };
+
+  std::vector<rmf_traffic::schedule::Participant> participants;
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    participants.emplace_back(
+      rmf_traffic::schedule::make_participant(
+        rmf_traffic::schedule::ParticipantDescription{
+          "participant " + std::to_string(i),
+          "test_ResponseQueue",
+          rmf_traffic::schedule::ParticipantDescription::Rx::Responsive,
+          profile
+        },
+        database));
+  }
+
+  const std::string test_map_name = "test_map";
+  rmf_traffic::agv::Graph graph;
+  graph.add_waypoint(test_map_name, { 0.0, -5.0}); // 0
+  graph.add_waypoint(test_map_name, {-5.0, 0.0}); // 1
+  graph.add_waypoint(test_map_name, { 0.0, 0.0}); // 2
+  graph.add_waypoint(test_map_name, { 5.0,  0.0}); // 3
+  graph.add_waypoint(test_map_name, { 0.0, 5.0}); // 4
+
+  /*
+   *         4
+   *         |
+   *         |
+   *   1-----2-----3
+   *         |
+   *         |
+   *         0
+   */
+
+  const auto add_bidir_lane = [&](const std::size_t w0, const std::size_t w1)
+    {
+      graph.add_lane(w0, w1);
+      graph.add_lane(w1, w0);
+    };
+
+  add_bidir_lane(0, 2);
+  add_bidir_lane(1, 2);
+  add_bidir_lane(3, 2);
+  add_bidir_lane(4, 2);
+
+  const rmf_traffic::agv::VehicleTraits traits{
+    {0.7, 0.3},
+    {1.0, 0.45},
+    profile
+  };
+
+  const rmf_traffic::agv::Planner::Configuration configuration{graph, traits};
+  const auto time = std::chrono::steady_clock::now();
+
+  std::map<ParticipantId, Intention> intentions;
+
+  GIVEN("Three participants crossing through the middle")
+  {
+    intentions.insert({participants[0].id(), {{time, 1, 0.0}, 3}});
+    intentions.insert({participants[1].id(), {{time, 0, M_PI/2.0}, 4}});
+    intentions.insert({participants[2].id(), {{time, 3, 0.0}, 1}});
+  }
+
+  GIVEN("Four participants crossing through the middle")
+  {
+    intentions.insert({participants[0].id(), {{time, 1, 0.0}, 3}});
+    intentions.insert({participants[1].id(), {{time, 0, M_PI/2.0}, 4}});
+    intentions.insert({participants[2].id(), {{time, 3, 0.0}, 1}});
+    intentions.insert({participants[3].id(), {{time, 4, -M_PI/2.0}, 0}});
+  }
+
+  const auto serial = negotiate(database, intentions, configuration, nullptr);
+
+  rmf_traffic_ros2::schedule::ThreadPool pool(num_threads);
+  const auto parallel = negotiate(database, intentions, configuration, &pool);
+
+  CHECK_FALSE(serial.visited.empty());
+  CHECK(parallel.visited == serial.visited);
+  CHECK(parallel.forfeited == serial.forfeited);
+  CHECK(parallel.ready == serial.ready);
+  CHECK(parallel.complete == serial.complete);
+  CHECK(parallel.times == serial.times);
+
+  REQUIRE(parallel.positions.size() == serial.positions.size());
+  for (const auto& p : serial.positions)
+  {
+    const auto& parallel_positions = parallel.positions.at(p.first);
+    REQUIRE(parallel_positions.size() == p.second.size());
+    for (std::size_t i = 0; i < p.second.size(); ++i)
+      CHECK((parallel_positions[i] - p.second[i]).norm() < 1e-8);
+  }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "rmf_traffic_ros2/schedule/internal_Node.hpp"
+
+#include <rmf_traffic_ros2/schedule/Writer.hpp>
+
+#include <rmf_traffic/geometry/Circle.hpp>
+
+#include <rclcpp/executors/single_threaded_executor.hpp>
+
+#include <rmf_utils/catch.hpp>
+
+#include <algorithm>
+
+namespace {
+
+using ScheduleNode = rmf_traffic_ros2::schedule::ScheduleNode;
+
+//==============================================================================
+rmf_traffic::schedule::Writer::Input make_input(
+  const rmf_traffic::RouteId id,
+  const rmf_traffic::Time start)
+{
+  rmf_traffic::Trajectory trajectory;
+  trajectory.insert(start, {0.0, 0.0, 0.0}, Eigen::Vector3d::Zero());
+  trajectory.insert(
+    start + std::chrono::seconds(5), {5.0, 0.0, 0.0}, Eigen::Vector3d::Zero());
+
+  return {
+    {id, std::make_shared<rmf_traffic::Route>("L1", std::move(trajectory))}
+  };
+}
+
+} // anonymous namespace
+
+//==============================================================================
+SCENARIO("A burst of itinerary changes is applied in order")
+{
+  rclcpp::init(0, nullptr);
+
+  auto node = std::make_shared<ScheduleNode>(
+    rclcpp::NodeOptions().parameter_overrides(
+      {rclcpp::Parameter("writer_batch_window", 0.05)}));
+
+  REQUIRE(node->batch_timer);
+
+  ScheduleNode::ParticipantId participant;
+  {
+    std::lock_guard<std::mutex> lock(node->database_mutex);
+    participant = node->database->register_participant(
+      rmf_traffic::schedule::ParticipantDescription{
+        "participant",
+        "test_WriterBatching",
+        rmf_traffic::schedule::ParticipantDescription::Rx::Responsive,
+        rmf_traffic::Profile{
+          rmf_traffic::geometry::make_final_convex<
+            rmf_traffic::geometry::Circle>(1.0)
+        }
+      });
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto route_start = [&](const std::size_t i)
+    {
+      return start + std::chrono::seconds(10*i);
+    };
+
+  const std::size_t num_extensions = 20;
+  const auto delay = std::chrono::seconds(5);
+  rmf_traffic::schedule::ItineraryVersion version = 0;
+
+  // Set the first route, extend it, delay everything, erase the first route,
+  // and then extend it once more. The last extension must not be delayed, so
+  // the final itinerary tells us whether the changes were applied in order.
+  ScheduleNode::ItinerarySet set;
+  set.participant = participant;
+  set.itinerary = rmf_traffic_ros2::convert(make_input(0, route_start(0)));
+  set.itinerary_version = version++;
+  node->itinerary_set(set);
+
+  for (std::size_t i = 1; i <= num_extensions; ++i)
+  {
+    ScheduleNode::ItineraryExtend extend;
+    extend.participant = participant;
+    extend.routes = rmf_traffic_ros2::convert(make_input(i, route_start(i)));
+    extend.itinerary_version = version++;
+    node->itinerary_extend(extend);
+  }
+
+  ScheduleNode::ItineraryDelay itinerary_delay;
+  itinerary_delay.participant = participant;
+  itinerary_delay.delay = rmf_traffic::Duration(delay).count();
+  itinerary_delay.itinerary_version = version++;
+  node->itinerary_delay(itinerary_delay);
+
+  ScheduleNode::ItineraryErase erase;
+  erase.participant = participant;
+  erase.routes = {0};
+  erase.itinerary_version = version++;
+  node->itinerary_erase(erase);
+
+  const std::size_t last = num_extensions + 1;
+  ScheduleNode::ItineraryExtend extend;
+  extend.participant = participant;
+  extend.routes =
+    rmf_traffic_ros2::convert(make_input(last, route_start(last)));
+  extend.itinerary_version = version++;
+  node->itinerary_extend(extend);
+
+  const auto last_version = version - 1;
+
+  // None of the changes are applied until the batch window closes
+  CHECK(node->pending_changes.size() == num_extensions + 4);
+  {
+    std::lock_guard<std::mutex> lock(node->database_mutex);
+    CHECK(node->database->get_itinerary(participant)->empty());
+  }
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto deadline =
+    std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!node->pending_changes.empty()
+    && std::chrono::steady_clock::now() < deadline)
+  {
+    executor.spin_once(std::chrono::milliseconds(10));
+  }
+
+  REQUIRE(node->pending_changes.empty());
+
+  {
+    std::lock_guard<std::mutex> lock(node->database_mutex);
+    const auto& database = *node->database;
+    CHECK(database.itinerary_version(participant) == last_version);
+
+    // A change that was applied out of order would have left a gap in the
+    // itinerary versions
+    const auto inconsistency = database.inconsistencies().find(participant);
+    REQUIRE(inconsistency != database.inconsistencies().end());
+    CHECK(inconsistency->ranges.size() == 0);
+
+    std::vector<rmf_traffic::Time> expected_starts;
+    for (std::size_t i = 1; i <= num_extensions; ++i)
+      expected_starts.push_back(route_start(i) + delay);
+    expected_starts.push_back(route_start(last));
+
+    std::vector<rmf_traffic::Time> starts;
+    for (const auto& route : *database.get_itinerary(participant))
+      starts.push_back(*route->trajectory().start_time());
+
+    std::sort(starts.begin(), starts.end());
+    CHECK(starts == expected_starts);
+  }
+
+  executor.remove_node(node);
+  node.reset();
+  rclcpp::shutdown();
+}